@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "default-platform-parameter.h"
+
+namespace RODOS {
+
+/**
+ * @file content-filter.h
+ * @date 2026/10/18
+ *
+ * @brief predicates over the content of topic messages, for subscribers and gateways
+ *
+ */
+
+/// Type of a field in the message, read in the byte order of the local node
+enum class FieldType : uint8_t { U8, I8, U16, I16, U32, I32, I64, F32, F64 };
+
+enum class FilterOp : uint8_t {
+    EQ, NE, LT, LE, GT, GE, ///< field <op> constant
+    MASK_ANY,              ///< (field & constant) != 0, integer fields
+    MASK_ALL,              ///< (field & constant) == constant, integer fields
+    AND, OR, NOT           ///< of the last results
+};
+
+struct FilterInstruction {
+    FilterOp  op;
+    FieldType type;
+    uint16_t  offset; ///< of the field in the message
+    union {
+        int64_t asInt;
+        double  asFloat;
+    } constant;
+};
+
+/**
+ * A compiled predicate over the layout of a message: a small bytecode for a
+ * stack machine (postfix). Comparisons push a result, AND, OR, NOT combine
+ * the last ones. Example: mode == 3 && altitude > 400.0f
+ *
+ *   ContentFilter highOrbit;
+ *   highOrbit.compare(offsetof(Orbit, mode), FieldType::U8, FilterOp::EQ, 3)
+ *            .compareFloat(offsetof(Orbit, altitude), FieldType::F32, FilterOp::GT, 400.0)
+ *            .logicalAnd();
+ *
+ * matches() needs no allocation and no semaphore. A field beyond the length
+ * of the message does not match. An empty filter matches everything, and so
+ * does an invalid one (too many instructions, unbalanced stack): a wrong
+ * filter shall not lose messages. The instructions can be sent to other
+ * nodes (serialize/deserialize, big endian); the fields are read with the
+ * layout of the node which evaluates the filter.
+ */
+class ContentFilter {
+  public:
+    static constexpr uint32_t MAX_INSTRUCTIONS = CONTENT_FILTER_MAX_INSTRUCTIONS;
+    static constexpr uint32_t MAX_STACK_DEPTH  = 32; ///< bits of the result stack
+    static constexpr size_t   SERIALIZED_INSTRUCTION_SIZE = 12;
+
+    ContentFilter() { clear(); }
+
+    void clear();
+
+    ContentFilter& compare(size_t offset, FieldType type, FilterOp op, int64_t constant);
+    ContentFilter& compareFloat(size_t offset, FieldType type, FilterOp op, double constant);
+    ContentFilter& logicalAnd() { return combine(FilterOp::AND); }
+    ContentFilter& logicalOr() { return combine(FilterOp::OR); }
+    ContentFilter& logicalNot() { return combine(FilterOp::NOT); }
+
+    /// this || other, false if it does not fit: then this is invalid (matches all)
+    bool appendOr(const ContentFilter& other);
+
+    bool matches(const void* data, size_t len) const;
+
+    /// complete and not too long
+    bool isValid() const { return valid && (numOfInstructions == 0 || stackDepth == 1); }
+    bool isEmpty() const { return numOfInstructions == 0; }
+    uint32_t length() const { return numOfInstructions; }
+
+    /// bytes needed by serialize()
+    size_t serializedSize() const { return 1 + numOfInstructions * SERIALIZED_INSTRUCTION_SIZE; }
+    /// @return bytes written, 0 if it does not fit into maxLen
+    size_t serialize(uint8_t* buf, size_t maxLen) const;
+    /// @return bytes read, 0 if the data is not a valid filter
+    size_t deserialize(const uint8_t* buf, size_t len);
+
+  private:
+    FilterInstruction instructions[MAX_INSTRUCTIONS];
+    uint8_t           numOfInstructions;
+    uint8_t           stackDepth; ///< after the last instruction, computed while building
+    bool              valid;
+
+    ContentFilter& combine(FilterOp op);
+    bool           append(const FilterInstruction& instruction);
+};
+
+} // namespace RODOS
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "thread.h"
+
+namespace RODOS {
+
+/**
+ * @file core-partition.h
+ * @date 2026/10/18
+ *
+ * @brief placement of the threads on the cores of a multi-core host (posix)
+ *
+ * A CorePartition maps threads to cores with a list of rules, the first
+ * matching rule gives the cores (bit n: core n):
+ *
+ *     static const CorePartitionRule rules[] = {
+ *         { "gateway", 0,   1 << 2 },          // the gateway on core 2
+ *         { 0,         300, (1 << 3) | (1 << 4) }, // priority >= 300 on the isolated cores 3, 4
+ *         { 0,         0,   0x3 },             // all others on core 0 and 1
+ *     };
+ *     static CorePartition partition(rules, 3, true, true);
+ *
+ * The first CorePartition object is the configuration of the node: it is
+ * applied when the threads are created (Thread::startAllThreads). Others can be
+ * applied later with apply(). A mask set with Thread::setAffinity() has
+ * precedence over the rules.
+ *
+ * fifoScheduling: RODOS priorities are mapped to SCHED_FIFO priorities
+ * (priority / 10, limited to 1 .. 99), as posix RODOS always did. Else the
+ * threads use SCHED_OTHER and the host scheduler ignores the RODOS priorities.
+ * lockMemory: mlockall(), no page faults after the start. Both need
+ * privileges (CAP_SYS_NICE, CAP_IPC_LOCK or rlimits), each refusal of the host
+ * is counted in refusals.
+ *
+ * Bare-metal ports have one core: only masks with core 0 are accepted, the
+ * memory is always locked.
+ */
+
+struct CorePartitionRule {
+    const char* threadName;  ///< 0: all threads, else only the threads with this name
+    int32_t     minPriority; ///< only threads with at least this priority
+    uint64_t    cpuMask;     ///< bit n: core n, 0: all cores
+};
+
+class CorePartition {
+    const CorePartitionRule* rules;
+    uint32_t                 numOfRules;
+
+  public:
+    static CorePartition* active;   ///< the partition applied last, the first one created before
+    static uint32_t       refusals; ///< affinities, SCHED_FIFO and mlockall the host refused
+
+    const bool fifoScheduling;
+    const bool lockMemory;
+    bool       memoryLocked = false;
+
+    /// rules has to live as long as the partition (static)
+    CorePartition(const CorePartitionRule* rules, uint32_t numOfRules, bool fifoScheduling = true, bool lockMemory = false);
+
+    /// the cores of the first matching rule, 0 if no rule matches
+    uint64_t maskOf(const Thread* thread) const;
+
+    /// setAffinity() of the thread, else of the active partition, 0: all cores
+    static uint64_t effectiveMask(const Thread* thread);
+    /// SCHED_FIFO for RODOS priorities, true without partition
+    static bool useFifoScheduling() { return active == 0 || active->fifoScheduling; }
+
+    /**
+     * Makes this partition the active one and applies it to all threads
+     * (affinity, scheduling policy) and locks the memory if requested. Returns
+     * false if the host refused something.
+     */
+    bool apply();
+
+    /// name, priority and cores of all threads
+    static void print();
+};
+
+/// mlockall() of the whole process, false if refused. Bare-metal: true
+bool lockProcessMemory();
+
+} // namespace RODOS
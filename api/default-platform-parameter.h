@@ -25,6 +25,8 @@
 #define XMALLOC_SIZE                2000000 //< Total memory for allocation (xmalloc) eg for all stacks
 #define DEFAULT_STACKSIZE             32000 //< in bytes
 #define SCHEDULER_STACKSIZE           DEFAULT_STACKSIZE  //< for the scheduler
+#define STACK_SCAN_SLICE_WORDS        64 //< bare-metal: words of a stack the idle thread compares each time it runs
+#define STACK_GUARD_WORDS             1  //< bare-metal: words at the end of each stack checked at every thread switch, 0: none
 
 #define PARAM_TIMER_INTERVAL          100000 //< in microseconds
 #define TIME_SLICE_FOR_SAME_PRIORITY (100*MILLISECONDS) //< for switch threads with same priority
@@ -45,12 +47,42 @@
 #define FLOORING_PRIORITY             10
 
 #define MAX_NUMBER_OF_NODES            10 //< for gateway if it has to forward msgs
+#define MAX_ADDRESSABLE_NODES          32 //< node indexes in NodeSet (multiple of 32, max 256), more than 32 need extended addressing
+#define SEEN_NODES_BUCKETS             16 //< gateway duplicate detection: hash buckets (power of 2), each with own semaphore
+#define SEEN_NODES_PER_BUCKET           4 //< sender nodes tracked per bucket, the least recently heard is replaced
 #define MAX_NETWORK_MESSAGE_LENGTH   1300
 #define MAX_SUBSCRIBERS                60 //< per node, for the gateway topic reporter
+#define REASSEMBLY_BUFFERS              2 //< gateway: longer messages than MAX_NETWORK_MESSAGE_LENGTH received at the same time
+#ifndef REASSEMBLY_BUFFER_SIZE // cmake -DREASSEMBLY_BUFFER_SIZE=n, eg. 1048576 for camera frames: REASSEMBLY_BUFFERS times n bytes
+#define REASSEMBLY_BUFFER_SIZE   (8*1024) //< gateway: longest message which can be received in fragments
+#endif
+#define REASSEMBLY_TIMEOUT    (1*SECONDS) //< a buffer is free again after this time without new fragments
+#define FRAGMENT_RATE    (10*1000*1000) //< bytes per second of the fragments of long messages (FragmentPacer), 0: unlimited
+#define FRAGMENT_BURST          (16*1024) //< bytes of fragments sent back to back at full speed
+#define FRAGMENT_BACK_PRESSURE_WAIT (100*MICROSECONDS) //< the link has no room for a fragment: try again after this time
+#define TRANSMIT_QUEUE_LENGTH           4 //< gateway with TransmitScheduler: messages per priority class (one slot stays free)
+#define NET_BUFFER_SMALL_SIZE          64 //< NetBufferPool: bytes (header + user data) of the small buffers
+#define NET_BUFFER_MEDIUM_SIZE        256 //< NetBufferPool: bytes of the medium buffers, the large ones take a whole NetworkMessage
+#define NET_BUFFERS_SMALL              16 //< NetBufferPool: number of small buffers, for UDP input and TransmitSchedulers (ports with UDP: see UDP_INCOMMIG_BUF_LEN)
+#define NET_BUFFERS_MEDIUM              8
+#define NET_BUFFERS_LARGE               4
+#define CONTENT_FILTER_MAX_INSTRUCTIONS 8 //< ContentFilter: comparisons and AND/OR/NOT of a filter
+#define CONTENT_FILTER_ENTRIES         16 //< gateway: filters of other nodes (topic, node), see Gateway::setContentFilterExport
+#define CONTENT_FILTER_REPORT_PERIOD (1*SECONDS) //< gateway: the filters of this node are sent again after this time
+#define CONTENT_FILTER_TIMEOUT  (4*SECONDS) //< gateway: filters of other nodes are forgotten after this time without reports
+#define FLIGHT_RECORDER_MAX_SEGMENTS      16 //< FlightRecorder: segments of a RecorderStorage which are used
+#define FLIGHT_RECORDER_MARKS_PER_SEGMENT 16 //< FlightRecorder: time marks in the index of each segment, for replay
+#define THREAD_LOAD_REPORT_MAX_THREADS    16 //< ThreadLoadMonitor: threads in one ThreadLoadReport, more are not reported
+#define LATENCY_REPORT_MAX_HISTOGRAMS     16 //< LatencyMonitor: histograms in one LatencyReport, more are not reported
+#define LATENCY_MAX_CLOCK_OFFSETS          8 //< setNodeClockOffset(): nodes with a known clock offset
+#define PROFILE_MAX_ZONES                 16 //< ProfileTable: zones per thread, measurements of more are dropped
 
 #define SPRINTF_MAX_SIZE              1000 
 
-#define UDP_INCOMMIG_BUF_LEN          500 //number of "NetworkMessage (1300 Bytes each)" in FIFO
+#define UDP_INCOMMIG_BUF_LEN          500 //number of messages in FIFO (pointers, the messages are in NetBufferPool)
+// The UDP input keeps at most as many messages as NET_BUFFERS_* has free buffers: with the small
+// defaults (16/8/4) only 28 of the 500. Ports with UDP set NET_BUFFERS_* for UDP_INCOMMIG_BUF_LEN
+// in their platform-parameter.h (on-posix, linux-x86 and linux-makecontext).
 
 
 //___________________________________________________ Important: Correct platform dependent parameter
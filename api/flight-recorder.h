@@ -0,0 +1,172 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "default-platform-parameter.h"
+#include "putter.h"
+#include "rodos-atomic.h"
+#include "rodos-semaphore.h"
+#include "subscriber.h"
+#include "timemodel.h"
+
+namespace RODOS {
+
+/**
+ * @file flight-recorder.h
+ * @date 2026/10/18
+ *
+ * @brief records all topic messages of a node in binary form, and replays them
+ *
+ */
+
+/**
+ * Memory of a FlightRecorder: segments of equal size, used as a ring.
+ * RamRecorderStorage for all platforms, MappedRecorderStorage (files,
+ * mapped-recorder-storage.h) on posix.
+ */
+class RecorderStorage {
+  public:
+    virtual ~RecorderStorage() = default;
+    virtual uint32_t numOfSegments() const = 0;
+    /// bytes of each segment, a multiple of 8
+    virtual size_t segmentSize() const = 0;
+    /// the memory of a segment, 8 byte aligned. 0 if it can not be used
+    virtual uint8_t* segment(uint32_t index) = 0;
+    /// the recorder has finished the segment (eg. to write it back to a file)
+    virtual void sync([[gnu::unused]] uint32_t index) {}
+};
+
+template <size_t SEGMENT_SIZE, uint32_t NUM_OF_SEGMENTS>
+class RamRecorderStorage : public RecorderStorage {
+    static_assert(SEGMENT_SIZE % 8 == 0, "records are 8 byte aligned");
+    static_assert(NUM_OF_SEGMENTS >= 2, "one segment is written while the others can be read");
+    alignas(8) uint8_t memory[NUM_OF_SEGMENTS][SEGMENT_SIZE];
+
+  public:
+    uint32_t numOfSegments() const override { return NUM_OF_SEGMENTS; }
+    size_t   segmentSize() const override { return SEGMENT_SIZE; }
+    uint8_t* segment(uint32_t index) override { return (index < NUM_OF_SEGMENTS) ? memory[index] : 0; }
+};
+
+/// in front of each recorded message, in the byte order of the node. The message follows, padded to 8 bytes
+struct RecordHeader {
+    uint32_t topicId;
+    uint32_t len; ///< of the message, END_OF_SEGMENT after the last record
+    int64_t  time;
+};
+
+/// at the begin of each segment
+struct SegmentHeader {
+    uint32_t magic;
+    uint32_t sequenceNr; ///< the order of the segments, 0: never used
+    int64_t  created;
+};
+
+/**
+ * Flight recorder: a subscriber on defaultGatewayTopic (like a gateway) which
+ * appends every message published on this node (topic id, time, content)
+ * to the segments of a RecorderStorage. When all segments are used, the
+ * oldest one is overwritten. Messages published only locally
+ * (shallSendToNetwork == false, onlyLocal topics) do not get to gateways,
+ * and so not to the recorder.
+ *
+ * For each segment there is a sparse index in RAM: the time of the first and
+ * the last record, FLIGHT_RECORDER_MARKS_PER_SEGMENT time marks (time, offset)
+ * and a bitmap of the topics in it. replay() skips segments and parts of
+ * segments with it, and republishes the records in the local topics: as fast
+ * as possible or paced like they were recorded (speed 1) or faster (speed N).
+ *
+ * Storage which holds records of a previous run (the files of a
+ * MappedRecorderStorage after a restart) are found at the first call, new
+ * records follow in the segment after the newest one, which is not reused
+ * for them. The times of another run are not
+ * comparable to NOW(), replay(0, END_OF_TIME) gives all of them in order.
+ *
+ *   static RamRecorderStorage<64 * 1024, 8> ram;
+ *   static FlightRecorder                  recorder(ram);
+ *   ...
+ *   recorder.replay(from, to, 1); // in a thread, blocks until all records are published
+ */
+class FlightRecorder : public Subscriber {
+  public:
+    static constexpr uint32_t MAGIC               = 0x46524543; // "FREC"
+    static constexpr uint32_t END_OF_SEGMENT      = 0xffffffff;
+    static constexpr uint32_t AS_FAST_AS_POSSIBLE = 0;
+    static constexpr uint32_t ALL_TOPICS          = 0;
+
+    FlightRecorder(RecorderStorage& storage, const char* name = "FlightRecorder");
+
+    uint32_t put(const uint32_t topicId, const size_t len, void* data, const NetMsgInfo& netMsgInfo) override;
+
+    /**
+     * Publishes the recorded messages with from <= time <= to (of topicId or all)
+     * in the local topics, in the order of recording. Topics which do not
+     * exist on this node are skipped. Blocks the caller until all are published.
+     * @param speed AS_FAST_AS_POSSIBLE, 1: the time between the messages like
+     *        recorded, N: N times faster
+     * @param toNetwork the messages go to the gateways too. The recorder does not
+     *        record during such a replay
+     * @return number of published messages
+     */
+    uint32_t replay(int64_t from = 0, int64_t to = END_OF_TIME, uint32_t speed = AS_FAST_AS_POSSIBLE,
+                    uint32_t topicId = ALL_TOPICS, bool toNetwork = false);
+
+    /**
+     * Records with from <= time <= to of topicId or all, like replay() without
+     * publishing. Each segment is counted in the semaphore of the recorder:
+     * recording waits meanwhile, it does not overwrite the segment.
+     */
+    uint32_t count(int64_t from = 0, int64_t to = END_OF_TIME, uint32_t topicId = ALL_TOPICS);
+
+    /// time of the oldest and of the newest record, 0 if there are none
+    int64_t firstRecordTime();
+    int64_t lastRecordTime();
+
+    /// forgets all records, in the storage too
+    void clear();
+
+    uint32_t recordedMsgs;
+    uint64_t recordedBytes;
+    uint32_t droppedMsgs; ///< too long for a segment, or the next segment is being replayed
+
+  private:
+    struct TimeMark {
+        int64_t  time;
+        uint32_t offset;
+    };
+
+    struct SegmentIndex {
+        uint32_t sequenceNr; ///< 0: no records
+        uint32_t end;        ///< offset of the end marker
+        int64_t  firstTime;
+        int64_t  lastTime;
+        uint64_t topics;     ///< bit topicId % 64
+        uint32_t numOfMarks;
+        TimeMark marks[FLIGHT_RECORDER_MARKS_PER_SEGMENT];
+    };
+
+    Putter           nopPutter; ///< only as placeholder, like in Gateway
+    RecorderStorage& storage;
+    Semaphore        protector;
+    SegmentIndex     index[FLIGHT_RECORDER_MAX_SEGMENTS];
+    uint32_t         numOfSegments;
+    uint32_t         markDistance; ///< bytes between the time marks
+    uint32_t         currentSegment;
+    uint32_t         nextSequenceNr;
+    bool             started;
+    bool             ownSegment; ///< currentSegment was opened by this run, not found by start()
+    Atomic<int32_t>  replayedSegment; ///< may not be overwritten, -1: none
+    Atomic<bool>     replayingToNetwork;
+    TopicInterface*  lastTopic; ///< of replay, most records are of few topics
+
+    void start();
+    void scan(uint32_t segmentNr);
+    bool openNextSegment();
+    void addMark(SegmentIndex& segment, int64_t time, uint32_t offset);
+    uint32_t nextSegmentInOrder(uint32_t afterSequenceNr) const;
+    uint32_t walk(int64_t from, int64_t to, uint32_t speed, uint32_t topicId, bool publish, bool toNetwork);
+    TopicInterface* findTopic(uint32_t topicId);
+};
+
+} // namespace RODOS
@@ -15,6 +15,11 @@
 #include "gateway/linkinterfaceudp.h"
 #include "gateway/linkinterfacecan.h"
 #include "gateway/linkinterfaceshm.h"
+#include "gateway/compactheader.h"
+#include "gateway/payloadcompression.h"
+#include "gateway/transmitscheduler.h"
+#include "gateway/tokenbucket.h"
+#include "gateway/fragmentation.h"
 
 
 
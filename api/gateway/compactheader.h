@@ -0,0 +1,103 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "gateway/networkmessage.h"
+
+namespace RODOS {
+
+/**
+ * @file compactheader.h
+ * @date 2026/10/01
+ *
+ * @brief compact encoding of NetworkMessage headers for low bandwidth links
+ *
+ */
+
+/**
+ * The standard header of a NetworkMessage has 40 bytes. For messages of
+ * 4 to 16 bytes on UART links this is most of the bandwidth.
+ * A Linkinterface may use a CompactHeader (Linkinterface::setCompactHeader)
+ * to send the header in 16 to 23 bytes instead, frames of 20 to 27 bytes
+ * for 4 bytes of user data (see middleware-tests/compact-header). With all
+ * OMIT_xxx it has at least 9 bytes:
+ *
+ *    byte 0   : 10ffffff  marker (10) and flags (f), see F_xxx
+ *    2 bytes  : checksum of all following bytes
+ *    1 byte   : maxStepsToForward
+ *    2 bytes  : topicId (4 bytes if F_TOPIC32)
+ *    varint   : len of user data
+ *    varint   : senderNode (zigzag)
+ *    varint   : sequenceNr
+ *    varint   : type                                 if F_TYPE
+ *    varint   : receiverNode (zigzag), receiverNodesBitMap  if F_ADDR
+ *    varint   : senderThreadId                       if F_THREAD
+ *    8 bytes  : sentTime, the new epoch of the link  if F_EPOCH
+ *    varint   : sentTime - epoch in us (zigzag)      if F_TIME
+ *    user data
+ *
+ * Varints are unsigned LEB128, 7 bits per byte, least significant first.
+ * A standard header never begins with 10xxxxxx (receiverNode is small, -1 or -2),
+ * therefore the receiver accepts both encodings. The two ends of a link can be
+ * switched to compact headers one after the other.
+ *
+ * The epoch for sentTime is kept per link: use compact headers only on
+ * point to point links, where only one node sends in each direction.
+ * Fields omitted by the sender (see OMIT_xxx) are set by the receiver to:
+ * receiverNode = -1, receiverNodesBitMap = 0 (unknown: routers flood),
+ * senderThreadId = 0, sentTime = time of arrival.
+ */
+class CompactHeader {
+public:
+    static constexpr uint8_t OMIT_ADDRESSING = 0x01; ///< do not send receiverNode and receiverNodesBitMap
+    static constexpr uint8_t OMIT_THREAD_ID  = 0x02; ///< do not send senderThreadId
+    static constexpr uint8_t OMIT_TIME       = 0x04; ///< do not send sentTime
+
+    static constexpr uint8_t MARKER      = 0x80;
+    static constexpr uint8_t MARKER_MASK = 0xC0;
+    static constexpr uint8_t F_ADDR      = 0x01;
+    static constexpr uint8_t F_THREAD    = 0x02;
+    static constexpr uint8_t F_TIME      = 0x04;
+    static constexpr uint8_t F_EPOCH     = 0x08;
+    static constexpr uint8_t F_TYPE      = 0x10;
+    static constexpr uint8_t F_TOPIC32   = 0x20;
+
+    static constexpr uint32_t EPOCH_REFRESH_MSGS = 32;      ///< resend the epoch, in case the receiver lost it
+    static constexpr int64_t  MAX_TIME_DELTA_US  = 1 << 20; ///< else a new epoch is sent (delta: max 3 bytes)
+
+    /// worst case: all fields present with the longest varints
+    static constexpr size_t MAX_HEADER_SIZE  = 1 + 2 + 1 + 4 + 3 + 5 + 5 + 3 + 5 + 5 + 5 + 8;
+    static constexpr size_t MAX_ENCODED_SIZE = MAX_HEADER_SIZE + MAX_NETWORK_MESSAGE_LENGTH;
+
+    /** Buffers for the link: encoded messages to send and received (not yet decoded). */
+    uint8_t txBuffer[MAX_ENCODED_SIZE];
+    uint8_t rxBuffer[MAX_ENCODED_SIZE];
+
+    CompactHeader(uint8_t omitFields_ = 0);
+
+    /** Encodes msg to buf.
+     * @return number of bytes written, 0 if maxLen is too small
+     */
+    size_t encode(const NetworkMessage& msg, uint8_t* buf, size_t maxLen);
+
+    /** Decodes a message in compact or in standard encoding to msg.
+     * The checksum of msg is set again (sentTime may differ from the original by less than 1 us).
+     * @return false if the message is corrupt
+     */
+    bool decode(const uint8_t* buf, size_t len, NetworkMessage& msg);
+
+    static bool isCompact(const uint8_t* buf) { return (buf[0] & MARKER_MASK) == MARKER; }
+
+private:
+    uint8_t  omitFields;
+
+    int64_t  txEpoch;
+    bool     txEpochValid;
+    uint32_t msgsSinceEpoch;
+
+    int64_t  rxEpoch;
+    bool     rxEpochValid;
+};
+
+}  // namespace
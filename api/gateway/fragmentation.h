@@ -0,0 +1,122 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "gateway/networkmessage.h"
+#include "gateway/tokenbucket.h"
+#include "rodos-semaphore.h"
+
+namespace RODOS {
+
+/**
+ * @file fragmentation.h
+ * @date 2026/10/05
+ *
+ * @brief messages longer than MAX_NETWORK_MESSAGE_LENGTH: fragments and reassembly
+ *
+ */
+
+/**
+ * Gateways and routers send topic messages longer than MAX_NETWORK_MESSAGE_LENGTH
+ * in fragments, with NET_MSG_FRAGMENT in the type field.
+ * Each fragment gets its own sequence number (publish reserves one for each,
+ * see numberOfFragments()), therefore lost duplicates and redundant links
+ * work as for short messages. The user data of each fragment begins with:
+ *
+ *    4 bytes : msgId, the sequence number of the first fragment
+ *    4 bytes : total length of the message
+ *    4 bytes : offset of this fragment in the message, a multiple of MAX_FRAGMENT_DATA
+ *
+ * Fragments are sent back to back, without waiting for acknowledges.
+ * A FragmentPacer keeps them to FRAGMENT_RATE (bursts of FRAGMENT_BURST
+ * bytes), so that the receivers (fifos, socket buffers) can follow, and
+ * waits while the link reports no room (Linkinterface::hasRoomToSend).
+ * Other links need other rates, see Gateway::setFragmentPacing().
+ *
+ * The receiving gateways (all gateways of a node share them) collect the
+ * fragments in one of REASSEMBLY_BUFFERS buffers of REASSEMBLY_BUFFER_SIZE.
+ * Longer messages, and messages which find no free buffer, are dropped.
+ * A buffer is free again REASSEMBLY_TIMEOUT after its last fragment.
+ * Routers forward single fragments, they do not reassemble.
+ */
+
+/** Writes fragment number fragmentIndex of the len bytes in data to netMsg, with the header of prepareNetworkMessage() */
+void prepareFragment(NetworkMessage& netMsg, const uint32_t topicId, const void* data, size_t len,
+                     uint32_t fragmentIndex, const NetMsgInfo& netMsgInfo);
+
+/** Bytes of the network message with fragment number fragmentIndex of a message of len bytes */
+inline size_t fragmentBytes(size_t len, uint32_t fragmentIndex) {
+    size_t offset = fragmentIndex * MAX_FRAGMENT_DATA;
+    size_t rest   = (len > offset) ? len - offset : 0;
+    return sizeof(NetworkMessage) - MAX_NETWORK_MESSAGE_LENGTH + FRAGMENT_HEADER_SIZE + ((rest < MAX_FRAGMENT_DATA) ? rest : MAX_FRAGMENT_DATA);
+}
+
+class Linkinterface;
+
+/**
+ * Credit pacing of fragments: the sender waits only as long as its credit
+ * (a TokenBucket) or the link (back pressure) require, not a fixed pause.
+ */
+class FragmentPacer {
+    Semaphore   protector;
+    TokenBucket credit;
+
+public:
+    FragmentPacer() { credit.setRate(FRAGMENT_RATE, FRAGMENT_BURST, 0); }
+
+    /** 0 bytesPerSecond: only the back pressure of the link */
+    void setRate(uint32_t bytesPerSecond, uint32_t burstBytes) {
+        PROTECT_IN_SCOPE(protector);
+        credit.setRate(bytesPerSecond, burstBytes);
+    }
+
+    /** Waits until len more bytes are allowed and link (0: any) has room, takes them from the credit */
+    void waitToSend(size_t len, Linkinterface* link = 0);
+};
+
+
+struct ReassemblyBuffer {
+    enum class State : uint8_t {
+        FREE,
+        COLLECTING,
+        COMPLETE, ///< being distributed, until Reassembler::release()
+        DONE      ///< still remembers msgId, to ignore late duplicates of its fragments
+    };
+
+    State    state;
+    int32_t  senderNode;
+    uint32_t msgId;
+    uint32_t topicId;
+    uint32_t totalLen;
+    uint32_t receivedLen;
+    int64_t  lastFragmentTime;
+    uint8_t  receivedFragments[(REASSEMBLY_BUFFER_SIZE / MAX_FRAGMENT_DATA + 8) / 8]; ///< bitmap
+    uint8_t  data[REASSEMBLY_BUFFER_SIZE];
+
+    void start(int32_t senderNode_, uint32_t msgId_, uint32_t topicId_, uint32_t totalLen_);
+    bool isFree(int64_t timeNow) const;
+};
+
+
+class Reassembler {
+    Semaphore        protector;
+    ReassemblyBuffer buffers[REASSEMBLY_BUFFERS];
+
+    ReassemblyBuffer* findBuffer(int32_t senderNode, uint32_t msgId);
+    ReassemblyBuffer* getFreeBuffer(int64_t timeNow);
+
+public:
+    uint32_t droppedFragments = 0; ///< no free buffer, too long or corrupt
+
+    Reassembler();
+
+    /** Adds a fragment (user data of a message with NET_MSG_FRAGMENT, header included).
+     * @return the buffer with the complete message after its last fragment, else 0.
+     * Call release() for it after distributing it.
+     */
+    ReassemblyBuffer* addFragment(int32_t senderNode, uint32_t topicId, const uint8_t* fragment, size_t len);
+    void release(ReassemblyBuffer* buffer);
+};
+
+}  // namespace
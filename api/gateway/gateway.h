@@ -1,12 +1,17 @@
 
 #pragma once
 
+#include "content-filter.h"
+#include "gateway/fragmentation.h"
 #include "gateway/linkinterface.h"
 #include "subscriber.h"
 #include "putter.h"
 
 namespace RODOS {
 
+class PayloadCompression;
+class TransmitScheduler;
+
 /**
  * @file gateway.h
  * @date 2009/05/01 7:07
@@ -35,20 +40,64 @@ namespace RODOS {
  *
  */
 
+constexpr uint32_t SEQUENCE_WINDOW_WORDS = 2; ///< 64 bit words in the sliding window of each sender node
+constexpr uint32_t SEQUENCE_WINDOW_SIZE  = SEQUENCE_WINDOW_WORDS * 64; ///< sequence numbers tracked per sender node
+constexpr int64_t  SENDER_RESTART_TIME   = 5 * SECONDS; ///< sentTime this much older than the newest message: the sender restarted
+
+/**
+ * Duplicate detection for one sender node (see Gateway::messageSeen).
+ * Bit i of the window is set if the message with sequence number
+ * highestSequenceNr - i was already received. Messages may arrive out of
+ * order as long as they are not older than SEQUENCE_WINDOW_SIZE messages,
+ * older ones count as duplicates. Only a sentTime which goes back by more
+ * than SENDER_RESTART_TIME is a restart of the sender (its time and its
+ * sequence numbers begin again).
+ */
 struct SeenNode {
     int32_t  nodeID;
-    uint32_t sequenceCounter;
-    int64_t  lastMsgTime;
+    bool     inUse;
+    uint32_t highestSequenceNr;             ///< newest sequence number received from this node
+    uint64_t window[SEQUENCE_WINDOW_WORDS]; ///< bit i: highestSequenceNr - i already received
+    int64_t  lastMsgTime;                   ///< sentTime of highestSequenceNr, to recognise restarts of the sender
+    int64_t  lastAccessTime;                ///< local time, used to select the entry to replace
+
+    /// Forget the history of this node and continue from the given message
+    void restart(int32_t nodeId, uint32_t sequenceNr, int64_t sentTime);
+
+    /// true if already received, else it is registered as received
+    bool isDuplicate(uint32_t sequenceNr, int64_t sentTime);
+};
+
+/// Each bucket has its own semaphore, gateways contend only if sender nodes hash to the same bucket
+struct SeenNodesBucket {
+    Semaphore protector;
+    SeenNode  nodes[SEEN_NODES_PER_BUCKET];
+};
+
+/// The content filter of another node for one topic, see Gateway::setContentFilterExport
+struct RemoteContentFilter {
+    uint32_t      topicId;
+    int32_t       nodeNr;
+    int64_t       lastReport; ///< local time, 0: free entry
+    ContentFilter filter;     ///< empty: the node wants all messages of the topic
+};
+
+/// A topic with a filter which did not fit in Gateway::remoteFilters: all its messages are sent
+struct UnknownContentFilter {
+    uint32_t topicId;
+    int64_t  until; ///< local time, the entry is free after it
 };
 
 
 class Gateway : public Subscriber, public StaticThread<> {
+    friend class TransmitScheduler;
 
 private:
     Putter nopPutter; ///< inherited from parent but never used, only as placeholder
     Semaphore networkOutProtector;
     NetworkMessage networkOutMessage; // protected with semaphore
-    NetworkMessage networkInMessage;
+    NetworkMessage networkInMessage;   ///< for links without Linkinterface::getNetworkBuffer()
+    NodeSet        networkInReceivers; ///< of the message in AnalyseAndDistributeMessagesFromNetwork, if it has them
 
     /**
      * List of topics, which shall be forwarded to the external network.
@@ -67,6 +116,23 @@ private:
 
     bool getTopicsToForwardFromOutside;
 
+    PayloadCompression* payloadCompression; ///< 0 -> user data is sent as it is
+
+    FragmentPacer fragmentPacer; ///< see setFragmentPacing()
+
+    TransmitScheduler* transmitScheduler; ///< 0 -> messages are sent by the publishing thread
+    TopicListReport    topicPriorities[NUM_OF_TRANSMIT_PRIORITIES]; ///< see setTopicPriority()
+    bool               extendedAddressing; ///< see setExtendedAddressing()
+
+    bool                contentFilterExport;      ///< see setContentFilterExport()
+    uint32_t            exportedFiltersGeneration; ///< Subscriber::contentFiltersGeneration of the last reports
+    int64_t             lastContentFilterReport;
+    Semaphore           remoteFiltersProtector;
+    uint32_t            remoteFiltersInUse;        ///< entries used at least once, 0: nothing to evaluate
+    RemoteContentFilter remoteFilters[CONTENT_FILTER_ENTRIES];
+    UnknownContentFilter unknownFilters[CONTENT_FILTER_ENTRIES]; ///< live filters are never evicted, see markFilterUnknown()
+    int64_t             allFiltersUnknownUntil;    ///< unknownFilters was full too: all topics are sent
+
 
     /** Transfer messages from the local network to the external network.
      * @param[in] topicId ID of sending topic
@@ -76,14 +142,41 @@ private:
      */
     virtual uint32_t put(const uint32_t topicId, const size_t len, void* data, const NetMsgInfo& netMsgInfo);
 
-    void AnalyseAndDistributeMessagesFromNetwork();
+    /** Messages longer than MAX_NETWORK_MESSAGE_LENGTH, see fragmentation.h */
+    void sendFragmented(const uint32_t topicId, const size_t len, const void* data, const NetMsgInfo& netMsgInfo,
+                        TransmitPriority priority);
+
+    /**
+     * Compresses and sends through the link. Does not wait for the rate limiter:
+     * the callers wait before (waitForLink), not while they hold networkOutProtector.
+     */
+    void transmit(NetworkMessage& msg);
+
+    /** 0 if the rate limiter of the link lets the next message go, else the time to wait */
+    int64_t timeUntilLinkReady();
+    /** Until timeUntilLinkReady() is 0. Never call it holding networkOutProtector: other publishers would wait too */
+    void waitForLink();
+    /** To the TransmitScheduler, if there is one, else transmit() */
+    void enqueueOrTransmit(NetworkMessage& msg);
+
+    /** inMsg: networkInMessage or a buffer of the link, see Linkinterface::getNetworkBuffer() */
+    void AnalyseAndDistributeMessagesFromNetwork(NetworkMessage& inMsg);
 
-    static SeenNode seenNodes[MAX_NUMBER_OF_NODES];
-    static int32_t numberOfNodes;
-    static Semaphore seenNodesProtector;
+    /** The filters of the local subscribers, after changes and every CONTENT_FILTER_REPORT_PERIOD */
+    void sendContentFilterReports();
+    void receiveContentFilterReport(int32_t nodeNr, const uint8_t* userData, size_t len);
+    void markFilterUnknown(uint32_t topicId, int64_t timeNow);
+    /** false if the filters of other nodes are known for the topic and none matches */
+    bool wantedByRemoteFilters(const uint32_t topicId, const size_t len, const void* data);
+
+    /** Shared by all gateways: the same message may arrive through more than one link */
+    static SeenNodesBucket seenNodes[SEEN_NODES_BUCKETS];
 
     static bool messageSeen(NetworkMessage& msg);
 
+    /** Shared by all gateways: the fragments of a message may arrive through different links */
+    static Reassembler reassembler;
+
 public:
 
     /* From sublcases */
@@ -138,6 +231,60 @@ public:
 
     uint32_t getLinkIdentifier() {return linkinterface->getLinkdentifier();}
 
+    /**
+     * Compress the user data of outgoing messages (all topics or only the
+     * ones set in compression) and decompress incoming ones.
+     * Both ends of the link need a PayloadCompression. One object per gateway.
+     * 0 -> no compression (default).
+     */
+    void setPayloadCompression(PayloadCompression* compression) { payloadCompression = compression; }
+
+    /**
+     * Queue outgoing messages by priority, see transmitscheduler.h.
+     * One scheduler per gateway. 0 -> the publishing thread sends (default).
+     */
+    void setTransmitScheduler(TransmitScheduler* scheduler);
+
+    /** Gateway policy: the priority of a topic on this link, overrides TopicInterface::setTransmitPriority() */
+    void setTopicPriority(uint32_t topicId, TransmitPriority priority);
+
+    /** The priority from setTopicPriority(), else topicPriority */
+    TransmitPriority getTopicPriority(uint32_t topicId, TransmitPriority topicPriority);
+
+    /**
+     * Send the receivers of topics with more than 32 possible receiver nodes (NodeSet)
+     * at the end of the user data, see nodeset.h. Default off: older nodes
+     * would pass the extension to variable length topics as user data.
+     * Received extensions are always understood: messages for other nodes are
+     * not distributed locally, only forwarded to routers.
+     */
+    void setExtendedAddressing(bool onOff = true) { extendedAddressing = onOff; }
+
+    /**
+     * Exchange content filters (Subscriber::setContentFilter) with the other nodes of the link.
+     * This gateway sends, for each topic with local subscribers, the OR of their filters
+     * (no filter: all messages) and evaluates the filters of the other nodes before it
+     * sends a message: if none matches, the message does not use the link.
+     * Topics without reports are sent as before. All nodes of the link which subscribe
+     * have to export their filters, else they may miss messages the others do not want.
+     * Filters of other nodes are read with the message layout of this node.
+     * Messages forwarded by routers are not filtered.
+     * If CONTENT_FILTER_ENTRIES are in use, a report of a further (topic, node) is not
+     * stored and all messages of its topic are sent, until the report times out.
+     */
+    void setContentFilterExport(bool onOff = true);
+
+    uint32_t contentFilteredMsgs;   ///< not sent, no filter of another node matched
+    uint32_t contentFilterOverflows; ///< reports which did not fit, their topics are sent unfiltered
+
+    /**
+     * Fragments of long messages are sent at bytesPerSecond (header and user data),
+     * up to burstBytes back to back (default FRAGMENT_RATE, FRAGMENT_BURST).
+     * The receivers of the link have to take a burst without losses.
+     * 0 bytesPerSecond: as fast as the link has room (Linkinterface::hasRoomToSend).
+     */
+    void setFragmentPacing(uint32_t bytesPerSecond, uint32_t burstBytes) { fragmentPacer.setRate(bytesPerSecond, burstBytes); }
+
 };
 
 void prepareNetworkMessage(NetworkMessage& netMsg, const uint32_t topicId,const void* data, size_t len, const NetMsgInfo& netMsgInfo);
@@ -2,10 +2,14 @@
 #pragma once
 
 #include "gateway/networkmessage.h"
+#include "gateway/tokenbucket.h"
 #include "thread.h"
 
 namespace RODOS {
 
+class CompactHeader;
+class NetBufferRef;
+
 /**
  * @file linkinterface.h
  * @date 2009/05/01 7:07
@@ -32,9 +36,11 @@ protected:
     /// Gateway which has to be connected to the network / interface.
     const uint32_t linkIdentifier;
     Thread* threadToResume;
+    CompactHeader* compactHeader; ///< 0 -> standard 40 byte headers, see setCompactHeader()
 
 public:
     bool isBroadcastLink;
+    TokenBucket rateLimiter; ///< unlimited by default, see setRateLimit()
 
     /**
      * @brief	Constructor
@@ -46,6 +52,7 @@ public:
     Linkinterface(int64_t linkId) : linkIdentifier((linkId<0) ? linkidentifierCounter++ : static_cast<uint32_t>(linkId & 0xFFFFFFFF)) {
         isBroadcastLink = false;
         threadToResume=0;
+        compactHeader=0;
     }
     virtual ~Linkinterface() { }
 
@@ -64,6 +71,14 @@ public:
      */
     virtual bool getNetworkMsg([[gnu::unused]] NetworkMessage &inMsg, [[gnu::unused]] int32_t &numberOfReceivedBytes)   { return false; }
 
+    /**
+     * Zero copy variant of getNetworkMsg for links which receive into a NetBufferPool:
+     * the gateway processes the message in the buffer and releases it afterwards.
+     *@param buffer gets the received message, buffer.used() bytes of it
+     *@return false if nothing was received or the link has no buffers: then the gateway calls getNetworkMsg
+     */
+    virtual bool getNetworkBuffer([[gnu::unused]] NetBufferRef &buffer)                                                { return false; }
+
     /**
      * Returns if all buffered Messages have been transmittet on the wire.
      * If this returns true the next call to sendNetworkMsg should immetiatly start sending out the new messages.
@@ -71,6 +86,12 @@ public:
      */
     virtual bool isNetworkMsgSent()                     { return true; }
 
+    /**
+     * Back pressure for bursts (the fragments of long messages, see FragmentPacer):
+     * false while the link or its receivers have no room for another message.
+     */
+    virtual bool hasRoomToSend()                        { return true; }
+
     /**
      *  Sends NetworkMessage over the Link. May block. When it returns the Message should be send out or have been buffered.
      * @param The Message to send
@@ -78,6 +99,21 @@ public:
     virtual bool sendNetworkMsg([[gnu::unused]] NetworkMessage& outgoingMessage) { return true;  }
     inline uint32_t getLinkdentifier() const                { return this->linkIdentifier; }
 
+    /**
+     * For low bandwidth point to point links: send headers in compact encoding (see compactheader.h).
+     * The link translates in sendNetworkMsg and getNetworkMsg, gateways and routers always see
+     * standard NetworkMessages. Receivers accept both encodings.
+     * Implemented by LinkinterfaceUART. Call it before the gateway starts.
+     */
+    void setCompactHeader(CompactHeader* codec)              { compactHeader = codec; }
+
+    /**
+     * Mean data rate of the link (header and user data), with bursts of up to burstBytes.
+     * The gateway waits before sending if the rate is exhausted. 0 -> unlimited (default).
+     * With a TransmitScheduler the waiting messages are queued by priority.
+     */
+    void setRateLimit(uint32_t bytesPerSecond, uint32_t burstBytes) { rateLimiter.setRate(bytesPerSecond, burstBytes); }
+
     /**
      * This Thread is resumed when there is new Data availible and getNetworkMsg should be called
      *  or when buffered Messages have been transmittet on the wire.
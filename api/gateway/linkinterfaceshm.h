@@ -14,6 +14,7 @@ namespace RODOS {
 
 constexpr size_t   FIFOSIZE   = 10;
 constexpr uint32_t MAXMEMBERS = 50; //defines the maximum amount of participants in the fifo and shared memory
+constexpr int64_t  SHM_READER_TIMEOUT = 50 * MILLISECONDS; //a reader with unread messages which did not read for this time gives no back pressure
 
 
 class LinkinterfaceSHM: public Linkinterface, IOEventReceiver {
@@ -22,6 +23,8 @@ protected:
 	MultipleReaderFifo<NetworkMessage, FIFOSIZE, MAXMEMBERS> * fifo;
 	int32_t readerId;
 	Sharedmemory_IDX shmIdx;
+	size_t  lastReadX[MAXMEMBERS];  ///< hasRoomToSend(): where each reader was seen last
+	int64_t lastReadAt[MAXMEMBERS]; ///< and when it was empty or read last, 0: never (unused slot)
 
 public:
 
@@ -50,6 +53,13 @@ public:
 	 */
 	bool sendNetworkMsg(NetworkMessage& outgoingMessage);
 
+	/**
+	 * false while a reader has the fifo almost full: the next message would overwrite unread ones.
+	 * Only readers which kept up or read within SHM_READER_TIMEOUT count, unused
+	 * slots and dead processes would stop the sender forever.
+	 */
+	bool hasRoomToSend();
+
 	void onWriteFinished();
 
 	virtual void suspendUntilDataReady(int64_t reactivationTime = END_OF_TIME);
@@ -9,6 +9,7 @@
 
 #include "fifo.h"
 #include "gateway/linkinterface.h"
+#include "gateway/netbufferpool.h"
 #include "hal/udp.h"
 #include "subscriber.h"
 #include "topic.h"
@@ -26,10 +27,13 @@ protected:
 private:
 
     Topic<GenericMsgRef> udpAsyncTopic;
-    Fifo<NetworkMessage, UDP_INCOMMIG_BUF_LEN> incoming;
+    Fifo<NetBuffer*, UDP_INCOMMIG_BUF_LEN> incoming; ///< each holds one reference, see NetBufferRef::detach()
     //CommBuffer<NetworkMessage> incoming;
     bool newMessage;
 
+public:
+    uint32_t droppedMsgs; ///< no free buffer in netBufferPool or the fifo was full
+
 protected: //This is for LinkinterfaceUDP
 public:
 
@@ -49,6 +53,8 @@ public:
      */
     bool sendNetworkMsg(NetworkMessage &outMsg);
     bool getNetworkMsg(NetworkMessage &inMsg,int32_t &numberOfReceivedBytes);
+    /** The pool buffer of putFromInterrupt(), without copying */
+    bool getNetworkBuffer(NetBufferRef &buffer);
 
     virtual void putFromInterrupt(const uint32_t topicId, const void* any, size_t len = 0);
     virtual void suspendUntilDataReady(int64_t reactivationTime = END_OF_TIME);
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rodos-atomic.h"
+#include "netmsginfo.h"
+
+namespace RODOS {
+
+/**
+ * @file netbufferpool.h
+ * @date 2026/10/11
+ *
+ * @brief pool of reference counted buffers for network messages, in size classes
+ *
+ */
+
+class NetBufferPool;
+
+/**
+ * A pooled buffer: this header, followed by capacity bytes for a NetworkMessage
+ * (header + user data). Only the first capacity bytes of msg() may be used:
+ * enough for messages with numberOfBytesToSend() <= capacity.
+ */
+struct NetBuffer {
+    Atomic<uint32_t> refCount;
+    NetBufferPool*   pool;
+    uint16_t         capacity;
+    uint16_t         used;       ///< bytes written by NetBufferPool::copyOf()
+    uint16_t         next;       ///< free list
+    uint8_t          sizeClass;
+
+    NetworkMessage& msg() { return *reinterpret_cast<NetworkMessage*>(this + 1); } // NetworkMessage is packed
+};
+
+/// bytes of a NetBuffer in the pool, with its message
+constexpr size_t netBufferStride(size_t capacity) {
+    return (sizeof(NetBuffer) + capacity + alignof(NetBuffer) - 1) & ~(alignof(NetBuffer) - 1);
+}
+
+/**
+ * Handle of a NetBuffer which counts the references: copies share the buffer,
+ * the last one gives it back to its pool.
+ * To keep a buffer in a Fifo<NetBuffer*, n> (no reference counting) use
+ * detach() to put it and NetBufferRef(NetBuffer*) to take it out.
+ */
+class NetBufferRef {
+    NetBuffer* buffer;
+
+  public:
+    NetBufferRef() : buffer(0) {}
+    /// takes over one reference, eg. from a fifo (see detach())
+    explicit NetBufferRef(NetBuffer* adopted) : buffer(adopted) {}
+    NetBufferRef(const NetBufferRef& other);
+    NetBufferRef& operator=(const NetBufferRef& other);
+    ~NetBufferRef() { release(); }
+
+    void release();
+    /// gives up the handle without releasing the reference
+    NetBuffer* detach();
+    NetBuffer* get() const { return buffer; }
+
+    bool            isValid() const { return buffer != 0; }
+    size_t          capacity() const { return buffer ? buffer->capacity : 0; }
+    size_t          used() const { return buffer ? buffer->used : 0; }
+    NetworkMessage& msg() const { return buffer->msg(); }
+    NetworkMessage* operator->() const { return &buffer->msg(); }
+};
+
+/**
+ * Queued network messages take only the memory they need instead of a whole
+ * NetworkMessage (about 1340 bytes, even for a 4 byte topic): the fifos
+ * hold pointers to buffers from this pool (UDP input, TransmitScheduler).
+ *
+ * Three size classes, each a static array of buffers with a lock free free list
+ * (tagged index, against ABA): alloc and free are O(1), from threads and interrupts.
+ * If a class is empty, alloc() takes a buffer from a larger class.
+ * Sizes and numbers: NET_BUFFER_*_SIZE and NET_BUFFERS_* in platform-parameter.h
+ */
+class NetBufferPool {
+  public:
+    static constexpr uint32_t NUM_OF_SIZE_CLASSES = 3;
+    static constexpr uint16_t NO_BUFFER           = 0xffff;
+
+    static constexpr size_t SMALL_STRIDE  = netBufferStride(NET_BUFFER_SMALL_SIZE);
+    static constexpr size_t MEDIUM_STRIDE = netBufferStride(NET_BUFFER_MEDIUM_SIZE);
+    static constexpr size_t LARGE_STRIDE  = netBufferStride(sizeof(NetworkMessage));
+
+    static_assert(NET_BUFFER_SMALL_SIZE < NET_BUFFER_MEDIUM_SIZE && NET_BUFFER_MEDIUM_SIZE < sizeof(NetworkMessage),
+                  "size classes have to grow up to one NetworkMessage");
+    static_assert(NET_BUFFERS_SMALL > 0 && NET_BUFFERS_MEDIUM > 0 && NET_BUFFERS_LARGE > 0, "at least one buffer per class");
+    static_assert(NET_BUFFERS_SMALL < NO_BUFFER && NET_BUFFERS_MEDIUM < NO_BUFFER && NET_BUFFERS_LARGE < NO_BUFFER,
+                  "buffer indexes are 16 bits");
+
+    Atomic<uint32_t> allocFailures; ///< all classes large enough were empty (also from interrupts)
+
+    NetBufferPool();
+
+    /** A buffer for a message of bytes (header + user data), invalid if none is free */
+    NetBufferRef alloc(size_t bytes);
+    /** alloc() and copy len bytes received from a link */
+    NetBufferRef copyOf(const void* data, size_t len);
+    /** alloc() and copy msg.numberOfBytesToSend() bytes */
+    NetBufferRef copyOf(const NetworkMessage& msg);
+
+    /// from NetBufferRef, when the last reference is released
+    void free(NetBuffer* buffer);
+
+    uint32_t numOfFree(uint32_t sizeClass) const { return numOfFreeBuffers[sizeClass]; }
+    size_t   capacityOf(uint32_t sizeClass) const;
+    /// bytes of all buffers of the pool
+    static constexpr size_t memoryFootprint() {
+        return NET_BUFFERS_SMALL * SMALL_STRIDE + NET_BUFFERS_MEDIUM * MEDIUM_STRIDE + NET_BUFFERS_LARGE * LARGE_STRIDE;
+    }
+
+  private:
+    alignas(NetBuffer) uint8_t smallBuffers[NET_BUFFERS_SMALL * SMALL_STRIDE];
+    alignas(NetBuffer) uint8_t mediumBuffers[NET_BUFFERS_MEDIUM * MEDIUM_STRIDE];
+    alignas(NetBuffer) uint8_t largeBuffers[NET_BUFFERS_LARGE * LARGE_STRIDE];
+
+    Atomic<uint32_t> freeList[NUM_OF_SIZE_CLASSES]; ///< tag (upper 16 bits) : index of the first free buffer
+    Atomic<uint32_t> numOfFreeBuffers[NUM_OF_SIZE_CLASSES];
+
+    NetBuffer* buffer(uint32_t sizeClass, uint16_t index);
+    NetBuffer* allocBuffer(size_t bytes);
+    NetBuffer* pop(uint32_t sizeClass);
+};
+
+/// used by the links and TransmitSchedulers
+extern NetBufferPool netBufferPool;
+
+}  // namespace
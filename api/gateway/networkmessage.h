@@ -52,6 +52,18 @@ public:
         numberOfTopics++;
     }
 
+    /** Removes a topic from the list, if present (the last one takes its place).
+     * @param[in] topicId ID to remove from the list
+     */
+    void remove(const uint32_t topicId) {
+        for (uint32_t i = 0; i < numberOfTopics; i++) {
+            if (topicId == topicList[i]) {
+                topicList[i] = topicList[--numberOfTopics];
+                return;
+            }
+        }
+    }
+
     /// returns the size needed for transmission
     size_t numberOfBytesToSend() { return (sizeof(long) + numberOfTopics * sizeof(topicList[0])); }
 } __attribute__((packed));
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "gateway/networkmessage.h"
+
+namespace RODOS {
+
+/**
+ * @file payloadcompression.h
+ * @date 2026/10/03
+ *
+ * @brief optional compression of the user data of NetworkMessages
+ *
+ */
+
+/**
+ * Small LZ77 codec for the user data of NetworkMessages, without dynamic
+ * memory: one object needs about 5 KB (hash table, buffers and topic list).
+ * Set it to a gateway with Gateway::setPayloadCompression(). The gateway
+ * compresses all topics (or only the topics added with compressTopic()),
+ * if the compressed data is smaller than the original, and sets
+ * NET_MSG_COMPRESSED in the type field of the message.
+ * Receiving gateways need a PayloadCompression too, else they distribute no
+ * compressed messages locally. Routers forward compressed messages as they are.
+ *
+ * Encoding, a sequence of:
+ *
+ *    0nnnnnnn                    : n+1 literal bytes follow
+ *    1lllllxx xxxxxxxx           : copy l+MIN_MATCH bytes from x+1 bytes back
+ *
+ * Copies may overlap the bytes they produce (runs).
+ */
+class PayloadCompression {
+public:
+    static constexpr uint32_t HASH_BITS       = 10;
+    static constexpr uint32_t HASH_SIZE       = 1u << HASH_BITS;
+    static constexpr size_t   MIN_MATCH       = 3;
+    static constexpr size_t   MAX_MATCH       = MIN_MATCH + 31;
+    static constexpr size_t   MAX_OFFSET      = 1024;
+    static constexpr size_t   MAX_LITERAL_RUN = 128;
+
+    PayloadCompression() { }
+
+    /** Only these topics will be compressed. Without calling it: all topics (except topic reports). */
+    void compressTopic(uint32_t topicId) { topicsToCompress.add(topicId); }
+    bool shallCompress(uint32_t topicId) const {
+        return topicId != 0 && (topicsToCompress.numberOfTopics == 0 || topicsToCompress.find(topicId));
+    }
+
+    /** Compresses len bytes from src to dst.
+     * @return compressed length, 0 if it would not be smaller than len or not fit in maxLen
+     */
+    size_t compress(const uint8_t* src, size_t len, uint8_t* dst, size_t maxLen);
+
+    /** @return decompressed length, 0 if src is corrupt or does not fit in maxLen */
+    static size_t decompress(const uint8_t* src, size_t len, uint8_t* dst, size_t maxLen);
+
+    /** Compresses the user data of msg to compressedMsg (header copied, flag and checksum set).
+     * @return &compressedMsg, or &msg if compression does not pay off
+     */
+    NetworkMessage* compressMsg(NetworkMessage& msg);
+
+    /** Decompresses the user data of a message with NET_MSG_COMPRESSED to decompressedData.
+     * @param[out] len decompressed length
+     * @return decompressedData, 0 if corrupt
+     */
+    uint8_t* decompressMsg(const NetworkMessage& msg, size_t& len);
+
+private:
+    TopicListReport topicsToCompress;
+    uint16_t        hashTable[HASH_SIZE]; ///< last position + 1 of each hashed 3 byte sequence, 0 -> none
+    NetworkMessage  compressedMsg;        ///< used by the sending gateway thread
+    uint8_t         decompressedData[MAX_NETWORK_MESSAGE_LENGTH]; ///< used by the receiving gateway thread
+};
+
+}  // namespace
@@ -17,6 +17,48 @@
 namespace RODOS {
 
 constexpr uint8_t MAX_NUMBER_OF_GATEWAYS_PER_ROUTER = 8;
+constexpr int64_t ROUTE_MAX_AGE = 10*SECONDS; ///< a route not confirmed by a message for this time is forgotten
+
+/**
+ * Learned next hop to reach a node: the link from which its messages arrive.
+ * Nodes are identified by their index in NodeSet (in receiverNodesBitMap: index % 32),
+ * see receiverNode+receiverNodesBitMap.txt
+ */
+struct Route {
+    uint32_t linkId;
+    int16_t  stepsLeft;   ///< maxStepsToForward of the last message: the higher the nearer
+    int32_t  nodeNr;      ///< of the last message
+    int64_t  lastHeard;   ///< END_OF_TIME -> no route
+    int64_t  sharedUntil; ///< two live nodes with this index: flooded until then
+};
+
+class RoutingTable {
+    Route routes[MAX_ADDRESSABLE_NODES];
+    Semaphore protector;
+public:
+    /**
+     * Live nodes found with the same index (nodeNr % MAX_ADDRESSABLE_NODES, see NodeSet::nodeIndex).
+     * Their routes are not used for ROUTE_MAX_AGE: the messages for them are flooded.
+     */
+    uint32_t indexCollisions = 0;
+
+    RoutingTable() { reset(); }
+    void reset();
+
+    /// A message from senderNode arrived through linkId. Reports (RODOS_ERROR) another node with the same index
+    void learn(int32_t senderNode, uint32_t linkId, int16_t stepsLeft);
+
+    /// nodes with a route not older than ROUTE_MAX_AGE
+    void knownNodes(NodeSet& nodes);
+
+    /**
+     * The links leading to the nodes, each once, O(number of nodes).
+     * @return false if the route to one of them is not known (or its index shared) or more than maxLinks links
+     */
+    bool linksTo(const NodeSet& nodes, uint32_t* linkIds, uint32_t& numOfLinks, uint32_t maxLinks);
+
+    static uint32_t nodeIndex(int32_t nodeNr) { return NodeSet::nodeIndex(nodeNr); }
+};
 
 class Router : public Subscriber,Putter  {
     Subscriber localTopics;
@@ -26,6 +68,17 @@ protected:
     Gateway* gateways[MAX_NUMBER_OF_GATEWAYS_PER_ROUTER];
     uint8_t numberOfGateways;
     bool forwardTopicReports;
+    bool learnRoutes;
+    bool extendedAddressing;
+    RoutingTable routingTable;
+    FragmentPacer fragmentPacer; ///< local messages longer than MAX_NETWORK_MESSAGE_LENGTH
+
+    /**
+     * Nodes which shall get this message: its NodeSet (extended addressing) or the known nodes
+     * which may be meant by receiverNodesBitMap. Without the local node and the sender.
+     * @return false -> flood: broadcast topic, no information about receivers or some unknown
+     */
+    bool nodesToReach(NetworkMessage &msg, NodeSet& wantedNodes);
 
 public:
     Router(bool forwardTopicReports_ = false, Gateway* gateway1=0, Gateway* gateway2=0, Gateway* gateway3=0, Gateway* gateway4=0); 
@@ -61,6 +114,17 @@ public:
     virtual bool shouldRouteThisMsgToGateway(NetworkMessage &msg, uint32_t linkid,Gateway* gateway);
 
     virtual void addGateway(Gateway* gateway);
+
+    /**
+     * Learned routes: messages are sent only to gateways leading to nodes which have
+     * subscribers for the topic. Off by default: all messages are sent to all gateways.
+     */
+    void setRouteLearning(bool onOff = true) { learnRoutes = onOff; }
+
+    /** Local messages get the receivers as NodeSet, like Gateway::setExtendedAddressing() */
+    void setExtendedAddressing(bool onOff = true) { extendedAddressing = onOff; }
+
+    RoutingTable* getRoutingTable() { return &routingTable; }
 };
 
 
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "timemodel.h"
+
+namespace RODOS {
+
+/**
+ * @file tokenbucket.h
+ * @date 2026/10/07
+ *
+ * @brief token bucket rate limiter for links
+ *
+ */
+
+/**
+ * Limits the mean data rate of a link to bytesPerSecond, with bursts
+ * of up to burstBytes at full speed. Each Linkinterface has one
+ * (Linkinterface::setRateLimit), the gateway waits for it before it sends.
+ *
+ * A message may be sent as soon as the credit is not negative, also if the
+ * message is longer than the credit: the credit becomes negative and the
+ * next message waits longer. Therefore burstBytes may be smaller than a message.
+ * The credit is kept in byte * SECONDS units, so no rounding errors accumulate.
+ */
+class TokenBucket {
+    int64_t bytesPerSecond = 0; ///< 0 -> unlimited
+    int64_t depth          = 0; ///< burstBytes * SECONDS
+    int64_t credit         = 0; ///< bytes * SECONDS, negative after a message longer than the credit
+    int64_t lastRefill     = 0;
+
+    void refill(int64_t timeNow) {
+        if(timeNow < lastRefill) lastRefill = timeNow; // eg. set before the clock started, or time set back
+        int64_t elapsed   = timeNow - lastRefill;
+        int64_t maxNeeded = (depth - credit) / bytesPerSecond + 1; // avoids overflow after long pauses
+        if(elapsed > maxNeeded) elapsed = maxNeeded;
+        credit += elapsed * bytesPerSecond;
+        if(credit > depth) credit = depth;
+        lastRefill = timeNow;
+    }
+
+public:
+    /** bytesPerSecond 0 -> unlimited (default). Starts with a full bucket. */
+    void setRate(uint32_t bytesPerSecond_, uint32_t burstBytes, int64_t timeNow = NOW()) {
+        bytesPerSecond = bytesPerSecond_;
+        depth          = static_cast<int64_t>(burstBytes) * SECONDS;
+        credit         = depth;
+        lastRefill     = timeNow;
+    }
+
+    bool isLimited() const { return bytesPerSecond != 0; }
+
+    /** @return 0 if a message may be sent now, else the time to wait */
+    int64_t timeUntilReady(int64_t timeNow = NOW()) {
+        if(!isLimited()) return 0;
+        refill(timeNow);
+        if(credit >= 0) return 0;
+        return (-credit + bytesPerSecond - 1) / bytesPerSecond;
+    }
+
+    /** To call after sending len bytes */
+    void consume(size_t len, int64_t timeNow = NOW()) {
+        if(!isLimited()) return;
+        refill(timeNow);
+        credit -= static_cast<int64_t>(len) * SECONDS;
+    }
+};
+
+}  // namespace
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "fifo.h"
+#include "gateway/netbufferpool.h"
+#include "gateway/networkmessage.h"
+#include "rodos-semaphore.h"
+#include "thread.h"
+
+namespace RODOS {
+
+class Gateway;
+
+/**
+ * @file transmitscheduler.h
+ * @date 2026/10/07
+ *
+ * @brief priority queues for the outgoing messages of a gateway
+ *
+ */
+
+/**
+ * Without a TransmitScheduler the gateway sends each message in the thread
+ * which publishes it: on a saturated (or rate limited) link a command waits
+ * behind all messages published before it.
+ * With a TransmitScheduler (Gateway::setTransmitScheduler) the gateway queues
+ * the messages in one fifo per TransmitPriority, and the thread of the scheduler
+ * sends them. Before choosing the next message it waits for the rate limiter
+ * of the link (Linkinterface::setRateLimit), therefore a high priority message
+ * waits at most for the one message being sent.
+ *
+ *   STRICT_PRIORITY : always the highest non empty class first
+ *   WEIGHTED_FAIR   : deficit round robin, each class gets a share of the
+ *                     bytes proportional to its weight (setWeights), none starves
+ *
+ * The priority of a message is the one of its topic (TopicInterface::setTransmitPriority)
+ * or, if set, the one of Gateway::setTopicPriority(). If a fifo is full, the publisher
+ * waits until the scheduler takes a message out of it.
+ * The queued messages are copied into buffers of netBufferPool, as large as needed.
+ * If the pool has no free buffer, the publisher retries every POOL_RETRY_PERIOD.
+ * One object per gateway, it needs about 3 * 1.3 KB and its share of the pool.
+ */
+class TransmitScheduler : public StaticThread<> {
+    friend class Gateway;
+
+public:
+    enum class Mode : uint8_t {
+        STRICT_PRIORITY,
+        WEIGHTED_FAIR
+    };
+
+    /// bytes added to the deficit of a class per round and weight: at least one message
+    static constexpr int32_t QUANTUM = static_cast<int32_t>(sizeof(NetworkMessage));
+    static constexpr int64_t POOL_RETRY_PERIOD = 1 * MILLISECONDS;
+
+    uint32_t sentMsgs[NUM_OF_TRANSMIT_PRIORITIES];   ///< per class
+    uint32_t queueFulls[NUM_OF_TRANSMIT_PRIORITIES]; ///< publishers which had to wait, per class
+    uint32_t poolEmpty;                              ///< publishers which had to wait for a buffer
+
+    TransmitScheduler(Mode mode_ = Mode::STRICT_PRIORITY, int32_t priority = NETWORKREADER_PRIORITY);
+
+    /** For WEIGHTED_FAIR, default 4 : 2 : 1. Call it before the gateway starts. */
+    void setWeights(uint32_t high, uint32_t normal, uint32_t bulk);
+
+    /** Exclusive access to the message to prepare for a class; commit() queues it */
+    NetworkMessage& reserve(TransmitPriority priority);
+    /** Queues the message from reserve(), waits while the fifo is full */
+    void commit(TransmitPriority priority);
+    /** reserve(), copy msg, commit() */
+    void enqueue(const NetworkMessage& msg, TransmitPriority priority);
+
+    void run() override;
+
+private:
+    struct Queue {
+        Semaphore      writer;    ///< one publisher at a time prepares and puts
+        NetworkMessage preparing;
+        Fifo<NetBuffer*, TRANSMIT_QUEUE_LENGTH> fifo; ///< each holds one reference
+        Thread* volatile suspendedWriter;
+        int32_t        weight;
+        int32_t        deficit;   ///< bytes, negative after a message longer than the rest of the quantum
+    };
+
+    Mode           mode;
+    Queue          queues[NUM_OF_TRANSMIT_PRIORITIES];
+    uint32_t       current;       ///< WEIGHTED_FAIR: class being served
+    bool volatile  waitingForMessages;
+    Gateway*       gateway;       ///< set by Gateway::setTransmitScheduler()
+
+    /** Next message by mode, false if all fifos are empty. @param[out] priority its class */
+    bool dequeue(NetBufferRef& msg, uint32_t& priority);
+};
+
+}  // namespace
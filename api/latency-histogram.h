@@ -0,0 +1,143 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "default-platform-parameter.h"
+#include "listelement.h"
+#include "netmsginfo.h"
+#include "rodos-atomic.h"
+#include "thread.h"
+#include "topic.h"
+
+namespace RODOS {
+
+/**
+ * @file latency-histogram.h
+ * @date 2026/10/18
+ *
+ * @brief end-to-end latency of topics: from publish (NetMsgInfo::sentTime) to the delivery
+ *
+ * A LatencyHistogram attached to a topic (TopicInterface::setLatencyHistogram)
+ * counts the latency of each delivery to each of its subscribers, one attached
+ * to a subscriber (Subscriber::setLatencyHistogram) only the ones to it.
+ * The latency is measured when the middleware calls put() of the subscriber:
+ * local messages from their publish, messages from other nodes from the
+ * sentTime of the sender, corrected by the clock offset of the sender node
+ * (setNodeClockOffset). Without histograms the cost is one test per subscriber.
+ *
+ * The buckets are logarithmic (like HDR histograms): 8 per power of 2, each
+ * value is counted with an error of less than 12.5 %. add() is lock free, it
+ * may be called from any thread at any time. A LatencyMonitor publishes the
+ * percentiles of all histograms periodically in latencyTopic.
+ */
+
+/// the counters of a LatencyHistogram, can be copied to evaluate them
+struct LatencyCounts {
+    static constexpr uint32_t SUB_BUCKET_BITS = 3;   ///< 8 buckets per power of 2
+    static constexpr uint32_t NUM_OF_BUCKETS  = 256; ///< up to 2^34 ns (17 s), the last one counts all longer ones
+
+    uint32_t buckets[NUM_OF_BUCKETS];
+    uint32_t count;
+    int64_t  sum; ///< of all latencies, for the mean
+    int64_t  max;
+
+    void clear();
+
+    int64_t getMean() const { return (count == 0) ? 0 : sum / count; }
+    /// upper bound of the bucket where permille/1000 of the values are below, 0 if empty
+    int64_t percentile(uint32_t permille) const;
+
+    static uint32_t bucketOf(int64_t latency);
+    /// the smallest latency counted in bucket
+    static int64_t bucketLowerBound(uint32_t bucket);
+    /// the largest latency counted in bucket
+    static int64_t bucketUpperBound(uint32_t bucket);
+};
+
+class LatencyHistogram : public ListElement {
+    Atomic<uint32_t> buckets[LatencyCounts::NUM_OF_BUCKETS];
+    Atomic<uint32_t> count;
+    Atomic<uint32_t> sumLow;  ///< the sum in ns as 2 words: 64 bit atomics are not lock free on all ports
+    Atomic<uint32_t> sumHigh;
+    Atomic<uint32_t> max;     ///< in ns, saturated at 4.29 s
+
+  public:
+    static List latencyHistogramList; ///< all histograms, for LatencyMonitor
+
+    uint32_t topicId; ///< set by setLatencyHistogram() if 0, for reports
+
+    LatencyHistogram(const char* name = "latency", uint32_t topicId = 0);
+
+    /// lock free, negative latencies (clock offsets) count as 0
+    void add(int64_t latency);
+
+    /**
+     * Copy of the counters, resets them if wanted. Each latency added meanwhile
+     * is in the copy or stays in the histogram, the sum and the count may differ.
+     */
+    void snapshot(LatencyCounts& to, bool reset = false);
+    void reset();
+
+    uint32_t getCount() const { return count.load(); }
+    int64_t  getMax() const { return max.load(); }
+};
+
+/**
+ * Latency of a delivery now, of a message published at netMsgInfo.sentTime,
+ * in the clock of its sender node.
+ */
+int64_t deliveryLatency(const NetMsgInfo& netMsgInfo);
+
+/**
+ * Time of this node - time of the other node (localTime, NOW()), to compare their
+ * sentTime. Usually from a time synchronisation. Nodes without offset: 0.
+ * At most LATENCY_MAX_CLOCK_OFFSETS nodes, returns false if there is no space.
+ */
+bool    setNodeClockOffset(int32_t nodeNumber, int64_t offset);
+int64_t getNodeClockOffset(int32_t nodeNumber);
+
+/// one histogram in a LatencyReport, all in microseconds, since the last report
+struct LatencyEntry {
+    uint32_t topicId;
+    uint32_t count;
+    uint32_t p50Us;
+    uint32_t p90Us;
+    uint32_t p99Us;
+    uint32_t maxUs;
+};
+
+/// published with only the used entries (publishMsgPart)
+struct LatencyReport {
+    int64_t      time;   ///< of the report
+    int64_t      period; ///< since the last report
+    uint32_t     numOfHistograms;
+    uint32_t     reserved;
+    LatencyEntry histograms[LATENCY_REPORT_MAX_HISTOGRAMS];
+
+    static size_t lenForHistograms(uint32_t numOfHistograms) {
+        return sizeof(LatencyReport) - (LATENCY_REPORT_MAX_HISTOGRAMS - numOfHistograms) * sizeof(LatencyEntry);
+    }
+};
+
+extern Topic<LatencyReport> latencyTopic;
+
+/// reports and resets all histograms every period
+class LatencyMonitor : public StaticThread<> {
+    int64_t       period;
+    int64_t       lastReport;
+    LatencyCounts snapshotCounts;
+
+  public:
+    LatencyReport lastReportMsg; ///< also the last one published
+
+    LatencyMonitor(int64_t period = 1 * SECONDS, int32_t priority = MAX_THREAD_PRIORITY);
+
+    /// fills lastReportMsg (the latencies since the last report) and publishes it
+    void report();
+    /// lastReportMsg with the names of the histograms
+    void print();
+
+    void run() override;
+};
+
+} // namespace RODOS
@@ -53,6 +53,7 @@ extern void hwDisableInterrupts();      // global interrupt disable - use carefu
 extern void hwEnableInterrupts();       // global interrupt enable - use carefully
 extern void deepSleepUntil(int64_t until); //< cpu core and periphery off until external interrupt or time "until"
 extern bool isSchedulerRunning();       //< implemented in the platform dependent scheduler
+extern void hwTimeEventActivated(int64_t eventAt); //< a timer which sleeps until the next TimeEvent wakes earlier (posix), default: nothing
 
 
 /** Nop... no operation ... do nothing ***/
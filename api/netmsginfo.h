@@ -16,6 +16,7 @@
 #include "stream-bytesex.h"   // To serialize/deserialize
 #include "string_pico.h"      // for memcpy
 #include "checksumes.h"
+#include "nodeset.h"
 
 /******** Identification of Messages ************/
 
@@ -37,9 +38,22 @@ enum class NetMsgType  : uint16_t { // set but not used until now
 };
 
 
+/// Flag in the type field of NetworkMessage: the user data is compressed, see PayloadCompression
+constexpr uint16_t NET_MSG_COMPRESSED = 0x8000;
+/// Flag in the type field of NetworkMessage: the user data is a fragment of a longer message, see fragmentation.h
+constexpr uint16_t NET_MSG_FRAGMENT   = 0x4000;
+
+/// Transmit priority class of a topic, used by gateways with a TransmitScheduler
+enum class TransmitPriority : uint8_t {
+    HIGH   = 0, ///< eg. commands, alarms
+    NORMAL = 1, ///< default
+    BULK   = 2  ///< eg. images, file transfer
+};
+constexpr uint32_t NUM_OF_TRANSMIT_PRIORITIES = 3;
+
 constexpr uint32_t LINK_ID_RODOS_LOCAL_BROADCAST = 0; // What is that? (SM) DEPRECATED !
 
-constexpr uint32_t MAX_NUM_OF_NODES = 32; // Warning: in an 32-bit int each bit   reporesents a node from 0 to 31
+constexpr uint32_t MAX_NUM_OF_NODES = 32; // Warning: in an 32-bit int each bit   reporesents a node from 0 to 31. More: see NodeSet
 
 
 /**
@@ -58,6 +72,9 @@ class NetMsgInfo {
     uint32_t   receiverNodesBitMap;  ///< See receiverNode+receiverNodesBitMap.txt
     uint32_t   linkId;         ///< The ID of the Linkinterface from which the message was received. Set by Linkinterface
     NetMsgType messageType;    ///< The type of the message, set by sender
+    uint32_t   sequenceNr;     ///< Per sender node message counter, set in publish(). 0 -> not numbered
+    TransmitPriority transmitPriority; ///< Set in publish() from the topic. Local only, not in NetworkMessage
+    const NodeSet* receiverNodes;      ///< 0 -> receiverNodesBitMap is enough. Else sent as extension, see nodeset.h
 
     NetMsgInfo (NetMsgType type = NetMsgType::PUB_SUB_MSG) { init(type); }
     
@@ -69,15 +86,32 @@ class NetMsgInfo {
          senderThreadId = static_cast<uint32_t>(ptr);
          messageType    = type;
          receiverNode   = -1; // Not used until now, but 0xffffffff shall be broadcast
+         sequenceNr     = 0;  // assigned in publish(), only if the message goes to the network
+         transmitPriority = TransmitPriority::NORMAL;
+         receiverNodes  = 0;
     }
 };
 
+/// Next number of the per node message counter, never 0. See Gateway::messageSeen()
+/// count > 1 reserves consecutive numbers (one for each fragment), returns the first
+uint32_t getNextMsgSequenceNr(uint32_t count = 1);
+
+/// Each fragment of a message longer than MAX_NETWORK_MESSAGE_LENGTH begins with a fragment header
+constexpr size_t FRAGMENT_HEADER_SIZE = 12;
+constexpr size_t MAX_FRAGMENT_DATA    = MAX_NETWORK_MESSAGE_LENGTH - FRAGMENT_HEADER_SIZE;
+
+/// Number of network messages needed to send len bytes of user data
+inline uint32_t numberOfFragments(size_t len) {
+    if(len <= MAX_NETWORK_MESSAGE_LENGTH) return 1;
+    return static_cast<uint32_t>((len + MAX_FRAGMENT_DATA - 1) / MAX_FRAGMENT_DATA);
+}
+
 /**
  * Simple message data protocol to transmit data to a remote node.
  * Header is serialized NetMsgInfo, followed by the user data
  */
 class NetworkMessage {
-    static constexpr uint16_t HEADER_SIZE = 36;
+    static constexpr uint16_t HEADER_SIZE = 40;
     uint8_t header [HEADER_SIZE];
 public:
     inline void    put_receiverNode(int32_t x)         {int32_tToBigEndian(header + 0, x); } // see receiverNode+receiverNodesBitMap.txt
@@ -91,6 +125,7 @@ public:
     inline void    put_sentTime (int64_t x)            {int64_tToBigEndian(header +20, x); }
     inline void    put_senderThreadId(uint32_t x)      {uint32_tToBigEndian(header+28, x); }
     inline void    put_topicId(uint32_t x)             {uint32_tToBigEndian(header+32, x); }
+    inline void    put_sequenceNr(uint32_t x)          {uint32_tToBigEndian(header+36, x); } // 0 -> not numbered
 
     inline int32_t  get_receiverNode()         const { return bigEndianToInt32_t(header + 0); } // see receiverNode+receiverNodesBitMap.txt
     inline uint32_t get_receiverNodesBitMap()  const { return bigEndianToUint32_t(header+ 4); } // see receiverNode+receiverNodesBitMap.txt
@@ -103,6 +138,7 @@ public:
     inline int64_t  get_sentTime ()            const { return bigEndianToInt64_t(header +20); }
     inline uint32_t get_senderThreadId()       const { return bigEndianToUint32_t(header+28); }
     inline uint32_t get_topicId()              const { return bigEndianToUint32_t(header+32); }
+    inline uint32_t get_sequenceNr()           const { return bigEndianToUint32_t(header+36); } // 0 -> not numbered
 
     uint8_t userDataC[MAX_NETWORK_MESSAGE_LENGTH]; ///< local buffer for user data ca 1300. See platform-parameter.h
 
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "default-platform-parameter.h"
+
+namespace RODOS {
+
+class NetworkMessage;
+
+/**
+ * @file nodeset.h
+ * @date 2026/10/09
+ *
+ * @brief set of receiver nodes, for more than the 32 nodes of receiverNodesBitMap
+ *
+ */
+
+constexpr uint32_t NODE_SET_WORDS = MAX_ADDRESSABLE_NODES / 32;
+static_assert(MAX_ADDRESSABLE_NODES % 32 == 0 && NODE_SET_WORDS > 0, "MAX_ADDRESSABLE_NODES has to be a multiple of 32");
+static_assert(MAX_ADDRESSABLE_NODES <= 256, "node indexes have to fit in 8 bits (TopicListPerNode::nodeIndex)");
+
+/// Flag in the type field of NetworkMessage: the user data ends with an encoded NodeSet, see NodeSet::appendTo()
+constexpr uint16_t NET_MSG_RECEIVER_SET = 0x2000;
+
+/**
+ * Multi word bitmap, one bit per node index (nodeIndex(), 0..MAX_ADDRESSABLE_NODES-1).
+ * Membership tests are O(1).
+ *
+ * receiverNodesBitMap (32 bits) is the folded set: bit i is set if any node
+ * with index % 32 == i is in the set (fold()). Routers and gateways which know
+ * only the bitmap get a superset of the receivers.
+ *
+ * In the network the set is an extension at the end of the user data, sent by
+ * gateways with extended addressing if MAX_ADDRESSABLE_NODES > 32, see appendTo():
+ *
+ *    n * (wordIndex: 1 byte, word: 4 bytes big endian), n: 1 byte
+ *
+ * Only words which are not 0 are sent; n is the last byte.
+ */
+class NodeSet {
+    uint32_t words[NODE_SET_WORDS];
+
+  public:
+    NodeSet() { clear(); }
+
+    static uint32_t nodeIndex(int32_t nodeNr) { return static_cast<uint32_t>(nodeNr) % MAX_ADDRESSABLE_NODES; }
+
+    void clear() {
+        for(uint32_t i = 0; i < NODE_SET_WORDS; i++) words[i] = 0;
+    }
+    void setAll() {
+        for(uint32_t i = 0; i < NODE_SET_WORDS; i++) words[i] = ~0u;
+    }
+
+    void add(uint32_t index) { words[(index / 32) % NODE_SET_WORDS] |= 0x01u << (index % 32); }
+    void remove(uint32_t index) { words[(index / 32) % NODE_SET_WORDS] &= ~(0x01u << (index % 32)); }
+    bool contains(uint32_t index) const { return (words[(index / 32) % NODE_SET_WORDS] >> (index % 32)) & 0x01; }
+
+    bool isEmpty() const;
+    bool isExtended() const; ///< nodes with index > 31: receiverNodesBitMap is not enough
+    uint32_t count() const;
+
+    /// the first node index >= from, -1 if none
+    int32_t next(uint32_t from) const;
+
+    bool intersects(const NodeSet& other) const;
+    bool isSubsetOf(const NodeSet& other) const;
+    void intersectWith(const NodeSet& other);
+
+    /// receiverNodesBitMap: bit i for all nodes with index % 32 == i
+    uint32_t fold() const;
+    /// all nodes which may be meant by a receiverNodesBitMap
+    void unfold(uint32_t bitmap);
+
+    /// bytes appendTo() adds to the user data
+    size_t encodedSize() const;
+
+    /**
+     * Appends the set to the user data of msg (before setCheckSum) and sets NET_MSG_RECEIVER_SET.
+     * @return false if it does not fit in MAX_NETWORK_MESSAGE_LENGTH: msg has only receiverNodesBitMap
+     */
+    bool appendTo(NetworkMessage& msg) const;
+
+    /** Reads the set from a message with NET_MSG_RECEIVER_SET.
+     * @return false if the message has none or it is corrupt
+     */
+    bool readFrom(const NetworkMessage& msg);
+
+    /// bytes of the set at the end of the user data, 0 if none
+    static size_t extensionSize(const NetworkMessage& msg);
+};
+
+}  // namespace
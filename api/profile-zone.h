@@ -0,0 +1,190 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "default-platform-parameter.h"
+#include "listelement.h"
+#include "rodos-atomic.h"
+#include "thread.h"
+#include "timemodel.h"
+#include "topic.h"
+#include "trace-ring.h"
+
+namespace RODOS {
+
+/**
+ * @file profile-zone.h
+ * @date 2026/10/18
+ *
+ * @brief profiling zones: cycles spent in code regions, per thread
+ *
+ *     void f() {
+ *         RODOS_PROFILE_SCOPE("f");
+ *         ...
+ *     }
+ *
+ * measures the cycles from RODOS_PROFILE_SCOPE to the end of the scope with the
+ * cycle counter of the CPU (x86: rdtsc, aarch64: cntvct, Cortex-M3/4/7: DWT
+ * CYCCNT, else NOW() in ns). Only threads with a ProfileTable
+ * (Thread::setProfileTable) are measured: each zone is counted in the table of
+ * the thread, with count, total, min, max and a histogram. Zones in interrupt
+ * servers count for the interrupted thread. An interrupt server does not
+ * write the table while the thread is in add(): such a zone counts as dropped.
+ *
+ * A zone in a table costs about 50 ns on x86-64 posix (two reads of the
+ * counter and the update of the table), 1 % only for zones of 5 us and more.
+ * Threads without a table pay only the test of the pointer.
+ *
+ * The middleware has its own zones: "publish", "subscriber put",
+ * "gateway analyse", "link send" and "link receive". Two of them run for each
+ * publish (about 130 ns), they are measured only in tables constructed with
+ * middlewareZones (RODOS_PROFILE_MIDDLEWARE_SCOPE).
+ * A ProfileDumper publishes all tables periodically in profileTopic.
+ * Compiled with DISABLE_PROFILE_ZONES, RODOS_PROFILE_SCOPE is empty.
+ */
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+using ProfileCounter = uint32_t; ///< wraps, durations are computed modulo 2^32
+#else
+using ProfileCounter = uint64_t;
+#endif
+
+/// the cycle counter used for the zones
+inline ProfileCounter profileCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    uint32_t low, high;
+    asm volatile("rdtsc" : "=a"(low), "=d"(high));
+    return (static_cast<uint64_t>(high) << 32) | low;
+#elif defined(__aarch64__)
+    uint64_t counter;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(counter));
+    return counter;
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+    return *reinterpret_cast<volatile uint32_t*>(0xE0001004); // DWT CYCCNT, enabled by the first ProfileTable
+#else
+    return static_cast<ProfileCounter>(NOW());
+#endif
+}
+
+/// one zone in a ProfileTable, cumulative since the start
+struct ProfileZoneStats {
+    static constexpr uint32_t HISTOGRAM_BUCKETS = 8; ///< < 256 cycles, then * 4 each: < 1K, < 4K, ... the last one >= 1M
+
+    const char* name; ///< 0: free
+    uint64_t    totalCycles;
+    uint32_t    count;
+    uint32_t    minCycles;
+    uint32_t    maxCycles;
+    uint32_t    histogram[HISTOGRAM_BUCKETS];
+
+    static uint32_t bucketOf(uint32_t cycles);
+};
+
+/// the zones of one thread
+class ProfileTable : public ListElement {
+  public:
+    static List profileTableList; ///< all tables, for ProfileDumper
+
+    Thread*          thread;           ///< set by Thread::setProfileTable()
+    const bool       middlewareZones;  ///< measures the zones of the middleware too
+    uint32_t         numOfZones;
+    Atomic<uint32_t> droppedZones;     ///< no place in the table, or ended in an interrupt during add()
+    volatile bool    adding;           ///< in add(), an interrupt server may not add meanwhile
+    ProfileZoneStats zones[PROFILE_MAX_ZONES];
+
+    ProfileTable(const char* name = "profileTable", bool middlewareZones = false);
+
+    /// called by ProfileScope, from the thread of the table and its interrupt servers
+    void add(const char* zoneName, uint32_t cycles);
+    /// 0 if the zone was never measured
+    const ProfileZoneStats* find(const char* zoneName) const;
+
+  private:
+    void addZone(const char* zoneName, uint32_t cycles);
+};
+
+/// RAII: measures its lifetime in the table of the calling thread, see RODOS_PROFILE_SCOPE
+class ProfileScope {
+    ProfileTable*  table;
+    const char*    zoneName;
+    ProfileCounter start;
+
+  public:
+    ProfileScope(const char* zoneName_, bool middleware = false) : table(0), zoneName(zoneName_), start(0) {
+        Thread* caller = traceCurrentThread();
+        if(caller == 0 || (table = caller->getProfileTable()) == 0) return;
+        if(middleware && !table->middlewareZones) {
+            table = 0;
+            return;
+        }
+        start = profileCycles();
+    }
+    ~ProfileScope() {
+        if(!table) return;
+        ProfileCounter cycles    = profileCycles() - start;
+        uint32_t       saturated = static_cast<uint32_t>(cycles);
+        if constexpr(sizeof(ProfileCounter) > sizeof(uint32_t)) {
+            if(cycles > 0xffffffff) saturated = 0xffffffff;
+        }
+        table->add(zoneName, saturated);
+    }
+};
+
+#define RODOS_PROFILE_CONCAT2(a, b) a##b
+#define RODOS_PROFILE_CONCAT(a, b)  RODOS_PROFILE_CONCAT2(a, b)
+
+#ifndef DISABLE_PROFILE_ZONES
+/// zoneName has to be a string literal (or live forever): zones are identified by the pointer
+#define RODOS_PROFILE_SCOPE(zoneName) RODOS::ProfileScope RODOS_PROFILE_CONCAT(profileScope, __LINE__)(zoneName)
+/// the zones of the middleware, only in tables with middlewareZones
+#define RODOS_PROFILE_MIDDLEWARE_SCOPE(zoneName) RODOS::ProfileScope RODOS_PROFILE_CONCAT(profileScope, __LINE__)(zoneName, true)
+#else
+#define RODOS_PROFILE_SCOPE(zoneName) ((void)(zoneName))
+#define RODOS_PROFILE_MIDDLEWARE_SCOPE(zoneName) ((void)(zoneName))
+#endif
+
+/// one zone in a ProfileReport
+struct ProfileEntry {
+    uint64_t totalCycles;
+    uint32_t count;
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint32_t histogram[ProfileZoneStats::HISTOGRAM_BUCKETS];
+    char     name[16]; ///< truncated, 0 terminated
+};
+
+/// one ProfileTable, published with only the used entries (publishMsgPart)
+struct ProfileReport {
+    int64_t      time;            ///< of the report, the values may be from different moments
+    uint64_t     cyclesPerSecond; ///< measured by the ProfileDumper, 0: not yet known
+    uint32_t     threadId;        ///< ListElement::listElementID of the thread
+    uint16_t     numOfZones;
+    uint16_t     droppedZones;    ///< saturated at 0xffff
+    ProfileEntry zones[PROFILE_MAX_ZONES];
+
+    static size_t lenForZones(uint32_t numOfZones) {
+        return sizeof(ProfileReport) - (PROFILE_MAX_ZONES - numOfZones) * sizeof(ProfileEntry);
+    }
+};
+
+extern Topic<ProfileReport> profileTopic;
+
+/// publishes all ProfileTables every period, one ProfileReport for each one
+class ProfileDumper : public StaticThread<> {
+    int64_t        period;
+    int64_t        lastDumpTime;
+    ProfileCounter lastDumpCycles;
+    uint64_t       cyclesPerSecond;
+
+  public:
+    ProfileReport lastReportMsg; ///< the last one published
+
+    ProfileDumper(int64_t period = 10 * SECONDS, int32_t priority = 10);
+
+    /// one report for each table, returns the number of reports
+    uint32_t dump();
+
+    void run() override;
+};
+
+} // namespace RODOS
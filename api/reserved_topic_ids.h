@@ -24,6 +24,9 @@ constexpr uint32_t TOPIC_ID_NETWORK_REPORT      = 1;
 constexpr uint32_t TOPIC_ID_TAKS_DISTRIBUTION	= 2;
 constexpr uint32_t TOPIC_ID_MONITORING_MSG		= 3;
 constexpr uint32_t TOPIC_ID_DEBUG_CMD_MSG		= 4;
+constexpr uint32_t TOPIC_ID_THREAD_LOAD_REPORT	= 5;
+constexpr uint32_t TOPIC_ID_LATENCY_REPORT		= 7; // 6: TOPIC_ID_FOR_CONTENT_FILTER_REPORT
+constexpr uint32_t TOPIC_ID_PROFILE_REPORT		= 8;
 
 
 /************ 100 ... 999:  Input / Output services ***/
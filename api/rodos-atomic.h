@@ -69,6 +69,9 @@ template<typename T> struct Atomic : protected std::atomic<T> {
     T operator&=(T v) noexcept { return this->fetch_and(v); }
     T operator|=(T v) noexcept { return this->fetch_or(v);  }
     T operator^=(T v) noexcept { return this->fetch_xor(v); }
+
+    /// if the value is expected: desired, else expected gets the value
+    bool compareExchange(T& expected, T desired) noexcept { return this->compare_exchange_weak(expected, desired); }
 };
 
 /**
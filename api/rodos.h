@@ -50,10 +50,17 @@
 #include "topic.h"
 #include "reserved_topic_ids.h"
 #include "subscriber.h"
+#include "subscriber-adapters.h"
 
 #include "yprintf.h"
 
 #include "gateway.h"
+#include "flight-recorder.h"
+#include "trace-ring.h"
+#include "thread-load.h"
+#include "latency-histogram.h"
+#include "profile-zone.h"
+#include "core-partition.h"
 
 //___________________________ 
 using namespace RODOS;
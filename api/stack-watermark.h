@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace RODOS {
+
+/**
+ * @file stack-watermark.h
+ * @date 2026/10/18
+ *
+ * @brief incremental search of the deepest stack usage (the watermark)
+ *
+ * Stacks are painted with EMPTY_MEMORY_MARKER when created and grow down.
+ * The watermark is the lowest word which is not the marker any more. Instead
+ * of scanning the whole stack at once (Thread::getMaxStackUsage), scanSlice()
+ * compares a bounded number of words and continues there the next time: one
+ * round goes from the bottom up to the last watermark, then it starts again.
+ * The idle thread of the bare-metal ports scans a slice of one thread each
+ * time it runs (Thread::scanStacks), see Thread::getStackUsage().
+ */
+class StackWatermark {
+    const uint32_t* begin     = 0; ///< lowest word of the stack
+    const uint32_t* end       = 0; ///< after the highest word
+    const uint32_t* watermark = 0; ///< lowest word used until now, all below are markers
+    const uint32_t* scanPos   = 0; ///< next word to compare in this round
+    uint32_t        rounds    = 0;
+
+  public:
+    static constexpr uint32_t EMPTY_MEMORY_MARKER = 0xDEADBEEF;
+    static constexpr size_t   STACK_MARGIN        = 300; ///< bytes, a thread with less free stack is deactivated by the scheduler
+
+    /// paints the words from begin up to end (excluded)
+    static void paint(void* begin, void* end);
+
+    /// the stack (painted) from begin up to end (excluded)
+    void init(const void* begin, const void* end);
+
+    /**
+     * Compares at most maxWords words, returns true if a round ends with this
+     * slice. Can be called from any thread while the owner of the stack runs.
+     */
+    bool scanSlice(uint32_t maxWords);
+
+    /// bytes from the watermark up to the end, 0 before the first round (or if not initialized)
+    size_t getUsage() const;
+    /// complete rounds until now
+    uint32_t getRounds() const { return rounds; }
+
+    /// a stack size for this usage: 25 % and STACK_MARGIN more, rounded up to 64 bytes
+    static size_t recommendedSize(size_t usage);
+};
+
+} // namespace RODOS
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "commbuffer.h"
+#include "subscriber.h"
+
+namespace RODOS {
+
+/**
+ * @file subscriber-adapters.h
+ * @date 2026/10/12
+ *
+ * @brief subscribers for slow consumers of fast topics, see Subscriber::setDecimation(),
+ *        setThrottle() and setChangeOnly()
+ *
+ */
+
+/**
+ * Receives only every n-th message of its topic, eg. 10 Hz from a 1 kHz topic.
+ * @tparam Type The data type of the topic message.
+ */
+template <class Type>
+class DecimatingSubscriber : public SubscriberReceiver<Type> {
+public:
+    DecimatingSubscriber(TopicInterface &topic, uint32_t n, void (*funcPtr)(Type&) = 0, const char* name = "decimatingSubscriber") :
+        SubscriberReceiver<Type>(topic, funcPtr, name) {
+        this->setDecimation(n);
+    }
+};
+
+/**
+ * Receives at most one message per interval. If coalescing, getLatest()
+ * returns the latest published value at any time (CommBuffer), also the
+ * ones which were not delivered.
+ * @tparam Type The data type of the topic message.
+ */
+template <class Type>
+class ThrottledSubscriber : public SubscriberReceiver<Type> {
+    CommBuffer<Type> latest;
+
+public:
+    ThrottledSubscriber(TopicInterface &topic, int64_t interval, void (*funcPtr)(Type&) = 0, bool coalescing = false,
+                        const char* name = "throttledSubscriber") :
+        SubscriberReceiver<Type>(topic, funcPtr, name) {
+        this->setThrottle(interval, coalescing ? &latest : 0);
+    }
+
+    /// @return false if there was no new value since the last call (only if coalescing)
+    bool getLatest(Type& data) { return latest.getOnlyIfNewData(data); }
+};
+
+/**
+ * Receives only messages whose content changed, eg. modes and states
+ * published periodically.
+ * @tparam Type The data type of the topic message.
+ */
+template <class Type>
+class ChangeOnlySubscriber : public SubscriberReceiver<Type> {
+public:
+    ChangeOnlySubscriber(TopicInterface &topic, void (*funcPtr)(Type&) = 0, const char* name = "changeOnlySubscriber") :
+        SubscriberReceiver<Type>(topic, funcPtr, name) {
+        this->setChangeOnly();
+    }
+};
+
+}  // namespace
@@ -13,6 +13,7 @@
 
 #include <stdint.h>
 
+#include "content-filter.h"
 #include "rodos-debug.h"
 #include "rodos-semaphore.h"
 #include "topic.h"
@@ -22,6 +23,7 @@
 namespace RODOS {
 
 class Putter;
+class LatencyHistogram;
 
 /**
 * @class Subscriber
@@ -45,6 +47,7 @@ class Subscriber : public ListElement {
 
     friend class TopicInterface;
     friend class TopicReporter;
+    friend class Gateway;
     friend void initSystem();
 
 public:
@@ -63,6 +66,28 @@ protected:
     static List subscriberList;
 
     Semaphore protector;
+
+    /// see setDecimation(), setThrottle(), setChangeOnly(), the defaults are no policy. Guarded by protector
+    bool     hasDeliveryPolicy = false;
+    bool     changeOnly        = false;
+    bool     deliveredOnce     = false;
+    uint32_t decimation        = 1;
+    uint32_t msgsSinceDelivery = 0;
+    int64_t  minInterval       = 0;
+    int64_t  lastDelivery      = 0;
+    uint8_t* lastDelivered     = 0; ///< copy of the last delivered message for setChangeOnly(), topic size
+    size_t   lastDeliveredLen  = 0;
+    Putter*  latestValue       = 0;
+    const ContentFilter* contentFilter    = 0; ///< see setContentFilter()
+    LatencyHistogram*    latencyHistogram = 0; ///< see setLatencyHistogram()
+
+    /// called by TopicInterface::publish before put(). Without policy: no semaphore, no copy
+    bool acceptsMsg(const uint32_t topicId, const size_t len, const void* data, const NetMsgInfo& netMsgInfo) {
+        return !hasDeliveryPolicy || applyDeliveryPolicy(topicId, len, data, netMsgInfo);
+    }
+    bool applyDeliveryPolicy(const uint32_t topicId, const size_t len, const void* data, const NetMsgInfo& netMsgInfo);
+    void updateDeliveryPolicy();
+
     // DEPRECATED! DO not use anymore!
     //virtual long put(const long topicId, const long len, const void* data, long linkId);
 
@@ -121,6 +146,51 @@ public:
      */
     bool isGateway() const;
 
+    /**
+     * Delivery policies for slow consumers of fast topics (loggers, GUIs, ground links).
+     * TopicInterface::publish evaluates them before calling put(), therefore skipped
+     * messages cost no copy and no call of the receiver, only the semaphore of the
+     * subscriber, which guards the counters also with several publishers.
+     * They can be combined: first change only, then decimation, then throttle.
+     */
+    /// Only every n-th message goes to the receiver, 1 (default): all
+    void setDecimation(uint32_t n);
+    /**
+     * At most one message per interval goes to the receiver, 0 (default): all.
+     * If latestValue (eg. a CommBuffer) is given, it gets every message: the
+     * latest value can be read at any time, older ones are overwritten.
+     */
+    void setThrottle(int64_t interval, Putter* latestValue = 0);
+    /**
+     * Only messages which differ from the last delivered one, compared byte by byte.
+     * The copy of the last one (topic size) is allocated with xmalloc: call it before
+     * the scheduler starts (eg. in a constructor or init()), else all messages are delivered.
+     */
+    void setChangeOnly(bool onOff = true);
+
+    uint32_t skippedMsgs = 0; ///< not delivered due to the policies
+
+    /**
+     * Only messages which match the filter go to the receiver, 0 (default): all.
+     * It is evaluated first, before the other policies. The filter is not copied,
+     * it has to exist as long as the subscriber. Gateways with
+     * setContentFilterExport() send it to the other nodes, which then do not send
+     * messages no filter of this node wants.
+     */
+    void setContentFilter(const ContentFilter* filter);
+    const ContentFilter* getContentFilter() const { return contentFilter; }
+
+    uint32_t filteredMsgs = 0; ///< not delivered due to the content filter
+
+    /**
+     * Counts the latency of each message delivered to this subscriber, from the
+     * publish or from the sentTime of the sender node, see latency-histogram.h. 0: none.
+     */
+    void setLatencyHistogram(LatencyHistogram* histogram);
+
+    /// incremented for each change of a content filter or of an enabled flag, see Gateway::setContentFilterExport
+    static uint32_t contentFiltersGeneration;
+
 };
 
 
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "default-platform-parameter.h"
+#include "thread.h"
+#include "topic.h"
+
+namespace RODOS {
+
+/**
+ * @file thread-load.h
+ * @date 2026/10/18
+ *
+ * @brief periodic report of the CPU time of each thread and the deadline overruns
+ *
+ * Each thread counts its CPU time, its activations and deadline overruns
+ * (Thread::getCpuTime() ...). A ThreadLoadMonitor (one per node, if
+ * wanted) publishes them every period in threadLoadTopic, compact
+ * enough to be sent to ground.
+ */
+
+/// one thread in a ThreadLoadReport, all counters since the start of the thread
+struct ThreadLoadEntry {
+    uint16_t threadId;         ///< ListElement::listElementID of the thread
+    uint16_t loadPermille;     ///< CPU time in the last period / period
+    uint32_t maxActivationUs;  ///< CPU time of the longest activation
+    uint32_t activations;
+    uint16_t deadlineOverruns; ///< saturated at 0xffff
+    uint16_t missedBeats;      ///< saturated at 0xffff
+};
+
+/// published with only the used entries (publishMsgPart)
+struct ThreadLoadReport {
+    int64_t         time;            ///< of the report
+    int64_t         period;          ///< since the last report
+    uint16_t        cpuLoadPermille; ///< all threads except the ones of priority 0 (idle thread)
+    uint16_t        numOfThreads;
+    uint32_t        reserved;
+    ThreadLoadEntry threads[THREAD_LOAD_REPORT_MAX_THREADS];
+
+    static size_t lenForThreads(uint32_t numOfThreads) {
+        return sizeof(ThreadLoadReport) - (THREAD_LOAD_REPORT_MAX_THREADS - numOfThreads) * sizeof(ThreadLoadEntry);
+    }
+};
+
+extern Topic<ThreadLoadReport> threadLoadTopic;
+
+class ThreadLoadMonitor : public StaticThread<> {
+    int64_t period;
+    int64_t lastReport;
+
+  public:
+    ThreadLoadReport lastReportMsg; ///< also the last one published
+
+    ThreadLoadMonitor(int64_t period = 1 * SECONDS, int32_t priority = MAX_THREAD_PRIORITY);
+
+    /// fills lastReportMsg (the load since the last report) and publishes it
+    void report();
+    /// lastReportMsg with the names of the threads
+    void print();
+
+    void run() override;
+};
+
+} // namespace RODOS
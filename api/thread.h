@@ -18,6 +18,9 @@
 #include "listelement.h" // required when compilng with posix
 #include "timemodel.h"
 #include "default-platform-parameter.h"
+#include "stack-watermark.h"
+
+class ActivityExecuter; // support-libs/activity.cpp, suspends like GenericIOInterface
 
 namespace RODOS {
 
@@ -33,6 +36,8 @@ long* hwInitContext(long* stack, void* thread);
 * To implement a thread, users must inherit from a thread class and implement the run() method.
 * The standard way is to inherit from %StaticThread, which uses a static allocated stack.
 */
+class ProfileTable;
+
 class Thread : public ListElement {
   friend void schedulerWrapper(long* ctx);
   friend void threadStartupWrapper(Thread*);
@@ -41,6 +46,10 @@ class Thread : public ListElement {
   friend class Scheduler;
   friend class ThreadChecker; // not in RODOS, maybe created by users
   friend class GenericIOInterface;
+  friend class ::ActivityExecuter;
+  friend class TraceRing;
+  friend class ThreadLoadMonitor;
+  friend class CorePartition;
 
 private:
   static List threadList; ///< List of all threads
@@ -50,6 +59,29 @@ private:
 
   int64_t nextBeat = END_OF_TIME;  ///<  the next time to awake (used in wait)
   int64_t period = 0;    ///<  To repeat every period localTime units
+  int64_t deadline = 0;  ///<  relative to each beat, 0: the period
+  int64_t releaseTime = END_OF_TIME; ///< the beat of the current activation
+
+  /**
+   * @name CPU time accounting, see getCpuTime()
+   * An activation lasts from the return of suspendCallerUntil() until its next call.
+   * @{
+   */
+  int64_t runTime = 0;           ///< bare-metal: CPU time until the thread was switched in the last time
+  int64_t runningSince = 0;      ///< bare-metal: time it was switched in the last time
+  int64_t activationStart = 0;   ///< CPU time at the begin of the current activation
+  int64_t maxActivationTime = 0; ///< CPU time of the longest activation
+  uint32_t activations = 0;
+  uint32_t deadlineOverruns = 0; ///< activations of beats which ended after the deadline
+  uint32_t missedBeats = 0;      ///< beats skipped by suspendUntilNextBeat() because the thread was too late
+  int64_t reportedCpuTime = 0;   ///< for ThreadLoadMonitor
+  /** @} */
+
+  ProfileTable* profileTable = 0; ///< see setProfileTable()
+
+  StackWatermark stackWatermark; ///< bare-metal: see getStackUsage()
+
+  uint64_t affinity = 0; ///< set by setAffinity(), 0: as the CorePartition says
 
   /**
    * @name Shared variables used in both threads as well as interrupt handlers
@@ -77,6 +109,9 @@ private:
 
   bool checkStackViolations();
 
+  void beginActivation() { activationStart = getCpuTime(); }
+  void endActivation();
+
   static void initializeThreads(); ///< call the init method of all threads
 
 public:
@@ -197,10 +232,13 @@ public:
    *
    * @param begin Time for first the start time of the first computing period.
    * @param period Period between the start time of computing periods.
+   * @param deadline Relative to the begin of each period: an activation which ends later (next
+   *        suspendUntilNextBeat()) counts as overrun. 0: the period.
    *
    * @see suspendUntilNextBeat
+   * @see getDeadlineOverruns
    */
-  void setPeriodicBeat(const int64_t begin, const int64_t period);
+  void setPeriodicBeat(const int64_t begin, const int64_t period, const int64_t deadline = 0);
 
   /**
    * Resume the thread. The resumed thread gets unsuspended and the scheduler will be triggered at
@@ -237,7 +275,8 @@ public:
    * Get a pointer to the currently running thread. The method can used to identify the calling thread in
    * classes with no inheritance to the class Thread.
    *
-   * @return Pointer to the currently running thread.
+   * @return Pointer to the currently running thread. On posix 0 in handlers of
+   *         the timer thread (TimeEvents), which run in parallel to the threads.
    */
   static Thread* getCurrentThread();
 
@@ -290,6 +329,54 @@ public:
    */
   static size_t getMaxStackUsage();
 
+  /**
+   * The deepest stack usage of this thread until now, as far as the incremental
+   * scan (scanStacks) got. 0 if not scanned yet or not supported (posix).
+   */
+  size_t getStackUsage() const { return stackWatermark.getUsage(); }
+  size_t getStackSize() const { return stackSize; }
+
+  /**
+   * Scans maxWords words of the stack of one thread, the next thread the next
+   * time. Bare-metal: called by the idle thread with STACK_SCAN_SLICE_WORDS.
+   */
+  static void scanStacks(uint32_t maxWords);
+
+  /// stack size, usage (getStackUsage) and a recommended size of each thread
+  static void printStackReport();
+
+  /**
+   * CPU time the thread has consumed since it was started, in nanoseconds. Bare-metal: measured at
+   * each thread switch, including the interrupts while it runs. Posix: CLOCK_THREAD_CPUTIME_ID.
+   */
+  int64_t getCpuTime() const;
+
+  /**
+   * The profiling zones (RODOS_PROFILE_SCOPE) executed by this thread are counted
+   * in table, see profile-zone.h. 0 (default): not measured.
+   */
+  void setProfileTable(ProfileTable* table);
+  ProfileTable* getProfileTable() const { return profileTable; }
+
+  /// number of activations ended until now (calls of suspendCallerUntil())
+  uint32_t getActivations() const { return activations; }
+  /// CPU time of the longest activation until now
+  int64_t getMaxActivationTime() const { return maxActivationTime; }
+  /// periodic threads (suspendUntilNextBeat): activations which ended after their deadline
+  uint32_t getDeadlineOverruns() const { return deadlineOverruns; }
+  /// periodic threads: beats skipped because an activation ended after the next beat
+  uint32_t getMissedBeats() const { return missedBeats; }
+
+  /**
+   * The cores the thread may run on, bit n: core n. 0: as the CorePartition of
+   * the node says (core-partition.h), without partition all cores. Before the
+   * thread is created the mask is only stored. Returns false if the host refuses
+   * it (e.g. no such core). Bare-metal: one core, masks without core 0 are refused.
+   */
+  bool setAffinity(uint64_t cpuMask);
+  /// the cores the thread may run on now (posix: asked from the host), 0: unknown
+  uint64_t getAffinity() const;
+
 };
 
 
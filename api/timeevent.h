@@ -32,6 +32,7 @@ namespace RODOS {
 class TimeEvent: public ListElement {
 
   friend void initSystem();
+  friend class TraceRing;
 
 protected:
   /// default list of all time events
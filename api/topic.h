@@ -21,11 +21,13 @@
 namespace RODOS {
 
 class TopicFilter;
+class LatencyHistogram;
 
 
 /** Predifined topic ids ***/
 constexpr uint32_t TOPIC_ID_FOR_TOPIC_REPORT           =  0; // redundant with 2? yes, this is DEPRECATED!
 constexpr uint32_t TOPIC_ID_FOR_TOPICLIST_DISTRIBUTION =  1; // see receiverNode+receiverNodesBitMap.txt
+constexpr uint32_t TOPIC_ID_FOR_CONTENT_FILTER_REPORT  =  6; // see Gateway::setContentFilterExport, only from link to link
 constexpr uint32_t ALL_TOPICS_BELOW_THIS_ARE_BROADCAST = 10;
 constexpr uint32_t TOPIC_FOR_PRINTF = 11;
 
@@ -65,11 +67,16 @@ public:
 	uint32_t topicId;   ///< Topic ID used for identification by network tramsmitions
 	size_t   msgLen;    ///< Size of message transferred via this topic
 	bool     onlyLocal; ///< if true, never call the gateways for this topic, even if publish says ditritribute to network
+	TransmitPriority transmitPriority; ///< for gateways with a TransmitScheduler, see setTransmitPriority()
         uint32_t receiverNodesBitMap; ///< see receiverNode+receiverNodesBitMap.txt (Please do it!!)
+        NodeSet  receiverNodes;       ///< more than 32 nodes, receiverNodesBitMap is receiverNodes.fold(), see nodeset.h
+        bool     interestAnnounced;   ///< distributed-topic-register: reported to the other nodes as subscribed here
+        LatencyHistogram* latencyHistogram; ///< see setLatencyHistogram()
         // int32_t receiverNode;      ///< Better than store, the topic computes it from receiverNodesBitMap
 public:
 
-    TopicInterface(int64_t id, size_t len, const char* name, bool _onlyLocal = false);
+    TopicInterface(int64_t id, size_t len, const char* name, bool _onlyLocal = false,
+                   TransmitPriority _transmitPriority = TransmitPriority::NORMAL);
 
     virtual ~TopicInterface() { 
         if(isShuttingDown) return;
@@ -110,9 +117,30 @@ public:
 
      void setTopicFilter(TopicFilter* filter);
 
+     /// true if at least one subscriber of this topic is enabled
+     bool hasEnabledSubscribers() const;
+
+     /** Priority class of the messages of this topic in the transmit queues of
+      * gateways with a TransmitScheduler. Gateway::setTopicPriority() overrides it per gateway.
+      */
+     void setTransmitPriority(TransmitPriority priority) { transmitPriority = priority; }
+
+     /**
+      * Counts the latency of each delivery to a subscriber of this topic, from the
+      * publish or from the sentTime of the sender node, see latency-histogram.h. 0: none.
+      */
+     void setLatencyHistogram(LatencyHistogram* histogram);
+
+     /// The node (NodeSet::nodeIndex) has subscribers: receiverNodes and receiverNodesBitMap
+     void addReceiverNode(uint32_t nodeIndex);
+     void removeReceiverNode(uint32_t nodeIndex);
+
      // The value for receiverNode :  See receiverNode+receiverNodesBitMap.txt
      int32_t receiverNodesBitMap2Index();
 
+private:
+     void recordLatency(LatencyHistogram* subscriberHistogram, const NetMsgInfo& netMsgInfo);
+
 };
 
 
@@ -157,7 +185,8 @@ public:
       * to generate a topic id if it was defined as -1. This is the proposed
        * method.
       */
-    Topic(int64_t id, const char* name, bool _onlyLocal = false) : TopicInterface(id, sizeof(Type), name, _onlyLocal) { }
+    Topic(int64_t id, const char* name, bool _onlyLocal = false, TransmitPriority _transmitPriority = TransmitPriority::NORMAL) :
+        TopicInterface(id, sizeof(Type), name, _onlyLocal, _transmitPriority) { }
 
     ~Topic() {
         if(isShuttingDown) return;
@@ -244,6 +273,9 @@ extern Topic<void*> interruptUart;
 extern Topic<void*> interruptSigterm;
 extern Topic<GenericMsgRef> charInput; ///< used instead of getcharNoWait()
 
+/** Local: Subscriber::enable() switched a subscriber of this topic on or off (at run time only) */
+extern Topic<TopicInterface*> subscriptionChanged;
+
 /** To include the application DistributedTopicRegister 
  * (to known which nodes have subscribers to which topics, see TopicInterface::receiverNodesBitMap)
  * just create an object of this struct and do nothing with it.
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rodos-atomic.h"
+
+namespace RODOS {
+
+/**
+ * @file trace-ring.h
+ * @date 2026/10/18
+ *
+ * @brief binary trace of the scheduler, semaphores, topics, time events and interrupts
+ *
+ * Instead of PRINTFs, which change the timing a lot: the kernel records
+ * binary events (some tens of cycles each) in traceRing, a ring which
+ * overwrites the oldest events. It records only between start() and
+ * stop(), with the memory given to start(). The dump (dump() or
+ * printDump() on the console) is converted on the host to Chrome trace
+ * JSON (Perfetto, chrome://tracing) or to CTF (Trace Compass, babeltrace)
+ * by support/support-programs/trace-converter.
+ *
+ * The recording points cost nothing when compiled with DISABLE_TRACE_RING.
+ *
+ * There is one ring for all writers, also on the posix port, where threads
+ * run in parallel on several cores (Thread::setAffinity, CorePartition).
+ * A slot is reserved with one atomic increment of writeIndex, no writer ever
+ * waits for another one. But the cores share the cache line of writeIndex and
+ * of the slots (two events per 64 bytes): under heavy tracing from several
+ * cores each event costs a transfer of these lines between the cores, some
+ * 100 ns instead of some tens of cycles, and the tracing changes the timing
+ * more. Trace fewer events, or the threads of one core, where this matters.
+ */
+
+class Thread;
+
+enum class TraceEventType : uint8_t {
+    THREAD_RUN = 1,    ///< object: the thread which runs now. On one core the thread of the event stops running
+    THREAD_WAIT,       ///< the thread waits (posix, where threads run in parallel)
+    SEMAPHORE_REQUEST, ///< object: semaphore, only if it is occupied by another thread
+    SEMAPHORE_ENTER,
+    SEMAPHORE_LEAVE,
+    PUBLISH_BEGIN,     ///< object: topic id, arg: length of the message
+    PUBLISH_END,
+    TIME_EVENT_BEGIN,  ///< object: time event
+    TIME_EVENT_END,
+    INTERRUPT_BEGIN,   ///< object: interrupt (posix: signal), 0: scheduler
+    INTERRUPT_END,
+    USER               ///< recorded by applications, object and arg as they like
+};
+
+/// in the byte order of the node, time in ns (NOW())
+struct TraceEvent {
+    int64_t  time;
+    uint32_t thread; ///< traceId() of the running thread, 0 in interrupts (posix: signal handlers)
+    uint32_t object;
+    uint32_t arg;
+    uint8_t  type;   ///< TraceEventType
+    uint8_t  lap;    ///< written last: detects events not yet complete or overwritten while reading
+    uint16_t reserved;
+};
+
+/// threads, semaphores and time events are identified by their address, topics by their id
+inline uint32_t traceId(const void* object) {
+    uintptr_t address = reinterpret_cast<uintptr_t>(object);
+    return static_cast<uint32_t>(address ^ (static_cast<uint64_t>(address) >> 32));
+}
+
+/// to be implemented by each port: the running thread, without searching. 0 in interrupts
+Thread* traceCurrentThread();
+
+/**
+ * The dump, all in big endian:
+ *   header: "RTRC", version (uint16), 0 (uint16), number of names, number of
+ *           events, number of overwritten events (uint32 each)
+ *   names:  kind (uint8, TraceNameKind), length (uint8), id (uint32), name
+ *   events: time (int64), thread, object, arg (uint32 each), type (uint8),
+ *           oldest first
+ */
+enum class TraceNameKind : uint8_t { THREAD = 1, TOPIC, TIME_EVENT };
+static constexpr uint16_t TRACE_DUMP_VERSION     = 1;
+static constexpr size_t   TRACE_DUMP_HEADER_SIZE = 20;
+static constexpr size_t   TRACE_DUMP_EVENT_SIZE  = 21;
+
+class TraceDumpSink;
+
+class TraceRing {
+    TraceEvent*      events;
+    uint32_t         mask;
+    uint32_t         lapShift;
+    Atomic<uint32_t> writeIndex;
+    volatile bool    recording;
+
+  public:
+    TraceRing() : events(0), mask(0), lapShift(0), writeIndex(0), recording(false) {}
+
+    /// numOfEvents: a power of 2. Clears the ring
+    void start(TraceEvent* buffer, uint32_t numOfEvents);
+    template <uint32_t NUM_OF_EVENTS>
+    void start(TraceEvent (&buffer)[NUM_OF_EVENTS]) {
+        static_assert((NUM_OF_EVENTS & (NUM_OF_EVENTS - 1)) == 0, "a power of 2");
+        start(buffer, NUM_OF_EVENTS);
+    }
+    void stop() { recording = false; }
+    bool isRecording() const { return recording; }
+
+    inline void record(TraceEventType type, uint32_t object, uint32_t arg = 0) {
+        if(recording) recordRaw(type, object, arg);
+    }
+    void recordRaw(TraceEventType type, uint32_t object, uint32_t arg);
+
+    /// events since start(), also the overwritten ones
+    uint32_t numOfRecorded() const { return writeIndex.load(); }
+    uint32_t numOfOverwritten() const;
+
+    /// the events in the ring, oldest first, without the ones being written. Returns how many
+    uint32_t copyEvents(TraceEvent* to, uint32_t maxEvents) const;
+
+    /// the dump (see above) with as many of the newest events as fit. Returns the length, 0 if not even the names fit
+    size_t dump(void* buffer, size_t maxLen) const;
+    /// the dump in hex on the console, lines "TRACE <hex>" (the converter reads them from a log)
+    void printDump() const;
+
+  private:
+    void          writeDump(TraceDumpSink& sink, uint32_t maxEvents) const;
+    static size_t putNames(TraceDumpSink* sink, uint32_t& numOfNames);
+};
+
+extern TraceRing traceRing;
+
+/// records begin and the end (type + 1) of a scope
+class TraceInScope {
+    TraceEventType type;
+    uint32_t       object;
+
+  public:
+    TraceInScope(TraceEventType type_, uint32_t object_, uint32_t arg = 0) : type(type_), object(object_) {
+        traceRing.record(type, object, arg);
+    }
+    ~TraceInScope() { traceRing.record(static_cast<TraceEventType>(static_cast<uint8_t>(type) + 1), object); }
+};
+
+#ifndef DISABLE_TRACE_RING
+#define RODOS_TRACE(type, object, arg) RODOS::traceRing.record(RODOS::TraceEventType::type, object, arg)
+#define RODOS_TRACE_IN_SCOPE(type, object, arg) RODOS::TraceInScope traceInScope(RODOS::TraceEventType::type, object, arg)
+#else
+#define RODOS_TRACE(type, object, arg) ((void)0)
+#define RODOS_TRACE_IN_SCOPE(type, object, arg)
+#endif
+
+} // namespace RODOS
@@ -0,0 +1,108 @@
+#include "rodos.h"
+#include "rodos-bench.h"
+#include "activity.h"
+
+/**
+ * rodos-bench: the activity executer with 10000 activities registered
+ *   - burst: 10, 1000 or 10000 of them due at the same time, the sample is
+ *     the time from one step to the next (dispatch of a ready one)
+ *   - periodic: 100 activities with periods of 10 .. 19 ms, lateness of the
+ *     step after the planned time
+ *   - resume: from resume() in a thread until the step runs
+ * Before the heap, each dispatch scanned all activities: compare with an
+ * older version.
+ */
+
+static constexpr uint32_t NUM_OF_ACTIVITIES = 10000;
+static constexpr uint32_t NUM_OF_PERIODIC   = 100;
+static constexpr uint32_t SAMPLES           = 10000;
+
+static BenchSampleBuffer<SAMPLES> samples;
+static uint64_t                   lastStepAt = 0;
+static Atomic<uint32_t>           steps{ 0 };
+
+class BurstActivity : public Activity {
+  public:
+    bool periodic = false;
+    BurstActivity() : Activity("burst") {}
+    void step(int64_t timeNow) override {
+        uint64_t now = benchCycles();
+        if(periodic) {
+            static double cyclesPerNs = benchCyclesPerSecond() / 1.0e9;
+            int64_t       late        = timeNow - suspendedUntil;
+            samples.add(static_cast<uint64_t>(static_cast<double>((late > 0) ? late : 0) * cyclesPerNs));
+        } else if(lastStepAt != 0) {
+            samples.add(now - lastStepAt);
+        }
+        lastStepAt = now;
+        steps++;
+    }
+};
+
+static BurstActivity activities[NUM_OF_ACTIVITIES];
+
+class ResumedActivity : public Activity {
+  public:
+    uint64_t resumedAt = 0;
+    ResumedActivity() : Activity("resumed") {}
+    void step(int64_t) override {
+        samples.add(benchCycles() - resumedAt);
+        steps++;
+    }
+} resumedActivity;
+
+class ActivityScaling : public StaticThread<> {
+  public:
+    ActivityScaling() : StaticThread<>("activityScaling", 200) {}
+
+    void waitForSteps(uint32_t count) {
+        int64_t giveUp = NOW() + 10 * SECONDS;
+        while(steps.load() < count && NOW() < giveUp) suspendCallerUntil(NOW() + 1 * MILLISECONDS);
+        if(steps.load() < count) PRINTF("only %d of %d steps\n", static_cast<int>(steps.load()), static_cast<int>(count));
+    }
+
+    void run() {
+        char caseName[60];
+        benchCyclesPerSecond(); // calibrated before the measurements
+        suspendCallerUntil(NOW() + 100 * MILLISECONDS);
+
+        const uint32_t dueCases[] = { 10, 1000, NUM_OF_ACTIVITIES };
+        for(uint32_t due : dueCases) {
+            samples.clear();
+            steps           = 0;
+            uint32_t rounds = RODOS::min(100u, SAMPLES / due);
+            for(uint32_t round = 0; round < rounds; round++) {
+                lastStepAt = 0; // not the gap between the rounds
+                int64_t at = NOW() + 5 * MILLISECONDS;
+                for(uint32_t i = 0; i < due; i++) activities[i].activateAt(at);
+                waitForSteps((round + 1) * due);
+            }
+            SPRINTF(caseName, "burst registered=%d due=%d", static_cast<int>(NUM_OF_ACTIVITIES), static_cast<int>(due));
+            benchReport("activity-scaling", caseName, samples);
+        }
+
+        samples.clear();
+        steps = 0;
+        int64_t start = NOW() + 10 * MILLISECONDS;
+        for(uint32_t i = 0; i < NUM_OF_PERIODIC; i++) {
+            activities[i].periodic = true;
+            activities[i].activatePeriodic(start + i * 100 * MICROSECONDS, (10 + i % 10) * MILLISECONDS);
+        }
+        suspendCallerUntil(start + 1 * SECONDS);
+        for(uint32_t i = 0; i < NUM_OF_PERIODIC; i++) activities[i].activateAt(END_OF_TIME);
+        suspendCallerUntil(NOW() + 50 * MILLISECONDS);
+        SPRINTF(caseName, "periodic lateness n=%d", static_cast<int>(NUM_OF_PERIODIC));
+        benchReport("activity-scaling", caseName, samples);
+
+        samples.clear();
+        steps = 0;
+        for(uint32_t i = 0; i < SAMPLES / 10; i++) {
+            resumedActivity.resumedAt = benchCycles();
+            resumedActivity.resume();
+            waitForSteps(i + 1);
+        }
+        benchReport("activity-scaling", "resume from thread", samples);
+
+        hwResetAndReboot();
+    }
+} activityScaling;
@@ -0,0 +1,87 @@
+#include "rodos.h"
+#include "rodos-bench.h"
+
+/**
+ * rodos-bench: wakeup jitter of a periodic thread (1 ms) while load threads
+ * run, in three core partitions (core-partition.h) applied one after the other:
+ *   - shared:  no affinities, SCHED_OTHER, as plain pthreads
+ *   - pinned:  the periodic thread alone on the last core, the load on the
+ *              others (on one core all share it), SCHED_OTHER
+ *   - fifo:    pinned, SCHED_FIFO and mlockall
+ * A sample is the time from the planned wakeup until the thread runs.
+ * fifo needs privileges, the refusals are reported as value.
+ */
+
+static constexpr uint32_t LOADERS = 3;
+static constexpr uint32_t SAMPLES = 2000;
+static constexpr int64_t  PERIOD  = 1 * MILLISECONDS;
+
+static BenchSampleBuffer<SAMPLES> samples;
+
+static CorePartition shared(0, 0, false); // the first one: the configuration at the start
+
+static CorePartitionRule pinnedRules[] = {
+    { "jitterProbe", 0, 0 },
+    { 0, 0, 0 },
+};
+static CorePartition pinned(pinnedRules, 2, false);
+static CorePartition pinnedFifo(pinnedRules, 2, true, true);
+
+/// busy 1 ms, then 3 ms pause, touching memory: all together below 100 % of one core (RT throttling)
+class Loader : public StaticThread<> {
+    uint32_t memory[4096];
+
+  public:
+    Loader() : StaticThread<>("jitterLoad", 20) {}
+    void run() {
+        uint32_t i = 0;
+        while(1) {
+            int64_t end = NOW() + 1 * MILLISECONDS;
+            while(NOW() < end) {
+                memory[(i * 17) % 4096] += i;
+                i++;
+            }
+            suspendCallerUntil(NOW() + 3 * MILLISECONDS);
+        }
+    }
+} loaders[LOADERS];
+
+class JitterProbe : public StaticThread<> {
+  public:
+    JitterProbe() : StaticThread<>("jitterProbe", 200) {}
+
+    void measure(const char* caseName) {
+        double cyclesPerNs = benchCyclesPerSecond() / 1.0e9;
+        samples.clear();
+        int64_t next = NOW() + PERIOD;
+        for(uint32_t i = 0; i < SAMPLES; i++) {
+            suspendCallerUntil(next);
+            int64_t late = NOW() - next;
+            samples.add(static_cast<uint64_t>(static_cast<double>((late > 0) ? late : 0) * cyclesPerNs));
+            next += PERIOD;
+        }
+        benchReport("affinity-jitter", caseName, samples);
+    }
+
+    void run() {
+        benchCyclesPerSecond(); // calibrated before the measurements
+
+        uint64_t allCores = getAffinity();
+        uint64_t lastCore   = (allCores == 0) ? 0 : 1ull << (63 - __builtin_clzll(allCores));
+        uint64_t otherCores = allCores & ~lastCore;
+        if(otherCores == 0) otherCores = lastCore; // one core
+        pinnedRules[0].cpuMask = lastCore;
+        pinnedRules[1].cpuMask = otherCores;
+
+        measure("shared");
+        pinned.apply();
+        measure("pinned");
+        pinnedFifo.apply();
+        measure("pinned fifo mlock");
+
+        char caseName[40];
+        SPRINTF(caseName, "cores=%d", static_cast<int>(__builtin_popcountll(allCores)));
+        benchReportValue("affinity-jitter", caseName, "refusals", CorePartition::refusals);
+        hwResetAndReboot();
+    }
+} jitterProbe;
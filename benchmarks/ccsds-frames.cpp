@@ -0,0 +1,202 @@
+#include "rodos.h"
+#include "ccsds/ccsds-envelop.h"
+#include "ccsds/tm-frame-multiplexer.h"
+
+#include "ccsds/ccsds-envelop-for-spacecraft.cpp" // not in the rodos library
+
+/**
+ * Downlink transfer frames of 1000 bytes (CLCW and CRC) with a mix of
+ * source packet sizes, built on one core:
+ *   - DownlinkEnvelop: header fields through setBitField, the packets of a
+ *     frame one after the other, the rest of a frame is an idle packet
+ *   - TmFrameMultiplexer: packets written into the frame buffers of 3 virtual
+ *     channels, packets continue in the next frame, round robin
+ * Both with 16 bytes of packet headers (primary and secondary).
+ * Frames per second on one core (the CRC of each frame is most of it), the
+ * part of the frames used for user data, and user data per second.
+ * The frames of the multiplexer are read back: CRC and packets.
+ * At last the scheduling with shares 3:1 when both channels have frames.
+ */
+
+using namespace CCSDS;
+
+static constexpr uint32_t NUM_OF_FRAMES = 20000;
+static constexpr uint16_t SP_HEADER_LEN = 16; // primary and secondary header, like DownlinkSPHeader
+
+/// user data lengths: housekeeping, events, a large science packet
+static const uint16_t mix[] = { 40, 40, 120, 16, 40, 300, 40, 16, 600, 40 };
+static constexpr uint32_t MIX_LEN = sizeof(mix) / sizeof(mix[0]);
+
+static DownlinkEnvelop                   envelop;
+using Multiplexer = TmFrameMultiplexer<1000, 3, 4>;
+
+static Multiplexer                    multiplexer(321);
+static Multiplexer                    checked(321);
+static TmFrameMultiplexer<1000, 2, 4> shared(321);
+static uint8_t                        userData[1000];
+
+static void writeSpHeader(uint8_t* header, uint16_t apid, uint16_t seqCnt, uint16_t userDataLen) {
+    uint16_t dataPackLen = static_cast<uint16_t>(SP_HEADER_LEN - 6 + userDataLen - 1);
+    header[0] = static_cast<uint8_t>(0x08 | ((apid >> 8) & 0x07)); // secondary header follows
+    header[1] = static_cast<uint8_t>(apid & 0xff);
+    header[2] = static_cast<uint8_t>(0xc0 | ((seqCnt >> 8) & 0x3f));
+    header[3] = static_cast<uint8_t>(seqCnt & 0xff);
+    header[4] = static_cast<uint8_t>(dataPackLen >> 8);
+    header[5] = static_cast<uint8_t>(dataPackLen & 0xff);
+    for(uint16_t i = 6; i < SP_HEADER_LEN; i++) header[i] = 0;
+}
+
+/// one packet of the mix into the multiplexer, false if its frames are full
+static bool writePacket(Multiplexer& multiplexer, uint8_t vcid, uint32_t index) {
+    uint16_t   len  = static_cast<uint16_t>(SP_HEADER_LEN + mix[index % MIX_LEN]);
+    PacketSlot slot = multiplexer.reservePacket(vcid, len);
+    if(!slot.isValid()) return false;
+    uint8_t header[SP_HEADER_LEN];
+    writeSpHeader(header, static_cast<uint16_t>(100 + vcid), static_cast<uint16_t>(index), mix[index % MIX_LEN]);
+    if(slot.isContiguous()) {
+        for(uint16_t i = 0; i < SP_HEADER_LEN; i++) slot.part[0][i] = header[i];
+        for(uint16_t i = SP_HEADER_LEN; i < len; i++) slot.part[0][i] = userData[i]; // like a serializer writing in place
+    } else {
+        slot.write(0, header, SP_HEADER_LEN);
+        slot.write(SP_HEADER_LEN, userData, mix[index % MIX_LEN]);
+    }
+    multiplexer.commitPacket(vcid);
+    return true;
+}
+
+/// per virtual channel the stream of packets across the frames
+struct ChannelReader {
+    uint8_t  header[6]; ///< a primary header may continue in the next frame
+    uint16_t headerBytes;
+    uint32_t toSkip; ///< rest of the current packet
+    uint32_t packetsFound;
+};
+static ChannelReader readers[3];
+static uint32_t      badFrames;
+
+static void readBack(const uint8_t* frame) {
+    uint16_t crc = crcChecker.computeCRC(frame, 1000 - 2, CRC_SEED);
+    if(crc != ((frame[998] << 8) | frame[999])) badFrames++;
+    uint8_t  vcid        = static_cast<uint8_t>((frame[1] >> 1) & 0x07);
+    uint16_t firstHeader = static_cast<uint16_t>(((frame[4] & 0x07) << 8) | frame[5]);
+    if(vcid >= 3 || firstHeader == FHP_IDLE_FRAME) return;
+
+    ChannelReader& reader     = readers[vcid];
+    uint16_t       dataEnd    = 1000 - TF_OCF_SIZE - TF_FECF_SIZE;
+    uint16_t       firstStart = FHP_NO_PACKET_START;
+    uint16_t       pos        = TF_PRIMARY_HEADER_SIZE;
+    while(pos < dataEnd) {
+        if(reader.toSkip > 0) {
+            uint32_t skip = (reader.toSkip < static_cast<uint32_t>(dataEnd - pos)) ? reader.toSkip : dataEnd - pos;
+            reader.toSkip -= skip;
+            pos = static_cast<uint16_t>(pos + skip);
+            continue;
+        }
+        if(reader.headerBytes == 0 && firstStart == FHP_NO_PACKET_START) firstStart = static_cast<uint16_t>(pos - TF_PRIMARY_HEADER_SIZE);
+        reader.header[reader.headerBytes++] = frame[pos++];
+        if(reader.headerBytes < 6) continue;
+        uint16_t apid = static_cast<uint16_t>(((reader.header[0] & 0x07) << 8) | reader.header[1]);
+        if(apid != IDLE_APID) reader.packetsFound++;
+        reader.toSkip      = static_cast<uint32_t>(((reader.header[4] << 8) | reader.header[5]) + 1);
+        reader.headerBytes = 0;
+    }
+    if(firstStart != firstHeader) badFrames++;
+}
+
+/// producers fill their channels, the downlink takes 3 frames, and again
+static uint64_t sendFrames(Multiplexer& multiplexer, bool readFramesBack) {
+    uint32_t packets[3] = { 0, 0, 0 };
+    uint64_t user       = 0;
+    uint32_t frames     = 0;
+    while(frames < NUM_OF_FRAMES) {
+        for(uint8_t vcid = 0; vcid < 3; vcid++) {
+            while(writePacket(multiplexer, vcid, packets[vcid])) {
+                user += mix[packets[vcid] % MIX_LEN];
+                packets[vcid]++;
+            }
+        }
+        for(uint32_t i = 0; i < 3 && frames < NUM_OF_FRAMES; i++, frames++) {
+            const uint8_t* frame = multiplexer.nextFrame();
+            if(readFramesBack) readBack(frame);
+            multiplexer.releaseFrame();
+        }
+    }
+    if(readFramesBack) { // the rest
+        for(uint8_t vcid = 0; vcid < 3; vcid++) multiplexer.flush(vcid);
+        for(uint32_t i = 0; i < 3 * 4 + 1; i++) { // all queued frames and one idle frame
+            readBack(multiplexer.nextFrame());
+            multiplexer.releaseFrame();
+        }
+    }
+    return user;
+}
+
+class CcsdsFramesBenchmark : public StaticThread<> {
+  public:
+    CcsdsFramesBenchmark() : StaticThread<>("ccsdsFramesBenchmark", 300) {}
+
+    void run() {
+        for(uint32_t i = 0; i < sizeof(userData); i++) userData[i] = static_cast<uint8_t>(i);
+
+        //________________________________________________ DownlinkEnvelop
+        envelop.initDefaultTFHeaderAndTrailer(321);
+        uint32_t index       = 0;
+        uint64_t envelopUser = 0;
+        int64_t  start       = NOW();
+        for(uint32_t f = 0; f < NUM_OF_FRAMES; f++) {
+            envelop.beginNewTF();
+            envelop.tfHeader.virtualChanId = static_cast<uint8_t>(f % 3);
+            while(true) {
+                envelop.initDefaultSPHeader();
+                uint16_t maxLen = envelop.beginNewSP();
+                uint16_t len    = mix[index % MIX_LEN];
+                if(maxLen < len) break;
+                memcpy(envelop.userDataBuf, userData, len);
+                envelop.lenOfCurrentUserData = len;
+                envelop.spHeader.applicationId = static_cast<uint16_t>(100 + f % 3);
+                envelop.commitSP();
+                envelopUser += len;
+                index++;
+            }
+            envelop.commitTF();
+        }
+        int64_t envelopTime = NOW() - start;
+
+        //________________________________________________ TmFrameMultiplexer
+        start            = NOW();
+        uint64_t muxUser = sendFrames(multiplexer, false);
+        int64_t  muxTime = NOW() - start;
+
+        PRINTF("%d frames of 1000 bytes, packets of %d..%d bytes\n", static_cast<int>(NUM_OF_FRAMES), 16 + SP_HEADER_LEN,
+               600 + SP_HEADER_LEN);
+        PRINTF("  DownlinkEnvelop     %d frames/s, %d%% of the frames for user data, %d KB/s user data\n",
+               static_cast<int>(static_cast<int64_t>(NUM_OF_FRAMES) * SECONDS / envelopTime),
+               static_cast<int>(envelopUser * 100 / (NUM_OF_FRAMES * 1000ull)),
+               static_cast<int>(static_cast<int64_t>(envelopUser) * SECONDS / envelopTime / 1024));
+        PRINTF("  TmFrameMultiplexer  %d frames/s, %d%% of the frames for user data, %d KB/s user data\n",
+               static_cast<int>(static_cast<int64_t>(NUM_OF_FRAMES) * SECONDS / muxTime),
+               static_cast<int>(muxUser * 100 / (NUM_OF_FRAMES * 1000ull)),
+               static_cast<int>(static_cast<int64_t>(muxUser) * SECONDS / muxTime / 1024));
+
+        //________________________________________________ read back
+        sendFrames(checked, true);
+        uint32_t written = checked.getStatistics(0).packets + checked.getStatistics(1).packets + checked.getStatistics(2).packets;
+        PRINTF("read back: CRC or first header pointer wrong in %d frames, packets found %d of %d\n", static_cast<int>(badFrames),
+               static_cast<int>(readers[0].packetsFound + readers[1].packetsFound + readers[2].packetsFound), static_cast<int>(written));
+
+        //________________________________________________ shares
+        shared.setScheduling(VcScheduling::BANDWIDTH_SHARE);
+        shared.setShare(0, 3);
+        shared.setShare(1, 1);
+        for(uint32_t i = 0; i < 400; i++) {
+            for(uint8_t vcid = 0; vcid < 2; vcid++) {
+                while(shared.writePacket(vcid, userData, 200)) {}
+            }
+            shared.nextFrame();
+            shared.releaseFrame();
+        }
+        PRINTF("bandwidth share 3:1, frames %d : %d, idle %d\n", static_cast<int>(shared.getStatistics(0).frames),
+               static_cast<int>(shared.getStatistics(1).frames), static_cast<int>(shared.idleFrames));
+        hwResetAndReboot();
+    }
+} ccsdsFramesBenchmark;
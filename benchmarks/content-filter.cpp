@@ -0,0 +1,152 @@
+#include "rodos.h"
+
+/**
+ * Content filters: a telemetry topic with many consumers, each one
+ * interested in the samples of one of 20 instruments.
+ *   - local: CPU time per published message and deliveries, when each
+ *     consumer gets all messages and drops the others in its putter (as before)
+ *     or uses Subscriber::setContentFilter (the topic evaluates the filter)
+ *   - link: messages and bytes sent to another node which wants only one
+ *     instrument, without and with Gateway::setContentFilterExport
+ * The publisher is the only thread which runs, the time is its CPU time.
+ */
+
+static constexpr uint32_t NUM_OF_CONSUMERS = 20;
+static constexpr uint32_t NUM_OF_MSGS      = 20000;
+
+struct Sample {
+    uint16_t instrument;
+    uint16_t status;
+    int64_t  time;
+    float    values[8];
+};
+
+/// filtering by hand: every message gets through the semaphore and into put
+class InstrumentPutter : public Putter {
+  public:
+    uint16_t           instrument = 0;
+    uint32_t           calls      = 0;
+    CommBuffer<Sample> latest;
+    bool putGeneric(const uint32_t topicId, const size_t len, const void* msg, const NetMsgInfo& netMsgInfo) override {
+        calls++;
+        if(static_cast<const Sample*>(msg)->instrument != instrument) return true;
+        return latest.putGeneric(topicId, len, msg, netMsgInfo);
+    }
+};
+
+class CountingLink : public Linkinterface {
+  public:
+    uint32_t       msgs  = 0;
+    uint32_t       bytes = 0;
+    NetworkMessage toReceive;
+    bool           hasToReceive = false;
+
+    CountingLink() : Linkinterface(-1) {}
+    bool sendNetworkMsg(NetworkMessage& outgoingMessage) override {
+        if(outgoingMessage.get_topicId() == TOPIC_ID_FOR_CONTENT_FILTER_REPORT) return true;
+        msgs++;
+        bytes += outgoingMessage.numberOfBytesToSend();
+        return true;
+    }
+    bool getNetworkMsg(NetworkMessage& inMsg, int32_t& numberOfReceivedBytes) override {
+        if(!hasToReceive) return false;
+        inMsg                 = toReceive;
+        numberOfReceivedBytes = -1;
+        hasToReceive          = false;
+        return true;
+    }
+    void suspendUntilDataReady(int64_t reactivationTime) override { Thread::suspendCallerUntil(reactivationTime); }
+};
+
+static Topic<Sample> telemetry(3700, "telemetry");
+static CountingLink  countingLink;
+static Gateway       gateway(&countingLink, true, false); // enabled only for the link part
+
+struct Consumer {
+    InstrumentPutter byHand;
+    Subscriber       subscriber;
+    ContentFilter    filter;
+    Consumer() : subscriber(telemetry, byHand, "consumer") {}
+};
+static Consumer consumers[NUM_OF_CONSUMERS];
+
+static void setFiltered(bool filtered) {
+    for(uint16_t i = 0; i < NUM_OF_CONSUMERS; i++) {
+        consumers[i].byHand.instrument = i;
+        consumers[i].byHand.calls      = 0;
+        consumers[i].filter.clear();
+        consumers[i].filter.compare(offsetof(Sample, instrument), FieldType::U16, FilterOp::EQ, i);
+        consumers[i].subscriber.setContentFilter(filtered ? &consumers[i].filter : 0);
+    }
+}
+
+static int64_t publishAll() {
+    Sample sample;
+    memset(&sample, 0, sizeof(sample));
+    int64_t start = NOW();
+    for(uint32_t i = 0; i < NUM_OF_MSGS; i++) {
+        sample.instrument = static_cast<uint16_t>(i % NUM_OF_CONSUMERS);
+        sample.time       = static_cast<int64_t>(i);
+        telemetry.publish(sample);
+    }
+    return (NOW() - start) / NUM_OF_MSGS;
+}
+
+static uint32_t putCalls() {
+    uint32_t calls = 0;
+    for(Consumer& consumer : consumers) calls += consumer.byHand.calls;
+    return calls;
+}
+
+class ContentFilterBenchmark : public StaticThread<> {
+  public:
+    ContentFilterBenchmark() : StaticThread<>("contentFilterBenchmark", 300) {}
+
+    void run() {
+        setNodeNumber(0);
+        PRINTF("%d consumers, %d messages of %d bytes\n", static_cast<int>(NUM_OF_CONSUMERS), static_cast<int>(NUM_OF_MSGS),
+               static_cast<int>(sizeof(Sample)));
+
+        //________________________________________________ local
+        setFiltered(false);
+        int64_t  byHand      = publishAll();
+        uint32_t byHandCalls = putCalls();
+        setFiltered(true);
+        int64_t  filtered      = publishAll();
+        uint32_t filteredCalls = putCalls();
+
+        PRINTF("local\n");
+        PRINTF("  filter in the putter  %d ns/msg, %d put calls\n", static_cast<int>(byHand), static_cast<int>(byHandCalls));
+        PRINTF("  setContentFilter      %d ns/msg, %d put calls, %d%% CPU saved\n", static_cast<int>(filtered),
+               static_cast<int>(filteredCalls), static_cast<int>(100 - filtered * 100 / byHand));
+
+        //________________________________________________ link
+        for(Consumer& consumer : consumers) consumer.subscriber.enable(false);
+        gateway.enable(true);
+
+        countingLink.msgs = countingLink.bytes = 0;
+        publishAll();
+        uint32_t allMsgs = countingLink.msgs, allBytes = countingLink.bytes;
+
+        gateway.setContentFilterExport();
+        ContentFilter oneInstrument; // node 7 wants only instrument 3
+        oneInstrument.compare(offsetof(Sample, instrument), FieldType::U16, FilterOp::EQ, 3);
+        uint8_t report[4 + 1 + ContentFilter::MAX_INSTRUCTIONS * ContentFilter::SERIALIZED_INSTRUCTION_SIZE];
+        uint32_tToBigEndian(report, telemetry.topicId);
+        NetMsgInfo info;
+        info.senderNode = 7;
+        info.sequenceNr = 1;
+        prepareNetworkMessage(countingLink.toReceive, TOPIC_ID_FOR_CONTENT_FILTER_REPORT, report,
+                              4 + oneInstrument.serialize(report + 4, sizeof(report) - 4), info);
+        countingLink.hasToReceive = true;
+        suspendCallerUntil(NOW() + 50 * MILLISECONDS);
+
+        countingLink.msgs = countingLink.bytes = 0;
+        int64_t exported = publishAll();
+        PRINTF("link, the other node wants 1 of %d instruments\n", static_cast<int>(NUM_OF_CONSUMERS));
+        PRINTF("  without export  %d msgs %d KB\n", static_cast<int>(allMsgs), static_cast<int>(allBytes / 1024));
+        PRINTF("  with export     %d msgs %d KB, %d filtered, %d ns/msg\n", static_cast<int>(countingLink.msgs),
+               static_cast<int>(countingLink.bytes / 1024), static_cast<int>(gateway.contentFilteredMsgs), static_cast<int>(exported));
+        hwResetAndReboot();
+    }
+} contentFilterBenchmark;
@@ -0,0 +1,132 @@
+#include "rodos.h"
+#include "rodos-bench.h"
+
+/**
+ * rodos-bench: cost of Thread::yield()
+ *   - alone: no other thread is ready, no switch
+ *   - threads=2, 4: the threads yield in turns, one sample is one round
+ *     through all of them
+ * and of a switch by resume(): a thread resumes the suspended other one and
+ * suspends itself, from before resume() until the other one runs.
+ * linux-makecontext: compare the assembly switch with swapcontext, configure
+ * with -DMAKECONTEXT_UCONTEXT_SWITCH=ON and run both.
+ */
+
+static constexpr uint32_t MAX_YIELDERS = 4;
+static constexpr uint32_t SAMPLES      = 20000;
+
+static BenchSampleBuffer<SAMPLES> samples;
+
+static Atomic<int32_t> yielders(0);
+static Atomic<int32_t> phase(0);
+static Atomic<int32_t> done(0);
+
+class Yielder : public StaticThread<> {
+    uint32_t index;
+
+  public:
+    Yielder() : StaticThread<>("yielder") {
+        static uint32_t numOfYielders = 0;
+        index                         = numOfYielders++;
+    }
+
+    void run() {
+        int32_t lastPhase = 0;
+        while(1) {
+            while(phase.load() == lastPhase) suspendCallerUntil(NOW() + 1 * MILLISECONDS);
+            lastPhase = phase.load();
+            if(index >= static_cast<uint32_t>(yielders.load())) continue;
+            for(uint32_t i = 0; i < SAMPLES; i++) {
+                uint64_t start = benchCycles();
+                yield();
+                if(index == 0) samples.add(benchCycles() - start);
+            }
+            done++;
+        }
+    }
+} yielderThreads[MAX_YIELDERS];
+
+//________________________________________________ switch by resume
+
+static uint64_t       resumedAt = 0;
+static Atomic<int32_t> turn(-1); ///< 0: ping, 1: pong
+static Thread*        pingThread;
+static Thread*        pongThread;
+
+/**
+ * A resume() before the other one suspended is lost: on preemptive bare-metal
+ * ports the other one can be preempted between its resume() and its suspend.
+ * The turn is checked again after a timeout then (an outlier, no deadlock).
+ */
+static void waitForTurn(int32_t myTurn) {
+    while(turn.load() != myTurn) Thread::suspendCallerUntil(NOW() + 10 * MILLISECONDS);
+}
+
+static void handOver(Thread* other, int32_t otherTurn) {
+    resumedAt = benchCycles();
+    turn      = otherTurn;
+    other->resume();
+}
+
+class Ping : public StaticThread<> {
+  public:
+    Ping() : StaticThread<>("ping", 150) {}
+    void run() {
+        pingThread = this;
+        waitForTurn(0);
+        for(uint32_t i = 0; i < SAMPLES / 2; i++) {
+            samples.add(benchCycles() - resumedAt);
+            handOver(pongThread, 1);
+            waitForTurn(0);
+        }
+        done++;
+    }
+} ping;
+
+class Pong : public StaticThread<> {
+  public:
+    Pong() : StaticThread<>("pong", 150) {}
+    void run() {
+        pongThread = this;
+        waitForTurn(1);
+        for(uint32_t i = 0; i < SAMPLES / 2; i++) {
+            samples.add(benchCycles() - resumedAt);
+            handOver(pingThread, 0);
+            waitForTurn(1);
+        }
+    }
+} pong;
+
+class ContextSwitch : public StaticThread<> {
+  public:
+    ContextSwitch() : StaticThread<>("contextSwitch", 200) {}
+
+    void run() {
+        samples.clear();
+        for(uint32_t i = 0; i < SAMPLES; i++) {
+            uint64_t start = benchCycles();
+            yield();
+            samples.add(benchCycles() - start);
+        }
+        benchReport("context-switch", "yield alone", samples);
+
+        char caseName[40];
+        for(int32_t n = 2; n <= static_cast<int32_t>(MAX_YIELDERS); n *= 2) {
+            samples.clear();
+            done     = 0;
+            yielders = n;
+            phase++;
+            while(done.load() < n) suspendCallerUntil(NOW() + 1 * MILLISECONDS);
+            SPRINTF(caseName, "yield threads=%d", static_cast<int>(n));
+            benchReport("context-switch", caseName, samples);
+        }
+
+        samples.clear();
+        done = 0;
+        suspendCallerUntil(NOW() + 10 * MILLISECONDS); // both suspended
+        handOver(pingThread, 0);
+        while(done.load() < 1) suspendCallerUntil(NOW() + 1 * MILLISECONDS);
+        benchReport("context-switch", "resume", samples);
+        hwResetAndReboot();
+    }
+} contextSwitch;
@@ -0,0 +1,68 @@
+#include "rodos.h"
+#include "rodos-bench.h"
+
+/**
+ * rodos-bench: overhead of the CPU time accounting (thread-load.h)
+ *   - getCpuTime() of the calling thread and of another thread
+ *   - suspend round trip: suspendCallerUntil(now) including the accounting
+ *     of the end and the begin of an activation
+ *   - ThreadLoadMonitor::report() over all threads of this benchmark
+ */
+
+static constexpr uint32_t SLEEPERS = 12;
+static constexpr uint32_t SAMPLES      = 20000;
+
+static BenchSampleBuffer<SAMPLES> samples;
+
+class Sleeper : public StaticThread<> {
+  public:
+    Sleeper() : StaticThread<>("sleeper", 50) {}
+    void run() { suspendCallerUntil(END_OF_TIME); }
+} sleeperThreads[SLEEPERS];
+
+static ThreadLoadMonitor monitor(END_OF_TIME / 2); // reports only when asked
+
+class CpuAccounting : public StaticThread<> {
+  public:
+    CpuAccounting() : StaticThread<>("cpuAccounting", 200) {}
+
+    void run() {
+        int64_t sum = 0;
+        samples.clear();
+        for(uint32_t i = 0; i < SAMPLES; i++) {
+            uint64_t start = benchCycles();
+            sum += getCpuTime();
+            samples.add(benchCycles() - start);
+        }
+        benchReport("cpu-accounting", "getCpuTime own", samples);
+
+        samples.clear();
+        for(uint32_t i = 0; i < SAMPLES; i++) {
+            uint64_t start = benchCycles();
+            sum += sleeperThreads[0].getCpuTime();
+            samples.add(benchCycles() - start);
+        }
+        benchReport("cpu-accounting", "getCpuTime other", samples);
+
+        samples.clear();
+        for(uint32_t i = 0; i < SAMPLES; i++) {
+            uint64_t start = benchCycles();
+            suspendCallerUntil(NOW());
+            samples.add(benchCycles() - start);
+        }
+        benchReport("cpu-accounting", "suspend round trip", samples);
+
+        samples.clear();
+        for(uint32_t i = 0; i < SAMPLES / 10; i++) {
+            uint64_t start = benchCycles();
+            monitor.report();
+            samples.add(benchCycles() - start);
+        }
+        char caseName[40];
+        SPRINTF(caseName, "report threads=%d", static_cast<int>(monitor.lastReportMsg.numOfThreads));
+        benchReport("cpu-accounting", caseName, samples);
+
+        if(sum < 0) PRINTF("impossible\n"); // sum is used
+        hwResetAndReboot();
+    }
+} cpuAccounting;
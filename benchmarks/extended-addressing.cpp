@@ -0,0 +1,150 @@
+#include "rodos.h"
+
+/**
+ * Simulated swarm of 256 nodes in one process: this node (0) is a router
+ * with 8 links, 32 nodes behind each link (node n behind link n / 32, a bus
+ * where all nodes of the link get each message). Topics with 1..64 random
+ * receivers, addressed with receiverNodesBitMap (32 bits: each bit means
+ * 8 nodes) or with the NodeSet extension (Router::setExtendedAddressing).
+ * Measured: link messages and bytes per published message, nodes which
+ * get a message not for them (with the bitmap they can not know it, with
+ * the node set the gateway drops it: NodeSet::contains) and the time
+ * to route a message.
+ */
+
+static constexpr uint32_t NUM_OF_SIM_NODES = 256;
+static constexpr uint32_t NUM_OF_LINKS     = 8;
+static constexpr uint32_t NODES_PER_LINK   = NUM_OF_SIM_NODES / NUM_OF_LINKS;
+static constexpr uint32_t NUM_OF_TOPICS    = 32;
+static constexpr uint32_t MSGS_PER_TOPIC   = 50;
+
+static_assert(MAX_ADDRESSABLE_NODES >= NUM_OF_SIM_NODES, "needs MAX_ADDRESSABLE_NODES 256: on-posix only, see CMakeLists.txt");
+
+class CountingLink : public Linkinterface {
+  public:
+    uint32_t msgs  = 0;
+    uint32_t bytes = 0;
+    CountingLink() : Linkinterface(-1) {}
+    bool sendNetworkMsg(NetworkMessage& outgoingMessage) override {
+        msgs++;
+        bytes += outgoingMessage.numberOfBytesToSend();
+        return true;
+    }
+    void suspendUntilDataReady(int64_t reactivationTime) override { Thread::suspendCallerUntil(reactivationTime); }
+};
+
+struct Telemetry {
+    uint8_t data[32];
+};
+
+static CountingLink links[NUM_OF_LINKS];
+static Gateway      gateways[NUM_OF_LINKS] = { // the router sends, not the gateways
+    { &links[0], true, false }, { &links[1], true, false }, { &links[2], true, false }, { &links[3], true, false },
+    { &links[4], true, false }, { &links[5], true, false }, { &links[6], true, false }, { &links[7], true, false }
+};
+static Router router;
+
+static uint32_t nextTopicId = 5000;
+struct SwarmTopic {
+    Topic<Telemetry> topic;
+    SwarmTopic() : topic(static_cast<int64_t>(nextTopicId++), "swarmTopic") {}
+};
+static SwarmTopic topics[NUM_OF_TOPICS];
+
+static uint32_t randomState = 12345;
+static uint32_t randomNode() {
+    randomState = randomState * 1103515245u + 12345u;
+    return 1 + (randomState >> 8) % (NUM_OF_SIM_NODES - 1);
+}
+
+static void arrivesFrom(uint32_t linkIndex, int32_t senderNode) {
+    NetworkMessage msg;
+    NetMsgInfo     info;
+    int32_t        data = 0;
+    info.senderNode = senderNode;
+    info.sequenceNr = 1;
+    prepareNetworkMessage(msg, 3000, &data, sizeof(data), info);
+    info.linkId = links[linkIndex].getLinkdentifier();
+    router.put(3000, sizeof(msg), &msg, info);
+}
+
+struct Result {
+    uint32_t linkMsgs;
+    uint32_t linkBytes;
+    uint32_t wrongDeliveries; ///< nodes which get a message which is not for them
+    int64_t  routingTime;
+};
+
+/** Publishes all topics; per link message: which nodes behind the link take it */
+static Result publishAll(bool extended) {
+    Result    result = { 0, 0, 0, 0 };
+    Telemetry telemetry;
+    memset(&telemetry, 0, sizeof(telemetry));
+    router.setExtendedAddressing(extended);
+
+    for(uint32_t t = 0; t < NUM_OF_TOPICS; t++) {
+        TopicInterface& topic = topics[t].topic;
+        for(uint32_t m = 0; m < MSGS_PER_TOPIC; m++) {
+            uint32_t before[NUM_OF_LINKS];
+            for(uint32_t l = 0; l < NUM_OF_LINKS; l++) before[l] = links[l].msgs;
+
+            int64_t start = NOW();
+            topics[t].topic.publish(telemetry);
+            result.routingTime += NOW() - start;
+
+            for(uint32_t l = 0; l < NUM_OF_LINKS; l++) {
+                if(links[l].msgs == before[l]) continue;
+                for(uint32_t node = l * NODES_PER_LINK; node < (l + 1) * NODES_PER_LINK; node++) {
+                    bool takesIt = extended ? topic.receiverNodes.contains(node)
+                                            : (topic.receiverNodesBitMap >> (node % 32)) & 0x01;
+                    if(takesIt && !topic.receiverNodes.contains(node)) result.wrongDeliveries++;
+                }
+            }
+        }
+    }
+    for(uint32_t l = 0; l < NUM_OF_LINKS; l++) {
+        result.linkMsgs += links[l].msgs;
+        result.linkBytes += links[l].bytes;
+        links[l].msgs = links[l].bytes = 0;
+    }
+    return result;
+}
+
+static void printResult(const char* name, const Result& result) {
+    uint32_t numOfMsgs = NUM_OF_TOPICS * MSGS_PER_TOPIC;
+    PRINTF("    %s: %d.%02d link msgs, %d bytes, %d.%02d wrong nodes per msg, %d ns to route\n", name,
+           static_cast<int>(result.linkMsgs / numOfMsgs), static_cast<int>((result.linkMsgs * 100 / numOfMsgs) % 100),
+           static_cast<int>(result.linkBytes / numOfMsgs), static_cast<int>(result.wrongDeliveries / numOfMsgs),
+           static_cast<int>((result.wrongDeliveries * 100 / numOfMsgs) % 100), static_cast<int>(result.routingTime / numOfMsgs));
+}
+
+class ExtendedAddressingBenchmark : public StaticThread<> {
+  public:
+    ExtendedAddressingBenchmark() : StaticThread<>("extendedAddressingBenchmark", 300) {}
+
+    void init() {
+        for(Gateway& gateway : gateways) router.addGateway(&gateway);
+        router.setRouteLearning();
+    }
+
+    void run() {
+        setNodeNumber(0);
+        for(uint32_t node = 1; node < NUM_OF_SIM_NODES; node++) arrivesFrom(node / NODES_PER_LINK, static_cast<int32_t>(node));
+        for(CountingLink& link : links) link.msgs = link.bytes = 0; // the learning messages were routed too
+
+        PRINTF("%d nodes, %d links, %d messages per case\n", static_cast<int>(NUM_OF_SIM_NODES), static_cast<int>(NUM_OF_LINKS),
+               static_cast<int>(NUM_OF_TOPICS * MSGS_PER_TOPIC));
+        static const uint32_t receiversPerTopic[] = { 1, 4, 16, 64 };
+        for(uint32_t numOfReceivers : receiversPerTopic) {
+            for(SwarmTopic& swarmTopic : topics) {
+                swarmTopic.topic.receiverNodes.clear();
+                swarmTopic.topic.receiverNodesBitMap = 0;
+                for(uint32_t r = 0; r < numOfReceivers; r++) swarmTopic.topic.addReceiverNode(randomNode());
+            }
+            PRINTF("  %d receivers per topic\n", static_cast<int>(numOfReceivers));
+            printResult("bitmap  ", publishAll(false));
+            printResult("node set", publishAll(true));
+        }
+        hwResetAndReboot();
+    }
+} extendedAddressingBenchmark;
@@ -0,0 +1,89 @@
+#include "rodos.h"
+#include "rodos-bench.h"
+
+/**
+ * rodos-bench: Fifo and SyncFifo of uint64_t (64 entries)
+ *   - put + get in one thread, latency
+ *   - a producer and a consumer thread, items per second: Fifo with yield
+ *     when it is full/empty, SyncFifo with syncPut/syncGet
+ */
+
+static constexpr uint32_t SAMPLES = 20000;
+static constexpr uint32_t ITEMS   = 200000;
+
+static Fifo<uint64_t, 64>     fifo;
+static SyncFifo<uint64_t, 64> syncFifo;
+
+static BenchSampleBuffer<SAMPLES> samples;
+
+static Atomic<int32_t> phase(0); // 1: Fifo, 2: SyncFifo
+static Atomic<int32_t> consumed(0);
+static int64_t         producerStart = 0;
+static int64_t         consumerEnd   = 0;
+static uint64_t        checksum      = 0;
+
+static void waitForPhase(int32_t wanted) {
+    while(phase.load() != wanted) Thread::suspendCallerUntil(NOW() + 1 * MILLISECONDS);
+}
+
+class Producer : public StaticThread<> {
+  public:
+    Producer() : StaticThread<>("fifoProducer") {}
+    void run() {
+        waitForPhase(1);
+        producerStart = NOW();
+        for(uint64_t i = 0; i < ITEMS; i++) {
+            while(!fifo.put(i)) yield();
+        }
+        waitForPhase(2);
+        producerStart = NOW();
+        for(uint64_t i = 0; i < ITEMS; i++) syncFifo.syncPut(i);
+    }
+} producer;
+
+class Consumer : public StaticThread<> {
+  public:
+    Consumer() : StaticThread<>("fifoConsumer") {}
+    void run() {
+        uint64_t item;
+        waitForPhase(1);
+        for(uint32_t i = 0; i < ITEMS; i++) {
+            while(!fifo.get(item)) yield();
+            checksum += item;
+        }
+        consumerEnd = NOW();
+        consumed    = 1;
+        waitForPhase(2);
+        for(uint32_t i = 0; i < ITEMS; i++) {
+            syncFifo.syncGet(item);
+            checksum += item;
+        }
+        consumerEnd = NOW();
+        consumed    = 2;
+    }
+} consumer;
+
+class FifoThroughput : public StaticThread<> {
+  public:
+    FifoThroughput() : StaticThread<>("fifoThroughput", 200) {}
+
+    void run() {
+        uint64_t item = 0;
+        for(uint32_t i = 0; i < SAMPLES; i++) {
+            uint64_t start = benchCycles();
+            fifo.put(i);
+            fifo.get(item);
+            samples.add(benchCycles() - start);
+        }
+        benchReport("fifo-throughput", "put+get", samples);
+
+        static const char* cases[] = { "", "fifo yield", "syncFifo" };
+        for(int32_t p = 1; p <= 2; p++) {
+            phase = p;
+            while(consumed.load() != p) suspendCallerUntil(NOW() + 1 * MILLISECONDS);
+            benchReportValue("fifo-throughput", cases[p], "items/s", static_cast<double>(ITEMS) * SECONDS / static_cast<double>(consumerEnd - producerStart));
+        }
+        if(checksum != 2 * (static_cast<uint64_t>(ITEMS) * (ITEMS - 1) / 2)) PRINTF("items lost\n");
+        hwResetAndReboot();
+    }
+} fifoThroughput;
@@ -0,0 +1,131 @@
+#include "rodos.h"
+#include "mapped-recorder-storage.h" // posix
+
+/**
+ * Flight recorder: CPU time per published message (64 bytes) of
+ *   - no recording
+ *   - a catch-all subscriber which writes each message as text (SPRINTF,
+ *     like a PRINTF log, without the output itself)
+ *   - FlightRecorder in RAM (RamRecorderStorage)
+ *   - FlightRecorder in memory mapped files (MappedRecorderStorage, /tmp)
+ * and the replay of the records: all as fast as possible (messages and MB
+ * per second), and the last 1% of the time, found through the index.
+ * The publisher is the only thread which runs, the time is its CPU time.
+ */
+
+static constexpr uint32_t NUM_OF_MSGS = 100000;
+
+struct Attitude {
+    int64_t time;
+    float   quaternion[4];
+    float   rates[3];
+    float   covariance[6];
+    int32_t mode;
+};
+
+static Topic<Attitude> attitude(3800, "attitude");
+
+/// the message as a line of text: topic, time, bytes in hex
+class TextLogger : public Subscriber {
+  public:
+    char     line[SPRINTF_MAX_SIZE];
+    uint32_t lines = 0;
+    TextLogger() : Subscriber(defaultGatewayTopic, "textLogger") {}
+    uint32_t put(const uint32_t topicId, const size_t len, void* data, const NetMsgInfo& netMsgInfo) override {
+        if(!isEnabled) return 0;
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        char*          pos   = line;
+        SPRINTF(pos, "%d %lld", static_cast<int>(topicId), static_cast<long long>(netMsgInfo.sentTime));
+        pos += strlen(pos);
+        for(size_t i = 0; i < len; i++, pos += 3) SPRINTF(pos, " %02x", bytes[i]);
+        lines++;
+        return 0;
+    }
+};
+
+static TextLogger                        textLogger;
+static RamRecorderStorage<64 * 1024, 16> ram;
+static FlightRecorder                    ramRecorder(ram, "ramRecorder");
+static MappedRecorderStorage             files("/tmp/rodos-flight-recorder", 16, 1024 * 1024);
+static FlightRecorder                    fileRecorder(files, "fileRecorder");
+
+static uint32_t replayed = 0;
+static void     countReplayed([[gnu::unused]] Attitude& sample) { replayed++; }
+static SubscriberReceiver<Attitude> replayCounter(attitude, countReplayed, "replayCounter");
+
+static void record(Subscriber* active) {
+    textLogger.enable(active == &textLogger);
+    ramRecorder.enable(active == &ramRecorder);
+    fileRecorder.enable(active == &fileRecorder);
+}
+
+static int64_t publishAll() {
+    Attitude sample;
+    memset(&sample, 0, sizeof(sample));
+    int64_t start = NOW();
+    for(uint32_t i = 0; i < NUM_OF_MSGS; i++) {
+        sample.time = static_cast<int64_t>(i);
+        sample.mode = static_cast<int32_t>(i % 4);
+        attitude.publish(sample);
+    }
+    return (NOW() - start) / NUM_OF_MSGS;
+}
+
+class FlightRecorderBenchmark : public StaticThread<> {
+  public:
+    FlightRecorderBenchmark() : StaticThread<>("flightRecorderBenchmark", 300) {}
+
+    void run() {
+        PRINTF("%d messages of %d bytes\n", static_cast<int>(NUM_OF_MSGS), static_cast<int>(sizeof(Attitude)));
+        ramRecorder.clear();
+        fileRecorder.clear();
+        replayCounter.enable(false);
+
+        //________________________________________________ recording
+        record(0);
+        int64_t none = publishAll();
+        record(&textLogger);
+        int64_t text = publishAll();
+        record(&ramRecorder);
+        int64_t inRam = publishAll();
+        record(&fileRecorder);
+        int64_t inFiles = publishAll();
+        record(0);
+
+        PRINTF("recording, ns/msg\n");
+        PRINTF("  without       %d\n", static_cast<int>(none));
+        PRINTF("  text log      %d (+%d)\n", static_cast<int>(text), static_cast<int>(text - none));
+        PRINTF("  recorder RAM  %d (+%d), recorded %d\n", static_cast<int>(inRam), static_cast<int>(inRam - none),
+               static_cast<int>(ramRecorder.recordedMsgs));
+        PRINTF("  recorder file %d (+%d), recorded %d\n", static_cast<int>(inFiles), static_cast<int>(inFiles - none),
+               static_cast<int>(fileRecorder.recordedMsgs));
+
+        //________________________________________________ replay
+        replayCounter.enable(true);
+        PRINTF("replay as fast as possible\n");
+        replay("RAM ", ramRecorder);
+        replay("file", fileRecorder);
+        hwResetAndReboot();
+    }
+
+    void replay(const char* name, FlightRecorder& recorder) {
+        replayed         = 0;
+        int64_t start    = NOW();
+        recorder.replay();
+        int64_t  all     = NOW() - start;
+        uint32_t allMsgs = replayed;
+
+        // the last 1% of the recording time
+        int64_t from   = recorder.lastRecordTime() - (recorder.lastRecordTime() - recorder.firstRecordTime()) / 100;
+        replayed       = 0;
+        start          = NOW();
+        recorder.replay(from);
+        int64_t  part     = NOW() - start;
+        uint32_t partMsgs = replayed;
+
+        PRINTF("  %s all: %d msgs/s, %d MB/s (%d msgs). last 1%% of the time: %d msgs in %d us\n", name,
+               static_cast<int>(static_cast<int64_t>(allMsgs) * SECONDS / all),
+               static_cast<int>(static_cast<int64_t>(allMsgs * sizeof(Attitude)) * SECONDS / all / (1024 * 1024)), static_cast<int>(allMsgs),
+               static_cast<int>(partMsgs), static_cast<int>(part / MICROSECONDS));
+    }
+} flightRecorderBenchmark;
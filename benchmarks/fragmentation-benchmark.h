@@ -0,0 +1,140 @@
+#pragma once
+
+/**
+ * Throughput of fragmented messages (64 KB to 1 MB) between two processes.
+ * Included by the benchmarks for each link, which define the gateway.
+ * Start the receiver first, then the sender in a second shell:
+ *    ./fragmentation-udp-bench &
+ *    ./fragmentation-udp-bench sender
+ * The reference is the raw rate of the link: messages of one network
+ * message (MAX_FRAGMENT_DATA bytes) sent back to back, without any pacing,
+ * as fast as the link takes them. How many of them the receiver could
+ * follow is reported as well. Sizes above REASSEMBLY_BUFFER_SIZE
+ * (8 KB by default) are skipped, for all build with
+ *    cmake -DREASSEMBLY_BUFFER_SIZE=1048576 ...
+ */
+
+#include "rodos.h"
+
+extern int    main_argc;
+extern char** main_argv;
+
+template<size_t SIZE> struct Block {
+    uint8_t data[SIZE];
+};
+
+struct Ack {
+    uint32_t topicId;
+    int32_t  received;
+};
+
+static Topic<Block<MAX_FRAGMENT_DATA>> singleMsgs(3300, "singleMsgs");
+static Topic<Block<64 * 1024>>         blocks64k(3301, "blocks64k");
+static Topic<Block<256 * 1024>>        blocks256k(3302, "blocks256k");
+static Topic<Block<1024 * 1024>>       blocks1m(3303, "blocks1m");
+static Topic<Ack>                      acks(3310, "acks");
+static Topic<int32_t>                  benchmarkDone(3311, "benchmarkDone");
+
+static bool isSender() { return main_argc > 1 && strcmp(main_argv[1], "sender") == 0; }
+
+/*************** receiver: acknowledges each complete message *********/
+
+class BlockReceiver : public Subscriber {
+    int32_t received = 0;
+  public:
+    BlockReceiver(TopicInterface& topic) : Subscriber(topic, "blockReceiver") {}
+    uint32_t put(const uint32_t topicId, [[gnu::unused]] const size_t len, [[gnu::unused]] void* data, const NetMsgInfo& info) override {
+        if(isSender() || info.senderNode == getNodeNumber()) return 0;
+        Ack ack { topicId, ++received };
+        acks.publish(ack);
+        return 1;
+    }
+};
+
+static BlockReceiver singleMsgsReceiver(singleMsgs), blocks64kReceiver(blocks64k), blocks256kReceiver(blocks256k), blocks1mReceiver(blocks1m);
+
+static SubscriberReceiver<int32_t> doneReceiver(benchmarkDone, [](int32_t&) {
+    if(!isSender()) hwResetAndReboot();
+});
+
+/*************** sender *********/
+
+static Atomic<int32_t> acksReceived[4];
+
+static SubscriberReceiver<Ack> ackReceiver(acks, [](Ack& ack) {
+    if(isSender() && ack.topicId >= 3300 && ack.topicId <= 3303) acksReceived[ack.topicId - 3300] = ack.received;
+});
+
+static Block<1024 * 1024> sentData;
+
+template<size_t SIZE>
+static void measure(const char* linkName, Topic<Block<SIZE>>& topic, int32_t count, double referenceRate) {
+    static int32_t sent[4];
+    if(SIZE > REASSEMBLY_BUFFER_SIZE) {
+        PRINTF("%s: %7u bytes: skipped, longer than REASSEMBLY_BUFFER_SIZE\n", linkName, static_cast<unsigned>(SIZE));
+        return;
+    }
+    uint32_t       index = topic.topicId - 3300;
+
+    int64_t start = NOW();
+    for(int32_t i = 0; i < count; i++) topic.publish(*reinterpret_cast<Block<SIZE>*>(&sentData));
+    sent[index] += count;
+
+    int64_t timeout = NOW() + 20 * SECONDS;
+    while(acksReceived[index] < sent[index] && NOW() < timeout) Thread::suspendCallerUntil(NOW() + 100 * MICROSECONDS);
+    int64_t duration = NOW() - start;
+
+    double rate = static_cast<double>(SIZE) * count / 1.0e6 / (static_cast<double>(duration) / SECONDS);
+    PRINTF("%s: %7u bytes x %3d: %7.2f MB/s", linkName, static_cast<unsigned>(SIZE), static_cast<int>(count), rate);
+    if(referenceRate > 0) PRINTF(" (%d %% of the raw link)", static_cast<int>(rate / referenceRate * 100));
+    if(acksReceived[index] < sent[index]) PRINTF(", %d lost", static_cast<int>(sent[index] - acksReceived[index]));
+    PRINTF("\n");
+    if(referenceRate <= 0) sent[index] = acksReceived[index]; // nothing to compare with, next run starts again
+}
+
+class FragmentationBenchmark : public StaticThread<> {
+    const char* linkName;
+    Gateway&    gateway;
+    uint32_t    bytesPerSecond;
+    uint32_t    burstBytes;
+  public:
+    FragmentationBenchmark(const char* linkName_, Gateway& gateway_, uint32_t bytesPerSecond_, uint32_t burstBytes_) :
+        linkName(linkName_), gateway(gateway_), bytesPerSecond(bytesPerSecond_), burstBytes(burstBytes_) {}
+    void run() {
+        if(!isSender()) return;
+        gateway.setFragmentPacing(bytesPerSecond, burstBytes);
+        for(size_t i = 0; i < sizeof(sentData.data); i++) sentData.data[i] = static_cast<uint8_t>(i * 7);
+        Thread::suspendCallerUntil(NOW() + 1 * SECONDS); // receiver ready
+
+        PRINTF("fragmentation: pacing %d KB/s (0: back pressure only), bursts of %d bytes\n",
+               static_cast<int>(bytesPerSecond / 1000), static_cast<int>(burstBytes));
+        int32_t count = 2000;
+        int64_t start = NOW();
+        for(int32_t i = 0; i < count; i++) singleMsgs.publish(*reinterpret_cast<Block<MAX_FRAGMENT_DATA>*>(&sentData));
+        int64_t sendTime  = NOW() - start;
+        int64_t lastAckAt = NOW();
+        int32_t acked     = 0;
+        while(acksReceived[0] < count && NOW() < lastAckAt + 200 * MILLISECONDS) { // lost ones do not come
+            if(acksReceived[0] != acked) {
+                acked     = acksReceived[0];
+                lastAckAt = NOW();
+            }
+            Thread::suspendCallerUntil(NOW() + 100 * MICROSECONDS);
+        }
+        int32_t received  = acksReceived[0];
+        double  reference = static_cast<double>(MAX_FRAGMENT_DATA) * count / 1.0e6 / (static_cast<double>(sendTime) / SECONDS);
+        double  delivered = static_cast<double>(MAX_FRAGMENT_DATA) * received / 1.0e6 / (static_cast<double>(lastAckAt - start) / SECONDS);
+        PRINTF("%s: %7u bytes x %3d: %7.2f MB/s raw link, %.2f MB/s delivered", linkName,
+               static_cast<unsigned>(MAX_FRAGMENT_DATA), static_cast<int>(count), reference, delivered);
+        if(received < count) PRINTF(", %d lost", static_cast<int>(count - received));
+        PRINTF("\n");
+
+        measure(linkName, blocks64k, 100, reference);
+        measure(linkName, blocks256k, 25, reference);
+        measure(linkName, blocks1m, 8, reference);
+
+        benchmarkDone.publish(0);
+        Thread::suspendCallerUntil(NOW() + 100 * MILLISECONDS);
+        hwResetAndReboot();
+    }
+};
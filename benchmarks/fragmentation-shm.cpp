@@ -0,0 +1,9 @@
+#include "rodos.h"
+#include "gateway.h"
+
+#include "fragmentation-benchmark.h"
+
+static LinkinterfaceSHM linkinterfaceSHM(Sharedmemory_IDX0);
+static Gateway          gateway(&linkinterfaceSHM, true);
+
+static FragmentationBenchmark benchmark("shm", gateway, 0, 0); // the fifo has only FIFOSIZE messages: back pressure
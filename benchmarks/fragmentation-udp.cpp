@@ -0,0 +1,10 @@
+#include "rodos.h"
+#include "gateway.h"
+
+#include "fragmentation-benchmark.h"
+
+static UDPInOut         udp(-50000);
+static LinkinterfaceUDP linkinterfaceUDP(&udp);
+static Gateway          gateway(&linkinterfaceUDP, true);
+
+static FragmentationBenchmark benchmark("udp", gateway, FRAGMENT_RATE, FRAGMENT_BURST);
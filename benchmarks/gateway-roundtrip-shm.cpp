@@ -0,0 +1,9 @@
+#include "rodos.h"
+#include "gateway.h"
+
+#include "gateway-roundtrip.h"
+
+static LinkinterfaceSHM linkinterfaceSHM(Sharedmemory_IDX0);
+static Gateway          gateway(&linkinterfaceSHM, true);
+
+static GatewayRoundTrip roundTrip("gateway-roundtrip-shm");
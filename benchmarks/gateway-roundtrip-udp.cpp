@@ -0,0 +1,10 @@
+#include "rodos.h"
+#include "gateway.h"
+
+#include "gateway-roundtrip.h"
+
+static UDPInOut         udp(-50010);
+static LinkinterfaceUDP linkinterfaceUDP(&udp);
+static Gateway          gateway(&linkinterfaceUDP, true);
+
+static GatewayRoundTrip roundTrip("gateway-roundtrip-udp");
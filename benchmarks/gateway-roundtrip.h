@@ -0,0 +1,110 @@
+#pragma once
+
+/**
+ * rodos-bench: round trip time through two gateways: the sender publishes a
+ * ping, the other process publishes it back as pong. Encode, send, receive
+ * and decode twice, for 16 .. 1024 bytes.
+ * Included by the benchmarks for each link, which define the gateway.
+ * Start the echo first, then the sender in a second shell:
+ *    ./gateway-roundtrip-udp-bench &
+ *    ./gateway-roundtrip-udp-bench sender
+ */
+
+#include "rodos.h"
+#include "rodos-bench.h"
+
+extern int    main_argc;
+extern char** main_argv;
+
+static constexpr uint32_t ROUND_TRIPS = 2000;
+
+struct Ping {
+    uint32_t sequenceNr;
+    uint8_t  data[1024];
+};
+
+static Topic<Ping>    pings(3960, "benchPings");
+static Topic<Ping>    pongs(3961, "benchPongs");
+static Topic<int32_t> roundTripsDone(3962, "roundTripsDone");
+
+static bool isSender() { return main_argc > 1 && strcmp(main_argv[1], "sender") == 0; }
+
+/*************** echo *********/
+
+class Echo : public Subscriber {
+  public:
+    Echo() : Subscriber(pings, "echo") {}
+    uint32_t put([[gnu::unused]] const uint32_t topicId, const size_t len, void* data, const NetMsgInfo& info) override {
+        if(isSender() || info.senderNode == getNodeNumber()) return 0;
+        pongs.publishMsgPart(*static_cast<Ping*>(data), len);
+        return 1;
+    }
+} echo;
+
+static SubscriberReceiver<int32_t> doneReceiver(roundTripsDone, [](int32_t&) {
+    if(!isSender() && NOW() > 500 * MILLISECONDS) hwResetAndReboot(); // not an old one, shared memory keeps them
+});
+
+/*************** sender *********/
+
+static Thread*           waitingSender = 0;
+static uint64_t          pongAt        = 0;
+static Atomic<uint32_t>  lastPong(0);
+
+class PongReceiver : public Subscriber {
+  public:
+    PongReceiver() : Subscriber(pongs, "pongReceiver") {}
+    uint32_t put([[gnu::unused]] const uint32_t topicId, [[gnu::unused]] const size_t len, void* data, const NetMsgInfo& info) override {
+        if(!isSender() || info.senderNode == getNodeNumber()) return 0;
+        pongAt   = benchCycles();
+        lastPong = static_cast<Ping*>(data)->sequenceNr;
+        if(waitingSender) waitingSender->resume();
+        return 1;
+    }
+} pongReceiver;
+
+static BenchSampleBuffer<ROUND_TRIPS> samples;
+
+class GatewayRoundTrip : public StaticThread<> {
+    const char* benchmark;
+
+  public:
+    GatewayRoundTrip(const char* benchmark_) : StaticThread<>("gatewayRoundTrip"), benchmark(benchmark_) {}
+
+    void run() {
+        if(!isSender()) return;
+        waitingSender = this;
+        suspendCallerUntil(NOW() + 1 * SECONDS); // echo ready
+
+        static Ping ping;
+        uint32_t    sequenceNr = 0;
+        char        caseName[40];
+        for(uint32_t size = 16; size <= sizeof(ping.data); size *= 4) {
+            samples.clear();
+            uint32_t lost = 0;
+            for(uint32_t i = 0; i < ROUND_TRIPS + 100; i++) { // the first ones to warm up
+                ping.sequenceNr = ++sequenceNr;
+                uint64_t start  = benchCycles();
+                pings.publishMsgPart(ping, sizeof(ping.sequenceNr) + size);
+                int64_t timeout = NOW() + 100 * MILLISECONDS;
+                while(lastPong.load() != sequenceNr && NOW() < timeout) suspendCallerUntil(timeout);
+                if(lastPong.load() != sequenceNr) {
+                    if(++lost >= 10) break; // no echo
+                    continue;
+                }
+                if(i >= 100) samples.add(pongAt - start);
+            }
+            if(lost >= 10) {
+                PRINTF("no echo\n");
+                break;
+            }
+            SPRINTF(caseName, "bytes=%d", static_cast<int>(size));
+            benchReport(benchmark, caseName, samples);
+            if(lost > 0) PRINTF("%d lost\n", static_cast<int>(lost));
+        }
+
+        roundTripsDone.publish(0);
+        suspendCallerUntil(NOW() + 100 * MILLISECONDS);
+        hwResetAndReboot();
+    }
+};
@@ -0,0 +1,192 @@
+#include "rodos.h"
+#include "housekeeping.h"
+
+/**
+ * Housekeeping of 1000 parameters (temperatures every 10th tick, voltages,
+ * packet and error counters and positions every tick, status every 100th
+ * tick), bytes and CPU time per tick of
+ *   - an ad-hoc thread which copies all variables into a struct (4 bytes
+ *     each) every tick, like the usual housekeeping structs
+ *   - Housekeeping: bit-packed raw values only, with deltas, with deltas and
+ *     runs of unchanged parameters
+ * The struct or the packet is published to a downlink which copies it.
+ * The values drift slowly with noise. Each packet is decoded again
+ * (HousekeepingDecoder) and the values of the last one are compared.
+ */
+
+static constexpr uint32_t NUM_OF_TEMPERATURES = 250;
+static constexpr uint32_t NUM_OF_VOLTAGES     = 250;
+static constexpr uint32_t NUM_OF_COUNTERS     = 200;
+static constexpr uint32_t NUM_OF_STATUS       = 200;
+static constexpr uint32_t NUM_OF_POSITIONS    = 100;
+static constexpr uint32_t NUM_OF_PARAMETERS   = 1000;
+static constexpr uint32_t TICKS               = 2001; // the last one has all parameters
+
+static int16_t  temperatures[NUM_OF_TEMPERATURES];
+static float    voltages[NUM_OF_VOLTAGES];
+static uint32_t counters[NUM_OF_COUNTERS];
+static uint8_t  status[NUM_OF_STATUS];
+static int32_t  positions[NUM_OF_POSITIONS];
+
+struct AdHocHousekeeping {
+    int32_t  temperatures[NUM_OF_TEMPERATURES];
+    float    voltages[NUM_OF_VOLTAGES];
+    uint32_t counters[NUM_OF_COUNTERS];
+    uint32_t status[NUM_OF_STATUS];
+    int32_t  positions[NUM_OF_POSITIONS];
+};
+static AdHocHousekeeping adHoc;
+
+static Topic<AdHocHousekeeping> adHocTopic(3900, "adHocHousekeeping");
+static Topic<uint8_t[8 * 1024]> packetTopic(3901, "housekeepingPackets");
+
+/// copies each message into the next frame, like a downlink
+class Downlink : public Subscriber {
+    uint8_t frame[8 * 1024];
+
+  public:
+    Downlink(TopicInterface& topic, const char* name) : Subscriber(topic, name) {}
+    uint32_t put([[gnu::unused]] const uint32_t topicId, const size_t len, void* data, [[gnu::unused]] const NetMsgInfo& netMsgInfo) override {
+        memcpy(frame, data, len);
+        return 1;
+    }
+};
+static Downlink adHocDownlink(adHocTopic, "adHocDownlink");
+static Downlink packetDownlink(packetTopic, "packetDownlink");
+
+static Housekeeping<NUM_OF_PARAMETERS> housekeeping[3]; // bit-packed, delta, delta and runs
+static HkLayoutEntry                   layout[NUM_OF_PARAMETERS];
+static uint32_t                        decodedRaw[NUM_OF_PARAMETERS];
+static uint8_t                         packet[8 * 1024];
+
+static uint32_t seed = 4711;
+static int32_t  noise(int32_t amplitude) {
+    seed = seed * 1103515245 + 12345;
+    return static_cast<int32_t>((seed >> 16) % static_cast<uint32_t>(2 * amplitude + 1)) - amplitude;
+}
+
+static void initValues() {
+    seed = 4711;
+    for(uint32_t i = 0; i < NUM_OF_TEMPERATURES; i++) temperatures[i] = static_cast<int16_t>(20 + i % 10);
+    for(uint32_t i = 0; i < NUM_OF_VOLTAGES; i++) voltages[i] = 28.0f - static_cast<float>(i % 8);
+    for(uint32_t i = 0; i < NUM_OF_COUNTERS; i++) counters[i] = i * 100;
+    for(uint32_t i = 0; i < NUM_OF_STATUS; i++) status[i] = static_cast<uint8_t>(i % 4);
+    for(uint32_t i = 0; i < NUM_OF_POSITIONS; i++) positions[i] = static_cast<int32_t>(i * 500) - 25000;
+}
+
+/// the next tick: some sensors change a bit, most status stays
+static void updateValues(uint32_t tick) {
+    if(tick % 10 == 0) {
+        for(uint32_t i = 0; i < NUM_OF_TEMPERATURES; i++) {
+            if(noise(3) == 0) temperatures[i] = static_cast<int16_t>(temperatures[i] + noise(1));
+        }
+    }
+    for(uint32_t i = 0; i < NUM_OF_VOLTAGES; i++) {
+        if(noise(2) == 0) voltages[i] += static_cast<float>(noise(2)) * 0.01f;
+    }
+    for(uint32_t i = 0; i < NUM_OF_COUNTERS; i++) { // packet counters, then error counters
+        if(i < NUM_OF_COUNTERS / 4 || noise(500) == 0) counters[i]++;
+    }
+    if(tick % 100 == 0) status[(tick / 100) % NUM_OF_STATUS] ^= 1;
+    for(uint32_t i = 0; i < NUM_OF_POSITIONS; i++) positions[i] += 3 + noise(2);
+}
+
+static void copyAdHoc() {
+    for(uint32_t i = 0; i < NUM_OF_TEMPERATURES; i++) adHoc.temperatures[i] = temperatures[i];
+    for(uint32_t i = 0; i < NUM_OF_VOLTAGES; i++) adHoc.voltages[i] = voltages[i];
+    for(uint32_t i = 0; i < NUM_OF_COUNTERS; i++) adHoc.counters[i] = counters[i];
+    for(uint32_t i = 0; i < NUM_OF_STATUS; i++) adHoc.status[i] = status[i];
+    for(uint32_t i = 0; i < NUM_OF_POSITIONS; i++) adHoc.positions[i] = positions[i];
+}
+
+/// the decoded values of the last packet are the variables
+static uint32_t differentValues(const HousekeepingDecoder& decoder) {
+    uint32_t different = 0;
+    for(uint32_t i = 0; i < NUM_OF_PARAMETERS; i++) {
+        double expected = 0;
+        uint16_t id     = layout[i].id;
+        if(id < 1000) expected = temperatures[id];
+        else if(id < 2000) expected = voltages[id - 1000];
+        else if(id < 3000) expected = counters[id - 2000];
+        else if(id < 4000) expected = status[id - 3000];
+        else expected = positions[id - 4000];
+        double difference = decoder.value(i) - expected;
+        if(difference > 0.006 || difference < -0.006) different++;
+    }
+    return different;
+}
+
+class HousekeepingBenchmark : public StaticThread<> {
+  public:
+    HousekeepingBenchmark() : StaticThread<>("housekeepingBenchmark", 300) {}
+
+    void init() {
+        for(auto& engine : housekeeping) {
+            for(uint16_t i = 0; i < NUM_OF_TEMPERATURES; i++) engine.add(i, temperatures[i], -40, 125, 10);
+            for(uint16_t i = 0; i < NUM_OF_VOLTAGES; i++) engine.add(static_cast<uint16_t>(1000 + i), voltages[i], 0.0f, 40.0f, 0.01f);
+            for(uint16_t i = 0; i < NUM_OF_COUNTERS; i++) engine.add(static_cast<uint16_t>(2000 + i), counters[i], 0, 1000000);
+            for(uint16_t i = 0; i < NUM_OF_STATUS; i++) engine.add(static_cast<uint16_t>(3000 + i), status[i], 0, 15, 100);
+            for(uint16_t i = 0; i < NUM_OF_POSITIONS; i++) engine.add(static_cast<uint16_t>(4000 + i), positions[i], -100000, 100000);
+        }
+    }
+
+    void run() {
+        housekeeping[0].getLayout(layout, NUM_OF_PARAMETERS);
+        PRINTF("%d parameters, %d ticks, max packet %d bytes\n", static_cast<int>(housekeeping[0].numOfParameters()), static_cast<int>(TICKS),
+               static_cast<int>(housekeeping[0].maxPacketSize()));
+        PRINTF("per tick         bytes  sample ns  pack ns  publish ns  decoded  wrong values\n");
+
+        initValues();
+        int64_t copyTime    = 0;
+        int64_t publishTime = 0;
+        for(uint32_t tick = 0; tick < TICKS; tick++) {
+            updateValues(tick);
+            int64_t start = NOW();
+            copyAdHoc();
+            int64_t copied = NOW();
+            adHocTopic.publish(adHoc);
+            publishTime += NOW() - copied;
+            copyTime += copied - start;
+        }
+        PRINTF("  ad-hoc struct  %d   %d       -        %d\n", static_cast<int>(sizeof(adHoc)), static_cast<int>(copyTime / TICKS),
+               static_cast<int>(publishTime / TICKS));
+
+        HkPacking packing;
+        packing.delta     = false;
+        packing.runLength = false;
+        measure("bit-packed    ", housekeeping[0], packing);
+        packing.delta = true;
+        measure("delta         ", housekeeping[1], packing);
+        packing.runLength = true;
+        measure("delta and runs", housekeeping[2], packing);
+        hwResetAndReboot();
+    }
+
+    void measure(const char* name, Housekeeping<NUM_OF_PARAMETERS>& engine, const HkPacking& packing) {
+        HousekeepingDecoder decoder(layout, engine.numOfParameters(), decodedRaw);
+        engine.setPacking(packing);
+        initValues();
+        int64_t sampleTime  = 0;
+        int64_t packTime    = 0;
+        int64_t publishTime = 0;
+        int64_t bytes       = 0;
+        for(uint32_t tick = 0; tick < TICKS; tick++) {
+            updateValues(tick);
+            int64_t start = NOW();
+            engine.sample();
+            int64_t sampled = NOW();
+            size_t  len     = engine.pack(packet, sizeof(packet));
+            int64_t packed  = NOW();
+            packetTopic.publishMsgPart(packet, len);
+            publishTime += NOW() - packed;
+            packTime += packed - sampled;
+            sampleTime += sampled - start;
+            bytes += static_cast<int64_t>(len);
+            decoder.decode(packet, len);
+        }
+        uint32_t different = differentValues(decoder);
+        PRINTF("  %s %d   %d       %d     %d         %d     %d\n", name, static_cast<int>(bytes / TICKS),
+               static_cast<int>(sampleTime / TICKS), static_cast<int>(packTime / TICKS), static_cast<int>(publishTime / TICKS),
+               static_cast<int>(decoder.decodedPackets), static_cast<int>(different));
+    }
+} housekeepingBenchmark;
@@ -0,0 +1,108 @@
+#include "rodos.h"
+
+/**
+ * Queued network messages in whole NetworkMessages (as before) compared with
+ * pointers to buffers of netBufferPool (UDP input, TransmitScheduler).
+ *   - memory of a queue of UDP_INCOMMIG_BUF_LEN messages, and the bytes
+ *     really held for a mix of message sizes
+ *   - time to put a message into the queue and to take it out again
+ *   - time to alloc and free a buffer, to share one (reference counting)
+ */
+
+static constexpr size_t   NETWORK_HEADER_SIZE = sizeof(NetworkMessage) - MAX_NETWORK_MESSAGE_LENGTH;
+static constexpr uint32_t ROUNDS              = 200000;
+static constexpr uint32_t QUEUED              = 64; // messages in the queue at a time
+
+/// user data lengths of a typical mix: housekeeping values, frames, images
+static const size_t mix[] = { 4, 4, 4, 8, 4, 16, 4, 200, 4, 8, 4, 4, 160, 4, 4, 1200, 4, 8, 4, 32 };
+static constexpr uint32_t MIX_LEN = sizeof(mix) / sizeof(mix[0]);
+
+static Fifo<NetworkMessage, QUEUED + 1> messageFifo;
+static Fifo<NetBuffer*, QUEUED + 1>     pointerFifo;
+static NetworkMessage                   messages[MIX_LEN];
+static NetworkMessage                   received;
+
+static int32_t nsPer(int64_t time, uint32_t count) { return static_cast<int32_t>(time / count); }
+
+class NetBufferPoolBenchmark : public StaticThread<> {
+  public:
+    NetBufferPoolBenchmark() : StaticThread<>("netBufferPoolBenchmark", 300) {}
+
+    void run() {
+        for(uint32_t i = 0; i < MIX_LEN; i++) {
+            NetMsgInfo info;
+            uint8_t    data[1200];
+            memset(data, 0, sizeof(data));
+            prepareNetworkMessage(messages[i], 3400 + i, data, mix[i], info);
+        }
+
+        //________________________________________________ memory
+        size_t mixBytes = 0;
+        for(uint32_t i = 0; i < MIX_LEN; i++) {
+            size_t len = NETWORK_HEADER_SIZE + mix[i];
+            mixBytes += (len <= NET_BUFFER_SMALL_SIZE)    ? NetBufferPool::SMALL_STRIDE
+                        : (len <= NET_BUFFER_MEDIUM_SIZE) ? NetBufferPool::MEDIUM_STRIDE
+                                                          : NetBufferPool::LARGE_STRIDE;
+        }
+        PRINTF("memory, queue of %d messages (UDP_INCOMMIG_BUF_LEN)\n", static_cast<int>(UDP_INCOMMIG_BUF_LEN));
+        PRINTF("  NetworkMessages %d KB, pointers %d KB + pool %d KB (shared with the TransmitSchedulers)\n",
+               static_cast<int>(sizeof(Fifo<NetworkMessage, UDP_INCOMMIG_BUF_LEN>) / 1024),
+               static_cast<int>(sizeof(Fifo<NetBuffer*, UDP_INCOMMIG_BUF_LEN>) / 1024),
+               static_cast<int>(NetBufferPool::memoryFootprint() / 1024));
+        PRINTF("  per queued message of the mix: NetworkMessage %d bytes, pooled buffer %d bytes\n",
+               static_cast<int>(sizeof(NetworkMessage)), static_cast<int>(mixBytes / MIX_LEN + sizeof(NetBuffer*)));
+        PRINTF("  buffers with header: small %d, medium %d, large %d bytes\n", static_cast<int>(NetBufferPool::SMALL_STRIDE),
+               static_cast<int>(NetBufferPool::MEDIUM_STRIDE), static_cast<int>(NetBufferPool::LARGE_STRIDE));
+
+        //________________________________________________ throughput
+        int64_t start = NOW();
+        for(uint32_t r = 0; r < ROUNDS / QUEUED; r++) {
+            for(uint32_t i = 0; i < QUEUED; i++) messageFifo.put(messages[(r + i) % MIX_LEN]);
+            for(uint32_t i = 0; i < QUEUED; i++) messageFifo.get(received);
+        }
+        int64_t copyTime = NOW() - start;
+
+        start = NOW();
+        for(uint32_t r = 0; r < ROUNDS / QUEUED; r++) {
+            for(uint32_t i = 0; i < QUEUED; i++) {
+                NetBufferRef buffer = netBufferPool.copyOf(messages[(r + i) % MIX_LEN]);
+                pointerFifo.put(buffer.detach());
+            }
+            for(uint32_t i = 0; i < QUEUED; i++) {
+                NetBuffer* buffer;
+                pointerFifo.get(buffer);
+                NetBufferRef ref(buffer);
+                memcpy(&received, &ref.msg(), ref.used()); // like LinkinterfaceUDP::getNetworkMsg
+            }
+        }
+        int64_t poolTime = NOW() - start;
+
+        start = NOW();
+        for(uint32_t r = 0; r < ROUNDS; r++) {
+            NetBufferRef buffer = netBufferPool.alloc(NETWORK_HEADER_SIZE + 4);
+        }
+        int64_t allocTime = NOW() - start;
+
+        NetBufferRef shared = netBufferPool.copyOf(messages[15]);
+        start               = NOW();
+        for(uint32_t r = 0; r < ROUNDS; r++) {
+            NetBufferRef another = shared;
+        }
+        int64_t shareTime = NOW() - start;
+
+        start = NOW();
+        for(uint32_t r = 0; r < ROUNDS; r++) {
+            received = messages[15];
+        }
+        int64_t copyLargeTime = NOW() - start;
+
+        uint32_t msgs = (ROUNDS / QUEUED) * QUEUED;
+        PRINTF("\nthroughput, put and get of the mix, %d messages\n", static_cast<int>(msgs));
+        PRINTF("  NetworkMessage fifo %d ns/msg, pooled buffers %d ns/msg (%d msgs/s)\n", nsPer(copyTime, msgs),
+               nsPer(poolTime, msgs), static_cast<int>(static_cast<int64_t>(msgs) * SECONDS / (poolTime > 0 ? poolTime : 1)));
+        PRINTF("  alloc + free %d ns, share a handle %d ns, copy a message of %d bytes %d ns\n", nsPer(allocTime, ROUNDS),
+               nsPer(shareTime, ROUNDS), static_cast<int>(messages[15].numberOfBytesToSend()), nsPer(copyLargeTime, ROUNDS));
+        PRINTF("  alloc failures %d\n", static_cast<int>(netBufferPool.allocFailures));
+        hwResetAndReboot();
+    }
+} netBufferPoolBenchmark;
@@ -0,0 +1,125 @@
+#include "rodos.h"
+
+/**
+ * Compression ratio and throughput of PayloadCompression for typical
+ * telemetry: housekeeping frames, thumbnails and event logs.
+ * The samples are generated like the recorded ones (slowly drifting sensor
+ * values with noise, mostly constant status fields, smooth images), to be
+ * reproducible without data files.
+ */
+
+static constexpr int32_t NUM_OF_SAMPLES = 64;
+static constexpr int32_t ITERATIONS     = 200;
+
+struct Housekeeping {
+    uint32_t counter;
+    int64_t  time;
+    int16_t  temperatures[24];
+    uint16_t voltages[24];
+    uint16_t currents[24];
+    uint8_t  modes[32];
+    uint32_t errorCounters[32];
+};
+
+static uint32_t seed = 4711;
+static int32_t  noise(int32_t amplitude) {
+    seed = seed * 1103515245 + 12345;
+    return static_cast<int32_t>((seed >> 16) % static_cast<uint32_t>(2 * amplitude + 1)) - amplitude;
+}
+
+struct Sample {
+    uint8_t data[MAX_NETWORK_MESSAGE_LENGTH];
+    size_t  len;
+};
+
+static Sample housekeepingSamples[NUM_OF_SAMPLES];
+static Sample thumbnailSamples[NUM_OF_SAMPLES];
+static Sample eventLogSamples[NUM_OF_SAMPLES];
+
+static void generateSamples() {
+    Housekeeping hk;
+    memset(&hk, 0, sizeof(hk));
+    for(int32_t k = 0; k < 24; k++) {
+        hk.temperatures[k] = static_cast<int16_t>(150 + 10 * k);
+        hk.voltages[k]     = static_cast<uint16_t>(3300 + 1700 * (k % 3));
+        hk.currents[k]     = static_cast<uint16_t>(120 + k);
+    }
+    hk.modes[0] = 2;
+    hk.modes[7] = 1;
+
+    for(int32_t i = 0; i < NUM_OF_SAMPLES; i++) {
+        hk.counter = static_cast<uint32_t>(i);
+        hk.time    = 1000 * SECONDS + i * 100 * MILLISECONDS;
+        for(int32_t k = 0; k < 24; k++) {
+            hk.temperatures[k] = static_cast<int16_t>(hk.temperatures[k] + noise(1));
+            hk.currents[k]     = static_cast<uint16_t>(120 + k + noise(3));
+        }
+        if(i % 16 == 15) hk.errorCounters[3]++;
+        memcpy(housekeepingSamples[i].data, &hk, sizeof(hk));
+        housekeepingSamples[i].len = sizeof(hk);
+
+        uint8_t* pixel = thumbnailSamples[i].data; // 32 x 32 grey
+        for(int32_t y = 0; y < 32; y++) {
+            for(int32_t x = 0; x < 32; x++) {
+                int32_t value = (x * 4 + y * 2 + i) / 4 * 4 + ((x - 16) * (x - 16) + (y - 16) * (y - 16) < 40 ? 100 : 0);
+                *pixel++      = static_cast<uint8_t>(value + (noise(8) == 0 ? 1 : 0));
+            }
+        }
+        thumbnailSamples[i].len = 32 * 32;
+
+        size_t len = 0;
+        char*  log = reinterpret_cast<char*>(eventLogSamples[i].data);
+        for(int32_t line = 0; line < 8; line++) {
+            SPRINTF(log + len, "%d AOCS mode=%d wheel%d rpm=%d status=OK\n", static_cast<int>(1000 + i * 8 + line), 2, line % 4, 3000 + noise(50));
+            len += strlen(log + len);
+        }
+        eventLogSamples[i].len = len;
+    }
+}
+
+static PayloadCompression codec;
+static uint8_t            compressed[NUM_OF_SAMPLES][MAX_NETWORK_MESSAGE_LENGTH];
+static size_t             compressedLen[NUM_OF_SAMPLES];
+static uint8_t            decompressed[MAX_NETWORK_MESSAGE_LENGTH];
+
+static void measure(const char* name, Sample* samples) {
+    size_t originalBytes = 0, compressedBytes = 0;
+    for(int32_t i = 0; i < NUM_OF_SAMPLES; i++) {
+        compressedLen[i] = codec.compress(samples[i].data, samples[i].len, compressed[i], MAX_NETWORK_MESSAGE_LENGTH);
+        originalBytes += samples[i].len;
+        compressedBytes += (compressedLen[i] == 0) ? samples[i].len : compressedLen[i]; // not compressed: sent as it is
+    }
+
+    int64_t start = NOW();
+    for(int32_t n = 0; n < ITERATIONS; n++) {
+        for(int32_t i = 0; i < NUM_OF_SAMPLES; i++) codec.compress(samples[i].data, samples[i].len, compressed[i], MAX_NETWORK_MESSAGE_LENGTH);
+    }
+    int64_t compressTime = NOW() - start;
+
+    start = NOW();
+    for(int32_t n = 0; n < ITERATIONS; n++) {
+        for(int32_t i = 0; i < NUM_OF_SAMPLES; i++) {
+            if(compressedLen[i] != 0) PayloadCompression::decompress(compressed[i], compressedLen[i], decompressed, sizeof(decompressed));
+        }
+    }
+    int64_t decompressTime = NOW() - start;
+
+    double megabytes = static_cast<double>(originalBytes) * ITERATIONS / 1.0e6;
+    PRINTF("%s: %u bytes, ratio %.2f  compress %.1f MB/s  decompress %.1f MB/s\n",
+           name, static_cast<unsigned>(originalBytes),
+           static_cast<double>(originalBytes) / static_cast<double>(compressedBytes),
+           megabytes / (static_cast<double>(compressTime) / SECONDS),
+           megabytes / (static_cast<double>(decompressTime) / SECONDS));
+}
+
+class CompressionBenchmark : public StaticThread<> {
+  public:
+    void run() {
+        generateSamples();
+        PRINTF("payload compression, %d samples each, %d iterations\n", static_cast<int>(NUM_OF_SAMPLES), static_cast<int>(ITERATIONS));
+        measure("housekeeping", housekeepingSamples);
+        measure("thumbnail", thumbnailSamples);
+        measure("event log", eventLogSamples);
+        hwResetAndReboot();
+    }
+} compressionBenchmark;
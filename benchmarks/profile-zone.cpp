@@ -0,0 +1,52 @@
+#include "rodos.h"
+#include "rodos-bench.h"
+
+/**
+ * rodos-bench: overhead of the profiling zones (profile-zone.h)
+ *   - an empty zone in a thread with and without ProfileTable
+ *   - publish to one subscriber without ProfileTable, with one and with
+ *     one which measures the middleware zones "publish" and "subscriber put"
+ * Compiled with DISABLE_PROFILE_ZONES both cases cost the same.
+ */
+
+static constexpr uint32_t SAMPLES = 20000;
+
+static BenchSampleBuffer<SAMPLES> samples;
+
+static ProfileTable benchTable("benchTable");
+static ProfileTable middlewareTable("middlewareTable", true);
+
+static Topic<int32_t> benchTopic(3995, "benchTopic");
+static int32_t        received = 0;
+static SubscriberReceiver<int32_t> benchReceiver(benchTopic, [](int32_t& msg) { received += msg; });
+
+class ProfileZoneBench : public StaticThread<> {
+  public:
+    ProfileZoneBench() : StaticThread<>("profileZoneBench", 200) {}
+
+    void measure(const char* caseName, bool publish) {
+        samples.clear();
+        for(uint32_t i = 0; i < SAMPLES; i++) {
+            uint64_t start = benchCycles();
+            if(publish) {
+                benchTopic.publish(1);
+            } else {
+                RODOS_PROFILE_SCOPE("empty");
+            }
+            samples.add(benchCycles() - start);
+        }
+        benchReport("profile-zone", caseName, samples);
+    }
+
+    void run() {
+        measure("empty zone, no table", false);
+        measure("publish, no table", true);
+        setProfileTable(&benchTable);
+        measure("empty zone", false);
+        measure("publish", true);
+        setProfileTable(&middlewareTable);
+        measure("publish, middleware zones", true);
+        setProfileTable(0);
+        hwResetAndReboot();
+    }
+} profileZoneBench;
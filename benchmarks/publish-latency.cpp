@@ -0,0 +1,67 @@
+#include "rodos.h"
+#include "rodos-bench.h"
+
+/**
+ * rodos-bench: latency of Topic::publish() of 64 bytes for 0 .. 32 local
+ * subscribers (Subscriber::put() which copies the message), and of a
+ * SubscriberReceiver as the only one.
+ */
+
+static constexpr uint32_t NUM_OF_SUBSCRIBERS = 32;
+static constexpr uint32_t SAMPLES         = 20000;
+
+struct Message {
+    uint8_t data[64];
+};
+
+static Topic<Message> messages(3950, "benchMessages");
+static Topic<Message> received(3951, "benchReceived");
+
+class CopyingSubscriber : public Subscriber {
+    Message copy;
+
+  public:
+    CopyingSubscriber() : Subscriber(messages, "copyingSubscriber") {}
+    uint32_t put([[gnu::unused]] const uint32_t topicId, const size_t len, void* data, [[gnu::unused]] const NetMsgInfo& netMsgInfo) override {
+        if(!isEnabled) return 0;
+        memcpy(&copy, data, len);
+        return 1;
+    }
+};
+
+static CopyingSubscriber subscribers[NUM_OF_SUBSCRIBERS];
+
+static uint32_t                    receivedMsgs = 0;
+static SubscriberReceiver<Message> receiver(received, [](Message&) { receivedMsgs++; }, "benchReceiver");
+
+static BenchSampleBuffer<SAMPLES> samples;
+
+class PublishLatency : public StaticThread<> {
+  public:
+    void run() {
+        Message message;
+        memset(&message, 0, sizeof(message));
+        char caseName[40];
+
+        for(uint32_t numOfSubscribers = 0; numOfSubscribers <= NUM_OF_SUBSCRIBERS; numOfSubscribers = (numOfSubscribers == 0) ? 1 : 2 * numOfSubscribers) {
+            for(uint32_t i = 0; i < NUM_OF_SUBSCRIBERS; i++) subscribers[i].enable(i < numOfSubscribers);
+            samples.clear();
+            for(uint32_t i = 0; i < SAMPLES; i++) {
+                uint64_t start = benchCycles();
+                messages.publish(message, false);
+                samples.add(benchCycles() - start);
+            }
+            SPRINTF(caseName, "subscribers=%d", static_cast<int>(numOfSubscribers));
+            benchReport("publish-latency", caseName, samples);
+        }
+
+        samples.clear();
+        for(uint32_t i = 0; i < SAMPLES; i++) {
+            uint64_t start = benchCycles();
+            received.publish(message, false);
+            samples.add(benchCycles() - start);
+        }
+        benchReport("publish-latency", "subscriberReceiver", samples);
+        hwResetAndReboot();
+    }
+} publishLatency;
@@ -0,0 +1,139 @@
+#pragma once
+
+/**
+ * rodos-bench: common parts of the benchmark suite (see CMakeLists.txt,
+ * "make run-benchmarks").
+ *
+ *   - benchCycles(): cycle counter of the CPU (x86: rdtsc, aarch64: the
+ *     virtual counter), else NOW() in ns. benchCyclesPerSecond() calibrates
+ *     it against NOW() once.
+ *   - BenchSamples: durations in cycles, sorted for the percentiles.
+ *   - benchReport(): one result as a JSON object in one line, in ns:
+ *       {"benchmark":"fifo-throughput","case":"put+get","unit":"ns","timer":"rdtsc",
+ *        "samples":10000,"min":..,"mean":..,"p50":..,"p90":..,"p99":..,"p999":..,"max":..}
+ *     benchReportValue() for rates: {"benchmark":..,"case":..,"unit":"items/s","value":..}
+ * run-benchmarks.sh collects the lines of all benchmarks in one JSON array.
+ */
+
+#include "rodos.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+static constexpr const char* BENCH_TIMER = "rdtsc";
+#elif defined(__aarch64__)
+static constexpr const char* BENCH_TIMER = "cntvct";
+#else
+static constexpr const char* BENCH_TIMER = "NOW";
+#endif
+
+inline uint64_t benchCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    uint32_t low, high;
+    asm volatile("lfence\n\trdtsc" : "=a"(low), "=d"(high) : : "memory"); // not before the instructions measured
+    return (static_cast<uint64_t>(high) << 32) | low;
+#elif defined(__aarch64__)
+    uint64_t counter;
+    asm volatile("isb\n\tmrs %0, cntvct_el0" : "=r"(counter) : : "memory");
+    return counter;
+#else
+    return static_cast<uint64_t>(NOW());
+#endif
+}
+
+/// cycles of benchCycles() per second, measured over 50 ms the first time
+inline double benchCyclesPerSecond() {
+    static double cyclesPerSecond = 0;
+    if(cyclesPerSecond == 0) {
+        int64_t  start       = NOW();
+        uint64_t startCycles = benchCycles();
+        while(NOW() - start < 50 * MILLISECONDS) {}
+        uint64_t cycles = benchCycles() - startCycles;
+        cyclesPerSecond = static_cast<double>(cycles) * SECONDS / static_cast<double>(NOW() - start);
+    }
+    return cyclesPerSecond;
+}
+
+inline double benchCyclesToNs(double cycles) { return cycles * 1.0e9 / benchCyclesPerSecond(); }
+
+class BenchSamples {
+    uint64_t* samples;
+    uint32_t  capacity;
+    bool      sorted;
+
+  public:
+    uint32_t count;
+    uint32_t lost; ///< did not fit
+
+    BenchSamples(uint64_t* samples_, uint32_t capacity_) : samples(samples_), capacity(capacity_), sorted(true), count(0), lost(0) {}
+
+    void clear() {
+        count  = 0;
+        lost   = 0;
+        sorted = true;
+    }
+
+    void add(uint64_t cycles) {
+        if(count >= capacity) {
+            lost++;
+            return;
+        }
+        samples[count++] = cycles;
+        sorted           = false;
+    }
+
+    void add(const BenchSamples& other) {
+        for(uint32_t i = 0; i < other.count; i++) add(other.samples[i]);
+    }
+
+    /// percent 0 .. 100, in cycles
+    uint64_t percentile(double percent) {
+        if(count == 0) return 0;
+        sort();
+        uint32_t index = static_cast<uint32_t>(percent / 100.0 * (count - 1) + 0.5);
+        return samples[index];
+    }
+
+    double mean() const {
+        double sum = 0;
+        for(uint32_t i = 0; i < count; i++) sum += static_cast<double>(samples[i]);
+        return (count == 0) ? 0 : sum / count;
+    }
+
+  private:
+    void sort() { // shell sort, without heap
+        if(sorted) return;
+        static const uint32_t gaps[] = { 8929, 3905, 1750, 701, 301, 132, 57, 23, 10, 4, 1 };
+        for(uint32_t gap : gaps) {
+            for(uint32_t i = gap; i < count; i++) {
+                uint64_t sample = samples[i];
+                uint32_t j      = i;
+                for(; j >= gap && samples[j - gap] > sample; j -= gap) samples[j] = samples[j - gap];
+                samples[j] = sample;
+            }
+        }
+        sorted = true;
+    }
+};
+
+template <uint32_t MAX_SAMPLES>
+class BenchSampleBuffer : public BenchSamples {
+    uint64_t buffer[MAX_SAMPLES];
+
+  public:
+    BenchSampleBuffer() : BenchSamples(buffer, MAX_SAMPLES) {}
+};
+
+inline void benchReport(const char* benchmark, const char* caseName, BenchSamples& samples) {
+    static const double percents[] = { 0, 50, 90, 99, 99.9, 100 };
+    double              ns[6];
+    for(uint32_t i = 0; i < 6; i++) ns[i] = benchCyclesToNs(static_cast<double>(samples.percentile(percents[i])));
+    double mean = benchCyclesToNs(samples.mean());
+
+    PRINTF("{\"benchmark\":\"%s\",\"case\":\"%s\",\"unit\":\"ns\",\"timer\":\"%s\",\"samples\":%d,", benchmark, caseName, BENCH_TIMER,
+           static_cast<int>(samples.count));
+    PRINTF("\"min\":%.1f,\"mean\":%.1f,\"p50\":%.1f,\"p90\":%.1f,", ns[0], mean, ns[1], ns[2]);
+    PRINTF("\"p99\":%.1f,\"p999\":%.1f,\"max\":%.1f}\n", ns[3], ns[4], ns[5]);
+}
+
+inline void benchReportValue(const char* benchmark, const char* caseName, const char* unit, double value) {
+    PRINTF("{\"benchmark\":\"%s\",\"case\":\"%s\",\"unit\":\"%s\",\"value\":%.1f}\n", benchmark, caseName, unit, value);
+}
@@ -0,0 +1,41 @@
+#!/bin/bash
+# rodos-bench: runs the benchmarks of the suite one after the other and
+# collects their results (JSON lines) in one JSON array.
+#   run-benchmarks.sh results.json benchmark-executables...
+# gateway-roundtrip-* need two processes: an echo and the sender.
+# RODOS blocks SIGTERM, hence timeout -s KILL. Killed processes leave the
+# shared memory (key 1001) and its semaphore behind with stale members, so
+# they are removed before the shared memory run.
+
+results=$1
+shift
+lines=$(mktemp)
+
+for benchmark in "$@"; do
+    name=$(basename "$benchmark")
+    echo "running $name" >&2
+    case "$name" in
+        gateway-roundtrip-*)
+            if [ "$name" = gateway-roundtrip-shm-bench ]; then
+                ipcrm -M 1001 2> /dev/null
+                rm -f /dev/shm/sem.RodosSHM0
+            fi
+            timeout -s KILL 120 "$benchmark" > /dev/null 2>&1 &
+            echo_pid=$!
+            sleep 0.5
+            timeout -s KILL 120 "$benchmark" sender 2>/dev/null | grep '^{"benchmark"' >> "$lines"
+            wait $echo_pid
+            ;;
+        *)
+            timeout -s KILL 300 "$benchmark" 2>/dev/null | grep '^{"benchmark"' >> "$lines"
+            ;;
+    esac
+done
+
+{
+    echo "["
+    sed -e '$!s/$/,/' -e 's/^/  /' "$lines"
+    echo "]"
+} > "$results"
+rm -f "$lines"
+echo "results in $results" >&2
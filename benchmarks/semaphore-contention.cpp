@@ -0,0 +1,78 @@
+#include "rodos.h"
+#include "rodos-bench.h"
+
+/**
+ * rodos-bench: Semaphore enter() + leave() of 1 .. 8 threads on the same
+ * semaphore. Each thread yields inside the critical section, so that the
+ * others find it occupied and wait.
+ */
+
+static constexpr uint32_t MAX_CONTENDERS = 8;
+static constexpr uint32_t ROUNDS         = 2000;
+
+static Semaphore semaphore;
+static uint32_t  shared = 0;
+
+static BenchSampleBuffer<ROUNDS> samples[MAX_CONTENDERS];
+
+static Atomic<int32_t> contenders(0); // of the running phase
+static Atomic<int32_t> phase(0);
+static Atomic<int32_t> done(0);
+
+class Contender : public StaticThread<> {
+    uint32_t index;
+
+  public:
+    Contender() : StaticThread<>("contender") {
+        static uint32_t numOfContenders = 0;
+        index                           = numOfContenders++;
+    }
+
+    void run() {
+        int32_t lastPhase = 0;
+        while(1) {
+            while(phase.load() == lastPhase) suspendCallerUntil(NOW() + 1 * MILLISECONDS);
+            lastPhase = phase.load();
+            if(index < static_cast<uint32_t>(contenders.load())) {
+                samples[index].clear();
+                for(uint32_t i = 0; i < ROUNDS; i++) {
+                    uint64_t start = benchCycles();
+                    semaphore.enter();
+                    shared++;
+                    uint64_t inside = benchCycles();
+                    if(contenders.load() > 1) yield();
+                    uint64_t yielded = benchCycles();
+                    semaphore.leave();
+                    samples[index].add(benchCycles() - start - (yielded - inside)); // without the time of the others
+                }
+                done++;
+            }
+        }
+    }
+} contenderThreads[MAX_CONTENDERS];
+
+static BenchSampleBuffer<ROUNDS * MAX_CONTENDERS> all;
+
+class SemaphoreContention : public StaticThread<> {
+  public:
+    SemaphoreContention() : StaticThread<>("semaphoreContention", 200) {}
+
+    void run() {
+        char caseName[40];
+        for(int32_t n = 1; n <= static_cast<int32_t>(MAX_CONTENDERS); n *= 2) {
+            done       = 0;
+            contenders = n;
+            phase++;
+            while(done.load() < n) suspendCallerUntil(NOW() + 1 * MILLISECONDS);
+
+            all.clear();
+            for(int32_t t = 0; t < n; t++) {
+                all.add(samples[t]);
+            }
+            SPRINTF(caseName, "threads=%d", static_cast<int>(n));
+            benchReport("semaphore-contention", caseName, all);
+        }
+        if(shared != ROUNDS * (1 + 2 + 4 + 8)) PRINTF("mutual exclusion failed\n");
+        hwResetAndReboot();
+    }
+} semaphoreContention;
@@ -0,0 +1,100 @@
+#include "rodos.h"
+
+/**
+ * A saturated topic (published as fast as possible) with many slow consumers,
+ * each with a CommBuffer: CPU time per published message when
+ *   - each consumer gets every message (as before)
+ *   - each consumer drops 9 of 10 itself, in its putter (as before, by hand)
+ *   - Subscriber::setDecimation(10)
+ *   - Subscriber::setThrottle(1 ms)
+ *   - Subscriber::setChangeOnly() and the value does not change
+ * The publisher is the only thread which runs, the time is its CPU time.
+ */
+
+static constexpr uint32_t NUM_OF_CONSUMERS = 20;
+static constexpr uint32_t NUM_OF_MSGS      = 20000;
+
+struct Attitude {
+    int64_t time;
+    float   quaternion[4];
+    float   rates[3];
+    float   covariance[6];
+};
+
+/// decimation by hand: every message gets through the semaphore and into put
+class DecimatingPutter : public Putter {
+    uint32_t msgs = 0;
+
+  public:
+    CommBuffer<Attitude> latest;
+    bool putGeneric(const uint32_t topicId, const size_t len, const void* msg, const NetMsgInfo& netMsgInfo) override {
+        if((msgs++ % 10) != 0) return true;
+        return latest.putGeneric(topicId, len, msg, netMsgInfo);
+    }
+};
+
+static Topic<Attitude> attitude(3600, "attitude");
+
+struct Consumer {
+    CommBuffer<Attitude> buffer;
+    DecimatingPutter     byHand;
+    Subscriber           subscriber;
+    Subscriber           byHandSubscriber;
+    Consumer() : subscriber(attitude, buffer, "consumer"), byHandSubscriber(attitude, byHand, "byHand") {}
+};
+static Consumer consumers[NUM_OF_CONSUMERS];
+
+static void setPolicy(uint32_t decimation, int64_t interval, bool changeOnly, bool byHand) {
+    for(Consumer& consumer : consumers) {
+        consumer.subscriber.setDecimation(decimation);
+        consumer.subscriber.setThrottle(interval);
+        consumer.subscriber.setChangeOnly(changeOnly);
+        consumer.subscriber.enable(!byHand);
+        consumer.byHandSubscriber.enable(byHand);
+    }
+}
+
+static int64_t publishAll(bool changing) {
+    Attitude sample;
+    memset(&sample, 0, sizeof(sample));
+    int64_t start = NOW();
+    for(uint32_t i = 0; i < NUM_OF_MSGS; i++) {
+        if(changing) sample.time = static_cast<int64_t>(i);
+        attitude.publish(sample);
+    }
+    return (NOW() - start) / NUM_OF_MSGS;
+}
+
+static void printCase(const char* name, int64_t nsPerMsg, int64_t reference) {
+    PRINTF("  %s %d ns/msg, %d%% CPU saved\n", name, static_cast<int>(nsPerMsg),
+           static_cast<int>(100 - nsPerMsg * 100 / reference));
+}
+
+class SubscriberAdaptersBenchmark : public StaticThread<> {
+  public:
+    SubscriberAdaptersBenchmark() : StaticThread<>("subscriberAdaptersBenchmark", 300) {}
+
+    void run() {
+        PRINTF("%d consumers, %d messages of %d bytes\n", static_cast<int>(NUM_OF_CONSUMERS), static_cast<int>(NUM_OF_MSGS),
+               static_cast<int>(sizeof(Attitude)));
+
+        setPolicy(1, 0, false, false);
+        int64_t all = publishAll(true);
+        setPolicy(1, 0, false, true);
+        int64_t byHand = publishAll(true);
+        setPolicy(10, 0, false, false);
+        int64_t decimated = publishAll(true);
+        setPolicy(1, 1 * MILLISECONDS, false, false);
+        int64_t throttled = publishAll(true);
+        setPolicy(1, 0, true, false);
+        int64_t unchanged = publishAll(false);
+
+        printCase("every message          ", all, all);
+        printCase("decimation by hand     ", byHand, all);
+        printCase("setDecimation(10)      ", decimated, all);
+        printCase("setThrottle(1 ms)      ", throttled, all);
+        printCase("setChangeOnly, constant", unchanged, all);
+        PRINTF("  skipped by the first consumer: %d\n", static_cast<int>(consumers[0].subscriber.skippedMsgs));
+        hwResetAndReboot();
+    }
+} subscriberAdaptersBenchmark;
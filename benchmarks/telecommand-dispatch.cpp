@@ -0,0 +1,123 @@
+#include "rodos.h"
+#include "telecommand-dispatcher-1024.h"
+
+/**
+ * Dispatch of 1024 telecommands (64 services with 16 commands each, see
+ * telecommands-1024.tc), ns per command with its length check, of
+ *   - the generated dispatcher: perfect hash into a dense table
+ *   - an if chain on the ids in the order of the definition (modelled by a
+ *     linear search), like hand written dispatchers
+ *   - a switch on the ids, which the compiler makes a binary search for ids
+ *     this sparse (modelled by a binary search)
+ * for the commands of the first service, of the last one, all in random
+ * order and for unknown ids. The arguments are read through the generated
+ * views.
+ */
+
+static constexpr uint32_t NUM_OF_SERVICES = 64;
+static constexpr uint32_t NUM_OF_IDS      = 4096;
+static constexpr uint32_t ROUNDS          = 100;
+
+static uint16_t commandId(uint32_t service, uint32_t subservice) { return static_cast<uint16_t>(((service * 3 + 4) << 8) | (subservice + 1)); }
+static uint16_t argsLen(uint32_t subservice) {
+    static const uint16_t lens[16] = { 0, 1, 6, 4, 6, 0, 0, 4, 9, 0, 0, 0, 0, 0, 0, 0 };
+    return lens[subservice];
+}
+
+struct Command {
+    uint16_t id;
+    uint16_t argsLen;
+};
+static Command definitions[BENCH::TelecommandDispatcher::NUM_OF_COMMANDS]; // like in telecommands-1024.tc
+static Command sorted[BENCH::TelecommandDispatcher::NUM_OF_COMMANDS];
+
+static int64_t sum = 0;
+
+class Handlers : public BENCH::TelecommandDispatcher {
+  public:
+    uint32_t calls = 0;
+    void     S00_CMD01() override { calls++; }
+    void     S00_CMD02(const BENCH::S00_CMD02_Args& args) override {
+        calls++;
+        sum += args.MODE();
+    }
+    void S00_CMD03(const BENCH::S00_CMD03_Args& args) override {
+        calls++;
+        sum += args.ANGLE() + args.DURATION();
+    }
+    void S63_CMD16() override { calls++; }
+};
+static Handlers handlers;
+
+static bool linearSearch(uint16_t id, uint32_t len) { // if(id == ...) else if ...
+    for(uint32_t i = 0; i < BENCH::TelecommandDispatcher::NUM_OF_COMMANDS; i++) {
+        if(definitions[i].id == id) return definitions[i].argsLen == len;
+    }
+    return false;
+}
+
+static bool binarySearch(uint16_t id, uint32_t len) {
+    uint32_t low  = 0;
+    uint32_t high = BENCH::TelecommandDispatcher::NUM_OF_COMMANDS;
+    while(low < high) {
+        uint32_t middle = (low + high) / 2;
+        if(sorted[middle].id == id) return sorted[middle].argsLen == len;
+        if(sorted[middle].id < id) low = middle + 1;
+        else high = middle;
+    }
+    return false;
+}
+
+static uint16_t ids[NUM_OF_IDS];
+static uint16_t lens[NUM_OF_IDS];
+static uint8_t  args[64];
+
+/// ns per command, and how many were found with the right length
+static int64_t measure(uint32_t method, uint32_t& found) {
+    found         = 0;
+    int64_t start = NOW();
+    for(uint32_t round = 0; round < ROUNDS; round++) {
+        for(uint32_t i = 0; i < NUM_OF_IDS; i++) {
+            bool ok;
+            if(method == 0) ok = handlers.dispatch(ids[i], args, lens[i]) == BENCH::TelecommandDispatcher::DISPATCHED;
+            else if(method == 1) ok = linearSearch(ids[i], lens[i]);
+            else ok = binarySearch(ids[i], lens[i]);
+            if(ok) found++;
+        }
+    }
+    return (NOW() - start) / (ROUNDS * NUM_OF_IDS);
+}
+
+class TelecommandDispatchBenchmark : public StaticThread<> {
+  public:
+    void run() {
+        uint32_t n = 0;
+        for(uint32_t service = 0; service < NUM_OF_SERVICES; service++) {
+            for(uint32_t subservice = 0; subservice < 16; subservice++, n++) definitions[n] = { commandId(service, subservice), argsLen(subservice) };
+        }
+        for(uint32_t i = 0; i < n; i++) sorted[i] = definitions[i]; // already by id
+        for(uint32_t i = 0; i < sizeof(args); i++) args[i] = static_cast<uint8_t>(i + 1);
+        PRINTF("%d commands, %d per measurement, ns per command\n", static_cast<int>(n), static_cast<int>(NUM_OF_IDS));
+        PRINTF("                  perfect hash  if chain  switch (binary search)\n");
+
+        uint32_t seed = 4711;
+        for(uint32_t kind = 0; kind < 4; kind++) {
+            for(uint32_t i = 0; i < NUM_OF_IDS; i++) {
+                seed                = seed * 1103515245 + 12345;
+                uint32_t service    = (kind == 0) ? 0 : (kind == 1) ? NUM_OF_SERVICES - 1 : (seed >> 16) % NUM_OF_SERVICES;
+                uint32_t subservice = i % 16;
+                ids[i]              = (kind == 3) ? static_cast<uint16_t>(commandId(service, subservice) + 16) : commandId(service, subservice);
+                lens[i]             = argsLen(subservice);
+            }
+            uint32_t found[3];
+            int64_t  time[3];
+            for(uint32_t method = 0; method < 3; method++) time[method] = measure(method, found[method]);
+
+            static const char* kinds[] = { "first service  ", "last service   ", "random         ", "unknown ids    " };
+            PRINTF("  %s %d            %d        %d", kinds[kind], static_cast<int>(time[0]), static_cast<int>(time[1]), static_cast<int>(time[2]));
+            PRINTF("   (found %d %d %d)\n", static_cast<int>(found[0]), static_cast<int>(found[1]), static_cast<int>(found[2]));
+        }
+        PRINTF("handler calls %d, sum %lld\n", static_cast<int>(handlers.calls), static_cast<long long>(sum));
+        hwResetAndReboot();
+    }
+} telecommandDispatchBenchmark;
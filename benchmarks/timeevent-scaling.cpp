@@ -0,0 +1,62 @@
+#include "rodos.h"
+#include "rodos-bench.h"
+
+/**
+ * rodos-bench: TimeEvent::propagate() and getNextTriggerTime() with 512
+ * more time events registered, of which 0 .. 512 are due. propagate() is
+ * called with a time far in the future (the events are activated there),
+ * so that the timer of the system does not handle them before.
+ */
+
+static constexpr uint32_t NUM_OF_EVENTS = 512;
+static constexpr uint32_t SAMPLES       = 2000;
+static constexpr int64_t  FUTURE        = 1000000 * SECONDS;
+
+static uint32_t handled = 0;
+
+class BenchEvent : public TimeEvent {
+  public:
+    BenchEvent() : TimeEvent("benchEvent") {}
+    void handle() override { handled++; }
+
+    static uint32_t registered() {
+        uint32_t count = 0;
+        ITERATE_LIST(TimeEvent, TimeEvent::timeEventList) count++;
+        return count;
+    }
+};
+
+static BenchEvent                 events[NUM_OF_EVENTS];
+static BenchSampleBuffer<SAMPLES> samples;
+
+class TimeEventScaling : public StaticThread<> {
+  public:
+    void run() {
+        char     caseName[60];
+        uint32_t registered = BenchEvent::registered();
+
+        for(uint32_t due = 0; due <= NUM_OF_EVENTS; due = (due == 0) ? 1 : due * 8) {
+            samples.clear();
+            handled = 0;
+            for(uint32_t i = 0; i < SAMPLES; i++) {
+                for(uint32_t e = 0; e < due; e++) events[e].activateAt(FUTURE);
+                uint64_t start = benchCycles();
+                TimeEvent::propagate(FUTURE + 1);
+                samples.add(benchCycles() - start);
+            }
+            SPRINTF(caseName, "propagate registered=%d due=%d", static_cast<int>(registered), static_cast<int>(due));
+            benchReport("timeevent-scaling", caseName, samples);
+            if(handled != due * SAMPLES) PRINTF("handled %d of %d\n", static_cast<int>(handled), static_cast<int>(due * SAMPLES));
+        }
+
+        samples.clear();
+        for(uint32_t i = 0; i < SAMPLES; i++) {
+            uint64_t start = benchCycles();
+            TimeEvent::getNextTriggerTime();
+            samples.add(benchCycles() - start);
+        }
+        SPRINTF(caseName, "getNextTriggerTime registered=%d", static_cast<int>(registered));
+        benchReport("timeevent-scaling", caseName, samples);
+        hwResetAndReboot();
+    }
+} timeEventScaling;
@@ -0,0 +1,81 @@
+#include "rodos.h"
+#include "rodos-bench.h"
+
+/**
+ * rodos-bench: wakeup lateness of the time base of the port
+ *   - suspendCallerUntil(): from the planned time until the thread runs
+ *   - TimeEvent: from eventAt until handle() runs, activated 1 ms ahead in
+ *     handle() (posix: in the timer thread) and from a thread
+ * Compare the posix timer thread with the setitimer/SIGALRM timer of older
+ * versions: configure with -DPOSIX_SIGNAL_TIMER=ON and run both.
+ */
+
+static constexpr uint32_t SAMPLES = 1000;
+static constexpr int64_t  PERIOD  = 1 * MILLISECONDS;
+
+static BenchSampleBuffer<SAMPLES> samples;
+
+static void addLateness(int64_t late) {
+    static double cyclesPerNs = benchCyclesPerSecond() / 1.0e9;
+    samples.add(static_cast<uint64_t>(static_cast<double>((late > 0) ? late : 0) * cyclesPerNs));
+}
+
+class LatenessEvent : public TimeEvent {
+  public:
+    int64_t          plannedAt = 0;
+    bool             chained   = false; ///< activates itself again in handle()
+    Atomic<uint32_t> handled{ 0 };
+
+    LatenessEvent() : TimeEvent("latenessEvent") {}
+
+    void handle() override {
+        addLateness(NOW() - plannedAt);
+        handled++;
+        if(chained && handled.load() < SAMPLES) {
+            plannedAt = NOW() + PERIOD;
+            activateAt(plannedAt);
+        }
+    }
+} latenessEvent;
+
+class TimerJitter : public StaticThread<> {
+  public:
+    TimerJitter() : StaticThread<>("timerJitter", 200) {}
+
+    void run() {
+        benchCyclesPerSecond(); // calibrated before the measurements
+
+        samples.clear();
+        int64_t next = NOW() + PERIOD;
+        for(uint32_t i = 0; i < SAMPLES; i++) {
+            suspendCallerUntil(next);
+            addLateness(NOW() - next);
+            next += PERIOD;
+        }
+        benchReport("timer-jitter", "suspendCallerUntil", samples);
+
+        samples.clear();
+        latenessEvent.chained   = true;
+        latenessEvent.handled   = 0;
+        latenessEvent.plannedAt = NOW() + PERIOD;
+        latenessEvent.activateAt(latenessEvent.plannedAt);
+        int64_t giveUp = NOW() + 5 * SAMPLES * PERIOD; // the interval timer needs 100 ms for each one
+        while(latenessEvent.handled.load() < SAMPLES && NOW() < giveUp) suspendCallerUntil(NOW() + 10 * MILLISECONDS);
+        latenessEvent.chained = false;
+        latenessEvent.activateAt(END_OF_TIME);
+        suspendCallerUntil(NOW() + 200 * MILLISECONDS); // a handle() in progress ends
+        benchReport("timer-jitter", "TimeEvent chained", samples);
+
+        samples.clear();
+        latenessEvent.chained = false;
+        latenessEvent.handled = 0;
+        for(uint32_t i = 0; i < SAMPLES / 10; i++) { // up to one timer interval late: fewer samples
+            latenessEvent.plannedAt = NOW() + PERIOD;
+            latenessEvent.activateAt(latenessEvent.plannedAt);
+            while(latenessEvent.handled.load() <= i) suspendCallerUntil(NOW() + 1 * MILLISECONDS);
+        }
+        benchReport("timer-jitter", "TimeEvent from thread", samples);
+
+        hwResetAndReboot();
+    }
+} timerJitter;
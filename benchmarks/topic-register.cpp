@@ -0,0 +1,134 @@
+#include "rodos.h"
+#include "distributed-topic-register.h"
+
+/**
+ * Bandwidth and convergence time of the distributed-topic-register.
+ * One node with NUM_OF_TOPICS topics with subscribers; its link counts the
+ * topic reports (topic id 1) which it would broadcast. Measured:
+ *   - steady state bytes/s (only digests)
+ *   - time from Subscriber::enable() to the delta on the link
+ *   - size of a delta and of a whole snapshot
+ * The table for 10..100 nodes on a broadcast bus is a model, not a
+ * measurement: N times the figures of this node (all nodes like this one,
+ * no other node is simulated, no collisions or retries), compared with the
+ * former full reports: the whole TopicListReport every 3 s, at most 60
+ * topics. The output says so.
+ */
+
+static constexpr int32_t NUM_OF_TOPICS  = 200;
+static constexpr int64_t STEADY_TIME    = 9 * SECONDS;
+static constexpr int32_t NUM_OF_CHANGES = 20;
+static constexpr size_t  NETWORK_HEADER_SIZE = sizeof(NetworkMessage) - MAX_NETWORK_MESSAGE_LENGTH;
+
+static DistributedTopicRegisterDecoy linkTheRegister;
+
+/** Topic reports of this node which the gateway sends */
+class CountingLink : public Linkinterface {
+  public:
+    uint32_t bytes[4]   = { 0, 0, 0, 0 }; ///< per TopicReportKind, with network header
+    uint32_t counts[4]  = { 0, 0, 0, 0 };
+    int64_t  lastDeltaTime = 0;
+
+    CountingLink() : Linkinterface(-1) {}
+    bool sendNetworkMsg(NetworkMessage& outgoingMessage) override {
+        if(outgoingMessage.get_topicId() != TOPIC_ID_FOR_TOPICLIST_DISTRIBUTION) return true;
+        TopicListPerNode* report = reinterpret_cast<TopicListPerNode*>(outgoingMessage.userDataC);
+        uint32_t kind = static_cast<uint32_t>(report->kind);
+        if(kind >= 4) return true;
+        bytes[kind] += outgoingMessage.numberOfBytesToSend();
+        counts[kind]++;
+        if(report->kind == TopicReportKind::DELTA) lastDeltaTime = NOW();
+        return true;
+    }
+    void suspendUntilDataReady(int64_t reactivationTime) override { Thread::suspendCallerUntil(reactivationTime); }
+    void reset() {
+        for(int32_t i = 0; i < 4; i++) bytes[i] = counts[i] = 0;
+    }
+};
+
+static CountingLink countingLink;
+static Gateway      gateway(&countingLink, true); // forward all: there are no other nodes
+
+static void nopReceiver([[gnu::unused]] int32_t& value) {}
+
+static uint32_t nextTopicId = 4000;
+
+struct TopicWithSubscriber {
+    Topic<int32_t>              topic;
+    SubscriberReceiver<int32_t> receiver;
+    TopicWithSubscriber() : topic(static_cast<int64_t>(nextTopicId++), "benchTopic"), receiver(topic, nopReceiver, "benchReceiver") {}
+};
+
+static TopicWithSubscriber topics[NUM_OF_TOPICS];
+
+/// the former report: nodeNr, nodeIndex and a TopicListReport, always sent complete
+struct FormerTopicListPerNode {
+    uint32_t        nodeNr;
+    uint8_t         nodeIndex;
+    TopicListReport topicListReport;
+};
+static constexpr int32_t FORMER_MAX_TOPICS = static_cast<int32_t>(sizeof(TopicListReport::topicList) / sizeof(uint32_t));
+
+static TopicListPerNode request;
+
+class TopicRegisterBenchmark : public StaticThread<> {
+  public:
+    TopicRegisterBenchmark() : StaticThread<>("topicRegisterBenchmark", 300) {}
+
+    void run() {
+        suspendCallerUntil(NOW() + 500 * MILLISECONDS); // initial delta
+        int32_t initialBytes = static_cast<int32_t>(countingLink.bytes[0]);
+
+        countingLink.reset();
+        suspendCallerUntil(NOW() + STEADY_TIME);
+        int32_t steadyBytesPerS = static_cast<int32_t>(static_cast<int64_t>(countingLink.bytes[1]) * SECONDS / STEADY_TIME);
+
+        countingLink.reset();
+        int64_t sumLatency = 0;
+        int64_t maxLatency = 0;
+        for(int32_t i = 0; i < NUM_OF_CHANGES; i++) {
+            SubscriberReceiver<int32_t>& receiver = topics[(i / 2) * (2 * NUM_OF_TOPICS / NUM_OF_CHANGES)].receiver;
+            int64_t                      changeTime = NOW();
+            receiver.enable((i % 2) == 1); // off, on again
+
+            suspendCallerUntil(NOW() + 20 * MILLISECONDS);
+            int64_t latency = countingLink.lastDeltaTime - changeTime;
+            sumLatency += latency;
+            if(latency > maxLatency) maxLatency = latency;
+        }
+        int32_t deltaBytes = static_cast<int32_t>(countingLink.bytes[0] / countingLink.counts[0]);
+
+        countingLink.reset();
+        request.nodeNr        = 1234;
+        request.nodeIndex     = static_cast<uint8_t>(NodeSet::nodeIndex(1234));
+        request.kind          = TopicReportKind::REQUEST;
+        request.requestedNode = static_cast<uint32_t>(getNodeNumber());
+        topicListDistribution.publish(request, false);
+        suspendCallerUntil(NOW() + 100 * MILLISECONDS);
+        int32_t snapshotBytes = static_cast<int32_t>(countingLink.bytes[3]);
+        int32_t requestBytes  = static_cast<int32_t>(NETWORK_HEADER_SIZE + request.len());
+
+        int32_t formerBytes = static_cast<int32_t>(NETWORK_HEADER_SIZE + sizeof(FormerTopicListPerNode));
+        int32_t formerBytesPerS = static_cast<int32_t>(formerBytes * SECONDS / TOPIC_DIGEST_PERIOD);
+
+        PRINTF("one node, %d topics with subscribers (the former reports had at most %d)\n", static_cast<int>(NUM_OF_TOPICS),
+               static_cast<int>(FORMER_MAX_TOPICS));
+        PRINTF("  initial delta %d bytes, steady state %d bytes/s (former %d)\n", initialBytes,
+               static_cast<int>(steadyBytesPerS), static_cast<int>(formerBytesPerS));
+        PRINTF("  change: delta %d bytes (former %d), enable() -> link mean %d us, max %d us (former up to %d ms)\n",
+               static_cast<int>(deltaBytes), static_cast<int>(formerBytes), static_cast<int>(sumLatency / NUM_OF_CHANGES / MICROSECONDS),
+               static_cast<int>(maxLatency / MICROSECONDS), static_cast<int>(TOPIC_DIGEST_PERIOD / MILLISECONDS));
+        PRINTF("  snapshot %d bytes, request %d bytes\n", static_cast<int>(snapshotBytes), static_cast<int>(requestBytes));
+
+        PRINTF("\nMODEL, not measured: N nodes like this one on one broadcast bus, bytes/s\n");
+        PRINTF("  (N x the figures above; a join: N-1 requests and snapshots plus the initial delta)\n");
+        PRINTF("  nodes   former   steady  +1 change/s/node  join of a node (bytes once)\n");
+        static const int32_t numsOfNodes[] = { 10, 25, 50, 100 };
+        for(int32_t n : numsOfNodes) {
+            PRINTF("  %5d %8d %8d %8d          %8d\n", static_cast<int>(n), static_cast<int>(n * formerBytesPerS),
+                   static_cast<int>(n * steadyBytesPerS), static_cast<int>(n * (steadyBytesPerS + deltaBytes)),
+                   static_cast<int>((n - 1) * (requestBytes + snapshotBytes) + initialBytes));
+        }
+        hwResetAndReboot();
+    }
+} topicRegisterBenchmark;
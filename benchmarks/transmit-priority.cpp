@@ -0,0 +1,146 @@
+#include "rodos.h"
+
+/**
+ * Latency of high priority commands on a link saturated with bulk data
+ * (images of 4 fragments, back to back), shaped by the rate limiter of the
+ * link to 100 KB/s: without TransmitScheduler, with strict priority and with
+ * weighted fair queuing. The link itself is instant: the latency is the time
+ * from publish() to Linkinterface::sendNetworkMsg().
+ * Without scheduler the command publisher is blocked by the link too and
+ * misses periods: fewer commands are sent.
+ */
+
+static constexpr uint32_t LINK_RATE        = 100 * 1000;
+static constexpr int64_t  PHASE_DURATION   = 3 * SECONDS;
+static constexpr int64_t  COMMAND_PERIOD   = 7 * MILLISECONDS;
+static constexpr int32_t  MAX_SAMPLES      = 1024;
+static constexpr int32_t  NUM_OF_PHASES    = 3;
+
+static const char* phaseNames[NUM_OF_PHASES] = { "no scheduler", "strict priority", "weighted fair" };
+
+struct Command {
+    uint8_t data[16];
+};
+struct Image {
+    uint8_t pixels[4 * MAX_FRAGMENT_DATA];
+};
+
+/** Records the latency of commands and the bytes of bulk data */
+class ShapedLink : public Linkinterface {
+  public:
+    int64_t  latencies[MAX_SAMPLES];
+    int32_t  numOfSamples = 0;
+    uint64_t bulkBytes    = 0;
+
+    ShapedLink() : Linkinterface(-1) { setRateLimit(LINK_RATE, 2 * sizeof(NetworkMessage)); }
+    bool sendNetworkMsg(NetworkMessage& outgoingMessage) override {
+        if(outgoingMessage.get_type() & NET_MSG_FRAGMENT) {
+            bulkBytes += outgoingMessage.numberOfBytesToSend();
+        } else if(outgoingMessage.get_topicId() != 0 && numOfSamples < MAX_SAMPLES) {
+            latencies[numOfSamples++] = NOW() - outgoingMessage.get_sentTime();
+        }
+        return true;
+    }
+    void suspendUntilDataReady(int64_t reactivationTime) override { Thread::suspendCallerUntil(reactivationTime); }
+};
+
+static Topic<Command> commands[NUM_OF_PHASES] = {
+    { 3300, "commands0", false, TransmitPriority::HIGH },
+    { 3301, "commands1", false, TransmitPriority::HIGH },
+    { 3302, "commands2", false, TransmitPriority::HIGH }
+};
+static Topic<Image> images[NUM_OF_PHASES] = {
+    { 3310, "images0", false, TransmitPriority::BULK },
+    { 3311, "images1", false, TransmitPriority::BULK },
+    { 3312, "images2", false, TransmitPriority::BULK }
+};
+
+static ShapedLink links[NUM_OF_PHASES];
+static Gateway    gateways[NUM_OF_PHASES] = { Gateway(&links[0]), Gateway(&links[1]), Gateway(&links[2]) };
+
+static TransmitScheduler strictScheduler(TransmitScheduler::Mode::STRICT_PRIORITY);
+static TransmitScheduler fairScheduler(TransmitScheduler::Mode::WEIGHTED_FAIR);
+
+static int32_t volatile phase        = -1;
+static bool    volatile phaseRunning = false;
+
+static void sortSamples(int64_t* samples, int32_t n) {
+    for(int32_t i = 1; i < n; i++) {
+        int64_t value = samples[i];
+        int32_t j     = i;
+        for(; j > 0 && samples[j - 1] > value; j--) samples[j] = samples[j - 1];
+        samples[j] = value;
+    }
+}
+
+static int32_t percentileUs(const int64_t* sorted, int32_t n, int32_t percent) {
+    if(n == 0) return 0;
+    int32_t index = (n * percent) / 100;
+    if(index >= n) index = n - 1;
+    return static_cast<int32_t>(sorted[index] / MICROSECONDS);
+}
+
+class ImagePublisher : public StaticThread<> {
+    Image image;
+
+  public:
+    ImagePublisher() : StaticThread<>("imagePublisher", 100) {}
+    void run() {
+        memset(&image, 0x55, sizeof(image));
+        while(1) {
+            if(phaseRunning) {
+                images[phase].publish(image);
+            } else {
+                suspendCallerUntil(NOW() + 10 * MILLISECONDS);
+            }
+        }
+    }
+} imagePublisher;
+
+class CommandPublisher : public StaticThread<> {
+    Command command;
+
+  public:
+    CommandPublisher() : StaticThread<>("commandPublisher", 200) {}
+    void run() {
+        memset(&command, 0, sizeof(command));
+        TIME_LOOP(0, COMMAND_PERIOD) {
+            if(phaseRunning) commands[phase].publish(command);
+        }
+    }
+} commandPublisher;
+
+class TransmitPriorityBenchmark : public StaticThread<> {
+  public:
+    TransmitPriorityBenchmark() : StaticThread<>("transmitPriorityBenchmark", 300) {}
+
+    void init() {
+        for(int32_t i = 0; i < NUM_OF_PHASES; i++) gateways[i].addTopicsToForward(&commands[i], &images[i]);
+        gateways[1].setTransmitScheduler(&strictScheduler);
+        gateways[2].setTransmitScheduler(&fairScheduler);
+    }
+
+    void run() {
+        PRINTF("link %d bytes/s, images of %d bytes back to back, a command every %d ms\n",
+               static_cast<int>(LINK_RATE), static_cast<int>(sizeof(Image)), static_cast<int>(COMMAND_PERIOD / MILLISECONDS));
+        PRINTF("command latency in us: p50 p90 p99 max, bulk throughput\n");
+
+        for(int32_t i = 0; i < NUM_OF_PHASES; i++) {
+            phase        = i;
+            phaseRunning = true;
+            suspendCallerUntil(NOW() + PHASE_DURATION);
+            phaseRunning = false;
+            suspendCallerUntil(NOW() + 500 * MILLISECONDS); // the queues drain
+
+            ShapedLink& link = links[i];
+            sortSamples(link.latencies, link.numOfSamples);
+            PRINTF("%s: %d commands, latency %d %d %d %d, bulk %d bytes/s\n", phaseNames[i], static_cast<int>(link.numOfSamples),
+                   static_cast<int>(percentileUs(link.latencies, link.numOfSamples, 50)),
+                   static_cast<int>(percentileUs(link.latencies, link.numOfSamples, 90)),
+                   static_cast<int>(percentileUs(link.latencies, link.numOfSamples, 99)),
+                   static_cast<int>(percentileUs(link.latencies, link.numOfSamples, 100)),
+                   static_cast<int>(link.bulkBytes * SECONDS / (PHASE_DURATION + 500 * MILLISECONDS)));
+        }
+        hwResetAndReboot();
+    }
+} transmitPriorityBenchmark;
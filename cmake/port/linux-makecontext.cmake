@@ -1,5 +1,3 @@
 set(port_dir "bare-metal/linux-makecontext")
 set(is_port_baremetal TRUE)
 
-add_compile_options(-m32)
-add_link_options(-m32)
@@ -49,6 +49,7 @@ void Semaphore::enter() {
     PRIORITY_CEILER_IN_SCOPE();
     // Check if semaphore is occupied by another thread
     if ((owner != 0) && (owner != caller) ) {
+      RODOS_TRACE(SEMAPHORE_REQUEST, traceId(this), 0);
 
       // Avoid priority inversion
       if (callerPriority > owner.load()->getPriority()) {
@@ -61,6 +62,7 @@ void Semaphore::enter() {
     owner = caller;
     ownerPriority = callerPriority;
     ownerEnterCnt = ownerEnterCnt + 1;
+    if(ownerEnterCnt == 1) RODOS_TRACE(SEMAPHORE_ENTER, traceId(this), 0);
   } // end of prio_ceiling
   caller->yield(); // wating with prio_ceiling, maybe some one more important wants to work?
 }
@@ -85,6 +87,7 @@ void Semaphore::leave() {
   int32_t currentOwnerPriority;
   {
     PRIORITY_CEILER_IN_SCOPE();
+    RODOS_TRACE(SEMAPHORE_LEAVE, traceId(this), 0);
     owner = 0;
     currentOwnerPriority = ownerPriority;
     ownerPriority = 0;
@@ -43,6 +43,7 @@ extern RODOS::Atomic<int64_t> timeToTryAgainToSchedule;
 void schedulerWrapper(long* ctx) {
     Thread *active_trd = Thread::currentThread.loadFromISR();
     active_trd->context = ctx;
+    RODOS_TRACE(INTERRUPT_BEGIN, 0, 0);
 
 #ifndef DISABLE_TIMEEVENTS
     TimeEvent::propagate(NOW());
@@ -63,6 +64,7 @@ void schedulerWrapper(long* ctx) {
     } else {
         active_trd = Scheduler::schedule();
     }
+    RODOS_TRACE(INTERRUPT_END, 0, 0);
 
     // resume active thread
     active_trd->activate();
@@ -116,6 +118,14 @@ Thread* Scheduler::schedule() {
         nextThreadToRun = idlethreadP;
     }
 
+    Thread* previousThread = Thread::currentThread.loadFromISR();
+    if(nextThreadToRun != previousThread) RODOS_TRACE(THREAD_RUN, traceId(nextThreadToRun), 0);
+
+    // CPU time accounting: the previous thread ran until now (also if it continues)
+    int64_t timeNow = NOW();
+    previousThread->runTime += timeNow - previousThread->runningSince;
+    nextThreadToRun->runningSince = timeNow;
+
     // update the respective variables according to the schedule
     nextThreadToRun->lastActivation.storeFromISR(Scheduler::scheduleCounter.loadFromISR()); // timeNow ?? but what with on-os_xx, on-posix, etc?
 
@@ -20,7 +20,7 @@
 
 namespace RODOS {
 
-constexpr uint32_t EMPTY_MEMORY_MARKER = 0xDEADBEEF;
+constexpr uint32_t EMPTY_MEMORY_MARKER = StackWatermark::EMPTY_MEMORY_MARKER;
 
 RODOS::Atomic<int64_t> timeToTryAgainToSchedule{0};
 RODOS::Atomic<bool> yieldSchedulingLock{false};
@@ -41,19 +41,18 @@ Thread::Thread(const char* name,
 }
 
 void Thread::initializeStack() {
-    //Paint the stack space TODO: Comment out for faster start up
-    uint32_t* stackPaint = (uint32_t*)stack;
-    while((intptr_t)stackPaint >= (intptr_t)stackBegin) {
-        *stackPaint = EMPTY_MEMORY_MARKER;
-        stackPaint--;
-    }
+    //Paint the stack space, for the stack usage and the guard words
+    uintptr_t lowestWord = (reinterpret_cast<uintptr_t>(stackBegin) + 3) & ~static_cast<uintptr_t>(3u);
+    uintptr_t stackEnd   = (reinterpret_cast<uintptr_t>(stackBegin) + stackSize) & ~static_cast<uintptr_t>(3u);
+    StackWatermark::paint(reinterpret_cast<uint32_t*>(lowestWord), reinterpret_cast<uint32_t*>(stack) + 1);
+    stackWatermark.init(reinterpret_cast<uint32_t*>(lowestWord), reinterpret_cast<uint32_t*>(stackEnd));
 
     context = hwInitContext(stack, this);
 }
 
 bool Thread::checkStackViolations() {
     /** Check stack violations **/
-    constexpr size_t stackMargin      = 300;
+    constexpr size_t stackMargin      = StackWatermark::STACK_MARGIN;
     uintptr_t        minimumStackAddr = reinterpret_cast<uintptr_t>(this->stackBegin) + stackMargin;
     if(this->getCurrentStackAddr() < minimumStackAddr) {
         xprintf("!StackOverflow! %s DEACTIVATED!: free %d\n",
@@ -62,10 +61,13 @@ bool Thread::checkStackViolations() {
         this->suspendedUntil.store(END_OF_TIME);
         return true;
     }
-    if(*reinterpret_cast<uint32_t*>(this->stackBegin) != EMPTY_MEMORY_MARKER) { // this thread is going beyond its stack!
-        xprintf("! PANIC %s beyond stack, DEACTIVATED!\n", this->name);
-        this->suspendedUntil.store(END_OF_TIME);
-        return true;
+    const uint32_t* guardWords = reinterpret_cast<uint32_t*>(this->stackBegin);
+    for(uint32_t i = 0; i < STACK_GUARD_WORDS; i++) {
+        if(guardWords[i] != EMPTY_MEMORY_MARKER) { // this thread is going beyond its stack!
+            xprintf("! PANIC %s beyond stack, DEACTIVATED!\n", this->name);
+            this->suspendedUntil.store(END_OF_TIME);
+            return true;
+        }
     }
 
     return false;
@@ -168,6 +170,28 @@ Thread* Thread::getCurrentThread() {
     return currentThread;
 }
 
+int64_t Thread::getCpuTime() const {
+    int64_t cpuTime      = runTime;
+    int64_t switchedInAt = runningSince;
+    if(this == currentThread.load()) cpuTime += NOW() - switchedInAt;
+    return cpuTime;
+}
+
+Thread* traceCurrentThread() {
+    return Thread::getCurrentThread();
+}
+
+/* one core: core 0 */
+bool Thread::setAffinity(uint64_t cpuMask) {
+    if(cpuMask != 0 && (cpuMask & 1) == 0) return false;
+    affinity = cpuMask;
+    return true;
+}
+
+uint64_t Thread::getAffinity() const { return 1; }
+
+bool lockProcessMemory() { return true; }
+
 
 
 /* resume the thread */
@@ -185,12 +209,14 @@ void Thread::resume() {
 bool Thread::suspendCallerUntil(const int64_t reactivationTime, void* signaler) {
 
     Thread* caller =  getCurrentThread();
+    caller->endActivation();
     {
         PRIORITY_CEILER_IN_SCOPE();
         caller->waitingFor = signaler;
         caller->suspendedUntil = reactivationTime;
     }
     yield();
+    caller->beginActivation();
 
     caller->waitingFor = nullptr;
     /** after yield: It was resumed (suspendedUntil set to 0) or time was reached ?*/
@@ -268,6 +294,7 @@ void IdleThread::run() {
         idleCnt = idleCnt + 1;
         setPriority(0); // Due to wrong usage of PRIORITY_CLING in events, once I got highest prio for Idle.
         sp_partition_yield(); // allow other linux processes or ARIC-653 partitions to run
+        scanStacks(STACK_SCAN_SLICE_WORDS);
         yield();
 
 #ifndef DISABLE_SLEEP_WHEN_IDLE
@@ -416,12 +443,8 @@ Thread* Thread::findNextWaitingFor(void* signaler) {
 size_t Thread::getMaxStackUsage(){
 	Thread* currentThread = getCurrentThread();
 
-	//Go to the beginning of the stack(lowest addres)
-	uint32_t* stackScan = (uint32_t*)currentThread->stack;
-	while((intptr_t)stackScan >= (intptr_t)currentThread->stackBegin){
-		stackScan--;
-	}
-	stackScan++;
+	//Begin at the lowest word of the stack
+	uint32_t* stackScan = (uint32_t*)(((uintptr_t)currentThread->stackBegin + 3) & ~(uintptr_t)3);
 
 	//Go up until empty markers are found and count
 	size_t freeStack=0;
@@ -60,7 +60,7 @@
 
 /** We can onlx buffer a few UDP packets on the gecko */
 #undef UDP_INCOMMIG_BUF_LEN          
-#define UDP_INCOMMIG_BUF_LEN         25 //number of "NetworkMessage (1300 Bytes each)" in FIFO
+#define UDP_INCOMMIG_BUF_LEN         25 //number of messages in FIFO, the messages are in NetBufferPool
 
 //______________________________________________________________________________________________
 
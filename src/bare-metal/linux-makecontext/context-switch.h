@@ -0,0 +1,16 @@
+/**
+* @file context-switch.h
+* @date 2026/10/18
+*
+* @brief selection of the context switch, see context-switch.S
+*
+* x86-64 and AArch64 switch in user space (context-switch.S), all others
+* and builds with MAKECONTEXT_UCONTEXT_SWITCH use ucontext
+* (swapcontext/setcontext), as before.
+*/
+
+#pragma once
+
+#if (defined(__x86_64__) || defined(__aarch64__)) && !defined(MAKECONTEXT_UCONTEXT_SWITCH)
+#define MAKECONTEXT_ASM_SWITCH
+#endif
@@ -1,3 +1,4 @@
+#include "context-switch.h"
 #include "hw_specific.h"
 #include "misc-rodos-funcs.h"
 #include "thread.h"
@@ -9,6 +10,55 @@
 
 namespace RODOS {
 
+#ifdef MAKECONTEXT_ASM_SWITCH
+
+extern "C" {
+  /** set while a context is saved and the next one loaded, see context-switch.S */
+  volatile sig_atomic_t __contextSwitching__ = 1; // until the first thread runs
+
+  /** the first return of a new thread, calls threadStartupWrapper(object) */
+  extern void __asmThreadEntry();
+
+  /** called by __asmSaveContextAndCallScheduler on the stack of the scheduler */
+  void __callSchedulerWrapper(long* ctx) { schedulerWrapper(ctx); }
+}
+
+uintptr_t Thread::getCurrentStackAddr(){
+    return reinterpret_cast<uintptr_t>(context.load());
+}
+
+/**
+ *create the frame of context-switch.S on stack and return a pointer to it
+ */
+long* hwInitContext(long* stack, void* object) {
+    /* top of stack = ALIGN(stack, 16 bytes boundary) */
+    uintptr_t tos = reinterpret_cast<uintptr_t>(stack) & (~static_cast<uintptr_t>(0xF));
+
+#if defined(__x86_64__)
+    long* ctx = reinterpret_cast<long*>(tos) - 8;
+    for(int i = 0; i < 8; i++) ctx[i] = 0;
+    /* current floating point control: mxcsr, x87 control word */
+    __asm__ __volatile__("stmxcsr (%0) \n"
+                         "\tfnstcw 4(%0)" ::"r"(ctx) : "memory");
+    ctx[3] = reinterpret_cast<long>(threadStartupWrapper); // r13
+    ctx[4] = reinterpret_cast<long>(object);               // r12
+    ctx[7] = reinterpret_cast<long>(__asmThreadEntry);     // return address
+#else
+    long* ctx = reinterpret_cast<long*>(tos) - 20;
+    for(int i = 0; i < 20; i++) ctx[i] = 0;
+    ctx[0]  = reinterpret_cast<long>(object);               // x19
+    ctx[1]  = reinterpret_cast<long>(threadStartupWrapper); // x20
+    ctx[11] = reinterpret_cast<long>(__asmThreadEntry);     // x30, return address
+#endif
+    return ctx;
+}
+
+void startIdleThread() { }
+
+}
+
+#else // ucontext
+
 ucontext_t* volatile contextT;
 
 constexpr size_t STACKSIZE = 4096;     /* stack size  WARNING/TODO: That is this? */
@@ -17,7 +67,13 @@ extern void* signal_stack;
 
 uintptr_t Thread::getCurrentStackAddr(){
     volatile ucontext_t* c = reinterpret_cast<volatile ucontext_t*>(context.load());
+#if defined(__x86_64__)
+    return static_cast<uintptr_t>(c->uc_mcontext.gregs[REG_RSP]);
+#elif defined(__aarch64__)
+    return static_cast<uintptr_t>(c->uc_mcontext.sp);
+#else
     return static_cast<uintptr_t>(c->uc_mcontext.gregs[REG_ESP]);
+#endif
 }
 
 /**
@@ -68,3 +124,5 @@ void __asmSwitchToContext(long* context) {
     RODOS::contextT = (ucontext_t*)context;
     setcontext(RODOS::contextT); /* go */
 }
+
+#endif // MAKECONTEXT_ASM_SWITCH
@@ -17,6 +17,7 @@
 
 #include <signal.h>
 
+#include "context-switch.h"
 #include "hw_specific.h"
 #include "rodos.h"
 #include "rodos-atomic.h"
@@ -59,6 +60,48 @@ extern "C" {
 extern RODOS::Atomic<bool> yieldSchedulingLock;
 extern void *signal_stack;
 
+#ifdef MAKECONTEXT_ASM_SWITCH
+
+extern "C" volatile sig_atomic_t __contextSwitching__;
+
+/**
+* The SIGALRM is a one-shot, armed by start() only if it does not come
+* before the requested time anyway: the switches (start, stop) do no
+* system call as long as the time slice is not over.
+*/
+static volatile int64_t signalDueAt = 0; ///< NOW() of the armed SIGALRM, 0: none
+constexpr int64_t RETRY_MICROSECONDS = 50;  ///< SIGALRM while switching
+
+static void armSignal(int64_t microseconds) {
+  itimerval params;
+  params.it_interval.tv_sec  = 0;
+  params.it_interval.tv_usec = 0;
+  params.it_value.tv_sec     = static_cast<__time_t>     (microseconds / 1000000);
+  params.it_value.tv_usec    = static_cast<__suseconds_t>(microseconds % 1000000);
+  if(microseconds <= 0) params.it_value.tv_usec = 1; // 0 would disarm
+  signalDueAt = NOW() + microseconds * MICROSECONDS;
+  int retval = setitimer(ITIMER_REAL,&params,0);
+  RODOS_ASSERT(retval == 0); // error during call to setitimer
+}
+
+/**
+* the signal handler for SIGALRM (timer signal)
+* SA_NODEFER: it may switch to a thread which does not return through a
+* signal handler, SIGALRM has to stay unblocked. During a yield and during a
+* switch it arms the signal again and returns.
+*/
+void timerSignalHandler(int, siginfo_t *, void *) {
+  signalDueAt = 0;
+  if(yieldSchedulingLock || __contextSwitching__) {
+    armSignal(RETRY_MICROSECONDS);
+    return;
+  }
+
+  __asmSaveContextAndCallScheduler();
+}
+
+#else
+
 /**
 * the signal handler for SIGVTALRM (timer signal)
 */
@@ -71,6 +114,8 @@ void timerSignalHandler(int, siginfo_t *, void *) {
   __asmSaveContextAndCallScheduler();
 }
 
+#endif
+
 /**
 * initialize the timer and signal handler 
 */
@@ -88,6 +133,9 @@ void Timer::init() {
     /* SA_ONSTACK - signal handler should use its own stack */ //<- disabled for the use of makecontext with newlib
     /* SA_RESTART - interrupted system calls shall be restartet */
     action.sa_flags = SA_SIGINFO | SA_RESTART;
+#ifdef MAKECONTEXT_ASM_SWITCH
+    action.sa_flags |= SA_NODEFER;
+#endif
 
     /* empty signal set */
     sigemptyset(&action.sa_mask);
@@ -101,6 +149,14 @@ void Timer::init() {
 * start timer 
 */
 void Timer::start() {
+#ifdef MAKECONTEXT_ASM_SWITCH
+  int64_t now   = NOW();
+  int64_t dueAt = signalDueAt;
+  if(dueAt > now && dueAt <= now + microsecondsInterval * MICROSECONDS) {
+    return; // the armed signal comes first, the scheduler starts the timer again then
+  }
+  armSignal(microsecondsInterval);
+#else
   itimerval params;
   int retval;
   params.it_interval.tv_sec  = static_cast<__time_t>     (microsecondsInterval / 1000000);
@@ -109,12 +165,16 @@ void Timer::start() {
   params.it_value.tv_usec    = params.it_interval.tv_usec;
   retval = setitimer(ITIMER_REAL,&params,0);
   RODOS_ASSERT(retval == 0); // error during call to sigaction
+#endif
 }
 
 /**
 * stop timer 
+* assembly switch: a SIGALRM during the yield is deferred by the handler,
+* the timer stays armed
 */
 void Timer::stop() {
+#ifndef MAKECONTEXT_ASM_SWITCH
   struct itimerval params;
   int retval;
   params.it_interval.tv_sec = 0;
@@ -123,6 +183,7 @@ void Timer::stop() {
   params.it_value.tv_usec = 0;
   retval = setitimer(ITIMER_REAL,&params,0);
   RODOS_ASSERT(retval == 0); // error during call to sigaction
+#endif
 }
 
 /**
@@ -19,11 +19,18 @@ namespace RODOS {
 // static long long timeAtStartup = 0LL;  now defined at 00globalobjects
 extern int64_t timeAtStartup;
 
+/** posix on Linux: NTP steps and settimeofday do not change NOW(), the wall clock is hwGetUTC() */
+#ifdef POSIX_MONOTONIC_TIMER
+static constexpr clockid_t RODOS_CLOCK = CLOCK_MONOTONIC;
+#else
+static constexpr clockid_t RODOS_CLOCK = CLOCK_REALTIME;
+#endif
+
 int64_t hwGetNanoseconds() {
     struct timespec tp;
     int64_t       timeNow;
 
-    clock_gettime(CLOCK_REALTIME, &tp);
+    clock_gettime(RODOS_CLOCK, &tp);
     timeNow = tp.tv_sec * 1000000000LL + tp.tv_nsec - timeAtStartup;
     return timeNow;
 }
@@ -32,7 +39,8 @@ void hwInitTime() {
     timeAtStartup = hwGetNanoseconds();
 }
 
-/******* abslute time (from host) for exotic function eg.random generator **/
+/******* abslute time (from host) for exotic function eg.random generator,
+ * and absolute timeouts on the clock of NOW() **/
 
 int64_t hwGetAbsoluteNanoseconds() {
     return hwGetNanoseconds() + timeAtStartup;
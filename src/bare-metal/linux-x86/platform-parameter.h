@@ -23,3 +23,11 @@
 //#define UART_GATEWAY                //< activates the Interrupt fo incomming networkmessages for the UART Gateway
 //#define ENABLE_LINUX_CAN_INTERRUPT  //< Uncomment to enable Linux CAN Interrupt (this may hang when using UDP!!)
 
+/** Bursts on the UDP input (UDP_INCOMMIG_BUF_LEN): about 200 KB of network buffers */
+#undef  NET_BUFFERS_SMALL
+#define NET_BUFFERS_SMALL           512
+#undef  NET_BUFFERS_MEDIUM
+#define NET_BUFFERS_MEDIUM          256
+#undef  NET_BUFFERS_LARGE
+#define NET_BUFFERS_LARGE            64
+
@@ -24,5 +24,11 @@
 #undef  SCHEDULER_STACKSIZE
 #define SCHEDULER_STACKSIZE	8
 #undef  UDP_INCOMMIG_BUF_LEN
-#define UDP_INCOMMIG_BUF_LEN          4 //number of "NetworkMessage (1300 Bytes each)" in FIFO
+#define UDP_INCOMMIG_BUF_LEN          4 //number of messages in FIFO, the messages are in NetBufferPool
+#undef  NET_BUFFERS_SMALL
+#define NET_BUFFERS_SMALL             4
+#undef  NET_BUFFERS_MEDIUM
+#define NET_BUFFERS_MEDIUM            2
+#undef  NET_BUFFERS_LARGE
+#define NET_BUFFERS_LARGE             2
 
@@ -0,0 +1,241 @@
+/**
+ * @file content-filter.cpp
+ * @date 2026/10/18
+ *
+ * @brief predicates over the content of topic messages, see content-filter.h
+ *
+ */
+
+#include "content-filter.h"
+#include "stream-bytesex.h"
+
+namespace RODOS {
+
+static constexpr uint8_t NUM_OF_FIELD_TYPES = static_cast<uint8_t>(FieldType::F64) + 1;
+static constexpr uint8_t NUM_OF_FILTER_OPS  = static_cast<uint8_t>(FilterOp::NOT) + 1;
+
+static inline size_t fieldSize(FieldType type) {
+    switch(type) {
+        case FieldType::U8:
+        case FieldType::I8:  return 1;
+        case FieldType::U16:
+        case FieldType::I16: return 2;
+        case FieldType::U32:
+        case FieldType::I32:
+        case FieldType::F32: return 4;
+        default:             return 8;
+    }
+}
+
+static inline bool isFloat(FieldType type) { return type == FieldType::F32 || type == FieldType::F64; }
+
+/// the field in the byte order of this node, integers extended to 64 bit
+static inline void readField(const uint8_t* field, FieldType type, int64_t& intValue, double& floatValue) {
+    union {
+        uint8_t  bytes[8];
+        uint8_t  u8;
+        int8_t   i8;
+        uint16_t u16;
+        int16_t  i16;
+        uint32_t u32;
+        int32_t  i32;
+        int64_t  i64;
+        float    f32;
+        double   f64;
+    } value;
+    size_t size = fieldSize(type);
+    for(size_t i = 0; i < size; i++) value.bytes[i] = field[i]; // may be unaligned
+    switch(type) {
+        case FieldType::U8:  intValue = value.u8;  break;
+        case FieldType::I8:  intValue = value.i8;  break;
+        case FieldType::U16: intValue = value.u16; break;
+        case FieldType::I16: intValue = value.i16; break;
+        case FieldType::U32: intValue = value.u32; break;
+        case FieldType::I32: intValue = value.i32; break;
+        case FieldType::I64: intValue = value.i64; break;
+        case FieldType::F32: floatValue = value.f32; break;
+        case FieldType::F64: floatValue = value.f64; break;
+    }
+}
+
+template <class T>
+static inline bool compareValues(FilterOp op, T value, T constant) {
+    switch(op) {
+        case FilterOp::EQ: return value == constant;
+        case FilterOp::NE: return value != constant;
+        case FilterOp::LT: return value < constant;
+        case FilterOp::LE: return value <= constant;
+        case FilterOp::GT: return value > constant;
+        case FilterOp::GE: return value >= constant;
+        default:           return false;
+    }
+}
+
+static bool evaluate(const FilterInstruction& instruction, const uint8_t* data, size_t len) {
+    if(static_cast<size_t>(instruction.offset) + fieldSize(instruction.type) > len) return false;
+
+    int64_t intValue   = 0;
+    double  floatValue = 0;
+    readField(data + instruction.offset, instruction.type, intValue, floatValue);
+
+    if(isFloat(instruction.type)) return compareValues(instruction.op, floatValue, instruction.constant.asFloat);
+
+    uint64_t mask = static_cast<uint64_t>(instruction.constant.asInt);
+    switch(instruction.op) {
+        case FilterOp::MASK_ANY: return (static_cast<uint64_t>(intValue) & mask) != 0;
+        case FilterOp::MASK_ALL: return (static_cast<uint64_t>(intValue) & mask) == mask;
+        default:                 return compareValues(instruction.op, intValue, instruction.constant.asInt);
+    }
+}
+
+/*************** building *****************/
+
+void ContentFilter::clear() {
+    numOfInstructions = 0;
+    stackDepth        = 0;
+    valid             = true;
+}
+
+bool ContentFilter::append(const FilterInstruction& instruction) {
+    if(!valid) return false;
+    bool combining = instruction.op == FilterOp::AND || instruction.op == FilterOp::OR || instruction.op == FilterOp::NOT;
+    uint8_t operands = (instruction.op == FilterOp::NOT) ? 1 : 2;
+    bool    fits     = numOfInstructions < MAX_INSTRUCTIONS;
+    if(combining) {
+        fits = fits && stackDepth >= operands;
+    } else {
+        fits = fits && stackDepth < MAX_STACK_DEPTH &&
+               (!isFloat(instruction.type) || (instruction.op != FilterOp::MASK_ANY && instruction.op != FilterOp::MASK_ALL));
+    }
+    if(!fits) {
+        valid = false;
+        return false;
+    }
+    instructions[numOfInstructions++] = instruction;
+    stackDepth = combining ? static_cast<uint8_t>(stackDepth - operands + 1) : static_cast<uint8_t>(stackDepth + 1);
+    return true;
+}
+
+ContentFilter& ContentFilter::compare(size_t offset, FieldType type, FilterOp op, int64_t constant) {
+    FilterInstruction instruction;
+    instruction.op             = op;
+    instruction.type           = type;
+    instruction.offset         = static_cast<uint16_t>(offset);
+    instruction.constant.asInt = constant;
+    if(offset > UINT16_MAX || isFloat(type)) {
+        valid = false;
+        return *this;
+    }
+    append(instruction);
+    return *this;
+}
+
+ContentFilter& ContentFilter::compareFloat(size_t offset, FieldType type, FilterOp op, double constant) {
+    FilterInstruction instruction;
+    instruction.op               = op;
+    instruction.type             = type;
+    instruction.offset           = static_cast<uint16_t>(offset);
+    instruction.constant.asFloat = constant;
+    if(offset > UINT16_MAX || !isFloat(type)) {
+        valid = false;
+        return *this;
+    }
+    append(instruction);
+    return *this;
+}
+
+ContentFilter& ContentFilter::combine(FilterOp op) {
+    FilterInstruction instruction;
+    instruction.op             = op;
+    instruction.type           = FieldType::U8;
+    instruction.offset         = 0;
+    instruction.constant.asInt = 0;
+    append(instruction);
+    return *this;
+}
+
+bool ContentFilter::appendOr(const ContentFilter& other) {
+    if(!isValid() || !other.isValid()) {
+        valid = false;
+        return false;
+    }
+    if(isEmpty()) return true;        // matches all already
+    if(other.isEmpty()) {             // || true
+        clear();
+        return true;
+    }
+    for(uint32_t i = 0; i < other.numOfInstructions; i++) append(other.instructions[i]);
+    logicalOr();
+    return valid;
+}
+
+/*************** evaluation *****************/
+
+bool ContentFilter::matches(const void* data, size_t len) const {
+    if(numOfInstructions == 0 || !isValid()) return true;
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint32_t       stack = 0; // bit 0: top of stack
+    for(uint32_t i = 0; i < numOfInstructions; i++) {
+        const FilterInstruction& instruction = instructions[i];
+        uint32_t                 top         = stack & 0x01;
+        switch(instruction.op) {
+            case FilterOp::AND:
+                stack >>= 1;
+                stack &= ~0x01u | top;
+                break;
+            case FilterOp::OR:
+                stack >>= 1;
+                stack |= top;
+                break;
+            case FilterOp::NOT:
+                stack ^= 0x01u;
+                break;
+            default:
+                stack = (stack << 1) | (evaluate(instruction, bytes, len) ? 0x01u : 0x00u);
+                break;
+        }
+    }
+    return (stack & 0x01) != 0;
+}
+
+/*************** wire format: count, then op, type, offset, constant (big endian) *****************/
+
+size_t ContentFilter::serialize(uint8_t* buf, size_t maxLen) const {
+    if(serializedSize() > maxLen || !isValid()) return 0;
+    buf[0] = numOfInstructions;
+    uint8_t* pos = buf + 1;
+    for(uint32_t i = 0; i < numOfInstructions; i++) {
+        pos[0] = static_cast<uint8_t>(instructions[i].op);
+        pos[1] = static_cast<uint8_t>(instructions[i].type);
+        uint16_tToBigEndian(pos + 2, instructions[i].offset);
+        int64_tToBigEndian(pos + 4, instructions[i].constant.asInt); // the bits of a double too
+        pos += SERIALIZED_INSTRUCTION_SIZE;
+    }
+    return serializedSize();
+}
+
+size_t ContentFilter::deserialize(const uint8_t* buf, size_t len) {
+    clear();
+    if(len < 1 || buf[0] > MAX_INSTRUCTIONS || len < 1 + buf[0] * SERIALIZED_INSTRUCTION_SIZE) {
+        valid = false;
+        return 0;
+    }
+    const uint8_t* pos = buf + 1;
+    for(uint32_t i = 0; i < buf[0]; i++) {
+        if(pos[0] >= NUM_OF_FILTER_OPS || pos[1] >= NUM_OF_FIELD_TYPES) {
+            valid = false;
+            return 0;
+        }
+        FilterInstruction instruction;
+        instruction.op             = static_cast<FilterOp>(pos[0]);
+        instruction.type           = static_cast<FieldType>(pos[1]);
+        instruction.offset         = bigEndianToUint16_t(pos + 2);
+        instruction.constant.asInt = bigEndianToInt64_t(pos + 4);
+        if(!append(instruction)) return 0;
+        pos += SERIALIZED_INSTRUCTION_SIZE;
+    }
+    return isValid() ? serializedSize() : 0;
+}
+
+} // namespace RODOS
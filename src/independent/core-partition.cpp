@@ -0,0 +1,60 @@
+/**
+ * @file core-partition.cpp
+ * @date 2026/10/18
+ *
+ * @brief placement of the threads on the cores, see core-partition.h
+ *
+ */
+
+#include "rodos.h"
+#include "core-partition.h"
+
+namespace RODOS {
+
+CorePartition* CorePartition::active   = 0;
+uint32_t       CorePartition::refusals = 0;
+
+CorePartition::CorePartition(const CorePartitionRule* rules_, uint32_t numOfRules_, bool fifoScheduling_, bool lockMemory_) :
+    rules(rules_), numOfRules(numOfRules_), fifoScheduling(fifoScheduling_), lockMemory(lockMemory_) {
+    if(active == 0) active = this; // the configuration of the node
+}
+
+uint64_t CorePartition::maskOf(const Thread* thread) const {
+    for(uint32_t i = 0; i < numOfRules; i++) {
+        const CorePartitionRule& rule = rules[i];
+        if(thread->getPriority() < rule.minPriority) continue;
+        if(rule.threadName != 0 && strcmp(rule.threadName, thread->getName()) != 0) continue;
+        return rule.cpuMask;
+    }
+    return 0;
+}
+
+uint64_t CorePartition::effectiveMask(const Thread* thread) {
+    if(thread->affinity != 0) return thread->affinity;
+    return (active == 0) ? 0 : active->maskOf(thread);
+}
+
+bool CorePartition::apply() {
+    active = this;
+    uint32_t refusalsBefore = refusals;
+
+    if(lockMemory && !memoryLocked) {
+        memoryLocked = lockProcessMemory();
+        if(!memoryLocked) refusals++;
+    }
+    ITERATE_LIST(Thread, Thread::threadList) {
+        if(!iter->setAffinity(iter->affinity)) refusals++;
+        iter->setPriority(iter->getPriority()); // the scheduling policy
+    }
+    return refusals == refusalsBefore;
+}
+
+void CorePartition::print() {
+    PRINTF("Cores: priority, cores (bit n: core n), %s\n", useFifoScheduling() ? "SCHED_FIFO" : "SCHED_OTHER");
+    ITERATE_LIST(Thread, Thread::threadList) {
+        PRINTF("  %s: %d, %llx\n", iter->getName(), static_cast<int>(iter->getPriority()),
+               static_cast<unsigned long long>(iter->getAffinity()));
+    }
+}
+
+} // namespace RODOS
@@ -0,0 +1,303 @@
+/**
+ * @file flight-recorder.cpp
+ * @date 2026/10/18
+ *
+ * @brief records all topic messages of a node and replays them, see flight-recorder.h
+ *
+ */
+
+#include "rodos.h"
+#include "flight-recorder.h"
+
+namespace RODOS {
+
+static inline uint32_t recordSize(uint32_t msgLen) {
+    return static_cast<uint32_t>(sizeof(RecordHeader)) + ((msgLen + 7u) & ~7u);
+}
+
+FlightRecorder::FlightRecorder(RecorderStorage& storage_, const char* name) :
+    Subscriber(defaultGatewayTopic, nopPutter, name, true),
+    storage(storage_) {
+    recordedMsgs   = 0;
+    recordedBytes  = 0;
+    droppedMsgs    = 0;
+    numOfSegments  = 0;
+    markDistance   = 1;
+    currentSegment = 0;
+    nextSequenceNr = 1;
+    started        = false; // the storage may be constructed after us: start() at the first message
+    ownSegment     = false;
+    replayedSegment    = -1;
+    replayingToNetwork = false;
+    lastTopic          = 0;
+    for(SegmentIndex& segment : index) segment.sequenceNr = 0;
+}
+
+/*************** recording *****************/
+
+void FlightRecorder::start() {
+    numOfSegments = storage.numOfSegments();
+    if(numOfSegments > FLIGHT_RECORDER_MAX_SEGMENTS) {
+        RODOS_ERROR("FlightRecorder: more segments than FLIGHT_RECORDER_MAX_SEGMENTS");
+        numOfSegments = FLIGHT_RECORDER_MAX_SEGMENTS;
+    }
+    markDistance = static_cast<uint32_t>(storage.segmentSize() / FLIGHT_RECORDER_MARKS_PER_SEGMENT);
+    if(markDistance == 0) markDistance = 1;
+
+    // records of a previous run: continue after the newest segment
+    currentSegment = numOfSegments - 1;
+    for(uint32_t nr = 0; nr < numOfSegments; nr++) {
+        scan(nr);
+        if(index[nr].sequenceNr >= nextSequenceNr) {
+            nextSequenceNr = index[nr].sequenceNr + 1;
+            currentSegment = nr;
+        }
+    }
+    started = true; // the next segment is opened by the first put(): the newest records stay until then
+}
+
+/// builds the index of a segment from its records
+void FlightRecorder::scan(uint32_t segmentNr) {
+    SegmentIndex& segment = index[segmentNr];
+    segment.sequenceNr    = 0;
+    uint8_t* memory       = storage.segment(segmentNr);
+    if(memory == 0) return;
+    const SegmentHeader* header = reinterpret_cast<const SegmentHeader*>(memory);
+    if(header->magic != MAGIC || header->sequenceNr == 0) return;
+
+    uint32_t size      = static_cast<uint32_t>(storage.segmentSize());
+    uint32_t offset    = sizeof(SegmentHeader);
+    segment.topics     = 0;
+    segment.numOfMarks = 0;
+    segment.firstTime  = 0;
+    segment.lastTime   = 0;
+    while(offset + sizeof(RecordHeader) <= size) {
+        const RecordHeader* record = reinterpret_cast<const RecordHeader*>(memory + offset);
+        if(record->len == END_OF_SEGMENT) break;
+        if(record->len > size || offset + recordSize(record->len) + sizeof(RecordHeader) > size) break; // not written completely
+        if(offset == sizeof(SegmentHeader)) segment.firstTime = record->time;
+        segment.lastTime = record->time;
+        segment.topics |= 1ull << (record->topicId % 64);
+        addMark(segment, record->time, offset);
+        offset += recordSize(record->len);
+    }
+    segment.end        = offset;
+    segment.sequenceNr = header->sequenceNr;
+}
+
+void FlightRecorder::addMark(SegmentIndex& segment, int64_t time, uint32_t offset) {
+    if(segment.numOfMarks >= FLIGHT_RECORDER_MARKS_PER_SEGMENT) return;
+    if(offset < segment.numOfMarks * markDistance) return;
+    segment.marks[segment.numOfMarks].time   = time;
+    segment.marks[segment.numOfMarks].offset = offset;
+    segment.numOfMarks++;
+}
+
+/// false if the next segment is being replayed or can not be used
+bool FlightRecorder::openNextSegment() {
+    if(index[currentSegment].sequenceNr != 0) storage.sync(currentSegment);
+    uint32_t nr = (currentSegment + 1) % numOfSegments;
+    if(replayedSegment == static_cast<int32_t>(nr)) return false;
+    uint8_t* memory = storage.segment(nr);
+    if(memory == 0) return false;
+
+    SegmentIndex& segment = index[nr];
+    segment.sequenceNr    = nextSequenceNr++;
+    segment.end           = sizeof(SegmentHeader);
+    segment.firstTime     = 0;
+    segment.lastTime      = 0;
+    segment.topics        = 0;
+    segment.numOfMarks    = 0;
+
+    SegmentHeader* header = reinterpret_cast<SegmentHeader*>(memory);
+    header->magic         = MAGIC;
+    header->sequenceNr    = segment.sequenceNr;
+    header->created       = NOW();
+    reinterpret_cast<RecordHeader*>(memory + segment.end)->len = END_OF_SEGMENT;
+    currentSegment = nr;
+    ownSegment     = true;
+    return true;
+}
+
+uint32_t FlightRecorder::put(const uint32_t topicId, const size_t len, void* data, [[gnu::unused]] const NetMsgInfo& netMsgInfo) {
+    if(!isEnabled || replayingToNetwork) return 0;
+    PROTECT_IN_SCOPE(protector);
+    if(!started) start();
+
+    size_t size = storage.segmentSize();
+    if(len > size || sizeof(SegmentHeader) + recordSize(static_cast<uint32_t>(len)) + sizeof(RecordHeader) > size) {
+        droppedMsgs++;
+        return 0;
+    }
+    uint32_t recordLen = recordSize(static_cast<uint32_t>(len));
+    if(!ownSegment || index[currentSegment].sequenceNr == 0 || index[currentSegment].end + recordLen + sizeof(RecordHeader) > size) {
+        if(!openNextSegment()) {
+            droppedMsgs++;
+            return 0;
+        }
+    }
+
+    SegmentIndex& segment = index[currentSegment];
+    uint8_t*      memory  = storage.segment(currentSegment);
+    RecordHeader* record  = reinterpret_cast<RecordHeader*>(memory + segment.end);
+    int64_t       now     = NOW(); // in the semaphore: the times of a segment are in order
+    record->topicId       = topicId;
+    record->len           = static_cast<uint32_t>(len);
+    record->time          = now;
+    memcpy(record + 1, data, len);
+    reinterpret_cast<RecordHeader*>(memory + segment.end + recordLen)->len = END_OF_SEGMENT;
+
+    if(segment.end == sizeof(SegmentHeader)) segment.firstTime = now;
+    segment.lastTime = now;
+    segment.topics |= 1ull << (topicId % 64);
+    addMark(segment, now, segment.end);
+    segment.end += recordLen;
+
+    recordedMsgs++;
+    recordedBytes += len;
+    return 0; // not a receiver, like the gateways
+}
+
+void FlightRecorder::clear() {
+    PROTECT_IN_SCOPE(protector);
+    if(!started) start();
+    for(uint32_t nr = 0; nr < numOfSegments; nr++) {
+        uint8_t* memory = storage.segment(nr);
+        if(memory != 0 && static_cast<int32_t>(nr) != replayedSegment) {
+            reinterpret_cast<SegmentHeader*>(memory)->magic = 0;
+            storage.sync(nr);
+        }
+        index[nr].sequenceNr = 0;
+    }
+    currentSegment = numOfSegments - 1;
+    ownSegment     = false;
+    openNextSegment();
+}
+
+/*************** replay *****************/
+
+int64_t FlightRecorder::firstRecordTime() {
+    PROTECT_IN_SCOPE(protector);
+    if(!started) start();
+    for(uint32_t nr = nextSegmentInOrder(0); nr < numOfSegments; nr = nextSegmentInOrder(index[nr].sequenceNr)) {
+        if(index[nr].end > sizeof(SegmentHeader)) return index[nr].firstTime;
+    }
+    return 0;
+}
+
+int64_t FlightRecorder::lastRecordTime() {
+    PROTECT_IN_SCOPE(protector);
+    if(!started) start();
+    int64_t  time       = 0;
+    uint32_t sequenceNr = 0;
+    for(uint32_t nr = 0; nr < numOfSegments; nr++) { // the newest segment may be empty
+        if(index[nr].sequenceNr > sequenceNr && index[nr].end > sizeof(SegmentHeader)) {
+            sequenceNr = index[nr].sequenceNr;
+            time       = index[nr].lastTime;
+        }
+    }
+    return time;
+}
+
+/// numOfSegments if there is no segment with a higher sequence number
+uint32_t FlightRecorder::nextSegmentInOrder(uint32_t afterSequenceNr) const {
+    uint32_t found = numOfSegments;
+    for(uint32_t nr = 0; nr < numOfSegments; nr++) {
+        uint32_t sequenceNr = index[nr].sequenceNr;
+        if(sequenceNr <= afterSequenceNr) continue;
+        if(found == numOfSegments || sequenceNr < index[found].sequenceNr) found = nr;
+    }
+    return found;
+}
+
+/// the records of a segment with from <= time <= to of topicId or all
+static uint32_t countRecords(const uint8_t* memory, uint32_t offset, uint32_t end, int64_t from, int64_t to, uint32_t topicId) {
+    uint32_t found = 0;
+    while(offset < end) {
+        const RecordHeader* record = reinterpret_cast<const RecordHeader*>(memory + offset);
+        offset += recordSize(record->len);
+        if(record->time > to) break; // the times of a segment are in order
+        if(record->time < from || (topicId != FlightRecorder::ALL_TOPICS && record->topicId != topicId)) continue;
+        found++;
+    }
+    return found;
+}
+
+TopicInterface* FlightRecorder::findTopic(uint32_t topicId) {
+    if(lastTopic == 0 || lastTopic->topicId != topicId) lastTopic = TopicInterface::findTopicId(topicId);
+    return lastTopic;
+}
+
+uint32_t FlightRecorder::walk(int64_t from, int64_t to, uint32_t speed, uint32_t topicId, bool publish, bool toNetwork) {
+    uint32_t found          = 0;
+    uint32_t sequenceNr     = 0;
+    bool     paced          = false;
+    int64_t  paceBase       = 0; // time of the record published at paceStart
+    int64_t  paceStart      = 0;
+    int64_t  lastRecordTime = 0;
+    uint64_t topicBit       = 1ull << (topicId % 64);
+
+    if(publish && toNetwork) replayingToNetwork = true;
+    while(true) {
+        uint32_t nr;
+        uint32_t offset = sizeof(SegmentHeader);
+        uint32_t end    = 0;
+        {
+            PROTECT_IN_SCOPE(protector);
+            if(!started) start();
+            nr = nextSegmentInOrder(sequenceNr);
+            if(nr == numOfSegments) break;
+            const SegmentIndex& segment = index[nr];
+            sequenceNr                  = segment.sequenceNr;
+            bool wanted = segment.end > sizeof(SegmentHeader) && segment.lastTime >= from && segment.firstTime <= to &&
+                          (topicId == ALL_TOPICS || (segment.topics & topicBit) != 0);
+            if(wanted) {
+                end = segment.end;
+                for(uint32_t i = 0; i < segment.numOfMarks && segment.marks[i].time < from; i++) offset = segment.marks[i].offset;
+                if(publish) {
+                    replayedSegment = static_cast<int32_t>(nr); // the recorder may not overwrite it now
+                } else {
+                    // count: in the semaphore, a put() waits instead of overwriting the segment
+                    found += countRecords(storage.segment(nr), offset, end, from, to, topicId);
+                    end = 0;
+                }
+            }
+        }
+
+        uint8_t* memory = storage.segment(nr);
+        while(offset < end) {
+            RecordHeader* record = reinterpret_cast<RecordHeader*>(memory + offset);
+            offset += recordSize(record->len);
+            if(record->time > to) break; // the times of a segment are in order
+            if(record->time < from || (topicId != ALL_TOPICS && record->topicId != topicId)) continue;
+            TopicInterface* topic = findTopic(record->topicId);
+            if(topic == 0 || record->len > topic->msgLen) continue; // not on this node, or another layout
+
+            if(speed != AS_FAST_AS_POSSIBLE) {
+                if(!paced || record->time < lastRecordTime) { // the first one, or of another run
+                    paced     = true;
+                    paceBase  = record->time;
+                    paceStart = NOW();
+                }
+                int64_t publishAt = paceStart + (record->time - paceBase) / speed;
+                if(publishAt > NOW()) Thread::suspendCallerUntil(publishAt);
+                lastRecordTime = record->time;
+            }
+            topic->publishMsgPart(record + 1, record->len, toNetwork);
+            found++;
+        }
+        replayedSegment = -1;
+    }
+    replayingToNetwork = false;
+    return found;
+}
+
+uint32_t FlightRecorder::replay(int64_t from, int64_t to, uint32_t speed, uint32_t topicId, bool toNetwork) {
+    return walk(from, to, speed, topicId, true, toNetwork);
+}
+
+uint32_t FlightRecorder::count(int64_t from, int64_t to, uint32_t topicId) {
+    return walk(from, to, AS_FAST_AS_POSSIBLE, topicId, false, false);
+}
+
+} // namespace RODOS
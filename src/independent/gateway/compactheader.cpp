@@ -0,0 +1,184 @@
+/**
+ * @file compactheader.cpp
+ * @date 2026/10/01
+ *
+ * @brief compact encoding of NetworkMessage headers, see compactheader.h
+ *
+ */
+
+#include "gateway/compactheader.h"
+#include "checksumes.h"
+#include "stream-bytesex.h"
+#include "string_pico.h"
+#include "timemodel.h"
+
+namespace RODOS {
+
+/*********** varints: 7 bits per byte, least significant first ***/
+
+static inline void putVarint(uint8_t*& pos, uint32_t value) {
+    while(value >= 0x80) {
+        *pos++ = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    *pos++ = static_cast<uint8_t>(value);
+}
+
+static inline bool getVarint(const uint8_t*& pos, const uint8_t* end, uint32_t& value) {
+    value = 0;
+    for(uint32_t shift = 0; shift < 35; shift += 7) {
+        if(pos >= end) return false;
+        uint8_t c = *pos++;
+        value |= static_cast<uint32_t>(c & 0x7f) << shift;
+        if((c & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+static inline uint32_t zigzag(int32_t x)    { return (static_cast<uint32_t>(x) << 1) ^ static_cast<uint32_t>(x >> 31); }
+static inline int32_t  unzigzag(uint32_t x) { return static_cast<int32_t>(x >> 1) ^ -static_cast<int32_t>(x & 0x01); }
+
+/*************************************************************************/
+
+CompactHeader::CompactHeader(uint8_t omitFields_) {
+    omitFields     = omitFields_;
+    txEpoch        = 0;
+    txEpochValid   = false;
+    msgsSinceEpoch = 0;
+    rxEpoch        = 0;
+    rxEpochValid   = false;
+}
+
+size_t CompactHeader::encode(const NetworkMessage& msg, uint8_t* buf, size_t maxLen) {
+    uint16_t len = msg.get_len();
+    if(len > MAX_NETWORK_MESSAGE_LENGTH || maxLen < MAX_HEADER_SIZE + len) return 0;
+
+    uint8_t  flags   = 0;
+    uint32_t topicId = msg.get_topicId();
+    if(topicId > 0xffff)                                  flags |= F_TOPIC32;
+    if(msg.get_type() != 0)                               flags |= F_TYPE;
+    if(!(omitFields & OMIT_ADDRESSING))                   flags |= F_ADDR;
+    if(!(omitFields & OMIT_THREAD_ID))                    flags |= F_THREAD;
+
+    int64_t sentTime = msg.get_sentTime();
+    int64_t deltaUs  = 0;
+    if(!(omitFields & OMIT_TIME)) {
+        deltaUs = (sentTime - txEpoch) / MICROSECONDS;
+        bool newEpoch = !txEpochValid || msgsSinceEpoch >= EPOCH_REFRESH_MSGS ||
+                        deltaUs >= MAX_TIME_DELTA_US || deltaUs <= -MAX_TIME_DELTA_US;
+        if(newEpoch) {
+            flags         |= F_EPOCH;
+            txEpoch        = sentTime;
+            txEpochValid   = true;
+            msgsSinceEpoch = 0;
+        } else {
+            flags |= F_TIME;
+            msgsSinceEpoch++;
+        }
+    }
+
+    uint8_t* pos = buf;
+    *pos++ = static_cast<uint8_t>(MARKER | flags);
+    pos += 2; // checksum, at the end
+    int16_t steps = msg.get_maxStepsToForward();
+    *pos++ = static_cast<uint8_t>(static_cast<int8_t>((steps > 127) ? 127 : steps));
+    if(flags & F_TOPIC32) {
+        uint32_tToBigEndian(pos, topicId);
+        pos += 4;
+    } else {
+        uint16_tToBigEndian(pos, static_cast<uint16_t>(topicId));
+        pos += 2;
+    }
+    putVarint(pos, len);
+    putVarint(pos, zigzag(msg.get_senderNode()));
+    putVarint(pos, msg.get_sequenceNr());
+    if(flags & F_TYPE)   putVarint(pos, msg.get_type());
+    if(flags & F_ADDR) {
+        putVarint(pos, zigzag(msg.get_receiverNode()));
+        putVarint(pos, msg.get_receiverNodesBitMap());
+    }
+    if(flags & F_THREAD) putVarint(pos, msg.get_senderThreadId());
+    if(flags & F_EPOCH) {
+        int64_tToBigEndian(pos, sentTime);
+        pos += 8;
+    }
+    if(flags & F_TIME)   putVarint(pos, zigzag(static_cast<int32_t>(deltaUs)));
+
+    memcpy(pos, msg.userDataC, len);
+    pos += len;
+
+    size_t encodedLen = static_cast<size_t>(pos - buf);
+    uint16_tToBigEndian(buf + 1, checkSum(buf + 3, encodedLen - 3));
+    return encodedLen;
+}
+
+bool CompactHeader::decode(const uint8_t* buf, size_t len, NetworkMessage& msg) {
+    if(len < 1) return false;
+    if(!isCompact(buf)) { // standard header, from a node not (yet) using compact headers
+        if(len > sizeof(NetworkMessage)) return false;
+        memcpy(&msg, buf, len);
+        return true;
+    }
+
+    const uint8_t* end = buf + len;
+    if(len < 6) return false;
+    if(bigEndianToUint16_t(buf + 1) != checkSum(buf + 3, len - 3)) return false;
+
+    uint8_t        flags = buf[0] & static_cast<uint8_t>(~MARKER_MASK);
+    const uint8_t* pos   = buf + 3;
+    msg.put_maxStepsToForward(static_cast<int8_t>(*pos++));
+    if(flags & F_TOPIC32) {
+        if(end - pos < 4) return false;
+        msg.put_topicId(bigEndianToUint32_t(pos));
+        pos += 4;
+    } else {
+        if(end - pos < 2) return false;
+        msg.put_topicId(bigEndianToUint16_t(pos));
+        pos += 2;
+    }
+
+    uint32_t userDataLen, senderNode, sequenceNr;
+    if(!getVarint(pos, end, userDataLen)) return false;
+    if(!getVarint(pos, end, senderNode))  return false;
+    if(!getVarint(pos, end, sequenceNr))  return false;
+    msg.put_senderNode(unzigzag(senderNode));
+    msg.put_sequenceNr(sequenceNr);
+
+    uint32_t type = 0;
+    if((flags & F_TYPE) && !getVarint(pos, end, type)) return false;
+    msg.put_type(static_cast<uint16_t>(type));
+
+    uint32_t receiverNode = zigzag(-1), bitmap = 0;
+    if(flags & F_ADDR) {
+        if(!getVarint(pos, end, receiverNode)) return false;
+        if(!getVarint(pos, end, bitmap))       return false;
+    }
+    msg.put_receiverNode(unzigzag(receiverNode));
+    msg.put_receiverNodesBitMap(bitmap);
+
+    uint32_t threadId = 0;
+    if((flags & F_THREAD) && !getVarint(pos, end, threadId)) return false;
+    msg.put_senderThreadId(threadId);
+
+    int64_t sentTime = NOW(); // if not transmitted or the epoch was lost
+    if(flags & F_EPOCH) {
+        if(end - pos < 8) return false;
+        rxEpoch      = bigEndianToInt64_t(pos);
+        rxEpochValid = true;
+        sentTime     = rxEpoch;
+        pos += 8;
+    }
+    if(flags & F_TIME) {
+        uint32_t deltaUs;
+        if(!getVarint(pos, end, deltaUs)) return false;
+        if(rxEpochValid) sentTime = rxEpoch + unzigzag(deltaUs) * MICROSECONDS;
+    }
+    msg.put_sentTime(sentTime);
+
+    if(userDataLen > MAX_NETWORK_MESSAGE_LENGTH || static_cast<uint32_t>(end - pos) != userDataLen) return false;
+    msg.setUserData(pos, static_cast<uint16_t>(userDataLen));
+    msg.setCheckSum();
+    return true;
+}
+
+} // namespace RODOS
@@ -0,0 +1,146 @@
+/**
+ * @file fragmentation.cpp
+ * @date 2026/10/05
+ *
+ * @brief fragments and reassembly of long messages, see fragmentation.h
+ *
+ */
+
+#include "gateway/fragmentation.h"
+#include "gateway/gateway.h"
+#include "stream-bytesex.h"
+#include "string_pico.h"
+#include "thread.h"
+#include "timemodel.h"
+
+namespace RODOS {
+
+/*************** sender *****************/
+
+void prepareFragment(NetworkMessage& netMsg, const uint32_t topicId, const void* data, size_t len,
+                     uint32_t fragmentIndex, const NetMsgInfo& netMsgInfo) {
+    size_t offset       = fragmentIndex * MAX_FRAGMENT_DATA;
+    size_t fragmentLen  = (len - offset < MAX_FRAGMENT_DATA) ? len - offset : MAX_FRAGMENT_DATA;
+
+    NetMsgInfo fragmentInfo = netMsgInfo;
+    fragmentInfo.sequenceNr = netMsgInfo.sequenceNr + fragmentIndex; // publish reserved them
+    fragmentInfo.receiverNodes = 0; // no room for the node set: fragments carry only the bitmap
+    prepareNetworkMessage(netMsg, topicId, data, 0, fragmentInfo); // header only
+
+    uint32_tToBigEndian(netMsg.userDataC + 0, netMsgInfo.sequenceNr);
+    uint32_tToBigEndian(netMsg.userDataC + 4, static_cast<uint32_t>(len));
+    uint32_tToBigEndian(netMsg.userDataC + 8, static_cast<uint32_t>(offset));
+    memcpy(netMsg.userDataC + FRAGMENT_HEADER_SIZE, static_cast<const uint8_t*>(data) + offset, fragmentLen);
+
+    netMsg.put_type(static_cast<uint16_t>(netMsg.get_type() | NET_MSG_FRAGMENT));
+    netMsg.put_len(static_cast<uint16_t>(FRAGMENT_HEADER_SIZE + fragmentLen));
+    netMsg.setCheckSum();
+}
+
+void FragmentPacer::waitToSend(size_t len, Linkinterface* link) {
+    int64_t giveUp = NOW() + 1000 * FRAGMENT_BACK_PRESSURE_WAIT; // a receiver which stopped reading shall not stop the sender
+    while(1) {
+        int64_t wait;
+        {
+            PROTECT_IN_SCOPE(protector);
+            wait = credit.timeUntilReady();
+            if(wait <= 0 && (link == 0 || link->hasRoomToSend() || NOW() > giveUp)) {
+                credit.consume(len);
+                return;
+            }
+        }
+        Thread::suspendCallerUntil(NOW() + ((wait > 0) ? wait : FRAGMENT_BACK_PRESSURE_WAIT));
+    }
+}
+
+
+/*************** receiver *****************/
+
+void ReassemblyBuffer::start(int32_t senderNode_, uint32_t msgId_, uint32_t topicId_, uint32_t totalLen_) {
+    state       = State::COLLECTING;
+    senderNode  = senderNode_;
+    msgId       = msgId_;
+    topicId     = topicId_;
+    totalLen    = totalLen_;
+    receivedLen = 0;
+    memset(receivedFragments, 0, sizeof(receivedFragments));
+}
+
+bool ReassemblyBuffer::isFree(int64_t timeNow) const {
+    if(state == State::FREE || state == State::DONE) return true;
+    return state == State::COLLECTING && timeNow - lastFragmentTime > REASSEMBLY_TIMEOUT;
+}
+
+Reassembler::Reassembler() {
+    for(ReassemblyBuffer& buffer : buffers) buffer.state = ReassemblyBuffer::State::FREE;
+}
+
+ReassemblyBuffer* Reassembler::findBuffer(int32_t senderNode, uint32_t msgId) {
+    for(ReassemblyBuffer& buffer : buffers) {
+        if(buffer.state != ReassemblyBuffer::State::FREE && buffer.senderNode == senderNode && buffer.msgId == msgId) return &buffer;
+    }
+    return 0;
+}
+
+ReassemblyBuffer* Reassembler::getFreeBuffer(int64_t timeNow) {
+    ReassemblyBuffer* oldest = 0;
+    for(ReassemblyBuffer& buffer : buffers) {
+        if(buffer.state == ReassemblyBuffer::State::FREE) return &buffer;
+        if(buffer.isFree(timeNow) && (oldest == 0 || buffer.lastFragmentTime < oldest->lastFragmentTime)) oldest = &buffer;
+    }
+    return oldest;
+}
+
+ReassemblyBuffer* Reassembler::addFragment(int32_t senderNode, uint32_t topicId, const uint8_t* fragment, size_t len) {
+    if(len < FRAGMENT_HEADER_SIZE) {
+        droppedFragments++;
+        return 0;
+    }
+    uint32_t msgId       = bigEndianToUint32_t(fragment + 0);
+    uint32_t totalLen    = bigEndianToUint32_t(fragment + 4);
+    uint32_t offset      = bigEndianToUint32_t(fragment + 8);
+    size_t   fragmentLen = len - FRAGMENT_HEADER_SIZE;
+    uint32_t index       = static_cast<uint32_t>(offset / MAX_FRAGMENT_DATA);
+
+    int64_t timeNow = NOW();
+    PROTECT_IN_SCOPE(protector);
+
+    if(totalLen > REASSEMBLY_BUFFER_SIZE || offset % MAX_FRAGMENT_DATA != 0 || offset + fragmentLen > totalLen) {
+        droppedFragments++;
+        return 0;
+    }
+
+    ReassemblyBuffer* buffer = findBuffer(senderNode, msgId);
+    if(buffer == 0) {
+        buffer = getFreeBuffer(timeNow);
+        if(buffer == 0) {
+            droppedFragments++;
+            return 0;
+        }
+        buffer->start(senderNode, msgId, topicId, totalLen);
+    }
+    if(buffer->state != ReassemblyBuffer::State::COLLECTING) return 0; // late duplicate
+    if(buffer->totalLen != totalLen) {
+        droppedFragments++;
+        return 0;
+    }
+
+    buffer->lastFragmentTime = timeNow;
+    uint8_t mask             = static_cast<uint8_t>(1u << (index % 8));
+    if(buffer->receivedFragments[index / 8] & mask) return 0; // duplicate
+    buffer->receivedFragments[index / 8] |= mask;
+
+    memcpy(buffer->data + offset, fragment + FRAGMENT_HEADER_SIZE, fragmentLen);
+    buffer->receivedLen += static_cast<uint32_t>(fragmentLen);
+    if(buffer->receivedLen < buffer->totalLen) return 0;
+
+    buffer->state = ReassemblyBuffer::State::COMPLETE;
+    return buffer;
+}
+
+void Reassembler::release(ReassemblyBuffer* buffer) {
+    PROTECT_IN_SCOPE(protector);
+    buffer->state = ReassemblyBuffer::State::DONE;
+}
+
+} // namespace RODOS
@@ -12,6 +12,10 @@
 
 #include "application.h"
 #include "gateway/gateway.h"
+#include "gateway/netbufferpool.h"
+#include "gateway/payloadcompression.h"
+#include "gateway/transmitscheduler.h"
+#include "profile-zone.h"
 #include "reserved_application_ids.h"
 #include "subscriber.h"
 #include "thread.h"
@@ -26,7 +30,15 @@ static Application application("Gateway", APID_GATEWAY_GENERIC);
 
 /**************** Transmitter part of the gateway   ******************/
 
-int32_t globalMsgSequenceCounter = 1;
+Atomic<uint32_t> globalMsgSequenceCounter {1};
+
+uint32_t getNextMsgSequenceNr(uint32_t count) {
+    uint32_t sequenceNr = (globalMsgSequenceCounter += count); // returns the value before adding
+    if(sequenceNr == 0 || sequenceNr > UINT32_MAX - (count - 1)) { // 0 is reserved for "not numbered", only after a wrap around
+        sequenceNr = (globalMsgSequenceCounter += count);
+    }
+    return sequenceNr;
+}
 
 Gateway::Gateway(Linkinterface* linkinterface_, bool forwardall_, bool enable_) :
     Subscriber(defaultGatewayTopic, nopPutter, "Gateway", true),
@@ -38,82 +50,110 @@ Gateway::Gateway(Linkinterface* linkinterface_, bool forwardall_, bool enable_)
 
     getTopicsToForwardFromOutside=true;
     externalsubscribers.init();
+    payloadCompression = 0;
+    transmitScheduler  = 0;
+    extendedAddressing = false;
+    for(TopicListReport& topics : topicPriorities) topics.init();
+    contentFilterExport       = false;
+    exportedFiltersGeneration = 0;
+    lastContentFilterReport   = 0;
+    remoteFiltersInUse        = 0;
+    contentFilteredMsgs       = 0;
+    contentFilterOverflows    = 0;
+    allFiltersUnknownUntil    = 0;
+    for(RemoteContentFilter& remote : remoteFilters) remote.lastReport = 0;
+    for(UnknownContentFilter& unknown : unknownFilters) unknown.until = 0;
 }
 
-int32_t Gateway::numberOfNodes = 0;
-SeenNode Gateway::seenNodes[MAX_NUMBER_OF_NODES];
-Semaphore Gateway::seenNodesProtector;
-
-int compare_SeenNode (const void *a, const void *b);
-int compare_SeenNode (const void *a, const void *b) {
-    int32_t temp =  ((const SeenNode*)a)->nodeID - ((const SeenNode*)b)->nodeID;
-    if(temp > 0)      return 1;
-    else if(temp < 0) return -1;
-    else              return 0;
-}
-
-bool Gateway::messageSeen(NetworkMessage& msg) {
-    //SeenNode key;
-    SeenNode* node;
+SeenNodesBucket Gateway::seenNodes[SEEN_NODES_BUCKETS];
+Reassembler     Gateway::reassembler;
 
+static_assert((SEEN_NODES_BUCKETS & (SEEN_NODES_BUCKETS - 1)) == 0, "SEEN_NODES_BUCKETS has to be a power of 2");
 
+static inline uint32_t seenNodesBucketIndex(int32_t nodeId) {
+    uint32_t h = static_cast<uint32_t>(nodeId) * 2654435761u; // Knuth multiplicative hash, posix node numbers are not sequential
+    return (h >> 16) & (SEEN_NODES_BUCKETS - 1);
+}
 
-    seenNodesProtector.enter();
-    /*===========qsort and binsearch version, disabled for now ========================
-    key.nodeID=msg.senderNode;
-
-    node= (SeenNode*)bsearch(&key,seenNodes,numberOfNodes,sizeof(SeenNode),compare_SeenNode);
-
-    if(!node) {
-        RODOS_ASSERT_IFNOT_RETURN(numberOfNodes < MAX_NUMBER_OF_NODES, false);
-        key.lastMsgTime=msg.sentTime-1;
-        seenNodes[numberOfNodes]=key;
-        numberOfNodes++;
+void SeenNode::restart(int32_t nodeId, uint32_t sequenceNr, int64_t sentTime) {
+    nodeID            = nodeId;
+    inUse             = true;
+    highestSequenceNr = sequenceNr;
+    lastMsgTime       = sentTime;
+    for(uint32_t i = 0; i < SEQUENCE_WINDOW_WORDS; i++) window[i] = 0;
+    window[0]         = 0x01; // sequenceNr itself
+}
 
-        qsort(seenNodes,numberOfNodes,sizeof(SeenNode),compare_SeenNode);
-        node= (SeenNode*)bsearch(&key,seenNodes,numberOfNodes,sizeof(SeenNode),compare_SeenNode);
+bool SeenNode::isDuplicate(uint32_t sequenceNr, int64_t sentTime) {
+    if(lastMsgTime - sentTime > SENDER_RESTART_TIME) { // sender restarted, its counter too
+        restart(nodeID, sequenceNr, sentTime);
+        return false;
     }
 
-    */
-
-    //=============== simple search =======================================
-       node=0;
-       for(int i=0;i< numberOfNodes;i++){
+    int32_t distance = static_cast<int32_t>(sequenceNr - highestSequenceNr); // modulo 2^32: survives the wrap around
 
-           if(seenNodes[i].nodeID == msg.get_senderNode()){
-               node = &seenNodes[i];
-               break;
-           }
-       }
-
-       if(!node){
-           RODOS_ASSERT_IFNOT_RETURN((numberOfNodes < MAX_NUMBER_OF_NODES), false);
-           
-           node=&seenNodes[numberOfNodes];
-           numberOfNodes++;
-
-           node->nodeID = msg.get_senderNode();
-           node->lastMsgTime = msg.get_sentTime()-1;
-       }
+    if(distance > 0) { // newer than all before: slide the window
+        uint32_t shift = static_cast<uint32_t>(distance);
+        if(shift >= SEQUENCE_WINDOW_SIZE) {
+            for(uint32_t i = 0; i < SEQUENCE_WINDOW_WORDS; i++) window[i] = 0;
+        } else {
+            uint32_t wordShift = shift / 64;
+            uint32_t bitShift  = shift % 64;
+            for(uint32_t i = SEQUENCE_WINDOW_WORDS; i-- > 0;) {
+                uint64_t shifted = 0;
+                if(i >= wordShift) {
+                    shifted = window[i - wordShift] << bitShift;
+                    if(bitShift != 0 && i > wordShift) shifted |= window[i - wordShift - 1] >> (64 - bitShift);
+                }
+                window[i] = shifted;
+            }
+        }
+        window[0]        |= 0x01;
+        highestSequenceNr = sequenceNr;
+        lastMsgTime       = sentTime;
+        return false;
+    }
 
-       // ==================================================
+    uint32_t age = static_cast<uint32_t>(-static_cast<int64_t>(distance));
+    if(age >= SEQUENCE_WINDOW_SIZE) return true; // too late, it may have been delivered already
 
+    uint64_t mask = static_cast<uint64_t>(0x01) << (age % 64);
+    if(window[age / 64] & mask) return true;
+    window[age / 64] |= mask; // an out of order message, not seen before
+    return false;
+}
 
-    int64_t msgSentTime = msg.get_sentTime();
-    if(node->lastMsgTime >= msgSentTime) {
-        if(node->lastMsgTime-msgSentTime > 5*SECONDS) {
-            node->lastMsgTime= msgSentTime;
-            seenNodesProtector.leave();
-            return false;
+/**
+ * Each sender node numbers its messages (getNextMsgSequenceNr). The same number is used
+ * for all gateways, so a message which arrives through several links is distributed only once.
+ * Messages with sequenceNr 0 are not numbered (eg. from CAN links) and are never discarded.
+ */
+bool Gateway::messageSeen(NetworkMessage& msg) {
+    uint32_t sequenceNr = msg.get_sequenceNr();
+    if(sequenceNr == 0) return false;
+
+    int32_t  nodeId   = msg.get_senderNode();
+    int64_t  sentTime = msg.get_sentTime();
+    int64_t  timeNow  = NOW();
+    SeenNodesBucket& bucket = seenNodes[seenNodesBucketIndex(nodeId)];
+
+    PROTECT_IN_SCOPE(bucket.protector);
+
+    SeenNode* victim = &bucket.nodes[0];
+    for(uint32_t i = 0; i < SEEN_NODES_PER_BUCKET; i++) {
+        SeenNode* node = &bucket.nodes[i];
+        if(node->inUse && node->nodeID == nodeId) {
+            node->lastAccessTime = timeNow;
+            return node->isDuplicate(sequenceNr, sentTime);
         }
-        seenNodesProtector.leave();
-        return true;
-    } else {
-        node->lastMsgTime= msgSentTime;
-        seenNodesProtector.leave();
-        return false;
+        if(!victim->inUse) continue;
+        if(!node->inUse || node->lastAccessTime < victim->lastAccessTime) victim = node;
     }
 
+    // A node not known until now: take a free entry or replace the least recently heard one
+    victim->restart(nodeId, sequenceNr, sentTime);
+    victim->lastAccessTime = timeNow;
+    return false;
 }
 
 /** Forward the message to the interface **/
@@ -127,30 +167,242 @@ uint32_t Gateway::put(const uint32_t topicId, const size_t len, void* data, cons
         if(topicId !=0 && !externalsubscribers.find(topicId)) { return 0; }
     }
 
+    if(contentFilterExport && !wantedByRemoteFilters(topicId, len, data)) {
+        contentFilteredMsgs++;
+        return 0;
+    }
+
+    if(netMsgInfo.receiverNodes && !extendedAddressing) { // the other nodes may not understand it
+        NetMsgInfo info    = netMsgInfo;
+        info.receiverNodes = 0;
+        return put(topicId, len, data, info);
+    }
+
+    TransmitPriority priority = getTopicPriority(topicId, netMsgInfo.transmitPriority);
+    if(len > MAX_NETWORK_MESSAGE_LENGTH) {
+        sendFragmented(topicId, len, data, netMsgInfo, priority);
+        return 1;
+    }
+
+    if(transmitScheduler) { // the thread of the scheduler sends it
+        prepareNetworkMessage(transmitScheduler->reserve(priority), topicId, data, len, netMsgInfo);
+        transmitScheduler->commit(priority);
+        return 1;
+    }
+
+    waitForLink();
     networkOutProtector.enter();
     {
         prepareNetworkMessage(networkOutMessage,topicId,data,len, netMsgInfo);
-        sendNetworkMessage(networkOutMessage);
+        transmit(networkOutMessage);
     }
     networkOutProtector.leave();
     return 1;
 }
 
+void Gateway::sendFragmented(const uint32_t topicId, const size_t len, const void* data, const NetMsgInfo& netMsgInfo,
+                             TransmitPriority priority) {
+    NetMsgInfo info = netMsgInfo;
+    uint32_t   numOfFragments = numberOfFragments(len);
+    if(info.sequenceNr == 0) info.sequenceNr = getNextMsgSequenceNr(numOfFragments); // not from publish()
+
+    for(uint32_t i = 0; i < numOfFragments; i++) {
+        fragmentPacer.waitToSend(fragmentBytes(len, i), linkinterface);
+        if(transmitScheduler) {
+            prepareFragment(transmitScheduler->reserve(priority), topicId, data, len, i, info);
+            transmitScheduler->commit(priority);
+        } else {
+            waitForLink();
+            networkOutProtector.enter(); // other messages may go between the fragments
+            prepareFragment(networkOutMessage, topicId, data, len, i, info);
+            transmit(networkOutMessage);
+            networkOutProtector.leave();
+        }
+    }
+}
 
 
-void Gateway::sendNetworkMessage(NetworkMessage& msg) {
-    //When implemented, buffering of the outgoing Messages should be done here.
 
+void Gateway::sendNetworkMessage(NetworkMessage& msg) {
     /*if(!forwardAll){
         if(msg.topicId !=0 && !externalsubscribers.find(msg.topicId)){
             return;
         }
     }*/
 
-    networkOutProtector.enter(); // Also lock here if this function gets called from outside
-    linkinterface->sendNetworkMsg(msg);
-    networkOutProtector.leave();
+    if(!transmitScheduler) waitForLink();
+    enqueueOrTransmit(msg);
+}
+
+void Gateway::enqueueOrTransmit(NetworkMessage& msg) {
+    if(transmitScheduler) { // eg. from routers: the priority of the local topic, if there is one
+        TopicInterface* topic = TopicInterface::findTopicId(msg.get_topicId());
+        TransmitPriority priority = getTopicPriority(msg.get_topicId(), topic ? topic->transmitPriority : TransmitPriority::NORMAL);
+        transmitScheduler->enqueue(msg, priority);
+        return;
+    }
+    transmit(msg);
+}
 
+void Gateway::transmit(NetworkMessage& msg) {
+    PROTECT_IN_SCOPE(networkOutProtector); // Also lock here if this function gets called from outside
+    NetworkMessage* toSend = payloadCompression ? payloadCompression->compressMsg(msg) : &msg;
+    {
+        RODOS_PROFILE_MIDDLEWARE_SCOPE("link send");
+        linkinterface->sendNetworkMsg(*toSend);
+    }
+    linkinterface->rateLimiter.consume(toSend->numberOfBytesToSend());
+}
+
+int64_t Gateway::timeUntilLinkReady() {
+    PROTECT_IN_SCOPE(networkOutProtector);
+    return linkinterface->rateLimiter.timeUntilReady();
+}
+
+void Gateway::waitForLink() {
+    // an other thread may send between the wait and the send: the credit gets negative, the next ones wait longer
+    for(int64_t wait = timeUntilLinkReady(); wait > 0; wait = timeUntilLinkReady()) {
+        Thread::suspendCallerUntil(NOW() + wait);
+    }
+}
+
+void Gateway::setTransmitScheduler(TransmitScheduler* scheduler) {
+    transmitScheduler = scheduler;
+    if(scheduler) scheduler->gateway = this;
+}
+
+void Gateway::setTopicPriority(uint32_t topicId, TransmitPriority priority) {
+    for(uint32_t i = 0; i < NUM_OF_TRANSMIT_PRIORITIES; i++) {
+        topicPriorities[i].remove(topicId);
+    }
+    topicPriorities[static_cast<uint32_t>(priority)].add(topicId);
+}
+
+TransmitPriority Gateway::getTopicPriority(uint32_t topicId, TransmitPriority topicPriority) {
+    for(uint32_t i = 0; i < NUM_OF_TRANSMIT_PRIORITIES; i++) {
+        if(topicPriorities[i].numberOfTopics > 0 && topicPriorities[i].find(topicId)) return static_cast<TransmitPriority>(i);
+    }
+    return topicPriority;
+}
+
+
+/**************** Content filters of the local subscribers and of other nodes   ******************/
+
+void Gateway::setContentFilterExport(bool onOff) {
+    contentFilterExport       = onOff;
+    exportedFiltersGeneration = Subscriber::contentFiltersGeneration - 1; // report at the next chance
+}
+
+/** User data of a report: topicId (big endian), then the filter, see ContentFilter::serialize */
+void Gateway::sendContentFilterReports() {
+    int64_t timeNow = NOW();
+    if(exportedFiltersGeneration == Subscriber::contentFiltersGeneration &&
+       timeNow - lastContentFilterReport < CONTENT_FILTER_REPORT_PERIOD) {
+        return;
+    }
+    exportedFiltersGeneration = Subscriber::contentFiltersGeneration;
+    lastContentFilterReport   = timeNow;
+
+    ITERATE_LIST(TopicInterface, TopicInterface::topicList) {
+        if(iter->topicId < ALL_TOPICS_BELOW_THIS_ARE_BROADCAST || iter->onlyLocal) continue;
+
+        ContentFilter combined;
+        bool          subscribed = false;
+        for(Subscriber* subscriber = (Subscriber*)iter->mySubscribers; subscriber != 0; subscriber = (Subscriber*)subscriber->getNext()) {
+            if(!subscriber->isEnabled) continue;
+            const ContentFilter* filter = subscriber->contentFilter;
+            if(!subscribed) {
+                if(filter) combined = *filter; // else: empty, all messages
+                subscribed = true;
+            } else if(!filter || !combined.appendOr(*filter)) {
+                combined.clear(); // too long or no filter: all messages
+            }
+        }
+        if(!subscribed) continue;
+
+        uint8_t report[4 + 1 + ContentFilter::MAX_INSTRUCTIONS * ContentFilter::SERIALIZED_INSTRUCTION_SIZE];
+        uint32_tToBigEndian(report, iter->topicId);
+        size_t len = 4 + combined.serialize(report + 4, sizeof(report) - 4);
+
+        NetMsgInfo info;
+        info.init();
+        info.senderNode = myNodeNr;
+        info.sentTime   = timeNow;
+        info.sequenceNr = getNextMsgSequenceNr();
+        if(!transmitScheduler) waitForLink();
+        networkOutProtector.enter();
+        prepareNetworkMessage(networkOutMessage, TOPIC_ID_FOR_CONTENT_FILTER_REPORT, report, len, info);
+        enqueueOrTransmit(networkOutMessage);
+        networkOutProtector.leave();
+    }
+}
+
+void Gateway::receiveContentFilterReport(int32_t nodeNr, const uint8_t* userData, size_t len) {
+    if(len < 5) return;
+    uint32_t topicId = bigEndianToUint32_t(userData);
+    int64_t  timeNow = NOW();
+
+    PROTECT_IN_SCOPE(remoteFiltersProtector);
+    RemoteContentFilter* entry    = 0;
+    RemoteContentFilter* freeSlot = 0; // a live entry is never evicted: its node would miss messages
+    for(RemoteContentFilter& remote : remoteFilters) {
+        bool live = remote.lastReport != 0 && timeNow - remote.lastReport <= CONTENT_FILTER_TIMEOUT;
+        if(live && remote.topicId == topicId && remote.nodeNr == nodeNr) {
+            entry = &remote;
+            break;
+        }
+        if(!live && !freeSlot) freeSlot = &remote;
+    }
+    if(!entry) {
+        if(!freeSlot) {
+            markFilterUnknown(topicId, timeNow);
+            return;
+        }
+        entry = freeSlot;
+        if(entry->lastReport == 0) remoteFiltersInUse++;
+        entry->topicId = topicId;
+        entry->nodeNr  = nodeNr;
+    }
+    entry->lastReport = timeNow;
+    if(entry->filter.deserialize(userData + 4, len - 4) == 0) entry->filter.clear(); // unknown: all messages
+}
+
+/** Table full: the filter of the node is not known, all messages of the topic have to be sent. Under remoteFiltersProtector */
+void Gateway::markFilterUnknown(uint32_t topicId, int64_t timeNow) {
+    contentFilterOverflows++;
+    int64_t               until    = timeNow + CONTENT_FILTER_TIMEOUT;
+    UnknownContentFilter* freeSlot = 0;
+    for(UnknownContentFilter& unknown : unknownFilters) {
+        if(unknown.until >= timeNow && unknown.topicId == topicId) {
+            unknown.until = until;
+            return;
+        }
+        if(unknown.until < timeNow && !freeSlot) freeSlot = &unknown;
+    }
+    if(!freeSlot) { // more unknown topics than entries: send all topics
+        allFiltersUnknownUntil = until;
+        return;
+    }
+    freeSlot->topicId = topicId;
+    freeSlot->until   = until;
+}
+
+bool Gateway::wantedByRemoteFilters(const uint32_t topicId, const size_t len, const void* data) {
+    if(remoteFiltersInUse == 0 || topicId < ALL_TOPICS_BELOW_THIS_ARE_BROADCAST) return true;
+
+    int64_t timeNow = NOW();
+    bool    known   = false;
+    PROTECT_IN_SCOPE(remoteFiltersProtector);
+    if(timeNow <= allFiltersUnknownUntil) return true;
+    for(UnknownContentFilter& unknown : unknownFilters) {
+        if(unknown.topicId == topicId && timeNow <= unknown.until) return true;
+    }
+    for(RemoteContentFilter& remote : remoteFilters) {
+        if(remote.lastReport == 0 || remote.topicId != topicId || timeNow - remote.lastReport > CONTENT_FILTER_TIMEOUT) continue;
+        if(remote.filter.matches(data, len)) return true;
+        known = true;
+    }
+    return !known;
 }
 
 
@@ -188,52 +440,75 @@ void Gateway::resetTopicsToForward() {
 
 /*************************************************************************/
 
-void Gateway::AnalyseAndDistributeMessagesFromNetwork() {
+void Gateway::AnalyseAndDistributeMessagesFromNetwork(NetworkMessage& inMsg) {
+    RODOS_PROFILE_MIDDLEWARE_SCOPE("gateway analyse");
 
-    if(networkInMessage.get_senderNode() == myNodeNr) {
+    if(inMsg.get_senderNode() == myNodeNr) {
         return;
     } // ***** discard messages from self
 
-    if(!networkInMessage.isCheckSumOk()) {
-        // PRINTF("Message dropped: Wrong Checksum %x != %x\n", networkInMessage.get_checksum(), networkInMessage.calculateCheckSum());
+    if(!inMsg.isCheckSumOk()) {
+        // PRINTF("Message dropped: Wrong Checksum %x != %x\n", inMsg.get_checksum(), inMsg.calculateCheckSum());
         return;
     }
-    if(messageSeen(networkInMessage)) return;
+    if(messageSeen(inMsg)) return;
 
-    networkInMessage.dec_maxStepsToForward();
+    inMsg.dec_maxStepsToForward();
     { PRIORITY_CEILER_IN_SCOPE();  numberOfReceivedMsgsFromNetwork++; }
 
-    uint32_t topicId           = networkInMessage.get_topicId();
+    uint32_t topicId           = inMsg.get_topicId();
 
     if(topicId == 0 && getTopicsToForwardFromOutside) { // This is a topic report of expected topics in network.
         if(linkinterface->isBroadcastLink) {
-            addTopicsToForward((TopicListReport*)networkInMessage.userDataC); // for broadcast networks
+            addTopicsToForward((TopicListReport*)inMsg.userDataC); // for broadcast networks
         } else {
-            setTopicsToForward((TopicListReport*)networkInMessage.userDataC); // for intelligent networks-Switches
+            setTopicsToForward((TopicListReport*)inMsg.userDataC); // for intelligent networks-Switches
         }
         getTopicsToForwardFromOutside=true;
 
+    } else if(topicId == TOPIC_ID_FOR_CONTENT_FILTER_REPORT) { // only for this link, not distributed, not forwarded
+        if(contentFilterExport && !(inMsg.get_type() & NET_MSG_COMPRESSED)) {
+            receiveContentFilterReport(inMsg.get_senderNode(), inMsg.userDataC, inMsg.get_len());
+        }
+
     } else if(topicId > 0) {
         /** now distribute locally (if not from self and not topicreports) **/
 
+        NodeSet* receivers   = networkInReceivers.readFrom(inMsg) ? &networkInReceivers : 0;
+        uint8_t* userData    = inMsg.userDataC;
+        size_t   userDataLen = inMsg.get_len() - NodeSet::extensionSize(inMsg);
+        if(inMsg.get_type() & NET_MSG_COMPRESSED) {
+            userData = payloadCompression ? payloadCompression->decompressMsg(inMsg, userDataLen) : 0;
+        }
+        ReassemblyBuffer* reassembled = 0;
+        if(userData && (inMsg.get_type() & NET_MSG_FRAGMENT)) {
+            reassembled = reassembler.addFragment(inMsg.get_senderNode(), topicId, userData, userDataLen);
+            userData    = reassembled ? reassembled->data : 0; // 0: more fragments to come
+        }
 
         NetMsgInfo msgInfo;
         msgInfo.linkId         = linkIdentifier;
-        msgInfo.sentTime       = networkInMessage.get_sentTime();
-        msgInfo.senderNode     = networkInMessage.get_senderNode();
-        msgInfo.senderThreadId = networkInMessage.get_senderThreadId();
-        msgInfo.receiverNode   = networkInMessage.get_receiverNode();
-        msgInfo.receiverNodesBitMap = networkInMessage.get_receiverNodesBitMap();
-        msgInfo.messageType    = (NetMsgType)networkInMessage.get_type();
-
-        ITERATE_LIST(TopicInterface, TopicInterface::topicList) {
-            if(iter->topicId == topicId) {
-                iter->publish(networkInMessage.userDataC, false, &msgInfo);
-            }
-        } // search all local topics
+        msgInfo.sentTime       = inMsg.get_sentTime();
+        msgInfo.senderNode     = inMsg.get_senderNode();
+        msgInfo.senderThreadId = inMsg.get_senderThreadId();
+        msgInfo.receiverNode   = inMsg.get_receiverNode();
+        msgInfo.receiverNodesBitMap = inMsg.get_receiverNodesBitMap();
+        msgInfo.receiverNodes  = receivers;
+        msgInfo.messageType    = (NetMsgType)(inMsg.get_type() & ~(NET_MSG_COMPRESSED | NET_MSG_FRAGMENT | NET_MSG_RECEIVER_SET));
+        msgInfo.sequenceNr     = reassembled ? reassembled->msgId : inMsg.get_sequenceNr();
+
+        bool forMe = !receivers || receivers->contains(NodeSet::nodeIndex(myNodeNr));
+        if(userData && forMe) { // 0: can not decompress it or an incomplete fragmented message. Routers still forward it
+            ITERATE_LIST(TopicInterface, TopicInterface::topicList) {
+                if(iter->topicId == topicId) {
+                    iter->publish(userData, false, &msgInfo);
+                }
+            } // search all local topics
+        }
+        if(reassembled) reassembler.release(reassembled);
 
         //Publish for Routers to forward
-        ((TopicInterface*)&defaultRouterTopic)->publish(&networkInMessage,false,&msgInfo);
+        ((TopicInterface*)&defaultRouterTopic)->publish(&inMsg,false,&msgInfo);
     }
 }
 
@@ -253,21 +528,35 @@ void Gateway::run() {
 
     while(1) {
         linkinterface->suspendUntilDataReady(NOW()+ 10 * MILLISECONDS);
+        // exit() may be destroying the link object: do not touch it any more
+        while(isShuttingDown) suspendCallerUntil(END_OF_TIME);
 
         didSomething=true;
         while(didSomething) {
             didSomething=false;
 
-            if(linkinterface->getNetworkMsg(networkInMessage, realMsgSize)) {
+            bool         received;
+            NetBufferRef inBuffer; // zero copy links: the message stays in the pool buffer, released after the loop
+            {
+                RODOS_PROFILE_MIDDLEWARE_SCOPE("link receive");
+                received = linkinterface->getNetworkBuffer(inBuffer);
+                if(received) {
+                    realMsgSize = static_cast<int32_t>(inBuffer.used());
+                } else {
+                    received = linkinterface->getNetworkMsg(networkInMessage, realMsgSize);
+                }
+            }
+            if(received) {
+                NetworkMessage& inMsg = inBuffer.isValid() ? inBuffer.msg() : networkInMessage;
 
                 if(realMsgSize < 0) {// The physical layer does not provide a "real" msg size by its own, but relies on the message header
-                    AnalyseAndDistributeMessagesFromNetwork();
+                    AnalyseAndDistributeMessagesFromNetwork(inMsg);
                 } else {
                     if(realMsgSize >= ((int32_t)sizeof(NetworkMessage)-MAX_NETWORK_MESSAGE_LENGTH)) {
-                        if(realMsgSize == (int32_t)networkInMessage.numberOfBytesToSend()) {
-                            AnalyseAndDistributeMessagesFromNetwork();
+                        if(realMsgSize == (int32_t)inMsg.numberOfBytesToSend()) {
+                            AnalyseAndDistributeMessagesFromNetwork(inMsg);
                         } else {
-                            PRINTF("Message dropped because expected size(%d) != real size(%d)\n",(int)networkInMessage.numberOfBytesToSend(),(int)realMsgSize);
+                            PRINTF("Message dropped because expected size(%d) != real size(%d)\n",(int)inMsg.numberOfBytesToSend(),(int)realMsgSize);
                         }
                     } else {
                         PRINTF("Message dropped because received is even smaller than the header\n");
@@ -278,6 +567,7 @@ void Gateway::run() {
             }
 
         }
+        if(contentFilterExport) sendContentFilterReports();
     }
 } // run
 
@@ -294,9 +584,11 @@ void prepareNetworkMessage(NetworkMessage& netMsg, const uint32_t topicId,const
     netMsg.put_sentTime(netMsgInfo.sentTime);
     netMsg.put_type((uint16_t)netMsgInfo.messageType);
     netMsg.put_senderThreadId(netMsgInfo.senderThreadId);
+    netMsg.put_sequenceNr(netMsgInfo.sequenceNr);
     RODOS_ASSERT(len <= UINT16_MAX);
     if(len > UINT16_MAX) len = UINT16_MAX;
     netMsg.setUserData(data, static_cast<uint16_t>(len)); // Sets len and copies user data
+    if(netMsgInfo.receiverNodes) netMsgInfo.receiverNodes->appendTo(netMsg);
     netMsg.setCheckSum();
 }
 
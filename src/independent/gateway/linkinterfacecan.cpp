@@ -256,6 +256,7 @@ bool LinkinterfaceCAN::appendCANMsgToCurrentNetMsg(BufferedCANMessage* canMsg){
 		currentMsg->put_senderNode(static_cast<int32_t>(currentReceiveCANId & uint32_tOnes(CAN_LINK_NODE_BITS)));
 		currentMsg->put_senderThreadId(0);
 		currentMsg->put_sentTime(NOW());
+		currentMsg->put_sequenceNr(0); // not transmitted over CAN: no duplicate detection
 		currentMsg->put_topicId((currentReceiveCANId >> CAN_LINK_NODE_BITS) & uint32_tOnes(CAN_LINK_TOPIC_BITS));
 		currentMsg->put_len(len);
 		currentDataPointer = currentMsg->userDataC;
@@ -15,6 +15,10 @@ HAL_Sharedmemory hal_sharedmemory(Sharedmemory_IDX0);
 LinkinterfaceSHM::LinkinterfaceSHM(Sharedmemory_IDX shmIdx) :
 		Linkinterface(-1) {
 	this->shmIdx = shmIdx;
+	for(uint32_t i = 0; i < MAXMEMBERS; i++) {
+		lastReadX[i]  = 0;
+		lastReadAt[i] = 0;
+	}
 }
 
 void LinkinterfaceSHM::init() {
@@ -70,6 +74,22 @@ bool LinkinterfaceSHM::sendNetworkMsg(NetworkMessage &outMsg) {
 	return true;
 }
 
+bool LinkinterfaceSHM::hasRoomToSend() {
+	if(fifo==0)
+		return true;
+	int64_t now = NOW();
+	bool room = true;
+	for(uint32_t i = 0; i < MAXMEMBERS; i++) {
+		size_t readX  = fifo->readX[i];
+		size_t unread = (fifo->writeX + FIFOSIZE - readX) % FIFOSIZE;
+		// put() shifts slow readers (and unused slots) to the full position, only reading moves them elsewhere
+		if(unread == 0 || (readX != lastReadX[i] && unread < FIFOSIZE - 1)) lastReadAt[i] = now;
+		lastReadX[i] = readX;
+		if(lastReadAt[i] != 0 && now - lastReadAt[i] < SHM_READER_TIMEOUT && unread >= FIFOSIZE - 2) room = false;
+	}
+	return room;
+}
+
 bool LinkinterfaceSHM::getNetworkMsg(NetworkMessage &inMsg, int32_t &numberOfReceivedBytes) {
 	if(fifo==0 || readerId < 0)
 		return false;
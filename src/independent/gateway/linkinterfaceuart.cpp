@@ -9,6 +9,7 @@
  */
 
 #include "gateway/linkinterfaceuart.h"
+#include "gateway/compactheader.h"
 
 namespace RODOS {
 
@@ -36,6 +37,15 @@ bool LinkinterfaceUART::sendNetworkMsg(NetworkMessage &outgoingMessage)	{
     uint8_t* outputBuffer     = reinterpret_cast<uint8_t*>(&outgoingMessage);
     int      outputBufferSize = static_cast<int>(outgoingMessage.numberOfBytesToSend());
 
+    if(compactHeader) {
+        outputBuffer     = compactHeader->txBuffer;
+        outputBufferSize = static_cast<int>(compactHeader->encode(outgoingMessage, outputBuffer, sizeof(compactHeader->txBuffer)));
+        if(outputBufferSize == 0) {
+            txInProg = false;
+            return false;
+        }
+    }
+
     errFLag = false;
     sendMsg(outputBufferSize, outputBuffer); // in the S3S lib, encodes and calls putByte
     
@@ -71,6 +81,15 @@ void LinkinterfaceUART::putByte(uint8_t c) { // caller will be suspended until d
 bool LinkinterfaceUART::getNetworkMsg(NetworkMessage &inMsg, int32_t &numberOfReceivedBytes) {
     uint8_t* inputBuffer = (unsigned char*)&inMsg;
 
+    if(compactHeader) {
+        int len = getMsg(static_cast<int>(sizeof(compactHeader->rxBuffer)), compactHeader->rxBuffer);
+        if(len <= 0) return false;
+        bool wasCompact = CompactHeader::isCompact(compactHeader->rxBuffer);
+        if(!compactHeader->decode(compactHeader->rxBuffer, static_cast<size_t>(len), inMsg)) return false;
+        numberOfReceivedBytes = wasCompact ? inMsg.numberOfBytesToSend() : len;
+        return true;
+    }
+
     numberOfReceivedBytes = getMsg(MAX_UART_MESSAGE_LENGTH, inputBuffer); // in S3P, calls getByte
 
     return numberOfReceivedBytes != -1;
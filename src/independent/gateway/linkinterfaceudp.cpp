@@ -26,6 +26,7 @@ LinkinterfaceUDP::LinkinterfaceUDP(UDPInOut* udpInOut, int64_t identifier) : Lin
     udpToNetwork = &(udpInOut->udpOut);
     isBroadcastLink = udpInOut->isBroadcastLink;
     newMessage=false;
+    droppedMsgs=0;
 }
 
 
@@ -45,14 +46,30 @@ bool LinkinterfaceUDP::sendNetworkMsg(NetworkMessage &outMsg)	{
 
 void LinkinterfaceUDP::putFromInterrupt([[gnu::unused]] const uint32_t topicId, const void* any, [[gnu::unused]] size_t len) {
     const GenericMsgRef* msg = (const GenericMsgRef*)any;
-    incoming.put(*((const NetworkMessage*)msg->msgPtr));
+    if(msg->msgLen <= 0) return;
+    NetBufferRef buffer = netBufferPool.copyOf(msg->msgPtr, static_cast<size_t>(msg->msgLen)); // only the received bytes
+    if(!buffer.isValid() || !incoming.put(buffer.get())) {
+        droppedMsgs++;
+        return; // buffer is released
+    }
+    buffer.detach(); // the fifo has the reference now
     if(threadToResume) threadToResume->resume();
 }
 
 
+bool LinkinterfaceUDP::getNetworkBuffer(NetBufferRef &buffer) {
+    NetBuffer* received;
+    if(!incoming.get(received)) return false;
+    buffer = NetBufferRef(received); // takes over the reference of the fifo
+    return true;
+}
+
 bool LinkinterfaceUDP::getNetworkMsg(NetworkMessage &inMsg,int32_t &numberOfReceivedBytes) {
     numberOfReceivedBytes = -1;
-    return incoming.get(inMsg);
+    NetBufferRef buffer; // released at return
+    if(!getNetworkBuffer(buffer)) return false;
+    memcpy(&inMsg, &buffer.msg(), buffer.used());
+    return true;
 }
 
 void LinkinterfaceUDP::suspendUntilDataReady(int64_t reactivationTime){
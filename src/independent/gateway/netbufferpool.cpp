@@ -0,0 +1,133 @@
+/**
+ * @file netbufferpool.cpp
+ * @date 2026/10/11
+ *
+ * @brief pool of reference counted buffers for network messages, see netbufferpool.h
+ *
+ */
+
+#include <new>
+#include <string.h>
+
+#include "gateway/netbufferpool.h"
+
+namespace RODOS {
+
+NetBufferPool netBufferPool;
+
+/*************** NetBufferRef *****************/
+
+NetBufferRef::NetBufferRef(const NetBufferRef& other) : buffer(other.buffer) {
+    if(buffer) buffer->refCount++;
+}
+
+NetBufferRef& NetBufferRef::operator=(const NetBufferRef& other) {
+    if(other.buffer) other.buffer->refCount++; // first: other may be this
+    release();
+    buffer = other.buffer;
+    return *this;
+}
+
+void NetBufferRef::release() {
+    if(buffer == 0) return;
+    if(buffer->refCount-- == 1) buffer->pool->free(buffer); // the last one
+    buffer = 0;
+}
+
+NetBuffer* NetBufferRef::detach() {
+    NetBuffer* detached = buffer;
+    buffer              = 0;
+    return detached;
+}
+
+/*************** NetBufferPool *****************/
+
+NetBufferPool::NetBufferPool() {
+    static const uint32_t numOfBuffers[NUM_OF_SIZE_CLASSES] = { NET_BUFFERS_SMALL, NET_BUFFERS_MEDIUM, NET_BUFFERS_LARGE };
+    allocFailures = 0;
+    for(uint32_t sizeClass = 0; sizeClass < NUM_OF_SIZE_CLASSES; sizeClass++) {
+        for(uint32_t i = 0; i < numOfBuffers[sizeClass]; i++) {
+            NetBuffer* buf = new(buffer(sizeClass, static_cast<uint16_t>(i))) NetBuffer; // placement new: the Atomic
+            buf->refCount  = 0;
+            buf->pool      = this;
+            buf->capacity  = static_cast<uint16_t>(capacityOf(sizeClass));
+            buf->used      = 0;
+            buf->sizeClass = static_cast<uint8_t>(sizeClass);
+            buf->next      = (i + 1 < numOfBuffers[sizeClass]) ? static_cast<uint16_t>(i + 1) : NO_BUFFER;
+        }
+        freeList[sizeClass]         = 0;
+        numOfFreeBuffers[sizeClass] = numOfBuffers[sizeClass];
+    }
+}
+
+size_t NetBufferPool::capacityOf(uint32_t sizeClass) const {
+    static const size_t capacities[NUM_OF_SIZE_CLASSES] = { NET_BUFFER_SMALL_SIZE, NET_BUFFER_MEDIUM_SIZE, sizeof(NetworkMessage) };
+    return capacities[sizeClass];
+}
+
+NetBuffer* NetBufferPool::buffer(uint32_t sizeClass, uint16_t index) {
+    switch(sizeClass) {
+    case 0: return reinterpret_cast<NetBuffer*>(smallBuffers + index * SMALL_STRIDE);
+    case 1: return reinterpret_cast<NetBuffer*>(mediumBuffers + index * MEDIUM_STRIDE);
+    default: return reinterpret_cast<NetBuffer*>(largeBuffers + index * LARGE_STRIDE);
+    }
+}
+
+NetBuffer* NetBufferPool::pop(uint32_t sizeClass) {
+    uint32_t head = freeList[sizeClass];
+    while(1) {
+        uint16_t index = static_cast<uint16_t>(head & 0xffff);
+        if(index == NO_BUFFER) return 0;
+        NetBuffer* buf     = buffer(sizeClass, index);
+        uint32_t   newHead = ((head + 0x10000) & 0xffff0000) | buf->next; // new tag: a pop and push between load and here fails
+        if(freeList[sizeClass].compareExchange(head, newHead)) {
+            numOfFreeBuffers[sizeClass]--;
+            return buf;
+        }
+    }
+}
+
+void NetBufferPool::free(NetBuffer* buf) {
+    uint32_t sizeClass = buf->sizeClass;
+    size_t   stride    = (sizeClass == 0) ? SMALL_STRIDE : (sizeClass == 1) ? MEDIUM_STRIDE : LARGE_STRIDE;
+    uint16_t index     = static_cast<uint16_t>(static_cast<size_t>(reinterpret_cast<uint8_t*>(buf) -
+                                                                   reinterpret_cast<uint8_t*>(buffer(sizeClass, 0))) / stride);
+    uint32_t head = freeList[sizeClass];
+    do {
+        buf->next = static_cast<uint16_t>(head & 0xffff);
+    } while(!freeList[sizeClass].compareExchange(head, ((head + 0x10000) & 0xffff0000) | index));
+    numOfFreeBuffers[sizeClass]++;
+}
+
+NetBuffer* NetBufferPool::allocBuffer(size_t bytes) {
+    for(uint32_t sizeClass = 0; sizeClass < NUM_OF_SIZE_CLASSES; sizeClass++) {
+        if(capacityOf(sizeClass) < bytes) continue;
+        NetBuffer* buf = pop(sizeClass);
+        if(buf == 0) continue; // a larger one
+        buf->refCount = 1;
+        buf->used     = 0;
+        return buf;
+    }
+    allocFailures++;
+    return 0;
+}
+
+NetBufferRef NetBufferPool::alloc(size_t bytes) {
+    return NetBufferRef(allocBuffer(bytes));
+}
+
+NetBufferRef NetBufferPool::copyOf(const void* data, size_t len) {
+    if(len > sizeof(NetworkMessage)) len = sizeof(NetworkMessage);
+    NetBuffer* buf = allocBuffer(len);
+    if(buf) {
+        memcpy(&buf->msg(), data, len);
+        buf->used = static_cast<uint16_t>(len);
+    }
+    return NetBufferRef(buf);
+}
+
+NetBufferRef NetBufferPool::copyOf(const NetworkMessage& msg) {
+    return copyOf(&msg, msg.numberOfBytesToSend());
+}
+
+} // namespace RODOS
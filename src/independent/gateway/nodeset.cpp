@@ -0,0 +1,120 @@
+/**
+ * @file nodeset.cpp
+ * @date 2026/10/09
+ *
+ * @brief set of receiver nodes, see nodeset.h
+ *
+ */
+
+#include "nodeset.h"
+#include "netmsginfo.h"
+
+namespace RODOS {
+
+bool NodeSet::isEmpty() const {
+    for(uint32_t i = 0; i < NODE_SET_WORDS; i++) {
+        if(words[i] != 0) return false;
+    }
+    return true;
+}
+
+bool NodeSet::isExtended() const {
+    for(uint32_t i = 1; i < NODE_SET_WORDS; i++) {
+        if(words[i] != 0) return true;
+    }
+    return false;
+}
+
+uint32_t NodeSet::count() const {
+    uint32_t cnt = 0;
+    for(uint32_t i = 0; i < NODE_SET_WORDS; i++) cnt += static_cast<uint32_t>(__builtin_popcount(words[i]));
+    return cnt;
+}
+
+int32_t NodeSet::next(uint32_t from) const {
+    for(uint32_t i = from / 32; i < NODE_SET_WORDS; i++) {
+        uint32_t word = words[i];
+        if(i == from / 32) word &= ~0u << (from % 32);
+        if(word != 0) return static_cast<int32_t>(i * 32 + static_cast<uint32_t>(__builtin_ctz(word)));
+    }
+    return -1;
+}
+
+bool NodeSet::intersects(const NodeSet& other) const {
+    for(uint32_t i = 0; i < NODE_SET_WORDS; i++) {
+        if(words[i] & other.words[i]) return true;
+    }
+    return false;
+}
+
+bool NodeSet::isSubsetOf(const NodeSet& other) const {
+    for(uint32_t i = 0; i < NODE_SET_WORDS; i++) {
+        if(words[i] & ~other.words[i]) return false;
+    }
+    return true;
+}
+
+void NodeSet::intersectWith(const NodeSet& other) {
+    for(uint32_t i = 0; i < NODE_SET_WORDS; i++) words[i] &= other.words[i];
+}
+
+uint32_t NodeSet::fold() const {
+    uint32_t bitmap = 0;
+    for(uint32_t i = 0; i < NODE_SET_WORDS; i++) bitmap |= words[i];
+    return bitmap;
+}
+
+void NodeSet::unfold(uint32_t bitmap) {
+    for(uint32_t i = 0; i < NODE_SET_WORDS; i++) words[i] = bitmap;
+}
+
+size_t NodeSet::encodedSize() const {
+    size_t size = 1;
+    for(uint32_t i = 0; i < NODE_SET_WORDS; i++) {
+        if(words[i] != 0) size += 5;
+    }
+    return size;
+}
+
+bool NodeSet::appendTo(NetworkMessage& msg) const {
+    size_t len = msg.get_len();
+    if(len + encodedSize() > MAX_NETWORK_MESSAGE_LENGTH) return false;
+
+    uint8_t* pos = msg.userDataC + len;
+    uint8_t  n   = 0;
+    for(uint32_t i = 0; i < NODE_SET_WORDS; i++) {
+        if(words[i] == 0) continue;
+        *pos++ = static_cast<uint8_t>(i);
+        uint32_tToBigEndian(pos, words[i]);
+        pos += 4;
+        n++;
+    }
+    *pos++ = n;
+    msg.put_len(static_cast<uint16_t>(pos - msg.userDataC));
+    msg.put_type(static_cast<uint16_t>(msg.get_type() | NET_MSG_RECEIVER_SET));
+    return true;
+}
+
+size_t NodeSet::extensionSize(const NetworkMessage& msg) {
+    if(!(msg.get_type() & NET_MSG_RECEIVER_SET)) return 0;
+    size_t len = msg.get_len();
+    if(len == 0) return 0;
+    size_t size = 1 + 5u * msg.userDataC[len - 1];
+    return (size <= len) ? size : 0;
+}
+
+bool NodeSet::readFrom(const NetworkMessage& msg) {
+    size_t size = extensionSize(msg);
+    if(size == 0) return false;
+
+    clear();
+    const uint8_t* pos = msg.userDataC + msg.get_len() - size;
+    for(size_t n = size / 5; n > 0; n--) {
+        uint32_t wordIndex = *pos++;
+        if(wordIndex < NODE_SET_WORDS) words[wordIndex] = bigEndianToUint32_t(pos); // more nodes than here: ignored
+        pos += 4;
+    }
+    return true;
+}
+
+} // namespace RODOS
@@ -0,0 +1,116 @@
+/**
+ * @file payloadcompression.cpp
+ * @date 2026/10/03
+ *
+ * @brief LZ77 compression of NetworkMessage user data, see payloadcompression.h
+ *
+ */
+
+#include "gateway/payloadcompression.h"
+#include "string_pico.h"
+
+namespace RODOS {
+
+static inline uint32_t hash3(const uint8_t* p) {
+    uint32_t x = static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16);
+    return (x * 2654435761u) >> (32 - PayloadCompression::HASH_BITS);
+}
+
+/// writes the pending literals, false if they do not fit
+static inline bool flushLiterals(const uint8_t* literals, size_t n, uint8_t*& out, const uint8_t* outEnd) {
+    while(n > 0) {
+        size_t run = (n > PayloadCompression::MAX_LITERAL_RUN) ? PayloadCompression::MAX_LITERAL_RUN : n;
+        if(static_cast<size_t>(outEnd - out) < run + 1) return false;
+        *out++ = static_cast<uint8_t>(run - 1);
+        memcpy(out, literals, run);
+        out      += run;
+        literals += run;
+        n        -= run;
+    }
+    return true;
+}
+
+size_t PayloadCompression::compress(const uint8_t* src, size_t len, uint8_t* dst, size_t maxLen) {
+    if(len <= MIN_MATCH || len > 0xffff) return 0;
+    size_t         limit  = (maxLen < len - 1) ? maxLen : len - 1; // has to be smaller than the original
+    uint8_t*       out    = dst;
+    const uint8_t* outEnd = dst + limit;
+    memset(hashTable, 0, sizeof(hashTable));
+
+    size_t pos          = 0;
+    size_t literalStart = 0;
+    while(pos + MIN_MATCH <= len) {
+        uint32_t h         = hash3(src + pos);
+        size_t   candidate = hashTable[h];
+        hashTable[h]       = static_cast<uint16_t>(pos + 1);
+
+        size_t matchLen = 0;
+        if(candidate != 0 && pos - (candidate - 1) <= MAX_OFFSET) {
+            const uint8_t* a   = src + candidate - 1;
+            size_t         max = (len - pos < MAX_MATCH) ? len - pos : MAX_MATCH;
+            while(matchLen < max && a[matchLen] == src[pos + matchLen]) matchLen++;
+        }
+        if(matchLen < MIN_MATCH) {
+            pos++;
+            continue;
+        }
+
+        if(!flushLiterals(src + literalStart, pos - literalStart, out, outEnd)) return 0;
+        if(outEnd - out < 2) return 0;
+        size_t offset = pos - (candidate - 1) - 1;
+        *out++ = static_cast<uint8_t>(0x80 | ((matchLen - MIN_MATCH) << 2) | (offset >> 8));
+        *out++ = static_cast<uint8_t>(offset & 0xff);
+
+        for(size_t end = pos + matchLen; ++pos < end;) { // the following matches may start inside this one
+            if(pos + MIN_MATCH <= len) hashTable[hash3(src + pos)] = static_cast<uint16_t>(pos + 1);
+        }
+        literalStart = pos;
+    }
+    if(!flushLiterals(src + literalStart, len - literalStart, out, outEnd)) return 0;
+    return static_cast<size_t>(out - dst);
+}
+
+size_t PayloadCompression::decompress(const uint8_t* src, size_t len, uint8_t* dst, size_t maxLen) {
+    const uint8_t* end = src + len;
+    size_t         out = 0;
+    while(src < end) {
+        uint8_t token = *src++;
+        if((token & 0x80) == 0) {
+            size_t run = static_cast<size_t>(token) + 1;
+            if(static_cast<size_t>(end - src) < run || maxLen - out < run) return 0;
+            memcpy(dst + out, src, run);
+            src += run;
+            out += run;
+        } else {
+            if(src >= end) return 0;
+            size_t matchLen = ((token >> 2) & 0x1f) + MIN_MATCH;
+            size_t offset   = ((static_cast<size_t>(token & 0x03) << 8) | *src++) + 1;
+            if(offset > out || maxLen - out < matchLen) return 0;
+            for(size_t i = 0; i < matchLen; i++, out++) dst[out] = dst[out - offset]; // byte by byte: may overlap
+        }
+    }
+    return out;
+}
+
+NetworkMessage* PayloadCompression::compressMsg(NetworkMessage& msg) {
+    if((msg.get_type() & NET_MSG_COMPRESSED) || !shallCompress(msg.get_topicId())) return &msg;
+
+    size_t receiversLen = NodeSet::extensionSize(msg); // stays uncompressed, routers read it
+    size_t dataLen      = msg.get_len() - receiversLen;
+    size_t len = compress(msg.userDataC, dataLen, compressedMsg.userDataC, MAX_NETWORK_MESSAGE_LENGTH - receiversLen);
+    if(len == 0) return &msg;
+
+    memcpy(&compressedMsg, &msg, msg.numberOfBytesToSend() - msg.get_len()); // header only
+    memcpy(compressedMsg.userDataC + len, msg.userDataC + dataLen, receiversLen);
+    compressedMsg.put_type(static_cast<uint16_t>(msg.get_type() | NET_MSG_COMPRESSED));
+    compressedMsg.put_len(static_cast<uint16_t>(len + receiversLen));
+    compressedMsg.setCheckSum();
+    return &compressedMsg;
+}
+
+uint8_t* PayloadCompression::decompressMsg(const NetworkMessage& msg, size_t& len) {
+    len = decompress(msg.userDataC, msg.get_len() - NodeSet::extensionSize(msg), decompressedData, MAX_NETWORK_MESSAGE_LENGTH);
+    return (len == 0) ? 0 : decompressedData;
+}
+
+} // namespace RODOS
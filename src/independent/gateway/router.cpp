@@ -19,11 +19,78 @@ namespace RODOS {
 
 constexpr uint8_t not0(const void* a) { return (a) ? 1 : 0; }
 
+extern int32_t myNodeNr;
+
+/*************************************************************************/
+
+void RoutingTable::reset() {
+    for(uint32_t i = 0; i < MAX_ADDRESSABLE_NODES; i++) {
+        routes[i].linkId    = 0;
+        routes[i].stepsLeft   = 0;
+        routes[i].nodeNr      = 0;
+        routes[i].lastHeard   = END_OF_TIME;
+        routes[i].sharedUntil = 0;
+    }
+}
+
+void RoutingTable::learn(int32_t senderNode, uint32_t linkId, int16_t stepsLeft) {
+    int64_t timeNow = NOW();
+    PROTECT_IN_SCOPE(protector);
+    Route&  route   = routes[nodeIndex(senderNode)];
+
+    bool isOld = route.lastHeard == END_OF_TIME || route.lastHeard < timeNow - ROUTE_MAX_AGE;
+    if(!isOld && route.nodeNr != senderNode) { // nodeIndex() is nodeNr % MAX_ADDRESSABLE_NODES
+        if(route.sharedUntil < timeNow) {
+            indexCollisions++;
+            RODOS_ERROR("RoutingTable: two nodes with the same node index, their messages are flooded");
+        }
+        route.sharedUntil = timeNow + ROUTE_MAX_AGE;
+    }
+    route.nodeNr = senderNode;
+    // in a mesh the same node is heard through several links: keep the shortest path
+    if(isOld || route.linkId == linkId || stepsLeft > route.stepsLeft) {
+        route.linkId    = linkId;
+        route.stepsLeft = stepsLeft;
+        route.lastHeard = timeNow;
+    }
+}
+
+void RoutingTable::knownNodes(NodeSet& nodes) {
+    int64_t definitionOfOld = NOW() - ROUTE_MAX_AGE;
+    nodes.clear();
+    PROTECT_IN_SCOPE(protector);
+    for(uint32_t i = 0; i < MAX_ADDRESSABLE_NODES; i++) {
+        if(routes[i].lastHeard != END_OF_TIME && routes[i].lastHeard >= definitionOfOld) nodes.add(i);
+    }
+}
+
+bool RoutingTable::linksTo(const NodeSet& nodes, uint32_t* linkIds, uint32_t& numOfLinks, uint32_t maxLinks) {
+    int64_t definitionOfOld = NOW() - ROUTE_MAX_AGE;
+    numOfLinks = 0;
+    PROTECT_IN_SCOPE(protector);
+    for(int32_t index = nodes.next(0); index >= 0; index = nodes.next(static_cast<uint32_t>(index) + 1)) {
+        const Route& route = routes[index];
+        if(route.lastHeard == END_OF_TIME || route.lastHeard < definitionOfOld) return false;
+        if(route.sharedUntil > definitionOfOld + ROUTE_MAX_AGE) return false; // which of the nodes is meant?
+
+        uint32_t i = 0;
+        while(i < numOfLinks && linkIds[i] != route.linkId) i++;
+        if(i < numOfLinks) continue;
+        if(numOfLinks == maxLinks) return false;
+        linkIds[numOfLinks++] = route.linkId;
+    }
+    return true;
+}
+
+/*************************************************************************/
+
 Router::Router(bool forwardTopicReports_, Gateway* gateway1, Gateway* gateway2, Gateway* gateway3, Gateway* gateway4) :
     Subscriber(defaultRouterTopic,"Router"),
     localTopics(defaultGatewayTopic,*this,"Router") {
 
     forwardTopicReports=forwardTopicReports_;
+    learnRoutes = false;
+    extendedAddressing = false;
     gateways[0]      = gateway1;
     gateways[1]      = gateway2;
     gateways[2]      = gateway3;
@@ -34,13 +101,36 @@ Router::Router(bool forwardTopicReports_, Gateway* gateway1, Gateway* gateway2,
 
 
 uint32_t Router::put([[gnu::unused]] const uint32_t topicId, [[gnu::unused]] const size_t len, void* data, const NetMsgInfo& netMsgInfo) {
-    routeMsg(*((NetworkMessage*)data),netMsgInfo.linkId);
+    NetworkMessage* msg = (NetworkMessage*)data;
+    // all messages, also topic reports (every 3 seconds from each node), confirm the route to their sender
+    routingTable.learn(msg->get_senderNode(), netMsgInfo.linkId, msg->get_maxStepsToForward());
+    routeMsg(*msg,netMsgInfo.linkId);
     return 1;
 }
 
 bool Router::putGeneric(const uint32_t topicId, const size_t len,
                         const void* msg, const NetMsgInfo& netMsgInfo) {
 
+    if(netMsgInfo.receiverNodes && !extendedAddressing) { // see Gateway::setExtendedAddressing()
+        NetMsgInfo info    = netMsgInfo;
+        info.receiverNodes = 0;
+        return putGeneric(topicId, len, msg, info);
+    }
+
+    if(len > MAX_NETWORK_MESSAGE_LENGTH) { // see fragmentation.h
+        NetMsgInfo info = netMsgInfo;
+        uint32_t   numOfFragments = numberOfFragments(len);
+        if(info.sequenceNr == 0) info.sequenceNr = getNextMsgSequenceNr(numOfFragments);
+        for(uint32_t i = 0; i < numOfFragments; i++) {
+            fragmentPacer.waitToSend(fragmentBytes(len, i));
+            protector.enter();
+            prepareFragment(localMessage, topicId, msg, len, i, info);
+            routeMsg(localMessage,LINK_ID_RODOS_LOCAL_BROADCAST);
+            protector.leave();
+        }
+        return true;
+    }
+
     protector.enter();
     prepareNetworkMessage(localMessage,topicId,msg,len, netMsgInfo);
     routeMsg(localMessage,LINK_ID_RODOS_LOCAL_BROADCAST);
@@ -52,8 +142,18 @@ bool Router::putGeneric(const uint32_t topicId, const size_t len,
 void Router::routeMsg(NetworkMessage& msg,uint32_t linkid) {
     if(shouldRouteThisMsg(msg,linkid)) {
         msg.setCheckSum();
+        NodeSet  wantedNodes;
+        uint32_t wantedLinks[MAX_NUMBER_OF_GATEWAYS_PER_ROUTER];
+        uint32_t numOfWantedLinks = 0;
+        bool     prune = learnRoutes && nodesToReach(msg, wantedNodes) &&
+                         routingTable.linksTo(wantedNodes, wantedLinks, numOfWantedLinks, MAX_NUMBER_OF_GATEWAYS_PER_ROUTER);
 
         for(uint8_t i=0; i<numberOfGateways; i++) {
+            if(prune) {
+                uint32_t j = 0;
+                while(j < numOfWantedLinks && wantedLinks[j] != gateways[i]->getLinkIdentifier()) j++;
+                if(j == numOfWantedLinks) continue; // no interested node behind this gateway
+            }
             if(shouldRouteThisMsgToGateway(msg,linkid,gateways[i])) {
                 gateways[i]->sendNetworkMessage(msg);
             }
@@ -61,6 +161,31 @@ void Router::routeMsg(NetworkMessage& msg,uint32_t linkid) {
     }
 }
 
+bool Router::nodesToReach(NetworkMessage& msg, NodeSet& wantedNodes) {
+    if(msg.get_topicId() < ALL_TOPICS_BELOW_THIS_ARE_BROADCAST) return false;
+    uint32_t myIndex     = RoutingTable::nodeIndex(myNodeNr);
+    uint32_t senderIndex = RoutingTable::nodeIndex(msg.get_senderNode());
+
+    if(wantedNodes.readFrom(msg)) { // extended addressing: exactly these nodes
+        wantedNodes.remove(myIndex);     // local subscribers got it already
+        wantedNodes.remove(senderIndex); // and the sender has it
+        return true;
+    }
+
+    uint32_t wantedBits = msg.get_receiverNodesBitMap();
+    if(wantedBits == 0) return false; // no information from distributed-topic-register: as before
+    wantedBits &= ~(0x01u << (myIndex % 32));
+    wantedBits &= ~(0x01u << (senderIndex % 32));
+
+    NodeSet candidates; // each bit may be several nodes: the known ones
+    candidates.unfold(wantedBits);
+    routingTable.knownNodes(wantedNodes);
+    wantedNodes.intersectWith(candidates);
+    wantedNodes.remove(myIndex);
+    wantedNodes.remove(senderIndex);
+    return wantedNodes.fold() == wantedBits; // else some receivers unknown
+}
+
 bool Router::shouldRouteThisMsg(NetworkMessage& msg, [[gnu::unused]] uint32_t linkid) {
     if(msg.get_maxStepsToForward() <= 0)               return false;
     if(msg.get_topicId() == 0 && !forwardTopicReports) return false;
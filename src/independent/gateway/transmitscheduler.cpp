@@ -0,0 +1,133 @@
+/**
+ * @file transmitscheduler.cpp
+ * @date 2026/10/07
+ *
+ * @brief priority queues for the outgoing messages of a gateway, see transmitscheduler.h
+ *
+ */
+
+#include "gateway/transmitscheduler.h"
+#include "gateway/gateway.h"
+
+namespace RODOS {
+
+TransmitScheduler::TransmitScheduler(Mode mode_, int32_t priority) :
+    StaticThread<>("transmitScheduler", priority) {
+    mode               = mode_;
+    current            = NUM_OF_TRANSMIT_PRIORITIES - 1; // the first round begins with HIGH
+    waitingForMessages = false;
+    gateway            = 0;
+    poolEmpty          = 0;
+    for(uint32_t i = 0; i < NUM_OF_TRANSMIT_PRIORITIES; i++) {
+        queues[i].suspendedWriter = 0;
+        queues[i].deficit         = 0;
+        sentMsgs[i]               = 0;
+        queueFulls[i]             = 0;
+    }
+    setWeights(4, 2, 1);
+}
+
+void TransmitScheduler::setWeights(uint32_t high, uint32_t normal, uint32_t bulk) {
+    uint32_t weights[NUM_OF_TRANSMIT_PRIORITIES] = { high, normal, bulk };
+    for(uint32_t i = 0; i < NUM_OF_TRANSMIT_PRIORITIES; i++) {
+        queues[i].weight = static_cast<int32_t>((weights[i] == 0) ? 1 : weights[i]); // none shall starve
+    }
+}
+
+/*************** publishers *****************/
+
+NetworkMessage& TransmitScheduler::reserve(TransmitPriority priority) {
+    Queue& queue = queues[static_cast<uint32_t>(priority)];
+    queue.writer.enter();
+    return queue.preparing;
+}
+
+void TransmitScheduler::commit(TransmitPriority priority) {
+    uint32_t     index  = static_cast<uint32_t>(priority);
+    Queue&       queue  = queues[index];
+    NetBufferRef buffer = netBufferPool.copyOf(queue.preparing);
+    while(!buffer.isValid()) { // eg. a burst on an UDP input took all
+        poolEmpty++;
+        Thread::suspendCallerUntil(NOW() + POOL_RETRY_PERIOD);
+        buffer = netBufferPool.copyOf(queue.preparing);
+    }
+
+    bool ok = false;
+    while(!ok) {
+        PRIORITY_CEILER_IN_SCOPE();
+        ok = queue.fifo.put(buffer.get());
+        if(ok) {
+            buffer.detach(); // the fifo has the reference now
+            if(waitingForMessages) resume();
+        } else {
+            queueFulls[index]++;
+            queue.suspendedWriter = Thread::getCurrentThread();
+            Thread::suspendCallerUntil(END_OF_TIME); // resumed by run() after taking one out
+            queue.suspendedWriter = 0;
+        }
+    }
+    queue.writer.leave();
+}
+
+void TransmitScheduler::enqueue(const NetworkMessage& msg, TransmitPriority priority) {
+    reserve(priority) = msg;
+    commit(priority);
+}
+
+/*************** sender thread *****************/
+
+bool TransmitScheduler::dequeue(NetBufferRef& msg, uint32_t& priority) {
+    NetBuffer* buffer;
+    if(mode == Mode::STRICT_PRIORITY) {
+        for(priority = 0; priority < NUM_OF_TRANSMIT_PRIORITIES; priority++) {
+            if(!queues[priority].fifo.isEmpty() && queues[priority].fifo.get(buffer)) {
+                msg = NetBufferRef(buffer);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // deficit round robin: serve a class while it has credit, then the next one gets its quantum
+    for(uint32_t visits = 0; visits <= 2 * NUM_OF_TRANSMIT_PRIORITIES; visits++) {
+        Queue& queue = queues[current];
+        if(!queue.fifo.isEmpty() && queue.deficit > 0 && queue.fifo.get(buffer)) {
+            msg = NetBufferRef(buffer);
+            queue.deficit -= msg->numberOfBytesToSend();
+            priority = current;
+            return true;
+        }
+        if(queue.fifo.isEmpty()) queue.deficit = 0; // idle classes save no credit
+        current = (current + 1) % NUM_OF_TRANSMIT_PRIORITIES;
+        queues[current].deficit += queues[current].weight * QUANTUM;
+    }
+    return false;
+}
+
+void TransmitScheduler::run() {
+    while(1) {
+        int64_t wait = (gateway == 0) ? 0 : gateway->timeUntilLinkReady();
+        if(wait > 0) {
+            suspendCallerUntil(NOW() + wait); // choose after waiting: the newest high priority message shall go first
+            continue;
+        }
+
+        uint32_t     priority;
+        NetBufferRef outMsg;
+        {
+            PRIORITY_CEILER_IN_SCOPE();
+            if(!dequeue(outMsg, priority)) {
+                waitingForMessages = true;
+                suspendCallerUntil(END_OF_TIME); // resumed by commit()
+                waitingForMessages = false;
+                continue;
+            }
+            Thread* writer = queues[priority].suspendedWriter;
+            if(writer != 0) writer->resume();
+        }
+        gateway->transmit(outMsg.msg());
+        sentMsgs[priority]++;
+    }
+}
+
+} // namespace RODOS
@@ -0,0 +1,198 @@
+/**
+ * @file latency-histogram.cpp
+ * @date 2026/10/18
+ *
+ * @brief end-to-end latency of topics, see latency-histogram.h
+ *
+ */
+
+#include "rodos.h"
+#include "latency-histogram.h"
+
+namespace RODOS {
+
+List LatencyHistogram::latencyHistogramList = 0;
+
+Topic<LatencyReport> latencyTopic(TOPIC_ID_LATENCY_REPORT, "latency");
+
+/*************** buckets *****************/
+
+static constexpr uint32_t SUB_BUCKETS = 1u << LatencyCounts::SUB_BUCKET_BITS;
+
+uint32_t LatencyCounts::bucketOf(int64_t latency) {
+    if(latency < SUB_BUCKETS) return (latency < 0) ? 0 : static_cast<uint32_t>(latency);
+    uint64_t value    = static_cast<uint64_t>(latency);
+    uint32_t exponent = 63u - static_cast<uint32_t>(__builtin_clzll(value)); // >= SUB_BUCKET_BITS
+    uint32_t sub      = static_cast<uint32_t>(value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+    uint32_t bucket   = (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+    return (bucket < NUM_OF_BUCKETS) ? bucket : NUM_OF_BUCKETS - 1;
+}
+
+int64_t LatencyCounts::bucketLowerBound(uint32_t bucket) {
+    if(bucket < SUB_BUCKETS) return bucket;
+    uint32_t exponent = bucket / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+    uint64_t mantissa = SUB_BUCKETS + bucket % SUB_BUCKETS;
+    return static_cast<int64_t>(mantissa << (exponent - SUB_BUCKET_BITS));
+}
+
+int64_t LatencyCounts::bucketUpperBound(uint32_t bucket) {
+    if(bucket >= NUM_OF_BUCKETS - 1) return END_OF_TIME;
+    return bucketLowerBound(bucket + 1) - 1;
+}
+
+void LatencyCounts::clear() {
+    for(uint32_t i = 0; i < NUM_OF_BUCKETS; i++) buckets[i] = 0;
+    count = 0;
+    sum   = 0;
+    max   = 0;
+}
+
+int64_t LatencyCounts::percentile(uint32_t permille) const {
+    if(count == 0) return 0;
+    uint64_t wanted = (static_cast<uint64_t>(count) * permille + 999) / 1000;
+    if(wanted == 0) wanted = 1;
+    uint64_t counted = 0;
+    for(uint32_t i = 0; i < NUM_OF_BUCKETS; i++) {
+        counted += buckets[i];
+        if(counted >= wanted) {
+            int64_t upperBound = bucketUpperBound(i);
+            return (upperBound < max) ? upperBound : max;
+        }
+    }
+    return max;
+}
+
+/*************** histogram *****************/
+
+LatencyHistogram::LatencyHistogram(const char* name, uint32_t topicId_) : ListElement(latencyHistogramList, name), topicId(topicId_) {
+    reset();
+}
+
+void LatencyHistogram::add(int64_t latency) {
+    if(latency < 0) latency = 0;
+    uint32_t value = (latency > 0xffffffff) ? 0xffffffff : static_cast<uint32_t>(latency);
+
+    buckets[LatencyCounts::bucketOf(latency)]++;
+    count++;
+    uint32_t oldSum = (sumLow += value);
+    if(oldSum + value < oldSum) sumHigh++;
+    uint32_t oldMax = max.load();
+    while(value > oldMax && !max.compareExchange(oldMax, value)) {}
+}
+
+/// the value, 0 is left if reset
+static uint32_t take(Atomic<uint32_t>& counter, bool reset) {
+    uint32_t value = counter.load();
+    while(reset && !counter.compareExchange(value, 0)) {}
+    return value;
+}
+
+void LatencyHistogram::snapshot(LatencyCounts& to, bool reset) {
+    to.count = 0;
+    for(uint32_t i = 0; i < LatencyCounts::NUM_OF_BUCKETS; i++) {
+        to.buckets[i] = take(buckets[i], reset);
+        to.count += to.buckets[i];
+    }
+    take(count, reset);
+    uint32_t high = take(sumHigh, reset);
+    uint32_t low  = take(sumLow, reset);
+    to.sum        = static_cast<int64_t>((static_cast<uint64_t>(high) << 32) | low);
+    to.max        = take(max, reset);
+}
+
+void LatencyHistogram::reset() {
+    for(uint32_t i = 0; i < LatencyCounts::NUM_OF_BUCKETS; i++) buckets[i] = 0;
+    count   = 0;
+    sumLow  = 0;
+    sumHigh = 0;
+    max     = 0;
+}
+
+/*************** clock offsets of other nodes *****************/
+
+static int32_t  offsetNodes[LATENCY_MAX_CLOCK_OFFSETS];
+static int64_t  clockOffsets[LATENCY_MAX_CLOCK_OFFSETS];
+static uint32_t numOfClockOffsets = 0;
+
+bool setNodeClockOffset(int32_t nodeNumber, int64_t offset) {
+    for(uint32_t i = 0; i < numOfClockOffsets; i++) {
+        if(offsetNodes[i] == nodeNumber) {
+            clockOffsets[i] = offset;
+            return true;
+        }
+    }
+    if(numOfClockOffsets >= LATENCY_MAX_CLOCK_OFFSETS) return false;
+    offsetNodes[numOfClockOffsets]  = nodeNumber;
+    clockOffsets[numOfClockOffsets] = offset;
+    numOfClockOffsets++;
+    return true;
+}
+
+int64_t getNodeClockOffset(int32_t nodeNumber) {
+    for(uint32_t i = 0; i < numOfClockOffsets; i++) {
+        if(offsetNodes[i] == nodeNumber) return clockOffsets[i];
+    }
+    return 0;
+}
+
+int64_t deliveryLatency(const NetMsgInfo& netMsgInfo) {
+    int64_t sentTime = netMsgInfo.sentTime;
+    if(netMsgInfo.senderNode != getNodeNumber()) sentTime += getNodeClockOffset(netMsgInfo.senderNode);
+    return NOW() - sentTime;
+}
+
+/*************** monitor *****************/
+
+static uint32_t toMicroseconds(int64_t time) {
+    int64_t us = time / MICROSECONDS;
+    return (us > 0xffffffff) ? 0xffffffff : static_cast<uint32_t>(us);
+}
+
+LatencyMonitor::LatencyMonitor(int64_t period_, int32_t priority) :
+    StaticThread<>("LatencyMonitor", priority), period(period_), lastReport(0) {
+    lastReportMsg.numOfHistograms = 0;
+}
+
+void LatencyMonitor::report() {
+    int64_t timeNow = NOW();
+
+    LatencyReport& msg       = lastReportMsg;
+    msg.time                 = timeNow;
+    msg.period               = timeNow - lastReport;
+    msg.reserved             = 0;
+    lastReport               = timeNow;
+    uint32_t numOfHistograms = 0;
+
+    ITERATE_LIST(LatencyHistogram, LatencyHistogram::latencyHistogramList) {
+        if(numOfHistograms >= LATENCY_REPORT_MAX_HISTOGRAMS) break;
+        iter->snapshot(snapshotCounts, true);
+        LatencyEntry& entry = msg.histograms[numOfHistograms++];
+        entry.topicId       = iter->topicId;
+        entry.count         = snapshotCounts.count;
+        entry.p50Us         = toMicroseconds(snapshotCounts.percentile(500));
+        entry.p90Us         = toMicroseconds(snapshotCounts.percentile(900));
+        entry.p99Us         = toMicroseconds(snapshotCounts.percentile(990));
+        entry.maxUs         = toMicroseconds(snapshotCounts.max);
+    }
+    msg.numOfHistograms = numOfHistograms;
+
+    latencyTopic.publishMsgPart(msg, LatencyReport::lenForHistograms(numOfHistograms));
+}
+
+void LatencyMonitor::print() {
+    PRINTF("latencies in us: topic, count, p50, p90, p99, max\n");
+    uint32_t index = 0;
+    ITERATE_LIST(LatencyHistogram, LatencyHistogram::latencyHistogramList) {
+        if(index >= lastReportMsg.numOfHistograms) break;
+        LatencyEntry& entry = lastReportMsg.histograms[index++];
+        PRINTF("  %s: %d, %d, %d, %d, %d, %d\n", iter->getName(), static_cast<int>(entry.topicId), static_cast<int>(entry.count),
+               static_cast<int>(entry.p50Us), static_cast<int>(entry.p90Us), static_cast<int>(entry.p99Us), static_cast<int>(entry.maxUs));
+    }
+}
+
+void LatencyMonitor::run() {
+    lastReport = NOW();
+    TIME_LOOP(lastReport + period, period) { report(); }
+}
+
+} // namespace RODOS
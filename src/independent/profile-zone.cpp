@@ -0,0 +1,153 @@
+/**
+ * @file profile-zone.cpp
+ * @date 2026/10/18
+ *
+ * @brief profiling zones, see profile-zone.h
+ *
+ */
+
+#include "rodos.h"
+#include "profile-zone.h"
+
+namespace RODOS {
+
+List ProfileTable::profileTableList = 0;
+
+Topic<ProfileReport> profileTopic(TOPIC_ID_PROFILE_REPORT, "profile");
+
+void Thread::setProfileTable(ProfileTable* table) {
+    if(table) table->thread = this;
+    profileTable = table;
+}
+
+uint32_t ProfileZoneStats::bucketOf(uint32_t cycles) {
+    if(cycles < 256) return 0;
+    uint32_t log2   = 31u - static_cast<uint32_t>(__builtin_clz(cycles)); // >= 8
+    uint32_t bucket = (log2 - 8) / 2 + 1;
+    return (bucket < HISTOGRAM_BUCKETS) ? bucket : HISTOGRAM_BUCKETS - 1;
+}
+
+ProfileTable::ProfileTable(const char* name, bool middlewareZones_) :
+    ListElement(profileTableList, name), middlewareZones(middlewareZones_) {
+    thread       = 0;
+    numOfZones   = 0;
+    droppedZones = 0;
+    adding       = false;
+    for(uint32_t i = 0; i < PROFILE_MAX_ZONES; i++) zones[i].name = 0;
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+    *reinterpret_cast<volatile uint32_t*>(0xE000EDFC) |= (1u << 24); // DEMCR TRCENA
+    *reinterpret_cast<volatile uint32_t*>(0xE0001000) |= 1u;         // DWT CTRL CYCCNTENA
+#endif
+}
+
+/// zones are searched from a hash of the pointer to their name, the next free place if taken
+static uint32_t zoneHash(const char* zoneName) {
+    uintptr_t ptr = reinterpret_cast<uintptr_t>(zoneName);
+    return static_cast<uint32_t>((ptr >> 2) ^ (ptr >> 9));
+}
+
+void ProfileTable::add(const char* zoneName, uint32_t cycles) {
+    // only the thread and its interrupt servers, which end before the thread
+    // continues: a flag is enough, no atomic instruction
+    if(adding) { // an interrupt server in the middle of add() of its thread
+        droppedZones++;
+        return;
+    }
+    adding = true;
+    asm volatile("" ::: "memory"); // the zones not before adding is set
+    addZone(zoneName, cycles);
+    asm volatile("" ::: "memory");
+    adding = false;
+}
+
+void ProfileTable::addZone(const char* zoneName, uint32_t cycles) {
+    uint32_t index = zoneHash(zoneName) % PROFILE_MAX_ZONES;
+    for(uint32_t tries = 0; zones[index].name != zoneName; tries++) {
+        if(zones[index].name == 0) { // a new zone
+            ProfileZoneStats& zone = zones[index];
+            zone.totalCycles       = 0;
+            zone.count             = 0;
+            zone.minCycles         = 0xffffffff;
+            zone.maxCycles         = 0;
+            for(uint32_t i = 0; i < ProfileZoneStats::HISTOGRAM_BUCKETS; i++) zone.histogram[i] = 0;
+            zone.name = zoneName;
+            numOfZones++;
+            break;
+        }
+        if(tries >= PROFILE_MAX_ZONES) {
+            droppedZones++;
+            return;
+        }
+        index = (index + 1) % PROFILE_MAX_ZONES;
+    }
+
+    ProfileZoneStats& zone = zones[index];
+    zone.totalCycles += cycles;
+    zone.count++;
+    if(cycles < zone.minCycles) zone.minCycles = cycles;
+    if(cycles > zone.maxCycles) zone.maxCycles = cycles;
+    zone.histogram[ProfileZoneStats::bucketOf(cycles)]++;
+}
+
+const ProfileZoneStats* ProfileTable::find(const char* zoneName) const {
+    for(uint32_t i = 0; i < PROFILE_MAX_ZONES; i++) {
+        if(zones[i].name == zoneName) return &zones[i];
+    }
+    for(uint32_t i = 0; i < PROFILE_MAX_ZONES; i++) { // the same text from another translation unit
+        if(zones[i].name != 0 && strcmp(zones[i].name, zoneName) == 0) return &zones[i];
+    }
+    return 0;
+}
+
+/*************** dumper *****************/
+
+ProfileDumper::ProfileDumper(int64_t period_, int32_t priority) :
+    StaticThread<>("ProfileDumper", priority), period(period_), lastDumpTime(0), lastDumpCycles(0), cyclesPerSecond(0) {
+    lastReportMsg.numOfZones = 0;
+}
+
+uint32_t ProfileDumper::dump() {
+    int64_t        timeNow   = NOW();
+    ProfileCounter cyclesNow = profileCycles();
+    if(lastDumpTime > 0 && timeNow - lastDumpTime >= 10 * MILLISECONDS) {
+        ProfileCounter cycles = cyclesNow - lastDumpCycles;
+        cyclesPerSecond       = static_cast<uint64_t>(static_cast<double>(cycles) * SECONDS / static_cast<double>(timeNow - lastDumpTime));
+    }
+    lastDumpTime   = timeNow;
+    lastDumpCycles = cyclesNow;
+
+    uint32_t       numOfReports = 0;
+    ProfileReport& msg          = lastReportMsg;
+    ITERATE_LIST(ProfileTable, ProfileTable::profileTableList) {
+        msg.time            = timeNow;
+        msg.cyclesPerSecond = cyclesPerSecond;
+        msg.threadId        = iter->thread ? static_cast<uint32_t>(iter->thread->listElementID) : 0;
+        msg.droppedZones    = static_cast<uint16_t>(RODOS::min(iter->droppedZones.load(), 0xffffu));
+        uint32_t numOfZones = 0;
+        for(uint32_t i = 0; i < PROFILE_MAX_ZONES; i++) {
+            const ProfileZoneStats& zone = iter->zones[i];
+            if(zone.name == 0) continue;
+            ProfileEntry& entry = msg.zones[numOfZones++];
+            entry.totalCycles   = zone.totalCycles;
+            entry.count         = zone.count;
+            entry.minCycles     = zone.minCycles;
+            entry.maxCycles     = zone.maxCycles;
+            for(uint32_t j = 0; j < ProfileZoneStats::HISTOGRAM_BUCKETS; j++) entry.histogram[j] = zone.histogram[j];
+            strncpy(entry.name, zone.name, sizeof(entry.name) - 1);
+            entry.name[sizeof(entry.name) - 1] = 0;
+        }
+        msg.numOfZones = static_cast<uint16_t>(numOfZones);
+        profileTopic.publishMsgPart(msg, ProfileReport::lenForZones(numOfZones));
+        numOfReports++;
+    }
+    return numOfReports;
+}
+
+void ProfileDumper::run() {
+    lastDumpTime   = NOW();
+    lastDumpCycles = profileCycles();
+    TIME_LOOP(lastDumpTime + period, period) { dump(); }
+}
+
+} // namespace RODOS
@@ -0,0 +1,61 @@
+/**
+ * @file stack-watermark.cpp
+ * @date 2026/10/18
+ *
+ * @brief incremental search of the deepest stack usage, see stack-watermark.h
+ *
+ */
+
+#include "stack-watermark.h"
+
+namespace RODOS {
+
+void StackWatermark::paint(void* begin_, void* end_) {
+    uint32_t* word = static_cast<uint32_t*>(begin_);
+    uint32_t* last = static_cast<uint32_t*>(end_);
+    while(word + 4 <= last) { // 4 words in each step, the compiler may use wider stores
+        word[0] = EMPTY_MEMORY_MARKER;
+        word[1] = EMPTY_MEMORY_MARKER;
+        word[2] = EMPTY_MEMORY_MARKER;
+        word[3] = EMPTY_MEMORY_MARKER;
+        word += 4;
+    }
+    while(word < last) *word++ = EMPTY_MEMORY_MARKER;
+}
+
+void StackWatermark::init(const void* begin_, const void* end_) {
+    begin     = static_cast<const uint32_t*>(begin_);
+    end       = static_cast<const uint32_t*>(end_);
+    watermark = end;
+    scanPos   = begin;
+    rounds    = 0;
+}
+
+bool StackWatermark::scanSlice(uint32_t maxWords) {
+    if(begin == 0) return false;
+    const volatile uint32_t* word = scanPos; // the owner thread writes its stack meanwhile
+    const uint32_t* limit         = (static_cast<size_t>(watermark - scanPos) > maxWords) ? scanPos + maxWords : watermark;
+    while(word < limit && *word == EMPTY_MEMORY_MARKER) word++;
+
+    if(word < limit) { // used: the new watermark, all below were markers
+        watermark = const_cast<const uint32_t*>(word);
+    } else if(limit < watermark) { // not yet at the watermark
+        scanPos = limit;
+        return false;
+    }
+    scanPos = begin;
+    rounds++;
+    return true;
+}
+
+size_t StackWatermark::getUsage() const {
+    if(rounds == 0) return 0;
+    return static_cast<size_t>(end - watermark) * sizeof(uint32_t);
+}
+
+size_t StackWatermark::recommendedSize(size_t usage) {
+    size_t size = usage + usage / 4 + STACK_MARGIN;
+    return (size + 63) & ~static_cast<size_t>(63);
+}
+
+} // namespace RODOS
@@ -11,7 +11,9 @@
 // List Subscriber::subscriberList = 0;
 
 
+#include "latency-histogram.h"
 #include "listelement.h"
+#include "misc-rodos-funcs.h"
 #include "putter.h"
 #include "subscriber.h"
 
@@ -39,11 +41,112 @@ Subscriber::Subscriber(TopicInterface& topic, const char* name) :
 //	return (isEnabled && (topicId == topicInterface.topicId));
 //}
 
-void Subscriber::enable(bool onOff) { isEnabled = onOff; }
+uint32_t Subscriber::contentFiltersGeneration = 0;
+
+void Subscriber::enable(bool onOff) {
+    bool changed = (isEnabled != onOff);
+    isEnabled = onOff;
+    if(changed) contentFiltersGeneration++;
+    if(changed && !isAGateway && isSchedulerRunning()) { // eg. for the distributed-topic-register
+        TopicInterface* topic = &topicInterface;
+        subscriptionChanged.publish(topic);
+    }
+}
 
 bool Subscriber::isGateway() const { return isAGateway; }
 
 
+/*************** delivery policies *****************/
+
+/** Guards the policy state. The setters run also in constructors, before the scheduler: nothing to guard then */
+class PolicyScope {
+    Semaphore& protector;
+    bool       locked;
+  public:
+    PolicyScope(Semaphore& protector_) : protector(protector_), locked(isSchedulerRunning()) {
+        if(locked) protector.enter();
+    }
+    ~PolicyScope() {
+        if(locked) protector.leave();
+    }
+};
+
+void Subscriber::setDecimation(uint32_t n) {
+    PolicyScope scope(protector);
+    decimation        = (n == 0) ? 1 : n;
+    msgsSinceDelivery = decimation - 1; // the first one is delivered
+    updateDeliveryPolicy();
+}
+
+void Subscriber::setThrottle(int64_t interval, Putter* latestValue_) {
+    PolicyScope scope(protector);
+    minInterval  = interval;
+    lastDelivery = -interval; // the first one is delivered
+    latestValue  = latestValue_;
+    updateDeliveryPolicy();
+}
+
+void Subscriber::setChangeOnly(bool onOff) {
+    PolicyScope scope(protector);
+    if(onOff && lastDelivered == 0) lastDelivered = static_cast<uint8_t*>(xmalloc(topicInterface.msgLen));
+    changeOnly       = onOff;
+    lastDeliveredLen = 0;
+    deliveredOnce    = false;
+    updateDeliveryPolicy();
+}
+
+void Subscriber::setContentFilter(const ContentFilter* filter) {
+    PolicyScope scope(protector);
+    contentFilter = filter;
+    contentFiltersGeneration++;
+    updateDeliveryPolicy();
+}
+
+void Subscriber::setLatencyHistogram(LatencyHistogram* histogram) {
+    if(histogram && histogram->topicId == 0) histogram->topicId = topicInterface.topicId;
+    latencyHistogram = histogram;
+}
+
+void Subscriber::updateDeliveryPolicy() {
+    hasDeliveryPolicy = changeOnly || decimation > 1 || minInterval > 0 || latestValue != 0 || contentFilter != 0;
+}
+
+bool Subscriber::applyDeliveryPolicy(const uint32_t topicId, const size_t len, const void* data, const NetMsgInfo& netMsgInfo) {
+    PolicyScope scope(protector); // several publishers may publish at the same time
+    if(contentFilter && !contentFilter->matches(data, len)) {
+        filteredMsgs++;
+        return false;
+    }
+    if(latestValue) latestValue->putGeneric(topicId, len, data, netMsgInfo); // every one, the reader takes the latest
+
+    // without a copy (xmalloc failed, or longer than the topic) it counts as changed
+    bool comparable = changeOnly && lastDelivered != 0 && len <= topicInterface.msgLen;
+    if(comparable && deliveredOnce && len == lastDeliveredLen && memcmp(data, lastDelivered, len) == 0) {
+        skippedMsgs++;
+        return false;
+    }
+    if(++msgsSinceDelivery < decimation) {
+        skippedMsgs++;
+        return false;
+    }
+    if(minInterval > 0) {
+        int64_t now = NOW();
+        if(now - lastDelivery < minInterval) {
+            skippedMsgs++;
+            return false;
+        }
+        lastDelivery = now;
+    }
+    msgsSinceDelivery = 0;
+    if(comparable) {
+        memcpy(lastDelivered, data, len);
+        lastDeliveredLen = len;
+        deliveredOnce    = true;
+    }
+    return true;
+}
+
+
 /**
  * Forward the message to the Subscriber owning receiver: a putter
  */
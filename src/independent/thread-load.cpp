@@ -0,0 +1,76 @@
+/**
+ * @file thread-load.cpp
+ * @date 2026/10/18
+ *
+ * @brief periodic report of the CPU time of each thread, see thread-load.h
+ *
+ */
+
+#include "rodos.h"
+#include "thread-load.h"
+
+namespace RODOS {
+
+Topic<ThreadLoadReport> threadLoadTopic(TOPIC_ID_THREAD_LOAD_REPORT, "threadLoad");
+
+static uint16_t saturated16(uint32_t value) { return static_cast<uint16_t>((value > 0xffff) ? 0xffff : value); }
+
+ThreadLoadMonitor::ThreadLoadMonitor(int64_t period_, int32_t priority) :
+    StaticThread<>("ThreadLoadMonitor", priority), period(period_), lastReport(0) {
+    lastReportMsg.numOfThreads = 0;
+}
+
+void ThreadLoadMonitor::report() {
+    int64_t timeNow  = NOW();
+    int64_t interval = timeNow - lastReport;
+    lastReport       = timeNow;
+    if(interval <= 0) interval = 1;
+
+    ThreadLoadReport& msg = lastReportMsg;
+    msg.time              = timeNow;
+    msg.period            = interval;
+    msg.reserved          = 0;
+    uint32_t numOfThreads = 0;
+    int64_t  busyTime     = 0;
+
+    ITERATE_LIST(Thread, Thread::threadList) {
+        int64_t cpuTime  = iter->getCpuTime();
+        int64_t usedTime = cpuTime - iter->reportedCpuTime;
+        iter->reportedCpuTime = cpuTime;
+        if(iter->getPriority() > 0) busyTime += usedTime;
+        if(numOfThreads >= THREAD_LOAD_REPORT_MAX_THREADS) continue;
+
+        ThreadLoadEntry& entry = msg.threads[numOfThreads++];
+        entry.threadId         = static_cast<uint16_t>(iter->listElementID);
+        entry.loadPermille     = saturated16(static_cast<uint32_t>(usedTime * 1000 / interval));
+        entry.maxActivationUs  = static_cast<uint32_t>(iter->maxActivationTime / MICROSECONDS);
+        entry.activations      = iter->activations;
+        entry.deadlineOverruns = saturated16(iter->deadlineOverruns);
+        entry.missedBeats      = saturated16(iter->missedBeats);
+    }
+    msg.numOfThreads    = static_cast<uint16_t>(numOfThreads);
+    msg.cpuLoadPermille = saturated16(static_cast<uint32_t>(busyTime * 1000 / interval));
+
+    threadLoadTopic.publishMsgPart(msg, ThreadLoadReport::lenForThreads(numOfThreads));
+}
+
+void ThreadLoadMonitor::print() {
+    PRINTF("CPU load %d.%d%%, threads: load %%, max activation us, activations, deadline overruns, missed beats\n",
+           lastReportMsg.cpuLoadPermille / 10, lastReportMsg.cpuLoadPermille % 10);
+    for(uint32_t i = 0; i < lastReportMsg.numOfThreads; i++) {
+        ThreadLoadEntry& entry = lastReportMsg.threads[i];
+        const char*      name  = "?";
+        ITERATE_LIST(Thread, Thread::threadList) {
+            if(iter->listElementID == entry.threadId) name = iter->getName();
+        }
+        PRINTF("  %s: %d.%d, %d, %d, %d, %d\n", name, entry.loadPermille / 10, entry.loadPermille % 10, static_cast<int>(entry.maxActivationUs),
+               static_cast<int>(entry.activations), entry.deadlineOverruns, entry.missedBeats);
+    }
+}
+
+void ThreadLoadMonitor::run() {
+    lastReport = NOW();
+    TIME_LOOP(lastReport + period, period) { report(); }
+}
+
+} // namespace RODOS
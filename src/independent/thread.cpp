@@ -19,9 +19,12 @@ namespace RODOS {
 /********************************************/
 
 void Thread::setPeriodicBeat(const int64_t begin,
-                             const int64_t period) {
+                             const int64_t period,
+                             const int64_t deadline) {
     nextBeat = begin;
     this->period = period;
+    this->deadline = deadline;
+    releaseTime = END_OF_TIME;
 }
 
 void Thread::suspendUntilNextBeat() {
@@ -30,9 +33,49 @@ void Thread::suspendUntilNextBeat() {
         suspendCallerUntil(); // WRONG! Period shall not be 0 for beats
     }
 
-    suspendCallerUntil(nextBeat);
+    if(releaseTime != END_OF_TIME) { // the activation of the beat releaseTime ends
+        int64_t relativeDeadline = (deadline > 0) ? deadline : period;
+        if(NOW() > releaseTime + relativeDeadline) deadlineOverruns++;
+    }
+
+    int64_t beat = nextBeat;
+    suspendCallerUntil(beat);
     int64_t timeNow = NOW();
-    nextBeat = TimeModel::computeNextBeat(nextBeat, period, timeNow);
+    nextBeat = TimeModel::computeNextBeat(beat, period, timeNow);
+    if(nextBeat > beat) { // not resumed before the beat
+        releaseTime = beat;
+        missedBeats += static_cast<uint32_t>((nextBeat - beat) / period - 1);
+    } else {
+        releaseTime = END_OF_TIME;
+    }
+}
+
+void Thread::endActivation() {
+    int64_t activationTime = getCpuTime() - activationStart;
+    if(activationTime > maxActivationTime) maxActivationTime = activationTime;
+    activations++;
+}
+
+/*************** stack usage *****************/
+
+void Thread::scanStacks(uint32_t maxWords) {
+    static Thread* scanned = 0; // a round of its stack is not complete
+    if(scanned == 0) scanned = static_cast<Thread*>(threadList);
+    if(scanned == 0) return;
+    if(scanned->stackWatermark.scanSlice(maxWords)) scanned = static_cast<Thread*>(scanned->getNext());
+}
+
+void Thread::printStackReport() {
+    PRINTF("Stacks: size, deepest usage found, recommended size\n");
+    ITERATE_LIST(Thread, threadList) {
+        size_t usage = iter->getStackUsage();
+        if(usage == 0) {
+            PRINTF("  %s: %d, not measured\n", iter->getName(), static_cast<int>(iter->stackSize));
+        } else {
+            PRINTF("  %s: %d, %d, %d\n", iter->getName(), static_cast<int>(iter->stackSize), static_cast<int>(usage),
+                   static_cast<int>(StackWatermark::recommendedSize(usage)));
+        }
+    }
 }
 
 
@@ -42,7 +85,8 @@ void Thread::suspendUntilNextBeat() {
 int32_t Thread::setPrioCurrentRunner(int32_t newPrio) {
     Thread* runner = getCurrentThread();
     if(runner==0) {
-        errorLog.addRaw("null pointer setPrioCurrentRunner");
+        // after the start: a handler of the posix timer thread, it has no priority
+        if(!schedulerRunning) errorLog.addRaw("null pointer setPrioCurrentRunner");
         return 0;
     }
     int32_t previusPriority = runner->getPriority();
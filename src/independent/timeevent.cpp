@@ -15,6 +15,7 @@
 #include "listelement.h"
 #include "rodos-debug.h"
 #include "misc-rodos-funcs.h"
+#include "trace-ring.h"
 
 namespace RODOS {
 
@@ -31,12 +32,16 @@ TimeEvent::~TimeEvent() {
     RODOS_ERROR("Time EventHandler deleted");
 }
 
+/** ports which see new TimeEvents at the next scheduling point need nothing */
+__attribute__((weak)) void hwTimeEventActivated([[gnu::unused]] int64_t eventAt) {}
+
 /* Sets the time when the handler should be called
  * @param absolute time of next event
  */
 void TimeEvent::activateAt(const int64_t time) {
     eventAt.store(time);
     eventPeriod.store(0);
+    hwTimeEventActivated(time);
 }
 
 /* defines the time relative to now, when the handler should be called: DEPRECATED */
@@ -46,6 +51,7 @@ void TimeEvent::activateAt(const int64_t time) {
 void TimeEvent::activatePeriodic(const int64_t startAt, const int64_t period) {
     eventPeriod.store(period);
     eventAt.store(startAt);
+    hwTimeEventActivated(startAt);
 }
 
 
@@ -70,7 +76,10 @@ int32_t TimeEvent::propagate(const int64_t timeNow) {
                     iter->eventAt.store(nextBeat);
                 }
             }
-            iter->handle();
+            {
+                RODOS_TRACE_IN_SCOPE(TIME_EVENT_BEGIN, traceId(iter), 0);
+                iter->handle();
+            }
             cnt++;
         }
     }
@@ -9,8 +9,11 @@
  */
 
 #include "application.h"
+#include "latency-histogram.h"
 #include "listelement.h"
 #include "misc-rodos-funcs.h"
+#include "profile-zone.h"
+#include "trace-ring.h"
 #include "reserved_application_ids.h"
 #include "reserved_topic_ids.h"
 #include "rodos-debug.h"
@@ -26,12 +29,15 @@ namespace RODOS {
 
 static Application applicationName("Topics & Middleware", APID_MIDDLEWARE);
 
-TopicInterface::TopicInterface(int64_t id, size_t len, const char* name, bool _onlyLocal) : ListElement(topicList, name)  {
+TopicInterface::TopicInterface(int64_t id, size_t len, const char* name, bool _onlyLocal, TransmitPriority _transmitPriority) : ListElement(topicList, name)  {
     mySubscribers = 0;
     msgLen        = len;
     onlyLocal     = _onlyLocal;
+    transmitPriority = _transmitPriority;
     topicFilter   = 0;
     receiverNodesBitMap = 0; // see receiverNode+receiverNodesBitMap.txt
+    interestAnnounced   = false;
+    latencyHistogram    = 0;
     if(id == -1) {
         topicId = hash(name) ;
         if(topicId < FIRST_USER_TOPIC_ID) { // reserved topic ids
@@ -40,7 +46,10 @@ TopicInterface::TopicInterface(int64_t id, size_t len, const char* name, bool _o
     } else {
         topicId       = static_cast<uint32_t>(id & 0xFFFFFFFF);
     }
-    if(topicId < ALL_TOPICS_BELOW_THIS_ARE_BROADCAST) receiverNodesBitMap = ~0u;
+    if(topicId < ALL_TOPICS_BELOW_THIS_ARE_BROADCAST) {
+        receiverNodesBitMap = ~0u;
+        receiverNodes.setAll();
+    }
 
     /** Check for replications - except for udp async topic**/
     static const uint32_t udpAsyncTopicID = 22582; 
@@ -51,6 +60,13 @@ TopicInterface::TopicInterface(int64_t id, size_t len, const char* name, bool _o
 } 
 
 
+bool TopicInterface::hasEnabledSubscribers() const {
+    ITERATE_LIST(Subscriber, mySubscribers) {
+        if(iter->isEnabled) return true;
+    }
+    return false;
+}
+
 void TopicInterface::setTopicFilter(TopicFilter* filter) {
     if(topicFilter != 0) {
         RODOS_ERROR("More than one topicFilter for topic");
@@ -66,6 +82,27 @@ TopicInterface*  TopicInterface::findTopicId(uint32_t wantedTopicId) {
     return 0;
 }
 
+void TopicInterface::setLatencyHistogram(LatencyHistogram* histogram) {
+    if(histogram && histogram->topicId == 0) histogram->topicId = topicId;
+    latencyHistogram = histogram;
+}
+
+void TopicInterface::recordLatency(LatencyHistogram* subscriberHistogram, const NetMsgInfo& netMsgInfo) {
+    int64_t latency = deliveryLatency(netMsgInfo);
+    if(latencyHistogram)    latencyHistogram->add(latency);
+    if(subscriberHistogram) subscriberHistogram->add(latency);
+}
+
+void TopicInterface::addReceiverNode(uint32_t nodeIndex) {
+    receiverNodes.add(nodeIndex);
+    receiverNodesBitMap = receiverNodes.fold();
+}
+
+void TopicInterface::removeReceiverNode(uint32_t nodeIndex) {
+    receiverNodes.remove(nodeIndex);
+    receiverNodesBitMap = receiverNodes.fold(); // other nodes may have the same bit
+}
+
 // The value for receiverNode :  See receiverNode+receiverNodesBitMap.txt
 int32_t TopicInterface::receiverNodesBitMap2Index() {
 
@@ -73,6 +110,10 @@ int32_t TopicInterface::receiverNodesBitMap2Index() {
         receiverNodesBitMap = ~0u; // all bits -> all channels -> all nodes. Redundant with constructor! Shall be!
         return -1;
     }
+    if(receiverNodes.isExtended()) {
+        if(receiverNodes.count() != 1) return -1;
+        return receiverNodes.next(0);
+    }
     uint32_t bitmap = receiverNodesBitMap;
     int32_t  indexFound = -2; // -2 -> no receiver found
     for(int index = 0; bitmap != 0; index++) {
@@ -94,6 +135,8 @@ uint32_t TopicInterface::publish(void* data, bool shallSendToNetwork, NetMsgInfo
 }
 
 uint32_t TopicInterface::publishMsgPart(void* data, size_t lenToSend, bool shallSendToNetwork, NetMsgInfo* netMsgInfo) {
+    RODOS_TRACE_IN_SCOPE(PUBLISH_BEGIN, topicId, static_cast<uint32_t>(lenToSend));
+    RODOS_PROFILE_MIDDLEWARE_SCOPE("publish");
     uint32_t cnt = 0; // number of receivers a message is sent to
     NetMsgInfo localmsgInfo;
 
@@ -110,7 +153,10 @@ uint32_t TopicInterface::publishMsgPart(void* data, size_t lenToSend, bool shall
 
     /** Distribute to all (and only) my subscribers **/
     ITERATE_LIST(Subscriber, mySubscribers) {
-        if(iter->isEnabled) cnt += iter->put(topicId, lenToSend, data, *netMsgInfo);
+        if(!iter->isEnabled || !iter->acceptsMsg(topicId, lenToSend, data, *netMsgInfo)) continue;
+        if(latencyHistogram || iter->latencyHistogram) recordLatency(iter->latencyHistogram, *netMsgInfo);
+        RODOS_PROFILE_MIDDLEWARE_SCOPE("subscriber put");
+        cnt += iter->put(topicId, lenToSend, data, *netMsgInfo);
     }
 
    if(topicFilter != 0)  {
@@ -123,6 +169,11 @@ uint32_t TopicInterface::publishMsgPart(void* data, size_t lenToSend, bool shall
     //______________________________________________ Now distribute message to all gateways
     netMsgInfo->receiverNode        = receiverNodesBitMap2Index(); // first this due to side-effect
     netMsgInfo->receiverNodesBitMap = this->receiverNodesBitMap;
+    // with more than 32 node indexes the bitmap is ambiguous, even for nodes 0..31
+    bool exactReceivers             = NODE_SET_WORDS > 1 && topicId >= ALL_TOPICS_BELOW_THIS_ARE_BROADCAST && !receiverNodes.isEmpty();
+    netMsgInfo->receiverNodes       = exactReceivers ? &receiverNodes : 0;
+    netMsgInfo->transmitPriority    = transmitPriority;
+    if(netMsgInfo->sequenceNr == 0) netMsgInfo->sequenceNr = getNextMsgSequenceNr(numberOfFragments(lenToSend)); // same nr for all gateways
     
     ITERATE_LIST(Subscriber, defaultGatewayTopic.mySubscribers) {
         cnt += iter->put(topicId, lenToSend, data, *netMsgInfo);
@@ -146,6 +197,7 @@ Topic<void*> interruptTimer(-1,   "TimerInterrupt",  true); // all these are onl
 Topic<void*> interruptUart(-1,    "UartInterrupt",   true);
 Topic<void*> interruptSigterm(-1, "SigTermInterrupt",true);
 Topic<GenericMsgRef> charInput(-1, "CharInput",      true);
+Topic<TopicInterface*> subscriptionChanged(-1, "SubscriptionChanged", true);
 
 }
 
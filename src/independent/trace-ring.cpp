@@ -0,0 +1,209 @@
+/**
+ * @file trace-ring.cpp
+ * @date 2026/10/18
+ *
+ * @brief binary trace of the kernel, see trace-ring.h
+ *
+ */
+
+#include "rodos.h"
+#include "trace-ring.h"
+
+namespace RODOS {
+
+TraceRing traceRing;
+
+void TraceRing::start(TraceEvent* buffer, uint32_t numOfEvents) {
+    if(numOfEvents == 0 || (numOfEvents & (numOfEvents - 1)) != 0) {
+        RODOS_ERROR("TraceRing: number of events not a power of 2");
+        return;
+    }
+    recording = false;
+    events    = buffer;
+    mask      = numOfEvents - 1;
+    lapShift  = 0;
+    while((1u << lapShift) < numOfEvents) lapShift++;
+    for(uint32_t i = 0; i < numOfEvents; i++) events[i].lap = 0; // laps start with 1
+    writeIndex = 0;
+    recording  = true;
+}
+
+void TraceRing::recordRaw(TraceEventType type, uint32_t object, uint32_t arg) {
+    uint32_t    index  = writeIndex++; // the slot is ours, also against interrupts and other cores
+    TraceEvent& event  = events[index & mask];
+    Thread*     thread = traceCurrentThread();
+    event.lap          = 0;
+    event.time         = NOW();
+    event.thread       = (thread == 0) ? 0 : traceId(thread);
+    event.object       = object;
+    event.arg          = arg;
+    event.type         = static_cast<uint8_t>(type);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    event.lap = static_cast<uint8_t>((index >> lapShift) + 1);
+}
+
+uint32_t TraceRing::numOfOverwritten() const {
+    uint32_t recorded = writeIndex.load();
+    return (events == 0 || recorded <= mask) ? 0 : recorded - mask - 1;
+}
+
+uint32_t TraceRing::copyEvents(TraceEvent* to, uint32_t maxEvents) const {
+    if(events == 0) return 0;
+    uint32_t end   = writeIndex.load();
+    uint32_t begin = (end > mask + 1) ? end - mask - 1 : 0;
+    if(end - begin > maxEvents) begin = end - maxEvents;
+
+    uint32_t copied = 0;
+    for(uint32_t index = begin; index != end; index++) {
+        const TraceEvent& event = events[index & mask];
+        uint8_t           lap   = static_cast<uint8_t>((index >> lapShift) + 1);
+        if(event.lap != lap) continue;
+        to[copied] = event;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if(event.lap != lap) continue; // overwritten while copying
+        copied++;
+    }
+    return copied;
+}
+
+/*************** dump *****************/
+
+class TraceDumpSink {
+  public:
+    virtual ~TraceDumpSink() = default;
+    virtual void put(const uint8_t* data, size_t len) = 0;
+};
+
+class TraceBufferSink : public TraceDumpSink {
+  public:
+    uint8_t* buffer;
+    size_t   len = 0;
+    TraceBufferSink(void* buffer_) : buffer(static_cast<uint8_t*>(buffer_)) {}
+    void put(const uint8_t* data, size_t dataLen) override {
+        memcpy(buffer + len, data, dataLen);
+        len += dataLen;
+    }
+};
+
+class TraceHexSink : public TraceDumpSink {
+    static constexpr size_t BYTES_PER_LINE = 32;
+    char                    line[BYTES_PER_LINE * 2 + 1];
+    size_t                  lineLen = 0;
+
+  public:
+    void put(const uint8_t* data, size_t len) override {
+        static const char hex[] = "0123456789abcdef";
+        for(size_t i = 0; i < len; i++) {
+            line[lineLen++] = hex[data[i] >> 4];
+            line[lineLen++] = hex[data[i] & 0x0f];
+            if(lineLen == BYTES_PER_LINE * 2) flush();
+        }
+    }
+    void flush() {
+        if(lineLen == 0) return;
+        line[lineLen] = 0;
+        PRINTF("TRACE %s\n", line);
+        lineLen = 0;
+    }
+};
+
+static void putName(TraceDumpSink& sink, TraceNameKind kind, uint32_t id, const char* name) {
+    uint8_t record[6];
+    size_t  len = strlen(name);
+    if(len > 255) len = 255;
+    record[0] = static_cast<uint8_t>(kind);
+    record[1] = static_cast<uint8_t>(len);
+    uint32_tToBigEndian(&record[2], id);
+    sink.put(record, sizeof(record));
+    sink.put(reinterpret_cast<const uint8_t*>(name), len);
+}
+
+/// the names in the dump, counts them if sink is 0
+size_t TraceRing::putNames(TraceDumpSink* sink, uint32_t& numOfNames) {
+    size_t len = 0;
+    numOfNames = 0;
+    auto name  = [&](TraceNameKind kind, uint32_t id, const char* text) {
+        size_t textLen = strlen(text);
+        len += 6 + ((textLen > 255) ? 255 : textLen);
+        numOfNames++;
+        if(sink != 0) putName(*sink, kind, id, text);
+    };
+    ITERATE_LIST(Thread, Thread::threadList) { name(TraceNameKind::THREAD, traceId(iter), iter->getName()); }
+    ITERATE_LIST(TopicInterface, TopicInterface::topicList) { name(TraceNameKind::TOPIC, iter->topicId, iter->getName()); }
+#ifndef DISABLE_TIMEEVENTS
+    ITERATE_LIST(TimeEvent, TimeEvent::timeEventList) { name(TraceNameKind::TIME_EVENT, traceId(iter), iter->getName()); }
+#endif
+    return len;
+}
+
+void TraceRing::writeDump(TraceDumpSink& sink, uint32_t maxEvents) const {
+    static constexpr uint32_t CHUNK = 32; // events copied at once, consistent among themselves
+    TraceEvent                chunk[CHUNK];
+
+    uint32_t numOfNames;
+    putNames(0, numOfNames);
+    uint32_t end   = writeIndex.load();
+    uint32_t begin = (events == 0) ? end : (end > mask + 1) ? end - mask - 1 : 0;
+    if(end - begin > maxEvents) begin = end - maxEvents;
+
+    // counted for the header. Some may be overwritten until they are written
+    uint32_t numOfEvents = 0;
+    for(uint32_t index = begin; index != end; index++) {
+        uint8_t lap = static_cast<uint8_t>((index >> lapShift) + 1);
+        if(events[index & mask].lap == lap) numOfEvents++;
+    }
+
+    uint8_t header[TRACE_DUMP_HEADER_SIZE];
+    memcpy(header, "RTRC", 4);
+    uint16_tToBigEndian(&header[4], TRACE_DUMP_VERSION);
+    uint16_tToBigEndian(&header[6], 0);
+    uint32_tToBigEndian(&header[8], numOfNames);
+    uint32_tToBigEndian(&header[12], numOfEvents);
+    uint32_tToBigEndian(&header[16], (end > mask + 1) ? end - mask - 1 : 0);
+    sink.put(header, sizeof(header));
+    putNames(&sink, numOfNames);
+
+    uint32_t written = 0;
+    uint32_t index   = begin;
+    while(index != end && written < numOfEvents) {
+        uint32_t count = 0;
+        for(; count < CHUNK && index != end; index++) {
+            const TraceEvent& event = events[index & mask];
+            uint8_t           lap   = static_cast<uint8_t>((index >> lapShift) + 1);
+            if(event.lap != lap) continue;
+            chunk[count] = event;
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if(event.lap == lap) count++;
+        }
+        for(uint32_t i = 0; i < count && written < numOfEvents; i++, written++) {
+            uint8_t record[TRACE_DUMP_EVENT_SIZE];
+            int64_tToBigEndian(&record[0], chunk[i].time);
+            uint32_tToBigEndian(&record[8], chunk[i].thread);
+            uint32_tToBigEndian(&record[12], chunk[i].object);
+            uint32_tToBigEndian(&record[16], chunk[i].arg);
+            record[20] = chunk[i].type;
+            sink.put(record, sizeof(record));
+        }
+    }
+
+    uint8_t nothing[TRACE_DUMP_EVENT_SIZE] = {}; // type 0: overwritten in between, the number in the header stays right
+    for(; written < numOfEvents; written++) sink.put(nothing, sizeof(nothing));
+}
+
+size_t TraceRing::dump(void* buffer, size_t maxLen) const {
+    uint32_t numOfNames;
+    size_t   namesLen = putNames(0, numOfNames);
+    if(maxLen < TRACE_DUMP_HEADER_SIZE + namesLen) return 0;
+    size_t          fit = (maxLen - TRACE_DUMP_HEADER_SIZE - namesLen) / TRACE_DUMP_EVENT_SIZE;
+    TraceBufferSink sink(buffer);
+    writeDump(sink, (fit > 0xffffffff) ? 0xffffffff : static_cast<uint32_t>(fit));
+    return sink.len;
+}
+
+void TraceRing::printDump() const {
+    TraceHexSink sink;
+    writeDump(sink, 0xffffffff);
+    sink.flush();
+}
+
+} // namespace RODOS
@@ -17,6 +17,7 @@
 #include <signal.h>
 #include <unistd.h>
 #include <time.h>
+#include <errno.h>
 
 extern "C" void abort();
 
@@ -53,6 +54,16 @@ void hwResetAndReboot() {
 
 // cpu core and periferis off until extern interrupt or time "until"
 void deepSleepUntil(int64_t until) {
+#ifdef POSIX_MONOTONIC_TIMER
+    int64_t  wakeup = hwGetAbsoluteNanoseconds() + (until - NOW());
+    timespec wakeupPosix;
+    wakeupPosix.tv_sec  = static_cast<time_t>(wakeup / SECONDS);
+    wakeupPosix.tv_nsec = static_cast<long>(wakeup % SECONDS);
+
+    hwDisableInterrupts();
+    while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeupPosix, 0) == EINTR) {}
+    hwEnableInterrupts();
+#else
     int64_t  deltaT = until - NOW();
     timespec deltaTPosix;
     timespec remainingTime;
@@ -62,6 +73,16 @@ void deepSleepUntil(int64_t until) {
     hwDisableInterrupts();
     nanosleep(&deltaTPosix, &remainingTime);
     hwEnableInterrupts();
+#endif
+}
+
+/** the unix time of 1.1.2000 0:00 UTC */
+static constexpr int64_t UNIX_TIME_2000 = 946684800LL * SECONDS;
+
+int64_t hwGetUTC() {
+    struct timespec tp;
+    clock_gettime(CLOCK_REALTIME, &tp);
+    return tp.tv_sec * SECONDS + tp.tv_nsec - UNIX_TIME_2000;
 }
 
 
@@ -16,6 +16,15 @@
 
 #include <stdint.h>
 
+/**
+ * Linux: NOW() on CLOCK_MONOTONIC, TimeEvents from a timer thread waiting on
+ * a timerfd (absolute times). Else, or compiled with POSIX_SIGNAL_TIMER:
+ * NOW() on CLOCK_REALTIME and a setitimer/SIGALRM interval timer.
+ */
+#if defined(__linux__) && !defined(POSIX_SIGNAL_TIMER)
+#define POSIX_MONOTONIC_TIMER
+#endif
+
 namespace RODOS {
 
 /***********************************/
@@ -25,6 +34,7 @@ void hwInit(); ///< initilisation of all hw interfaces, fpgas, devices, etc.
 /** get time, time unit is nanoseconds, time 0 = startup */
 int64_t hwGetNanoseconds();
 int64_t hwGetAbsoluteNanoseconds(); ///< from host, eg for random generators
+int64_t hwGetUTC();                 ///< wall clock of the host (CLOCK_REALTIME), ns since 1.1.2000, eg sysTime.setUTC(hwGetUTC())
 void    hwInitTime();               ///< Initialize the time (eg. time 0)
 
 void hwResetAndReboot(); ///<  End of Programm,
@@ -89,6 +99,12 @@ class Timer {
   *  Get timer interval.
   */
     static int64_t getInterval() { return microsecondsInterval; }
+
+    /**
+  *  Called at the scheduling points (suspend, yield): a TimeEvent activated
+  *  before the planned wakeup of the timer wakes it earlier.
+  */
+    static void updateTriggerToNextTimingEvent();
 };
 
 
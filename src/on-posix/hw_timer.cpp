@@ -9,16 +9,26 @@
 * @brief fixed interval timer
 *
 * class for fixed-interval timer  for Linux as guest os
-* uses the virtual timer (counts only when process is executed)
+* Linux: a timer thread on a timerfd (POSIX_MONOTONIC_TIMER, see hw_specific.h),
+* else the real time interval timer (setitimer, SIGALRM)
 */
 
 // #include <stdio.h>
 // #include <stdlib.h>
 
 #include <signal.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/timerfd.h>
+#endif
 
 #include "hw_specific.h"
 #include "rodos.h"
+#include "core-partition.h"
 #include <sys/time.h>
 
 
@@ -51,6 +61,131 @@ void timerSignalHandler([[gnu::unused]] int ignore) {
 
 }
 
+#ifdef POSIX_MONOTONIC_TIMER
+
+/**
+* The timer thread replaces the SIGALRM of setitimer: it waits on a timerfd
+* (CLOCK_MONOTONIC, absolute) for the next interval or the next TimeEvent,
+* whichever comes first, and calls the handler like the signals in
+* signalprocessLoop (scheduler.cpp): with signal_mutex, so
+* hwDisableInterrupts() holds it off. No signal interrupts system calls.
+* A TimeEvent activated before the planned wakeup re-arms the timerfd at once
+* (hwTimeEventActivated), the suspends and yields check again.
+*/
+extern pthread_mutex_t signal_mutex;
+extern int64_t         timeAtStartup;
+
+static pthread_t       timerThread;
+static int             timerFd = -1;
+static pthread_mutex_t timerFdMutex = PTHREAD_MUTEX_INITIALIZER;
+static Atomic<int64_t> plannedWakeup{ END_OF_TIME }; ///< local time (NOW()) the timerfd expires
+static Atomic<bool>    timerRunning{ false };
+
+/** with timerFdMutex */
+static void armTimer(const int64_t wakeup) {
+    int64_t    hostWakeup = wakeup + timeAtStartup; // CLOCK_MONOTONIC
+    itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.it_value.tv_sec  = static_cast<time_t>(hostWakeup / SECONDS);
+    spec.it_value.tv_nsec = static_cast<long>(hostWakeup % SECONDS);
+    if(spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) spec.it_value.tv_nsec = 1; // 0 would disarm
+    plannedWakeup = wakeup;
+    timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &spec, 0);
+}
+
+static void* timerThreadLoop(void*) {
+    int64_t interval = Timer::getInterval() * MICROSECONDS;
+    int64_t nextTick = (interval > 0) ? NOW() + interval : END_OF_TIME; // interval 0: only the TimeEvents
+    while(1) {
+        pthread_mutex_lock(&timerFdMutex);
+        int64_t wakeup = nextTick;
+#ifndef DISABLE_TIMEEVENTS
+        int64_t nextEvent = TimeEvent::getNextTriggerTime();
+        if(nextEvent < wakeup) wakeup = nextEvent;
+#endif
+        armTimer(wakeup);
+        pthread_mutex_unlock(&timerFdMutex);
+
+        uint64_t expirations;
+        if(read(timerFd, &expirations, sizeof(expirations)) < 0) continue; // EINTR
+
+        if(timerRunning) {
+            pthread_mutex_lock(&signal_mutex);
+            RODOS_TRACE(INTERRUPT_BEGIN, SIGALRM, 0);
+            timerSignalHandler(SIGALRM);
+            RODOS_TRACE(INTERRUPT_END, SIGALRM, 0);
+            pthread_mutex_unlock(&signal_mutex);
+        }
+        int64_t timeNow = NOW();
+        while(interval > 0 && nextTick <= timeNow) nextTick += interval;
+    }
+    return 0;
+}
+
+/**
+* initialize the timer
+*/
+void Timer::init() { }
+
+/**
+* start timer: the timer thread, with the highest SCHED_FIFO priority if permitted
+*/
+void Timer::start() {
+    timerRunning = true;
+    if(timerFd >= 0) return;
+
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    RODOS_ASSERT(timerFd >= 0); // error during timerfd_create
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    if(CorePartition::useFifoScheduling()) {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = sched_get_priority_max(SCHED_FIFO);
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        pthread_attr_setschedparam(&attr, &param);
+    }
+    int retval = pthread_create(&timerThread, &attr, timerThreadLoop, 0);
+    if(retval != 0) { // SCHED_FIFO not permitted
+        pthread_attr_init(&attr);
+        retval = pthread_create(&timerThread, &attr, timerThreadLoop, 0);
+    }
+    RODOS_ASSERT(retval == 0); // error during creation of the timer thread
+}
+
+/**
+* stop timer: the timer thread goes on waiting, without handler
+*/
+void Timer::stop() {
+    timerRunning = false;
+}
+
+/**
+* a TimeEvent before the planned wakeup of the timer thread: wake it earlier
+*/
+void Timer::updateTriggerToNextTimingEvent() {
+#ifndef DISABLE_TIMEEVENTS
+    if(timerFd < 0) return;
+    int64_t nextEvent = TimeEvent::getNextTriggerTime();
+    if(nextEvent >= plannedWakeup) return;
+    pthread_mutex_lock(&timerFdMutex);
+    if(nextEvent < plannedWakeup) armTimer(nextEvent);
+    pthread_mutex_unlock(&timerFdMutex);
+#endif
+}
+
+/**
+* a thread (or a handler) activated a TimeEvent: before the planned wakeup the timerfd is re-armed now,
+* the timer thread does not sleep until the next interval
+*/
+void hwTimeEventActivated(const int64_t eventAt) {
+    if(eventAt < plannedWakeup) Timer::updateTriggerToNextTimingEvent();
+}
+
+#else // POSIX_MONOTONIC_TIMER
+
 /**
 * initialize the timer and signal handler 
 */
@@ -87,6 +222,10 @@ void Timer::stop() {
     RODOS_ASSERT(retval == 0); // error during call to setitimer
 }
 
+void Timer::updateTriggerToNextTimingEvent() { } // the next interval
+
+#endif // POSIX_MONOTONIC_TIMER
+
 /**
 * set timer interval 
 */
@@ -0,0 +1,63 @@
+/**
+ * @file mapped-recorder-storage.cpp
+ * @date 2026/10/18
+ *
+ * @brief segments of a FlightRecorder in memory mapped files (posix)
+ *
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "rodos.h"
+#include "mapped-recorder-storage.h"
+
+namespace RODOS {
+
+MappedRecorderStorage::MappedRecorderStorage(const char* pathPrefix_, uint32_t numOfSegments_, size_t segmentSize_) {
+    pathPrefix = pathPrefix_;
+    segments   = (numOfSegments_ <= FLIGHT_RECORDER_MAX_SEGMENTS) ? numOfSegments_ : FLIGHT_RECORDER_MAX_SEGMENTS;
+    size       = segmentSize_ & ~static_cast<size_t>(7);
+    for(uint8_t*& memory : mapped) memory = 0;
+}
+
+MappedRecorderStorage::~MappedRecorderStorage() {
+    for(uint32_t i = 0; i < segments; i++) {
+        if(mapped[i] != 0) munmap(mapped[i], size);
+    }
+}
+
+uint8_t* MappedRecorderStorage::segment(uint32_t index) {
+    if(index >= segments) return 0;
+    if(mapped[index] != 0) return mapped[index];
+
+    char path[SPRINTF_MAX_SIZE];
+    SPRINTF(path, "%s-%02d.rec", pathPrefix, static_cast<int>(index));
+    int file = open(path, O_RDWR | O_CREAT, 0644);
+    if(file < 0) {
+        RODOS_ERROR("MappedRecorderStorage: can not open file");
+        return 0;
+    }
+    struct stat status;
+    if(fstat(file, &status) != 0 || (static_cast<size_t>(status.st_size) < size && ftruncate(file, static_cast<off_t>(size)) != 0)) {
+        close(file);
+        RODOS_ERROR("MappedRecorderStorage: can not resize file");
+        return 0;
+    }
+    void* memory = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    close(file); // the mapping stays
+    if(memory == MAP_FAILED) {
+        RODOS_ERROR("MappedRecorderStorage: can not map file");
+        return 0;
+    }
+    mapped[index] = static_cast<uint8_t*>(memory);
+    return mapped[index];
+}
+
+void MappedRecorderStorage::sync(uint32_t index) {
+    if(index < segments && mapped[index] != 0) msync(mapped[index], size, MS_ASYNC);
+}
+
+} // namespace RODOS
@@ -0,0 +1,38 @@
+/**
+ * @file mapped-recorder-storage.h
+ * @date 2026/10/18
+ *
+ * @brief segments of a FlightRecorder in memory mapped files (posix)
+ *
+ */
+
+#pragma once
+
+#include "flight-recorder.h"
+
+namespace RODOS {
+
+/**
+ * Each segment is a file <pathPrefix>-<nr>.rec of segmentSize bytes, mapped
+ * into memory (MAP_SHARED): the records are in the files even if the process
+ * crashes, and the next run finds them (see FlightRecorder).
+ * The files are created and mapped when the recorder uses them first.
+ */
+class MappedRecorderStorage : public RecorderStorage {
+  public:
+    MappedRecorderStorage(const char* pathPrefix, uint32_t numOfSegments, size_t segmentSize);
+    ~MappedRecorderStorage();
+
+    uint32_t numOfSegments() const override { return segments; }
+    size_t   segmentSize() const override { return size; }
+    uint8_t* segment(uint32_t index) override;
+    void     sync(uint32_t index) override;
+
+  private:
+    const char* pathPrefix;
+    uint32_t    segments;
+    size_t      size;
+    uint8_t*    mapped[FLIGHT_RECORDER_MAX_SEGMENTS];
+};
+
+} // namespace RODOS
@@ -23,6 +23,15 @@ namespace RODOS {
 pthread_mutex_t pthreadMutexInitialisation = PTHREAD_MUTEX_INITIALIZER;
 pthread_mutex_t globalAtomar = PTHREAD_MUTEX_INITIALIZER;
 
+/** owner for the handlers of the timer thread, for which getCurrentThread() is 0 */
+static char          handlerIdentity;
+static Thread* const HANDLER = reinterpret_cast<Thread*>(&handlerIdentity);
+
+static inline Thread* semaphoreCaller() {
+  Thread* caller = Thread::getCurrentThread();
+  return (caller != 0) ? caller : HANDLER;
+}
+
 /*****************************/
 
 
@@ -43,27 +52,32 @@ Semaphore::Semaphore() :
 * Owner may reenter withput deadlock
 */
 void Semaphore::enter() {
-  Thread* caller = Thread::getCurrentThread();
+  Thread* caller = semaphoreCaller();
   if(owner == caller) {
 	ownerEnterCnt = ownerEnterCnt + 1;
 	return;
   }
   pthread_mutex_t *mutexp = (pthread_mutex_t*)context.load();
-  pthread_mutex_lock(mutexp);
+  if(pthread_mutex_trylock(mutexp) != 0) {
+    RODOS_TRACE(SEMAPHORE_REQUEST, traceId(this), 0);
+    pthread_mutex_lock(mutexp);
+  }
   owner =  caller;
   ownerEnterCnt = 1;
+  RODOS_TRACE(SEMAPHORE_ENTER, traceId(this), 0);
 }
 
 /**
 *  caller does not block. resumes one waiting trhead (enter)
 */
 void Semaphore::leave() {
-  Thread* caller = Thread::getCurrentThread();
+  Thread* caller = semaphoreCaller();
   if (owner != caller) { // User Programm error: What to do? Nothing!
     return;
   }
   ownerEnterCnt = ownerEnterCnt - 1;
   if(ownerEnterCnt != 0) return;
+  RODOS_TRACE(SEMAPHORE_LEAVE, traceId(this), 0);
   owner = 0;
   pthread_mutex_t *mutexp = (pthread_mutex_t*)context.load();
   pthread_mutex_unlock(mutexp);
@@ -37,7 +37,9 @@ void signalprocessLoop() {
     sigset_t signalsToProcess;
     sigemptyset(&signalsToProcess);
     sigaddset(&signalsToProcess, SIGIO);
-    sigaddset(&signalsToProcess, SIGALRM);
+#ifndef POSIX_MONOTONIC_TIMER
+    sigaddset(&signalsToProcess, SIGALRM); // else from the timer thread, see hw_timer.cpp
+#endif
     sigaddset(&signalsToProcess, SIGUSR1);
 
 
@@ -46,6 +48,7 @@ void signalprocessLoop() {
             xprintf("sigwait failed, errno: %d\n", errno);
 
         pthread_mutex_lock(&signal_mutex);
+        RODOS_TRACE(INTERRUPT_BEGIN, static_cast<uint32_t>(signalnum), 0);
         switch(signalnum) {
             case SIGIO:
                 sigio_handler(signalnum);
@@ -60,6 +63,7 @@ void signalprocessLoop() {
                 xprintf("Warning: Got unknown signal: %d\n", signalnum);
                 break;
         }
+        RODOS_TRACE(INTERRUPT_END, static_cast<uint32_t>(signalnum), 0);
         pthread_mutex_unlock(&signal_mutex);
     }
 }
@@ -13,19 +13,29 @@
 #include "rodos.h"
 #include "scheduler.h"
 #include "hw_specific.h"
+#include "core-partition.h"
 
 #include <unistd.h>
 #include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
 #include <signal.h>
+#include <time.h>
 // #include <stdlib.h>
 namespace RODOS {
 
 pthread_mutex_t threadDataProtector = PTHREAD_MUTEX_INITIALIZER;
 
+/** Thread::currentThread is shared by all posix threads, getCurrentThread() searches */
+static thread_local Thread* posixCurrentThread = 0;
+
+Thread* traceCurrentThread() { return posixCurrentThread; }
+
 struct ThreadOnPosixContext{
 	pthread_t pt;
 	pthread_mutex_t mutex;
 	pthread_cond_t condition;
+	bool created; ///< pt is valid
 };
 
 /*********** dummy signal händler für all threads ***/
@@ -54,9 +64,17 @@ Thread::~Thread() {
 }
 
 void Thread::initializeStack() {
-    ThreadOnPosixContext* ctx =  new ThreadOnPosixContext;
+    ThreadOnPosixContext* ctx =  new ThreadOnPosixContext();
     pthread_mutex_init(&ctx->mutex,0);
+#ifdef POSIX_MONOTONIC_TIMER
+    pthread_condattr_t conditionAttr; // timeouts on the clock of NOW(), see checkSuspend()
+    pthread_condattr_init(&conditionAttr);
+    pthread_condattr_setclock(&conditionAttr, CLOCK_MONOTONIC);
+    pthread_cond_init(&ctx->condition, &conditionAttr);
+    pthread_condattr_destroy(&conditionAttr);
+#else
     pthread_cond_init(&ctx->condition,0);
+#endif
     context = (long*) ctx;
 }
 
@@ -73,6 +91,15 @@ void*           posixThreadEntryPoint(void *param) {
     return 0;
 }
 
+#ifdef __linux__
+static void cpuMaskToSet(uint64_t cpuMask, cpu_set_t& cpus) {
+    CPU_ZERO(&cpus);
+    for(size_t cpu = 0; cpu < 64; cpu++) {
+        if(cpuMask & (1ull << cpu)) CPU_SET(cpu, &cpus);
+    }
+}
+#endif
+
 /* called in main() after all constuctors, to create/init thread */
 void Thread::create() {
 
@@ -84,24 +111,47 @@ void Thread::create() {
     pthread_attr_setstacksize(&pthreadCreationAttr, stackSize);
     pthread_attr_setinheritsched(&pthreadCreationAttr, PTHREAD_EXPLICIT_SCHED);
 
+#ifdef __linux__
+    uint64_t cpuMask = CorePartition::effectiveMask(this);
+    if(cpuMask != 0) { // on its cores from the first instruction on
+        cpu_set_t cpus;
+        cpuMaskToSet(cpuMask, cpus);
+        pthread_attr_setaffinity_np(&pthreadCreationAttr, sizeof(cpus), &cpus);
+    }
+
+    if(pthread_create(&pt, &pthreadCreationAttr, posixThreadEntryPoint, this) != 0 && cpuMask != 0) {
+        CorePartition::refusals++; // no such core: on all cores
+        cpu_set_t cpus;
+        cpuMaskToSet(~0ull, cpus);
+        pthread_attr_setaffinity_np(&pthreadCreationAttr, sizeof(cpus), &cpus);
+        pthread_create(&pt, &pthreadCreationAttr, posixThreadEntryPoint, this);
+    }
+#else
     pthread_create(&pt, &pthreadCreationAttr, posixThreadEntryPoint, this);
+#endif
     ((ThreadOnPosixContext*)context.load())->pt = pt;
+    ((ThreadOnPosixContext*)context.load())->created = true;
     // xprintf("Thread %lx context %ld\n", (long)this, (long)context);
 
     setPriority(priority);
 }
 
 
-void checkSuspend(volatile int64_t* reactivationTime, pthread_cond_t* cond, pthread_mutex_t* mutex) {
+/**
+ * reactivationTime is read again after each wakeup: resume() sets it to 0.
+ * The timeout is absolute on the clock of NOW() (Linux: CLOCK_MONOTONIC, like
+ * clock_nanosleep(TIMER_ABSTIME)), a condition to be woken by resume().
+ */
+void checkSuspend(const Atomic<int64_t>& reactivationTime, pthread_cond_t* cond, pthread_mutex_t* mutex) {
     int64_t now                          = NOW();
-    int64_t hostabsoluteReactivationTime = hwGetAbsoluteNanoseconds() + (*reactivationTime - now);
+    int64_t hostabsoluteReactivationTime = hwGetAbsoluteNanoseconds() + (reactivationTime.load() - now);
 
     struct timespec tp;
     tp.tv_sec  = static_cast<time_t>(hostabsoluteReactivationTime / SECONDS);
     tp.tv_nsec = static_cast<long>(hostabsoluteReactivationTime % SECONDS);
 
-    while(*reactivationTime > now) {
-        if(*reactivationTime == END_OF_TIME) {
+    while(reactivationTime.load() > now) {
+        if(reactivationTime.load() == END_OF_TIME) {
             pthread_cond_wait(cond, mutex);
         } else {
             pthread_cond_timedwait(cond, mutex, &tp);
@@ -114,14 +164,17 @@ void checkSuspend(volatile int64_t* reactivationTime, pthread_cond_t* cond, pthr
 /** pause execution of this thread and call scheduler */
 void Thread::yield() {
     //Make suspendUntil.. in genericIO work
-    Thread*               caller =  getCurrentThread();
+    Thread* caller = getCurrentThread();
+    if(caller == 0) return; // a handler of the timer thread, it is no RODOS thread
     ThreadOnPosixContext* context = (ThreadOnPosixContext*)(caller->context.load());
 
+    Timer::updateTriggerToNextTimingEvent();
     pthread_mutex_lock(&context->mutex);
     if(caller->suspendedUntil > NOW()) {
         caller->waitingFor.store(0);
-        int64_t suspendedUntil = caller->suspendedUntil.load();
-        checkSuspend(&suspendedUntil, &context->condition, &context->mutex);
+        RODOS_TRACE(THREAD_WAIT, traceId(caller), 0);
+        checkSuspend(caller->suspendedUntil, &context->condition, &context->mutex);
+        RODOS_TRACE(THREAD_RUN, traceId(caller), 0);
     }
     pthread_mutex_unlock(&context->mutex);
 
@@ -163,8 +216,13 @@ void Thread::setPriority(const int32_t prio) {
     // xprintf("Setting Prio %ld for %d\n", priority, (int)pt);
     struct sched_param param;
     memset(&param, '\0', sizeof(param));
-    param.sched_priority = static_cast<int>(posixPrio);
-    pthread_setschedparam(pt, SCHED_FIFO, &param);
+    if(CorePartition::useFifoScheduling()) {
+        param.sched_priority = static_cast<int>(posixPrio);
+        bool refused = pthread_setschedparam(pt, SCHED_FIFO, &param) != 0;
+        if(refused && CorePartition::active != 0) CorePartition::refusals++; // without partition silently as before
+    } else {
+        pthread_setschedparam(pt, SCHED_OTHER, &param);
+    }
 
     /*** Only debug ***/
     // int policy;
@@ -174,7 +232,14 @@ void Thread::setPriority(const int32_t prio) {
     /************************/
 }
 
+/** all threads created: callers which are not RODOS threads are handlers of the timer thread */
+static bool allThreadsCreated = false;
+
 Thread* Thread::getCurrentThread() {
+    if(posixCurrentThread != 0) return posixCurrentThread;
+    // a handler of the timer thread runs in parallel to the threads, it is none of them
+    if(allThreadsCreated) return 0;
+
     pthread_t posixCaller = pthread_self();
 
     Thread* me = 0;
@@ -210,18 +275,23 @@ void Thread::resume() {
 /* suspend the thread */
 bool Thread::suspendCallerUntil(const int64_t reactivationTime, void* signaler) {
 
-    Thread* caller =  getCurrentThread();
+    Thread* caller = getCurrentThread();
+    if(caller == 0) return false; // a handler of the timer thread may not wait, like an interrupt
     ThreadOnPosixContext* context = (ThreadOnPosixContext*)(caller->context.load());
 
+    caller->endActivation();
+    Timer::updateTriggerToNextTimingEvent();
     pthread_mutex_lock(&context->mutex);
 
     caller->waitingFor = signaler;
     caller->suspendedUntil = reactivationTime;
 
-    int64_t suspendedUntil = caller->suspendedUntil.load();
-    checkSuspend(&suspendedUntil, &context->condition, &context->mutex);
+    RODOS_TRACE(THREAD_WAIT, traceId(caller), 0);
+    checkSuspend(caller->suspendedUntil, &context->condition, &context->mutex);
+    RODOS_TRACE(THREAD_RUN, traceId(caller), 0);
 
     pthread_mutex_unlock(&context->mutex);
+    caller->beginActivation();
 
     /** after yield: It was resumed (suspendedUntil set to 0) or time was reached ?*/
     if(caller->suspendedUntil == 0) return true; // it was resumed!
@@ -247,11 +317,21 @@ void Thread::initializeThreads() {
 
 void Thread::startAllThreads() {
 
+    CorePartition* partition = CorePartition::active;
+    if(partition != 0 && partition->lockMemory) {
+        partition->memoryLocked = lockProcessMemory();
+        if(!partition->memoryLocked) {
+            CorePartition::refusals++;
+            xprintf("CorePartition: mlockall not permitted\n");
+        }
+    }
+
     pthread_mutex_lock(&threadsGO);
 
     ITERATE_LIST(Thread, threadList) {
         iter->create();
     }
+    allThreadsCreated = true;
 
     pthread_mutex_unlock(&threadsGO);
 }
@@ -262,6 +342,8 @@ void Thread::startAllThreads() {
 
 void threadStartupWrapper(Thread* thread) {
     Thread::currentThread  = thread;
+    posixCurrentThread     = thread;
+    RODOS_TRACE(THREAD_RUN, traceId(thread), 0);
     thread->suspendedUntil = 0;
 
     thread->run();
@@ -305,4 +387,52 @@ Thread* Thread::findNextWaitingFor(void* signaler) {
 
 size_t Thread::getMaxStackUsage() { return 0; }
 
+int64_t Thread::getCpuTime() const {
+    ThreadOnPosixContext* ctx = (ThreadOnPosixContext*)context.load();
+    clockid_t             clock;
+    if(this == posixCurrentThread) {
+        clock = CLOCK_THREAD_CPUTIME_ID;
+    } else if(ctx == 0 || !ctx->created || pthread_getcpuclockid(ctx->pt, &clock) != 0) {
+        return 0;
+    }
+    struct timespec cpuTime;
+    clock_gettime(clock, &cpuTime);
+    return static_cast<int64_t>(cpuTime.tv_sec) * SECONDS + cpuTime.tv_nsec;
+}
+
+#ifdef __linux__
+bool Thread::setAffinity(uint64_t cpuMask) {
+    ThreadOnPosixContext* ctx = (ThreadOnPosixContext*)context.load();
+    uint64_t previous = affinity;
+    affinity          = cpuMask;
+    if(ctx == 0 || !ctx->created) return true; // set by create()
+
+    uint64_t  effective = CorePartition::effectiveMask(this);
+    cpu_set_t cpus;
+    cpuMaskToSet((effective == 0) ? ~0ull : effective, cpus);
+    if(pthread_setaffinity_np(ctx->pt, sizeof(cpus), &cpus) == 0) return true;
+    affinity = previous;
+    return false;
+}
+
+uint64_t Thread::getAffinity() const {
+    ThreadOnPosixContext* ctx = (ThreadOnPosixContext*)context.load();
+    if(ctx == 0 || !ctx->created) return CorePartition::effectiveMask(this);
+
+    cpu_set_t cpus;
+    if(pthread_getaffinity_np(ctx->pt, sizeof(cpus), &cpus) != 0) return 0;
+    uint64_t cpuMask = 0;
+    for(size_t cpu = 0; cpu < 64; cpu++) {
+        if(CPU_ISSET(cpu, &cpus)) cpuMask |= 1ull << cpu;
+    }
+    return cpuMask;
+}
+#else
+/* mac os: no affinities */
+bool Thread::setAffinity(uint64_t cpuMask) { return cpuMask == 0; }
+uint64_t Thread::getAffinity() const { return 0; }
+#endif
+
+bool lockProcessMemory() { return mlockall(MCL_CURRENT | MCL_FUTURE) == 0; }
+
 } // namespace RODOS
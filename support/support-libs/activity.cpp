@@ -1,52 +1,399 @@
 
+
 #include "rodos.h"
 #include "activity.h"
 
-Activity::Activity(const char* name, int prio, int64_t startAt, int64_t _period) : ListElement(activityList, name) {
-    suspendedUntil   = startAt; 
-    periode          = _period;
-    priority         = prio;
-    pseudoThreadLine = 0;
-}
-
 List Activity::activityList = 0;
 
 /*******************************************/
 
+static constexpr uint32_t MAX_LEVELS = 64; ///< priority levels of the ready fifos, one bit each
+
+static_assert(ACTIVITY_WORKERS >= 1 && ACTIVITY_WORKERS <= 32, "ACTIVITY_WORKERS: 1 .. 32");
+
 class ActivityExecuter : public StaticThread<> {
 public:
-    ActivityExecuter() : StaticThread<>("ActivityExecuter") { }
+    uint32_t index;
+    ActivityExecuter();
     void init();
     void run();
-} activityExecuter;
+};
+
+/**
+ * The data of the executer: the heap of the waiting activities, the ready
+ * fifos and the list of the woken ones. The heap and the fifos are used only
+ * with protector, the woken list is lock free (from any thread or interrupt).
+ */
+class ActivityScheduler {
+public:
+    enum State : uint8_t { PARKED, WAITING, READY, RUNNING }; ///< Activity::state
+
+    static Activity**       heap;
+    static int32_t          heapSize;
+    static int32_t          heapCapacity; ///< the activities at init()
+    static int32_t          levelPriority[MAX_LEVELS]; ///< ascending, the lowest priority of each level
+    static uint32_t         numOfLevels;
+    static Activity*        readyHead[MAX_LEVELS];
+    static Activity*        readyTail[MAX_LEVELS];
+    static uint64_t         readyLevels; ///< bit n: fifo n not empty
+    static Activity*        overflowList; ///< waiting ones which did not fit into the heap, sorted by time
+    static Atomic<Activity*> wokenList;
+    static Atomic<uint32_t>  idleWorkers; ///< bit n: worker n suspended
+    static Atomic<uint32_t>  kicks;       ///< of kick(): a worker suspends only if none since it looked for work
+    static bool             started;
+    static Semaphore        protector;
+    static ActivityExecuter workers[ACTIVITY_WORKERS];
+
+    static void setup();
+    static void takeWoken(int64_t timeNow);
+    static void takeDue(int64_t timeNow);
+    static void place(Activity* activity, int64_t timeNow);
+    static Activity* popReady(int64_t timeNow);
+    static void finishStep(Activity* activity, int64_t timeNow);
+    static int64_t nextTime();
+    static Activity* nextDue(int64_t timeNow);
+    static void kick();
+
+    static uint32_t levelOf(int32_t priority);
+    static void pushReady(Activity* activity);
+    static void heapSwap(int32_t a, int32_t b);
+    static void siftUp(int32_t pos);
+    static void siftDown(int32_t pos);
+    static void heapInsert(Activity* activity);
+    static void heapRemove(Activity* activity);
+    static void overflowInsert(Activity* activity);
+    static void overflowRemove(Activity* activity);
+};
+
+Activity**        ActivityScheduler::heap         = 0;
+int32_t           ActivityScheduler::heapSize     = 0;
+int32_t           ActivityScheduler::heapCapacity = 0;
+int32_t           ActivityScheduler::levelPriority[MAX_LEVELS];
+uint32_t          ActivityScheduler::numOfLevels = 1;
+Activity*         ActivityScheduler::readyHead[MAX_LEVELS];
+Activity*         ActivityScheduler::readyTail[MAX_LEVELS];
+uint64_t          ActivityScheduler::readyLevels = 0;
+Activity*         ActivityScheduler::overflowList = 0;
+Atomic<Activity*> ActivityScheduler::wokenList(0);
+Atomic<uint32_t>  ActivityScheduler::idleWorkers(0);
+Atomic<uint32_t>  ActivityScheduler::kicks(0);
+bool              ActivityScheduler::started = false;
+Semaphore         ActivityScheduler::protector;
+ActivityExecuter  ActivityScheduler::workers[ACTIVITY_WORKERS];
+
+//________________________________________________ levels and ready fifos
+
+/// the priorities of the activities, highest ones first: the lowest priorities share level 0 if more than MAX_LEVELS
+void ActivityScheduler::setup() {
+    int32_t count = 0;
+    ITERATE_LIST(Activity, Activity::activityList) count++;
+    heapCapacity = count;
+    heap         = static_cast<Activity**>(xmalloc(sizeof(Activity*) * static_cast<size_t>(count > 0 ? count : 1)));
+
+    int32_t distinct[MAX_LEVELS]; // descending
+    uint32_t numOfDistinct = 0;
+    ITERATE_LIST(Activity, Activity::activityList) {
+        int32_t  prio = iter->priority;
+        uint32_t pos  = 0;
+        while(pos < numOfDistinct && distinct[pos] > prio) pos++;
+        if(pos < numOfDistinct && distinct[pos] == prio) continue;
+        if(pos >= MAX_LEVELS) continue;
+        if(numOfDistinct < MAX_LEVELS) numOfDistinct++;
+        for(uint32_t i = numOfDistinct - 1; i > pos; i--) distinct[i] = distinct[i - 1];
+        distinct[pos] = prio;
+    }
+    numOfLevels = (numOfDistinct > 0) ? numOfDistinct : 1;
+    levelPriority[0] = INT32_MIN;
+    for(uint32_t level = 1; level < numOfDistinct; level++) levelPriority[level] = distinct[numOfDistinct - 1 - level];
+}
+
+/// the highest level with levelPriority <= priority (binary search, priorities may change)
+uint32_t ActivityScheduler::levelOf(int32_t priority) {
+    uint32_t low = 0, high = numOfLevels - 1;
+    while(low < high) {
+        uint32_t mid = (low + high + 1) / 2;
+        if(levelPriority[mid] <= priority) low = mid;
+        else high = mid - 1;
+    }
+    return low;
+}
+
+void ActivityScheduler::pushReady(Activity* activity) {
+    uint32_t level      = levelOf(activity->priority);
+    activity->state     = READY;
+    activity->nextReady = 0;
+    if(readyHead[level] == 0) readyHead[level] = activity;
+    else readyTail[level]->nextReady = activity;
+    readyTail[level] = activity;
+    readyLevels |= 1ull << level;
+}
+
+/// the first of the highest level; a ready one activated again in the future goes back to the heap
+Activity* ActivityScheduler::popReady(int64_t timeNow) {
+    while(readyLevels != 0) {
+        uint32_t  level    = 63 - static_cast<uint32_t>(__builtin_clzll(readyLevels));
+        Activity* activity = readyHead[level];
+        readyHead[level]   = activity->nextReady;
+        if(readyHead[level] == 0) readyLevels &= ~(1ull << level);
+
+        if(!activity->resumeRequested && activity->suspendedUntil > timeNow) {
+            place(activity, timeNow);
+            continue;
+        }
+        activity->resumeRequested = false;
+        activity->state           = RUNNING;
+        return activity;
+    }
+    return 0;
+}
+
+//________________________________________________ heap of the waiting ones
+
+void ActivityScheduler::heapSwap(int32_t a, int32_t b) {
+    Activity* tmp      = heap[a];
+    heap[a]            = heap[b];
+    heap[b]            = tmp;
+    heap[a]->heapIndex = a;
+    heap[b]->heapIndex = b;
+}
+
+void ActivityScheduler::siftUp(int32_t pos) {
+    while(pos > 0) {
+        int32_t parent = (pos - 1) / 2;
+        if(heap[parent]->heapKey <= heap[pos]->heapKey) return;
+        heapSwap(parent, pos);
+        pos = parent;
+    }
+}
+
+void ActivityScheduler::siftDown(int32_t pos) {
+    while(1) {
+        int32_t smallest = pos;
+        int32_t left     = 2 * pos + 1;
+        int32_t right    = left + 1;
+        if(left < heapSize && heap[left]->heapKey < heap[smallest]->heapKey) smallest = left;
+        if(right < heapSize && heap[right]->heapKey < heap[smallest]->heapKey) smallest = right;
+        if(smallest == pos) return;
+        heapSwap(pos, smallest);
+        pos = smallest;
+    }
+}
+
+void ActivityScheduler::heapInsert(Activity* activity) {
+    activity->state = WAITING;
+    if(heapSize >= heapCapacity) { // activities constructed after init()
+        overflowInsert(activity);
+        return;
+    }
+    activity->heapKey   = activity->suspendedUntil;
+    activity->heapIndex = heapSize;
+    heap[heapSize++]    = activity;
+    siftUp(activity->heapIndex);
+}
+
+/// from the heap or the overflow list; the first of the list takes the free place in the heap
+void ActivityScheduler::heapRemove(Activity* activity) {
+    int32_t pos     = activity->heapIndex;
+    activity->state = PARKED;
+    if(pos < 0) {
+        overflowRemove(activity);
+        return;
+    }
+    activity->heapIndex = -1;
+    heapSize--;
+    if(pos != heapSize) {
+        heap[pos]            = heap[heapSize];
+        heap[pos]->heapIndex = pos;
+        siftUp(pos);
+        siftDown(heap[pos]->heapIndex);
+    }
+    if(overflowList != 0) {
+        Activity* first = overflowList;
+        overflowList    = first->nextOverflow;
+        first->heapIndex = heapSize;
+        heap[heapSize++] = first;
+        siftUp(first->heapIndex);
+    }
+}
+
+void ActivityScheduler::overflowInsert(Activity* activity) {
+    activity->heapKey   = activity->suspendedUntil;
+    activity->heapIndex = -1;
+    Activity** link     = &overflowList;
+    while(*link != 0 && (*link)->heapKey <= activity->heapKey) link = &(*link)->nextOverflow;
+    activity->nextOverflow = *link;
+    *link                  = activity;
+}
+
+void ActivityScheduler::overflowRemove(Activity* activity) {
+    for(Activity** link = &overflowList; *link != 0; link = &(*link)->nextOverflow) {
+        if(*link == activity) {
+            *link = activity->nextOverflow;
+            return;
+        }
+    }
+}
+
+int64_t ActivityScheduler::nextTime() {
+    int64_t next = (heapSize > 0) ? heap[0]->heapKey : END_OF_TIME;
+    if(overflowList != 0 && overflowList->heapKey < next) next = overflowList->heapKey;
+    return next;
+}
+
+/// the earliest waiting one if it is due, else 0
+Activity* ActivityScheduler::nextDue(int64_t timeNow) {
+    Activity* first = (heapSize > 0) ? heap[0] : 0;
+    if(overflowList != 0 && (first == 0 || overflowList->heapKey < first->heapKey)) first = overflowList;
+    return (first != 0 && first->heapKey <= timeNow) ? first : 0;
+}
+
+//________________________________________________ transitions
+
+/// ready, waiting in the heap or parked (END_OF_TIME)
+void ActivityScheduler::place(Activity* activity, int64_t timeNow) {
+    if(activity->resumeRequested || activity->suspendedUntil <= timeNow) {
+        pushReady(activity);
+    } else if(activity->suspendedUntil < END_OF_TIME) {
+        heapInsert(activity);
+        if(activity->heapIndex == 0) kick(); // an idle worker may sleep until a later time
+        return;
+    } else {
+        activity->state = PARKED;
+        return;
+    }
+    kick();
+}
+
+/// after its step: the time of the next step is in suspendedUntil
+void ActivityScheduler::finishStep(Activity* activity, int64_t timeNow) {
+    activity->state = PARKED;
+    place(activity, timeNow);
+}
+
+/// the woken ones in the order of their wake()
+void ActivityScheduler::takeWoken(int64_t timeNow) {
+    Activity* list = wokenList;
+    while(!wokenList.compareExchange(list, 0)) {}
+
+    Activity* ordered = 0;
+    while(list != 0) { // reverse: the list is a stack
+        Activity* next  = list->nextWoken;
+        list->nextWoken = ordered;
+        ordered         = list;
+        list            = next;
+    }
+    while(ordered != 0) {
+        Activity* activity = ordered;
+        ordered            = activity->nextWoken;
+        activity->woken    = false;
+        if(!activity->initDone) { // constructed after init()
+            activity->initDone = true;
+            activity->init();
+        }
+        if(activity->state == WAITING) heapRemove(activity);
+        if(activity->state == PARKED) place(activity, timeNow);
+        // ready: popReady() checks the time, running: placed after its step
+    }
+}
+
+void ActivityScheduler::takeDue(int64_t timeNow) {
+    for(Activity* activity = nextDue(timeNow); activity != 0; activity = nextDue(timeNow)) {
+        heapRemove(activity);
+        place(activity, timeNow);
+    }
+}
+
+/// resumes a suspended worker, if there is one
+void ActivityScheduler::kick() {
+    if(!started) return;
+    kicks++;
+    uint32_t idle = idleWorkers;
+    if(idle == 0) return;
+    PRIORITY_CEILER_IN_SCOPE();
+    workers[__builtin_ctz(idle)].resume();
+}
+
+void Activity::wake() {
+    bool expected = false;
+    while(!woken.compareExchange(expected, true)) {
+        if(expected) return; // already in the list
+    }
+    Activity* head = ActivityScheduler::wokenList;
+    do {
+        nextWoken = head;
+    } while(!ActivityScheduler::wokenList.compareExchange(head, this));
+    ActivityScheduler::kick();
+}
+
+/*******************************************/
+
+/** after the init() of the executer: queued for it like by activateAt(), which places it and calls init() */
+Activity::Activity(const char* name, int prio, int64_t startAt, int64_t _period) : ListElement(activityList, name) {
+    suspendedUntil   = startAt;
+    periode          = _period;
+    priority         = prio;
+    pseudoThreadLine = 0;
+    if(ActivityScheduler::heap != 0) wake();
+}
+
+/*******************************************/
+
+ActivityExecuter::ActivityExecuter() : StaticThread<>("ActivityExecuter") {
+    static uint32_t numOfWorkers = 0;
+    index                        = numOfWorkers++;
+}
 
 void ActivityExecuter::init() {
+    if(index != 0) return;
+    ActivityScheduler::setup();
     xprintf("\ninit activities");
     ITERATE_LIST(Activity, Activity::activityList) {
         xprintf("\n     %s:", iter->name);
+        ActivityScheduler::place(iter, 0);
+        iter->initDone = true;
         iter->init();
     }
 }
 
 void ActivityExecuter::run(void) {
+    ActivityScheduler::started = true;
     while (1) {
-        int64_t nextTime = END_OF_TIME;
-        int64_t timeNow = NOW();
-        Activity* nextActivity = 0;
-
-        ITERATE_LIST(Activity, Activity::activityList) {
-            if (iter->suspendedUntil <= timeNow) { // due now
-               if (nextActivity == 0) nextActivity = iter;
-	       if (iter->priority > nextActivity->priority) nextActivity = iter;
-            } 
-            if (iter->suspendedUntil < nextTime) nextTime = iter->suspendedUntil;
-        } // listierator
-        if (nextActivity != 0 ) {
-            nextActivity->step(timeNow);
-            nextActivity->suspendedUntil = TimeModel::computeNextBeat(nextActivity->suspendedUntil, nextActivity->periode, timeNow);
+        Activity* activity  = 0;
+        int64_t   wakeAt    = END_OF_TIME;
+        uint32_t  seenKicks = 0;
+        {
+            PROTECT_IN_SCOPE(ActivityScheduler::protector);
+            int64_t timeNow = NOW();
+            ActivityScheduler::takeWoken(timeNow);
+            ActivityScheduler::takeDue(timeNow);
+            activity = ActivityScheduler::popReady(timeNow);
+            if(activity != 0 && ActivityScheduler::readyLevels != 0) ActivityScheduler::kick(); // more work for others
+            wakeAt    = ActivityScheduler::nextTime();
+            seenKicks = ActivityScheduler::kicks;
+        }
+
+        /**
+         * Like genericIO: the check and the suspend without interrupts, a
+         * resume() after them makes yield() return at once. A wake() or kick()
+         * which did not see the idle bit yet is seen here.
+         */
+        if(activity == 0) {
+            ActivityScheduler::idleWorkers |= 1u << index;
+            hwDisableInterrupts();
+            suspendedUntil = wakeAt;
+            if(ActivityScheduler::wokenList.load() != 0 || ActivityScheduler::kicks.load() != seenKicks) suspendedUntil = 0;
+            hwEnableInterrupts();
+            yield();
+            ActivityScheduler::idleWorkers &= ~(1u << index);
+            continue;
         }
-        timeNow = NOW(); // you may delete this if steps are very fast
-        if(nextTime > timeNow) suspendCallerUntil(nextTime);
+
+        int64_t timeNow = NOW();
+        activity->step(timeNow);
+        activity->suspendedUntil = TimeModel::computeNextBeat(activity->suspendedUntil, activity->periode, timeNow);
+
+        PROTECT_IN_SCOPE(ActivityScheduler::protector);
+        ActivityScheduler::finishStep(activity, NOW());
     } // loop
 } // run
 
@@ -1,14 +1,59 @@
 #pragma once
 
 #include "misc-rodos-funcs.h"
+#include "rodos-atomic.h"
+
+/**
+ * Activities: steps (protothreads) executed one after the other by the
+ * ActivityExecuter thread, without own stacks.
+ *
+ * The executer keeps the activities waiting for a time in a min-heap and the
+ * due ones in a fifo for each priority level (a bitmap of the levels with
+ * ready activities): a dispatch is O(log n) for n waiting activities, not a
+ * scan of all of them. Of the due activities the one with the highest
+ * priority runs first, equal priorities in the order they got due.
+ *
+ * activateAt(), activatePeriodic() and resume() may be called from any
+ * thread, TimeEvent or subscriber (O(1), they only queue the activity for the
+ * executer). suspendedUntil is written by the activity itself in step()
+ * (YIELD_UNTIL), from outside only through activateAt() and activatePeriodic().
+ * The heap has room for the activities constructed before the init() of the
+ * executer. Later ones (eg. from MAIN(), a list element can not be created
+ * once the scheduler runs) start at their startAt and get their init() from
+ * the executer; those which do not fit into the heap wait in a list sorted by
+ * time, O(n) for them.
+ *
+ * ACTIVITY_WORKERS (cmake -DACTIVITY_WORKERS=n): number of executer threads,
+ * more than 1 makes sense only on posix on a multi-core host. An activity
+ * never runs in two workers at the same time.
+ */
+
+#ifndef ACTIVITY_WORKERS
+#define ACTIVITY_WORKERS 1
+#endif
 
 class Activity : public ListElement {
+    friend class ActivityScheduler;
+    friend class ActivityExecuter;
+
+    int64_t                  heapKey     = 0;  ///< suspendedUntil when it entered the heap
+    int32_t                  heapIndex   = -1; ///< position in the heap, -1: not there
+    uint8_t                  state       = 0;  ///< parked, waiting, ready, running
+    Activity*                nextReady   = 0;  ///< fifo of its priority level
+    Activity*                nextWoken   = 0;  ///< list of the woken ones
+    Activity*                nextOverflow = 0; ///< waiting, did not fit into the heap
+    bool                     initDone    = false;
+    RODOS::Atomic<bool>      woken{ false };   ///< in the list of the woken ones
+    RODOS::Atomic<bool>      resumeRequested{ false };
+
+    /// queues the activity for the executer, which takes the new times
+    void wake();
+
 public:
     static List activityList;
 
     int pseudoThreadLine;
 
-    int64_t suspendedUntil;
     int64_t periode;
     int32_t priority;
 
@@ -18,14 +63,32 @@ public:
         RODOS_ERROR("activity deleted");
     }
 
-    void activateAt(const int64_t time) { suspendedUntil = time; }
+    void activateAt(const int64_t time) {
+        suspendedUntil = time;
+        wake();
+    }
     void activatePeriodic(const int64_t startAt, const int64_t _periode) {
         periode = _periode;
         suspendedUntil = startAt;
+        wake();
+    }
+    /**
+     * One step as soon as possible, eg. for a message or an event. The
+     * planned activation (suspendedUntil) stays, unless the step changes it.
+     */
+    void resume() {
+        resumeRequested = true;
+        wake();
     }
 
+    /// the planned activation
+    int64_t getSuspendedUntil() const { return suspendedUntil; }
+
     virtual void init() { }
     virtual void step([[gnu::unused]] int64_t timeNow) { }
+
+protected:
+    int64_t suspendedUntil; ///< for step() and YIELD_UNTIL, else activateAt()
 };
 
 
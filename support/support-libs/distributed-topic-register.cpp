@@ -1,6 +1,6 @@
 /*
  * @file: Distributed-Topic-Register
- * @date: Jun 10, 2022, August 2022
+ * @date: Jun 10, 2022, August 2022, October 2026: delta reports
  * @author: S. Büttner, T. Hegel, E. Zischka, Sergio Montenegro
  */
 
@@ -13,93 +13,370 @@
  * 2. It gets Topic-Ids reports from other nodes and keep track
  *    which topic has subscriber in which nodes
  *
+ * Only changes are published (DELTA), as soon as a subscriber is enabled
+ * or disabled, plus a DIGEST every TOPIC_DIGEST_PERIOD. Receivers which
+ * missed a change ask for a SNAPSHOT. See distributed-topic-register.h
+ *
  * but please see api/receiverNode+receiverNodesBitMap.txt  !!!!
  */
 
 #include "rodos.h"
-#include "gateway/networkmessage.h" // for class TopicListReport
-#include "netmsginfo.h"
+#include "distributed-topic-register.h"
 
 //____________________________________________________________________________________________________
-struct TopicListPerNode {
-    uint32_t        nodeNr;    // see MAX_NUM_OF_NODES but for example on_posix we have big numbers, which are not sequentially
-    uint8_t         nodeIndex; // 0..31 normally == nodeNr, but see comment of nodeNr
-    TopicListReport topicListReport;
-};
 
-Topic<TopicListPerNode> topicListDistribution(TOPIC_ID_FOR_TOPICLIST_DISTRIBUTION, "topicListDistribution"); // ID == 1 -> always Broadcast
+Topic<TopicListPerNode> RODOS::topicListDistribution(TOPIC_ID_FOR_TOPICLIST_DISTRIBUTION, "topicListDistribution"); // ID == 1 -> always Broadcast
 
 static Application nameNotImportant007("Distributed-Topic-Register", 22);
 
 DistributedTopicRegisterDecoy::DistributedTopicRegisterDecoy() { } // just decoy to link this whole file (application)
+
+/// What this node knows about the topics of another node (nodeIndex in TopicInterface::receiverNodes)
+struct RemoteTopicNode {
+    bool     known;              ///< reports received since start or since it was dead
+    uint32_t nodeNr;
+    uint32_t bootId;             ///< of its reports, another one: it restarted
+    uint32_t generation;         ///< reports applied up to this
+    uint32_t digest;
+    uint32_t snapshotGeneration; ///< of the snapshot being received
+    int32_t  nextChunk;          ///< of the snapshot being received, -1 -> none
+    int64_t  lastReportTime;
+    int64_t  lastRequestTime;
+    bool     requestPending;     ///< run() shall publish a request for a snapshot
+};
+
 //____________________________________________________________________________________________________
 class DistributedTopicRegister : public SubscriberReceiver<TopicListPerNode>, public StaticThread<>  {
-  public:
-    int64_t lastReportTimeOfNode[MAX_NUM_OF_NODES];
-    TopicListPerNode topicListFromMyNode; // topic report for all nodes
+    Semaphore        protector;  // for nodes: put() is called by the gateway threads
+    RemoteTopicNode  nodes[MAX_ADDRESSABLE_NODES];
+    TopicListPerNode report;     // only used by run()
 
-    DistributedTopicRegister() : 
-        SubscriberReceiver<TopicListPerNode>(topicListDistribution, "Distributed-Topic-Register"), 
+    uint32_t generation = 0;     // of my set of topics with subscribers
+    uint32_t digest     = 0;
+    uint32_t bootId     = 0;     // set by run()
+
+    volatile bool changesPending  = true; // at start: all topics with subscribers
+    volatile bool snapshotWanted  = false;
+    volatile bool requestsPending = false;
+    volatile bool waiting         = false;
+
+    static bool shallAnnounce(TopicInterface* topic);
+    void publishReport(TopicReportKind kind);
+    void sendDeltas();
+    void sendSnapshot();
+    void sendRequests();
+    void removeDeadNodes();
+
+    void forgetNode(uint32_t index);
+    void requestSnapshot(RemoteTopicNode& node);
+    void applyDelta(RemoteTopicNode& node, uint32_t index, const TopicListPerNode& hisTopics);
+    void applySnapshotChunk(RemoteTopicNode& node, uint32_t index, const TopicListPerNode& hisTopics);
+
+  public:
+    DistributedTopicRegister() :
+        SubscriberReceiver<TopicListPerNode>(topicListDistribution, "Distributed-Topic-Register"),
         StaticThread<>("Distributed-Topic-Register", 10) { // low Priority: not time critical
-            for(uint32_t i = 0; i < MAX_NUM_OF_NODES; i++) lastReportTimeOfNode[i] = END_OF_TIME;
+            for(uint32_t i = 0; i < MAX_ADDRESSABLE_NODES; i++) forgetNode(i);
     }
 
+    void wakeUp();                         // something to publish
+    void subscriptionsChanged() { changesPending = true; wakeUp(); }
     void run();                            // side 1: topic reports distribution
     void put(TopicListPerNode& hisTopics); // side 2: collect reports and update local topics
 
 } distributedTopicRegister;
 
+static void subscriptionsChanged([[gnu::unused]] TopicInterface*& topic) { distributedTopicRegister.subscriptionsChanged(); }
+static SubscriberReceiver<TopicInterface*> subscriptionWatcher(subscriptionChanged, subscriptionsChanged, "Distributed-Topic-Register");
+
+void DistributedTopicRegister::wakeUp() {
+    PRIORITY_CEILER_IN_SCOPE();
+    if(waiting) resume();
+}
+
 //_________________________________________ Side 1: topic reports distribution
-void DistributedTopicRegister::run() {
 
-    //_____________ preparations: which are my local topics with subscribers?
-    NetMsgInfo netMsgInfo; //(NetMsgType::TOPIC_LIST);
+bool DistributedTopicRegister::shallAnnounce(TopicInterface* topic) {
+    if(topic->onlyLocal || topic->topicId < ALL_TOPICS_BELOW_THIS_ARE_BROADCAST) return false;
+    return topic->hasEnabledSubscribers();
+}
 
-    ITERATE_LIST(TopicInterface, TopicInterface::topicList) {
-        if(iter->mySubscribers != 0) topicListFromMyNode.topicListReport.add(iter->topicId);
+void DistributedTopicRegister::publishReport(TopicReportKind kind) {
+    NetMsgInfo netMsgInfo(NetMsgType::TOPIC_LIST);
+    report.nodeNr     = (uint32_t)getNodeNumber();
+    report.nodeIndex  = static_cast<uint8_t>(NodeSet::nodeIndex(getNodeNumber()));
+    report.kind       = kind;
+    report.generation = generation;
+    report.digest     = digest;
+    report.bootId     = bootId;
+    static_cast<TopicInterface&>(topicListDistribution).publishMsgPart(&report, report.len(), true, &netMsgInfo);
+}
+
+/** Added topics first, then removed ones. More changes than fit in one report -> more deltas */
+void DistributedTopicRegister::sendDeltas() {
+    bool moreChanges = true;
+    while(moreChanges) {
+        moreChanges = false;
+        uint32_t numOfIds = 0;
+        report.numOfAdded   = 0;
+        report.numOfRemoved = 0;
+        for(int32_t added = 1; added >= 0; added--) {
+            ITERATE_LIST(TopicInterface, TopicInterface::topicList) {
+                bool subscribed = shallAnnounce(iter);
+                if(subscribed == iter->interestAnnounced || subscribed != (added == 1)) continue;
+                if(numOfIds == TOPIC_IDS_PER_REPORT) {
+                    moreChanges = true;
+                    continue;
+                }
+                report.topicIds[numOfIds++] = iter->topicId;
+                iter->interestAnnounced     = subscribed;
+                if(subscribed) {
+                    report.numOfAdded++;
+                    digest += topicDigest(iter->topicId);
+                } else {
+                    report.numOfRemoved++;
+                    digest -= topicDigest(iter->topicId);
+                }
+            }
+        }
+        if(numOfIds == 0) return;
+        generation++;
+        publishReport(TopicReportKind::DELTA);
+    }
+}
+
+/** The announced topics sorted by id, in chunks */
+void DistributedTopicRegister::sendSnapshot() {
+    uint32_t from = 0;
+    report.chunk  = 0;
+    while(1) {
+        uint32_t numOfIds   = 0;
+        uint32_t lowerBound = from;
+        bool     lastChunk  = true;
+        while(1) { // the next greater id, the number of topics is small
+            bool     found = false;
+            uint32_t next  = 0;
+            ITERATE_LIST(TopicInterface, TopicInterface::topicList) {
+                if(iter->interestAnnounced && iter->topicId >= lowerBound && (!found || iter->topicId < next)) {
+                    next  = iter->topicId;
+                    found = true;
+                }
+            }
+            if(!found) break;
+            if(numOfIds == TOPIC_IDS_PER_REPORT) {
+                lastChunk = false;
+                break;
+            }
+            report.topicIds[numOfIds++] = next;
+            if(next == UINT32_MAX) break;
+            lowerBound = next + 1;
+        }
+        report.numOfAdded   = static_cast<uint16_t>(numOfIds);
+        report.numOfRemoved = 0;
+        report.firstTopicId = from;
+        report.lastTopicId  = lastChunk ? UINT32_MAX : report.topicIds[numOfIds - 1];
+        publishReport(TopicReportKind::SNAPSHOT);
+        if(lastChunk) return;
+        from = report.lastTopicId + 1;
+        report.chunk++;
+    }
+}
+
+void DistributedTopicRegister::sendRequests() {
+    report.numOfAdded   = 0;
+    report.numOfRemoved = 0;
+    for(uint32_t i = 0; i < MAX_ADDRESSABLE_NODES; i++) {
+        {
+            PROTECT_IN_SCOPE(protector);
+            if(!nodes[i].requestPending) continue;
+            nodes[i].requestPending = false;
+            report.requestedNode    = nodes[i].nodeNr;
+        }
+        publishReport(TopicReportKind::REQUEST);
+    }
+}
+
+void DistributedTopicRegister::removeDeadNodes() {
+    int64_t definitionOfVeryOld = NOW() - TOPIC_NODE_TIMEOUT;
+    PROTECT_IN_SCOPE(protector);
+    for(uint32_t i = 0; i < MAX_ADDRESSABLE_NODES; i++) {
+        if(nodes[i].known && nodes[i].lastReportTime < definitionOfVeryOld) forgetNode(i); // its bits to 0 in all topics
     }
+}
 
-    //_______________________________________________________
-    TIME_LOOP(1117 * MILLISECONDS, 3 * SECONDS) {
-        topicListFromMyNode.nodeNr    = (uint32_t)getNodeNumber();
-        topicListFromMyNode.nodeIndex = topicListFromMyNode.nodeNr % MAX_NUM_OF_NODES;
-
-        netMsgInfo.init(NetMsgType::TOPIC_LIST);
-        topicListDistribution.publish(topicListFromMyNode, true, &netMsgInfo); // always the same, but important for new nodes
-
-        //____________________ find dead nodes and remove from bitmap of receivers
-
-        int64_t definitionOfVeryOld = NOW() - 10*SECONDS;
-        for(uint32_t i = 0; i < MAX_NUM_OF_NODES; i++) {
-            if(lastReportTimeOfNode[i] < definitionOfVeryOld) { // if dead, set corresponding bit to 0 in all topics
-                uint32_t zeroAtBitPos = ~(0x01u  << i);
-                ITERATE_LIST(TopicInterface, TopicInterface::topicList) {
-                    iter->receiverNodesBitMap &= zeroAtBitPos;
-                } // for all topics
-            } // if node is dead
-        } // for all nodes
-    } // TIME_LOOP
+/**
+ * There is no persistent boot counter: the time of day and the exact start
+ * time (nanoseconds, jitters from boot to boot) make it differ from the
+ * last start. Equal by chance: the receivers see the lower generation.
+ */
+static uint32_t topicBootId() {
+    uint64_t x = static_cast<uint64_t>(sysTime.getUTC()) ^ (static_cast<uint64_t>(NOW()) * 0x9E3779B97F4A7C15ull);
+    x ^= x >> 29;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 32;
+    return static_cast<uint32_t>(x);
+}
+
+void DistributedTopicRegister::run() {
+    int64_t nextDigest = NOW() + 1117 * MILLISECONDS;
+    bootId = topicBootId();
+
+    while(1) {
+        if(changesPending) {
+            changesPending = false;
+            sendDeltas();
+        }
+        if(snapshotWanted) {
+            snapshotWanted = false;
+            sendSnapshot();
+        }
+        if(requestsPending) {
+            requestsPending = false;
+            sendRequests();
+        }
+        if(NOW() >= nextDigest) { // important for new nodes and to detect lost deltas
+            report.numOfAdded   = 0;
+            report.numOfRemoved = 0;
+            publishReport(TopicReportKind::DIGEST);
+            removeDeadNodes();
+            nextDigest += TOPIC_DIGEST_PERIOD;
+            if(nextDigest < NOW()) nextDigest = NOW() + TOPIC_DIGEST_PERIOD;
+        }
+
+        {
+            PRIORITY_CEILER_IN_SCOPE();
+            if(!changesPending && !snapshotWanted && !requestsPending) {
+                waiting = true;
+                suspendCallerUntil(nextDigest); // or resumed by wakeUp()
+                waiting = false;
+            }
+        }
+    } // loop
 } // run
 
 //_________________________________________ Side 2: collect topic reports and update local topics
-void DistributedTopicRegister::put(TopicListPerNode& hisTopics) {
-    if(hisTopics.nodeNr == (uint32_t)getNodeNumber()) return; // Ignore my own reports
 
-    uint32_t oneAtBitPos = 0x01u  << hisTopics.nodeIndex; // See line 54: 0..31
-    lastReportTimeOfNode[hisTopics.nodeIndex] = NOW();
+void DistributedTopicRegister::forgetNode(uint32_t index) {
+    ITERATE_LIST(TopicInterface, TopicInterface::topicList) {
+        if(iter->topicId >= ALL_TOPICS_BELOW_THIS_ARE_BROADCAST) iter->removeReceiverNode(index);
+    }
+    RemoteTopicNode& node = nodes[index];
+    node.known           = false;
+    node.bootId          = 0;
+    node.generation      = 0; // a new node starts with generation 0: no topics
+    node.digest          = 0;
+    node.nextChunk       = -1;
+    node.lastRequestTime = -TOPIC_REQUEST_INTERVAL;
+    node.requestPending  = false;
+}
 
-    //PRINTF(" got report from %d -> %d: ", hisTopics.nodeNr, hisTopics.nodeIndex);
-    //for(uint32_t i = 0; i < hisTopics.topicListReport.numberOfTopics; i++) PRINTF(" %d ", hisTopics.topicListReport.topicList[i]);
-    //PRINTF("\n");
+void DistributedTopicRegister::requestSnapshot(RemoteTopicNode& node) {
+    int64_t timeNow = NOW();
+    if(timeNow - node.lastRequestTime < TOPIC_REQUEST_INTERVAL) return; // the snapshot may be on its way
+    node.lastRequestTime = timeNow;
+    node.requestPending  = true;
+    requestsPending      = true;
+    wakeUp();
+}
+
+void DistributedTopicRegister::applyDelta(RemoteTopicNode& node, uint32_t index, const TopicListPerNode& hisTopics) {
+    // Only the changed topics: no need to compare the whole list with all local topics
+    for(uint32_t i = 0; i < static_cast<uint32_t>(hisTopics.numOfAdded + hisTopics.numOfRemoved); i++) {
+        if(hisTopics.topicIds[i] < ALL_TOPICS_BELOW_THIS_ARE_BROADCAST) continue;
+        TopicInterface* topic = TopicInterface::findTopicId(hisTopics.topicIds[i]);
+        if(topic == 0) continue; // not used in this node
+        if(i < hisTopics.numOfAdded) {
+            topic->addReceiverNode(index);
+        } else {
+            topic->removeReceiverNode(index);
+        }
+    }
+    node.generation = hisTopics.generation;
+    node.digest     = hisTopics.digest;
+}
 
+static bool containsSorted(const uint32_t* ids, uint32_t numOfIds, uint32_t topicId) {
+    uint32_t low = 0, high = numOfIds;
+    while(low < high) {
+        uint32_t middle = (low + high) / 2;
+        if(ids[middle] == topicId) return true;
+        if(ids[middle] < topicId) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return false;
+}
 
-    // I have 2 options:
-    //   1. For each topic_id in the report: scan all my local topics
-    //   2. For each of my local topics: scan all topic_ids in the report
-    // I have the feeling Nr. 2 is more efficient.
+void DistributedTopicRegister::applySnapshotChunk(RemoteTopicNode& node, uint32_t index, const TopicListPerNode& hisTopics) {
+    if(hisTopics.chunk == 0) {
+        if(static_cast<int32_t>(hisTopics.generation - node.generation) < 0) return; // older than what I know
+        node.snapshotGeneration = hisTopics.generation;
+        node.nextChunk          = 0;
+    }
+    if(node.nextChunk != hisTopics.chunk || node.snapshotGeneration != hisTopics.generation) return; // lost a chunk
 
     ITERATE_LIST(TopicInterface, TopicInterface::topicList) {
-        if(hisTopics.topicListReport.find(iter->topicId)) iter->receiverNodesBitMap |= oneAtBitPos;
+        uint32_t id = iter->topicId;
+        if(id < hisTopics.firstTopicId || id > hisTopics.lastTopicId || id < ALL_TOPICS_BELOW_THIS_ARE_BROADCAST) continue;
+        if(containsSorted(hisTopics.topicIds, hisTopics.numOfAdded, id)) {
+            iter->addReceiverNode(index);
+        } else {
+            iter->removeReceiverNode(index);
+        }
+    }
+    node.nextChunk++;
+    if(hisTopics.lastTopicId == UINT32_MAX) {
+        node.generation = hisTopics.generation;
+        node.digest     = hisTopics.digest;
+        node.nextChunk  = -1;
     }
-} 
+}
 
+void DistributedTopicRegister::put(TopicListPerNode& hisTopics) {
+    uint32_t myNodeNr = (uint32_t)getNodeNumber();
+    if(hisTopics.nodeNr == myNodeNr) return; // Ignore my own reports
+    if(hisTopics.numOfAdded + hisTopics.numOfRemoved > TOPIC_IDS_PER_REPORT) return; // corrupt
+
+    if(hisTopics.kind == TopicReportKind::REQUEST) {
+        if(hisTopics.requestedNode == myNodeNr) {
+            snapshotWanted = true;
+            wakeUp();
+        }
+        return;
+    }
+
+    uint32_t index = hisTopics.nodeIndex % MAX_ADDRESSABLE_NODES;
+
+    PROTECT_IN_SCOPE(protector);
+    RemoteTopicNode& node = nodes[index];
+    int32_t distance  = static_cast<int32_t>(hisTopics.generation - node.generation);
+    bool    restarted = hisTopics.bootId != node.bootId || (hisTopics.kind == TopicReportKind::DIGEST && distance < 0);
+    if(!node.known || node.nodeNr != hisTopics.nodeNr || restarted) { // new (or another node with the same index)
+        forgetNode(index); // a restarted node counts its generations from 1 again
+        node.known  = true;
+        node.nodeNr = hisTopics.nodeNr;
+        node.bootId = hisTopics.bootId;
+        distance    = static_cast<int32_t>(hisTopics.generation - node.generation);
+    }
+    node.lastReportTime = NOW();
+
+    switch(hisTopics.kind) {
+    case TopicReportKind::DELTA:
+        if(distance == 1) {
+            applyDelta(node, index, hisTopics);
+        } else if(distance > 1) {
+            requestSnapshot(node); // lost one, distance <= 0: already applied
+        }
+        break;
+    case TopicReportKind::DIGEST:
+        if(distance != 0 || hisTopics.digest != node.digest) requestSnapshot(node); // lost a delta or new node
+        break;
+    case TopicReportKind::SNAPSHOT:
+        applySnapshotChunk(node, index, hisTopics);
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "netmsginfo.h"
+#include "topic.h"
+
+#ifndef NO_RODOS_NAMESPACE
+namespace RODOS {
+#endif
+
+/**
+ * @file distributed-topic-register.h
+ * @date 2026/10/08
+ *
+ * @brief messages of the distributed-topic-register, see distributed-topic-register.cpp
+ *
+ * Each node numbers the versions of its set of topics with subscribers
+ * (generation) and keeps a digest of it (sum of a hash of each topic id).
+ *
+ *   DELTA    : topics added and removed since generation - 1, sent as soon
+ *              as a subscriber is enabled or disabled (Subscriber::enable)
+ *   DIGEST   : generation and digest, every TOPIC_DIGEST_PERIOD (anti entropy, alive)
+ *   REQUEST  : a receiver missed a delta or does not know the node: requestedNode
+ *              shall send a snapshot
+ *   SNAPSHOT : the whole set in chunks, sorted by topic id. Each chunk covers the
+ *              ids firstTopicId..lastTopicId, the last one ends with UINT32_MAX
+ *
+ * A restarted node begins again with generation 1. Its reports carry a new
+ * bootId, so the receivers forget what they knew about it and take its
+ * deltas and snapshots again. A digest with a lower generation means the
+ * same (the boot ids of both starts were equal by chance).
+ *
+ * Only the used part of topicIds is sent (TopicListPerNode::len), there is no
+ * limit for the number of topics per node.
+ */
+
+constexpr uint32_t TOPIC_IDS_PER_REPORT   = (MAX_NETWORK_MESSAGE_LENGTH - 36) / 4;
+constexpr int64_t  TOPIC_DIGEST_PERIOD    = 3 * SECONDS;
+constexpr int64_t  TOPIC_NODE_TIMEOUT     = 10 * SECONDS; ///< without reports: the node is dead, its subscriptions are removed
+constexpr int64_t  TOPIC_REQUEST_INTERVAL = 1 * SECONDS;  ///< min. time between two requests for the same node
+
+enum class TopicReportKind : uint8_t {
+    DELTA,
+    DIGEST,
+    REQUEST,
+    SNAPSHOT
+};
+
+struct TopicListPerNode {
+    uint32_t nodeNr;        ///< see MAX_NUM_OF_NODES but for example on_posix we have big numbers, which are not sequentially
+    uint8_t  nodeIndex;     ///< NodeSet::nodeIndex(nodeNr), see comment of nodeNr
+    TopicReportKind kind;
+    uint16_t numOfAdded;    ///< DELTA: added topics, SNAPSHOT: all topics of the chunk
+    uint16_t numOfRemoved;  ///< DELTA: removed topics, after the added ones
+    uint16_t chunk;         ///< SNAPSHOT: 0, 1, ...
+    uint32_t generation;    ///< of the set of the sender after this report
+    uint32_t digest;        ///< of the set of the sender after this report
+    uint32_t firstTopicId;  ///< SNAPSHOT: range of this chunk
+    uint32_t lastTopicId;
+    uint32_t requestedNode; ///< REQUEST: nodeNr of the node which shall send a snapshot
+    uint32_t bootId;        ///< another one after each start of the sender, see topicBootId()
+    uint32_t topicIds[TOPIC_IDS_PER_REPORT];
+
+    /// bytes to publish
+    size_t len() const { return offsetof(TopicListPerNode, topicIds) + (numOfAdded + numOfRemoved) * sizeof(topicIds[0]); }
+};
+
+static_assert(offsetof(TopicListPerNode, topicIds) == 36, "header of topic reports: 36 bytes");
+
+extern Topic<TopicListPerNode> topicListDistribution; ///< ID TOPIC_ID_FOR_TOPICLIST_DISTRIBUTION, always broadcast
+
+/// Part of the digest for one topic id, the digest is the sum of all
+inline uint32_t topicDigest(uint32_t topicId) {
+    uint32_t h = topicId * 2654435761u;
+    return h ^ (h >> 15);
+}
+
+#ifndef NO_RODOS_NAMESPACE
+}
+#endif
@@ -0,0 +1,478 @@
+/**
+ * @file housekeeping.cpp
+ * @date 2026/10/18
+ *
+ * @brief housekeeping parameters: sampled from a table, packed in bits, deltas and runs
+ *
+ */
+
+#include "rodos.h"
+#include "housekeeping.h"
+
+#ifndef NO_RODOS_NAMESPACE
+namespace RODOS {
+#endif
+
+static constexpr size_t  LAYOUT_ENTRY_SIZE = 24; ///< serialized for the layout id
+static constexpr uint8_t HK_NEW_SAMPLE     = 0x80; ///< in latestBuffer: not packed yet
+
+/// MSB first, through a 64 bit accumulator
+class HkBitWriter {
+    uint8_t* buf;
+    size_t   maxLen;
+    size_t   len;
+    uint64_t accumulator;
+    uint32_t bitsInAccumulator;
+
+  public:
+    bool overflow;
+
+    HkBitWriter(uint8_t* buf_, size_t maxLen_) : buf(buf_), maxLen(maxLen_), len(0), accumulator(0), bitsInAccumulator(0), overflow(false) {}
+
+    /// bits <= 32, stored in bytes when 32 are collected
+    void write(uint32_t value, uint32_t bits) {
+        accumulator = (accumulator << bits) | (value & ((1ull << bits) - 1));
+        bitsInAccumulator += bits;
+        if(bitsInAccumulator >= 32) flush(32);
+    }
+
+    /// n >= 1 exp-Golomb: bits(n) - 1 zeros, then n
+    void writeRun(uint32_t n) {
+        uint32_t bits = 1;
+        while((n >> bits) != 0) bits++;
+        write(0, bits - 1);
+        write(n, bits);
+    }
+
+    /// bytes written, the last one filled with 0 bits
+    size_t finish() {
+        if((bitsInAccumulator % 8) != 0) write(0, 8 - bitsInAccumulator % 8);
+        flush(8);
+        return len;
+    }
+
+  private:
+    void flush(uint32_t downTo) {
+        while(bitsInAccumulator >= downTo && bitsInAccumulator > 0) {
+            bitsInAccumulator -= 8;
+            if(len >= maxLen) {
+                overflow = true;
+                continue;
+            }
+            buf[len++] = static_cast<uint8_t>(accumulator >> bitsInAccumulator);
+        }
+    }
+};
+
+class HkBitReader {
+    const uint8_t* buf;
+    size_t         len;
+    size_t         pos;
+    uint64_t       accumulator;
+    uint32_t       bitsInAccumulator;
+
+  public:
+    bool error;
+
+    HkBitReader(const uint8_t* buf_, size_t len_) : buf(buf_), len(len_), pos(0), accumulator(0), bitsInAccumulator(0), error(false) {}
+
+    uint32_t read(uint32_t bits) {
+        while(bitsInAccumulator < bits) {
+            if(pos >= len) {
+                error = true;
+                return 0;
+            }
+            accumulator = (accumulator << 8) | buf[pos++];
+            bitsInAccumulator += 8;
+        }
+        bitsInAccumulator -= bits;
+        return static_cast<uint32_t>((accumulator >> bitsInAccumulator) & ((1ull << bits) - 1));
+    }
+
+    uint32_t readRun() {
+        uint32_t zeros = 0;
+        while(read(1) == 0 && !error) {
+            if(++zeros >= 32) {
+                error = true;
+                return 0;
+            }
+        }
+        return (1u << zeros) | read(zeros);
+    }
+};
+
+static inline uint8_t bitsFor(uint64_t maxRaw) {
+    uint8_t bits = 1;
+    while(bits < 32 && (maxRaw >> bits) != 0) bits++;
+    return bits;
+}
+
+/// changes of small parameters are sent raw
+static inline uint8_t deltaBitsFor(uint8_t bits) { return (bits >= 8) ? static_cast<uint8_t>(bits / 4 + 2) : 0; }
+
+/// the raw values of a group of integers of type T
+template <typename T>
+static void readIntegers(HkParameter* group, uint32_t size, uint8_t buffer) {
+    for(uint32_t i = 0; i < size; i++) {
+        HkParameter& parameter = group[i];
+        int64_t      value     = static_cast<int64_t>(*static_cast<const T*>(parameter.address)) - parameter.min;
+        if(value <= 0) parameter.raw[buffer] = 0;
+        else if(value >= parameter.maxRaw) parameter.raw[buffer] = parameter.maxRaw;
+        else parameter.raw[buffer] = static_cast<uint32_t>(value);
+    }
+}
+
+static void readFloats(HkParameter* group, uint32_t size, uint8_t buffer) {
+    for(uint32_t i = 0; i < size; i++) {
+        HkParameter& parameter = group[i];
+        float        scaled    = (*static_cast<const float*>(parameter.address) - parameter.minFloat) * parameter.inverseResolution + 0.5f;
+        if(!(scaled > 0.0f)) parameter.raw[buffer] = 0; // NaN too
+        else if(scaled >= static_cast<float>(parameter.maxRaw)) parameter.raw[buffer] = parameter.maxRaw;
+        else parameter.raw[buffer] = static_cast<uint32_t>(scaled);
+    }
+}
+
+/// one type switch per group
+static void readGroup(HkParameter* group, uint32_t size, uint8_t buffer) {
+    switch(group->type) {
+        case FieldType::U8:  readIntegers<uint8_t>(group, size, buffer); break;
+        case FieldType::I8:  readIntegers<int8_t>(group, size, buffer); break;
+        case FieldType::U16: readIntegers<uint16_t>(group, size, buffer); break;
+        case FieldType::I16: readIntegers<int16_t>(group, size, buffer); break;
+        case FieldType::U32: readIntegers<uint32_t>(group, size, buffer); break;
+        case FieldType::F32: readFloats(group, size, buffer); break;
+        default:             readIntegers<int32_t>(group, size, buffer); break;
+    }
+}
+
+/// raw values have up to 32 bits: the difference needs 33, coded 64
+static inline uint64_t zigzag(int64_t delta) { return (delta >= 0) ? 2 * static_cast<uint64_t>(delta) : 2 * static_cast<uint64_t>(-delta) - 1; }
+static inline int64_t  unzigzag(uint32_t coded) { return (coded & 1) ? -static_cast<int64_t>(coded >> 1) - 1 : static_cast<int64_t>(coded >> 1); }
+
+/*************** registration *****************/
+
+HousekeepingPacker::HousekeepingPacker(HkParameter* table_, uint32_t capacity_) {
+    table                = table_;
+    capacity             = capacity_;
+    numOfParams          = 0;
+    tick                 = 0;
+    sequenceNr           = 0;
+    packetsSinceKeyFrame = 0;
+    started              = false;
+    cachedLayoutId       = 0;
+    sampleBuffer         = 0;
+    latestBuffer         = 1;
+    packBuffer           = 2;
+    for(uint32_t& bufferTickOf : bufferTick) bufferTickOf = 0;
+}
+
+/// lock free: sample() and pack() swap their buffer with the latest one
+static inline uint8_t exchangeBuffer(Atomic<uint8_t>& latestBuffer, uint8_t buffer) {
+    uint8_t latest = latestBuffer;
+    while(!latestBuffer.compareExchange(latest, buffer)) {}
+    return latest;
+}
+
+HkParameter* HousekeepingPacker::newParameter(uint16_t id, const void* address, FieldType type, uint32_t maxRaw, uint16_t divider) {
+    if(started || numOfParams >= capacity) {
+        RODOS_ERROR("housekeeping: table full, or parameter added after the first sample");
+        return 0;
+    }
+    HkParameter& parameter = table[numOfParams++];
+    parameter.address      = address;
+    parameter.sent         = 0;
+    parameter.maxRaw       = maxRaw;
+    parameter.countdown    = 1; // the first sample has all
+    parameter.divider      = (divider == 0) ? 1 : divider;
+    parameter.type         = type;
+    parameter.bits         = bitsFor(maxRaw);
+    parameter.deltaBits    = deltaBitsFor(parameter.bits);
+    parameter.groupSize    = 0;
+    for(uint8_t buffer = 0; buffer < HK_SAMPLE_BUFFERS; buffer++) {
+        parameter.raw[buffer]     = 0;
+        parameter.sampled[buffer] = false;
+    }
+    parameter.min          = 0;
+    parameter.minFloat     = 0;
+    parameter.inverseResolution = 1;
+    parameter.resolution   = 1;
+    parameter.id           = id;
+    return &parameter;
+}
+
+bool HousekeepingPacker::addInteger(uint16_t id, const void* address, FieldType type, int64_t min, int64_t max, uint16_t divider) {
+    if(max < min || static_cast<uint64_t>(max - min) > UINT32_MAX) return false;
+    HkParameter* parameter = newParameter(id, address, type, static_cast<uint32_t>(max - min), divider);
+    if(parameter == 0) return false;
+    parameter->min = min;
+    return true;
+}
+
+bool HousekeepingPacker::add(uint16_t id, const float& variable, float min, float max, float resolution, uint16_t divider) {
+    if(!(max > min) || !(resolution > 0.0f)) return false;
+    double steps = static_cast<double>(max - min) / static_cast<double>(resolution) + 0.5;
+    if(steps > static_cast<double>(UINT32_MAX)) return false;
+    HkParameter* parameter = newParameter(id, &variable, FieldType::F32, static_cast<uint32_t>(steps), divider);
+    if(parameter == 0) return false;
+    parameter->minFloat          = min;
+    parameter->inverseResolution = 1.0f / resolution;
+    parameter->resolution        = resolution;
+    return true;
+}
+
+void HousekeepingPacker::layoutEntry(uint32_t index, HkLayoutEntry& entry) const {
+    const HkParameter& parameter = table[index];
+    entry.id                     = parameter.id;
+    entry.type                   = parameter.type;
+    entry.bits                   = parameter.bits;
+    entry.deltaBits              = parameter.deltaBits;
+    entry.divider                = parameter.divider;
+    entry.min                    = parameter.min;
+    entry.minFloat               = parameter.minFloat;
+    entry.resolution             = parameter.resolution;
+}
+
+uint32_t HousekeepingPacker::getLayout(HkLayoutEntry* layout, uint32_t maxEntries) const {
+    uint32_t n = (numOfParams < maxEntries) ? numOfParams : maxEntries;
+    for(uint32_t i = 0; i < n; i++) layoutEntry(i, layout[i]);
+    return n;
+}
+
+/// the entry big endian into the CRC, the same on ground
+static uint16_t layoutCrc(const HkLayoutEntry& layout, uint16_t crc) {
+    uint8_t entry[LAYOUT_ENTRY_SIZE];
+    uint16_tToBigEndian(entry, layout.id);
+    entry[2] = static_cast<uint8_t>(layout.type);
+    entry[3] = layout.bits;
+    entry[4] = layout.deltaBits;
+    entry[5] = 0;
+    uint16_tToBigEndian(entry + 6, layout.divider);
+    int64_tToBigEndian(entry + 8, layout.min);
+    floatToBigEndian(entry + 16, layout.minFloat);
+    floatToBigEndian(entry + 20, layout.resolution);
+    return computeCrc(entry, sizeof(entry), crc);
+}
+
+uint16_t housekeepingLayoutId(const HkLayoutEntry* layout, uint32_t numOfParams) {
+    uint16_t crc = 0xffff;
+    for(uint32_t i = 0; i < numOfParams; i++) crc = layoutCrc(layout[i], crc);
+    return crc;
+}
+
+uint16_t HousekeepingPacker::layoutId() const {
+    if(started) return cachedLayoutId;
+    uint16_t crc = 0xffff;
+    for(uint32_t i = 0; i < numOfParams; i++) {
+        HkLayoutEntry entry;
+        layoutEntry(i, entry);
+        crc = layoutCrc(entry, crc);
+    }
+    return crc;
+}
+
+void HousekeepingPacker::printLayout() const {
+    PRINTF("housekeeping layout %04x: id, type, bits, deltaBits, divider, min, resolution (floats: then both as IEEE 754 bits)\n",
+           static_cast<unsigned int>(layoutId()));
+    for(uint32_t i = 0; i < numOfParams; i++) {
+        const HkParameter& parameter = table[i];
+        PRINTF("%d, %d, %d, %d, %d, ", static_cast<int>(parameter.id), static_cast<int>(parameter.type), static_cast<int>(parameter.bits),
+               static_cast<int>(parameter.deltaBits), static_cast<int>(parameter.divider));
+        if(parameter.type == FieldType::F32) {
+            uint8_t minBits[4], resolutionBits[4];
+            floatToBigEndian(minBits, parameter.minFloat);
+            floatToBigEndian(resolutionBits, parameter.resolution);
+            PRINTF("%.9f, %.9f, %08x, %08x\n", static_cast<double>(parameter.minFloat), static_cast<double>(parameter.resolution),
+                   static_cast<unsigned int>(bigEndianToUint32_t(minBits)), static_cast<unsigned int>(bigEndianToUint32_t(resolutionBits)));
+        } else {
+            PRINTF("%lld, 1\n", static_cast<long long>(parameter.min));
+        }
+    }
+}
+
+/*************** sampling and packing *****************/
+
+/// the groups of parameters of the same type and divider, at the first sample
+void HousekeepingPacker::findGroups() {
+    for(uint32_t first = 0; first < numOfParams;) {
+        HkParameter& head = table[first];
+        uint32_t     size = 1;
+        while(first + size < numOfParams && table[first + size].type == head.type && table[first + size].divider == head.divider) {
+            table[first + size].groupSize = 0;
+            size++;
+        }
+        head.groupSize = size;
+        first += size;
+    }
+}
+
+void HousekeepingPacker::sample() {
+    if(!started) {
+        cachedLayoutId = layoutId();
+        findGroups();
+        started = true; // the first sample is tick 0
+    } else {
+        tick++;
+    }
+    uint8_t buffer = sampleBuffer;
+    for(uint32_t first = 0; first < numOfParams; first += table[first].groupSize) {
+        HkParameter& head = table[first];
+        if(--head.countdown != 0) {
+            head.sampled[buffer] = false;
+            continue;
+        }
+        head.countdown       = head.divider;
+        head.sampled[buffer] = true;
+        readGroup(&head, head.groupSize, buffer);
+    }
+    bufferTick[buffer] = tick;
+    sampleBuffer       = static_cast<uint8_t>(exchangeBuffer(latestBuffer, static_cast<uint8_t>(buffer | HK_NEW_SAMPLE)) & ~HK_NEW_SAMPLE);
+}
+
+size_t HousekeepingPacker::maxPacketSize() const {
+    size_t bits = 0;
+    for(uint32_t i = 0; i < numOfParams; i++) bits += 2u + table[i].bits;
+    return HK_PACKET_HEADER_SIZE + (bits + 7) / 8;
+}
+
+size_t HousekeepingPacker::pack(uint8_t* buf, size_t maxLen) {
+    if(maxLen < HK_PACKET_HEADER_SIZE || (latestBuffer & HK_NEW_SAMPLE) == 0) return 0;
+    packBuffer              = static_cast<uint8_t>(exchangeBuffer(latestBuffer, packBuffer) & ~HK_NEW_SAMPLE);
+    uint8_t   buffer        = packBuffer;
+    bool      keyFrame      = !packing.delta || packetsSinceKeyFrame == 0;
+    HkBitWriter writer(buf + HK_PACKET_HEADER_SIZE, maxLen - HK_PACKET_HEADER_SIZE);
+    uint32_t  numOfSampled = 0;
+    uint32_t  unchanged    = 0; // run
+
+    for(uint32_t first = 0; first < numOfParams; first += table[first].groupSize) {
+        if(!table[first].sampled[buffer]) continue; // the whole group
+        uint32_t end = first + table[first].groupSize;
+        numOfSampled += table[first].groupSize;
+        if(keyFrame) {
+            for(uint32_t i = first; i < end; i++) {
+                writer.write(table[i].raw[buffer], table[i].bits);
+                table[i].sent = table[i].raw[buffer];
+            }
+            continue;
+        }
+        for(uint32_t i = first; i < end; i++) {
+            HkParameter& parameter = table[i];
+            uint32_t     raw       = parameter.raw[buffer];
+            if(raw == parameter.sent) {
+                if(packing.runLength) unchanged++;
+                else writer.write(0, 1);
+                continue;
+            }
+            if(unchanged > 0) {
+                writer.write(0, 1);
+                writer.writeRun(unchanged);
+                unchanged = 0;
+            }
+            uint64_t coded = zigzag(static_cast<int64_t>(raw) - static_cast<int64_t>(parameter.sent));
+            if(parameter.deltaBits > 0 && coded < (1ull << parameter.deltaBits)) {
+                writer.write(0x02, 2);
+                writer.write(static_cast<uint32_t>(coded), parameter.deltaBits);
+            } else { // does not fit in deltaBits: the absolute value
+                writer.write(0x03, 2);
+                writer.write(raw, parameter.bits);
+            }
+            parameter.sent = raw;
+        }
+    }
+    if(unchanged > 0) {
+        writer.write(0, 1);
+        writer.writeRun(unchanged);
+    }
+    size_t len = writer.finish();
+    if(writer.overflow) {
+        packetsSinceKeyFrame = 0; // the references are changed: the next one has to be a key frame
+        return 0;
+    }
+
+    uint16_tToBigEndian(buf, cachedLayoutId);
+    buf[2] = static_cast<uint8_t>((keyFrame ? HK_KEY_FRAME : 0) | (packing.runLength ? HK_RUN_LENGTH : 0));
+    buf[3] = HK_PACKET_VERSION;
+    uint32_tToBigEndian(buf + 4, bufferTick[buffer]);
+    uint16_tToBigEndian(buf + 8, sequenceNr++);
+    uint16_tToBigEndian(buf + 10, static_cast<uint16_t>(numOfSampled));
+    packetsSinceKeyFrame++;
+    if(packetsSinceKeyFrame >= packing.keyFrameInterval) packetsSinceKeyFrame = 0;
+    return HK_PACKET_HEADER_SIZE + len;
+}
+
+/*************** decoding *****************/
+
+HousekeepingDecoder::HousekeepingDecoder(const HkLayoutEntry* layout_, uint32_t numOfParams_, uint32_t* raw) {
+    layout          = layout_;
+    numOfParams     = numOfParams_;
+    layoutId        = housekeepingLayoutId(layout_, numOfParams_);
+    rawValues       = raw;
+    lastTick        = 0;
+    nextSequenceNr  = 0;
+    synchronized    = false;
+    decodedPackets  = 0;
+    rejectedPackets = 0;
+    for(uint32_t i = 0; i < numOfParams; i++) rawValues[i] = 0;
+}
+
+bool HousekeepingDecoder::decode(const uint8_t* packet, size_t len) {
+    if(len < HK_PACKET_HEADER_SIZE || bigEndianToUint16_t(packet) != layoutId || packet[3] != HK_PACKET_VERSION) {
+        rejectedPackets++;
+        return false;
+    }
+    bool     keyFrame    = (packet[2] & HK_KEY_FRAME) != 0;
+    bool     runLength   = (packet[2] & HK_RUN_LENGTH) != 0;
+    uint32_t tick        = bigEndianToUint32_t(packet + 4);
+    uint16_t sequenceNr  = bigEndianToUint16_t(packet + 8);
+    uint32_t numOfInside = bigEndianToUint16_t(packet + 10);
+    if(!keyFrame && (!synchronized || sequenceNr != nextSequenceNr)) { // the references are missing
+        synchronized = false;
+        rejectedPackets++;
+        return false;
+    }
+
+    HkBitReader reader(packet + HK_PACKET_HEADER_SIZE, len - HK_PACKET_HEADER_SIZE);
+    uint32_t  found     = 0;
+    uint32_t  unchanged = 0; // rest of a run
+    for(uint32_t i = 0; i < numOfParams && !reader.error; i++) {
+        const HkLayoutEntry& entry = layout[i];
+        if(tick % entry.divider != 0) continue;
+        found++;
+        if(keyFrame) {
+            rawValues[i] = reader.read(entry.bits);
+            continue;
+        }
+        if(unchanged > 0) {
+            unchanged--;
+            continue;
+        }
+        if(reader.read(1) == 0) {
+            if(runLength) unchanged = reader.readRun() - 1;
+            continue;
+        }
+        if(reader.read(1) == 0) {
+            rawValues[i] = static_cast<uint32_t>(rawValues[i] + unzigzag(reader.read(entry.deltaBits)));
+        } else {
+            rawValues[i] = reader.read(entry.bits);
+        }
+    }
+    if(reader.error || found != numOfInside || unchanged > 0) {
+        synchronized = false;
+        rejectedPackets++;
+        return false;
+    }
+    synchronized   = true;
+    nextSequenceNr = static_cast<uint16_t>(sequenceNr + 1);
+    lastTick       = tick;
+    decodedPackets++;
+    return true;
+}
+
+double HousekeepingDecoder::value(uint32_t index) const {
+    const HkLayoutEntry& entry = layout[index];
+    if(entry.type == FieldType::F32) return static_cast<double>(entry.minFloat) + rawValues[index] * static_cast<double>(entry.resolution);
+    return static_cast<double>(entry.min + rawValues[index]);
+}
+
+#ifndef NO_RODOS_NAMESPACE
+}
+#endif
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "content-filter.h" // FieldType
+#include "rodos-atomic.h"
+
+#ifndef NO_RODOS_NAMESPACE
+namespace RODOS {
+#endif
+
+/**
+ * @file housekeeping.h
+ * @date 2026/10/18
+ *
+ * @brief housekeeping parameters: sampled from a table, packed in bits, deltas and runs
+ *
+ * Each parameter is registered once: its variable, type, range (and the
+ * resolution of floats) and its rate (every divider-th sample). The range
+ * gives the number of bits of the raw value: raw = (value - min) / resolution,
+ * clamped to the range. sample() reads all parameters which are due in one
+ * pass over a compact table, pack() writes a packet of the latest sample.
+ * The samples are triple buffered: sample() (eg. in a high priority thread at
+ * the sampling rate) never waits for pack(), which may run in another thread
+ * (eg. the downlink); samples taken between two pack() are not sent.
+ * Parameters of the same type and rate registered one after the other form a
+ * group: a group which is not due is skipped as a whole, the others are read
+ * in a loop for their type. Register them in groups (all temperatures, then
+ * all voltages ...), one group per parameter costs a type switch each.
+ *
+ * Cost: the packing is paid in CPU time. 1000 parameters at mixed rates
+ * (benchmarks/housekeeping.cpp, Release, x86-64 host) take about 1.2 us to
+ * sample and 2.8 us to pack per tick, for 291 instead of 4000 bytes. Copying
+ * the same variables into a struct takes 0.2 us, and publishing the struct
+ * another 0.3 us. Where the downlink is not the bottleneck, the struct is
+ * cheaper. Only the sampling is paid in the sampling thread.
+ *
+ * Packet: 12 bytes header (big endian), then a bit stream (MSB first) of the
+ * parameters sampled at tick, in the order of registration:
+ *
+ *   uint16 layoutId     CRC of the layout, see getLayout()
+ *   uint8  flags        HK_KEY_FRAME, HK_RUN_LENGTH
+ *   uint8  version      HK_PACKET_VERSION
+ *   uint32 tick         number of the sample, parameter i is in it if tick % divider == 0
+ *   uint16 sequenceNr   of the packet
+ *   uint16 numOfParams  in this packet
+ *
+ *   key frame:   raw (bits) for each parameter
+ *   else:        0 + run      the next n parameters did not change, n exp-Golomb coded
+ *                             (bits(n) - 1 zeros, then n), without HK_RUN_LENGTH n = 1, no run
+ *                10 + delta   zigzag coded difference to the last sent value (deltaBits),
+ *                             if it fits, else raw
+ *                11 + raw     (bits)
+ *
+ * Ground tools get the layout from getLayout() (or printLayout()), and decode
+ * with it, like HousekeepingDecoder. Deltas refer to the last packet: after a
+ * lost packet the decoder waits for the next key frame.
+ */
+
+constexpr uint8_t  HK_PACKET_VERSION     = 1;
+constexpr size_t   HK_PACKET_HEADER_SIZE = 12;
+constexpr uint8_t  HK_KEY_FRAME          = 0x01;
+constexpr uint8_t  HK_RUN_LENGTH         = 0x02;
+constexpr uint8_t  HK_SAMPLE_BUFFERS     = 3; ///< sample() writes one, pack() reads one, one is the latest
+
+/// what ground needs to decode a parameter
+struct HkLayoutEntry {
+    uint16_t  id;
+    FieldType type;
+    uint8_t   bits;      ///< of the raw value
+    uint8_t   deltaBits; ///< 0: changes are sent raw
+    uint16_t  divider;
+    int64_t   min;        ///< integer parameters
+    float     minFloat;   ///< float parameters: value = minFloat + raw * resolution
+    float     resolution;
+};
+
+/// a registered parameter, the hot part first: one pass over these in sample()
+struct HkParameter {
+    const void* address;
+    uint32_t    raw[HK_SAMPLE_BUFFERS]; ///< sampled, one per buffer
+    uint32_t    sent;      ///< in the last packet, reference of the deltas
+    uint32_t    maxRaw;
+    uint16_t    countdown; ///< samples until it is due, of the first of a group
+    uint16_t    divider;
+    FieldType   type;
+    uint8_t     bits;
+    uint8_t     deltaBits;
+    bool        sampled[HK_SAMPLE_BUFFERS]; ///< in the sample of the buffer, of the first of a group
+    uint32_t    groupSize; ///< the first of a group: its parameters, else 0
+    int64_t     min;
+    float       minFloat;
+    float       inverseResolution;
+    float       resolution;
+    uint16_t    id;
+};
+
+struct HkPacking {
+    bool     delta            = true;
+    bool     runLength        = true;
+    uint16_t keyFrameInterval = 16; ///< every n-th packet has all values raw
+};
+
+class HousekeepingPacker {
+  public:
+    HousekeepingPacker(HkParameter* table, uint32_t capacity);
+
+    /// integer parameter, min <= value <= max. Sampled every divider-th time
+    bool add(uint16_t id, const uint8_t& variable, int64_t min, int64_t max, uint16_t divider = 1) { return addInteger(id, &variable, FieldType::U8, min, max, divider); }
+    bool add(uint16_t id, const int8_t& variable, int64_t min, int64_t max, uint16_t divider = 1) { return addInteger(id, &variable, FieldType::I8, min, max, divider); }
+    bool add(uint16_t id, const uint16_t& variable, int64_t min, int64_t max, uint16_t divider = 1) { return addInteger(id, &variable, FieldType::U16, min, max, divider); }
+    bool add(uint16_t id, const int16_t& variable, int64_t min, int64_t max, uint16_t divider = 1) { return addInteger(id, &variable, FieldType::I16, min, max, divider); }
+    bool add(uint16_t id, const uint32_t& variable, int64_t min, int64_t max, uint16_t divider = 1) { return addInteger(id, &variable, FieldType::U32, min, max, divider); }
+    bool add(uint16_t id, const int32_t& variable, int64_t min, int64_t max, uint16_t divider = 1) { return addInteger(id, &variable, FieldType::I32, min, max, divider); }
+    /// float parameter, min <= value <= max in steps of resolution
+    bool add(uint16_t id, const float& variable, float min, float max, float resolution, uint16_t divider = 1);
+
+    /// the next packet is a key frame
+    void setPacking(const HkPacking& packing_) {
+        packing              = packing_;
+        packetsSinceKeyFrame = 0;
+    }
+
+    /// reads the parameters which are due, the next tick. One thread, never waits for pack()
+    void sample();
+    /**
+     * Packet of the latest sample() into buf, one thread, may be another one than of sample().
+     * @return its length, 0 if there is no new sample or maxLen is too short (the next packet is a key frame then)
+     */
+    size_t pack(uint8_t* buf, size_t maxLen);
+    /// bytes pack() needs at most (all parameters raw)
+    size_t maxPacketSize() const;
+
+    uint32_t numOfParameters() const { return numOfParams; }
+    /// CRC of the layout, in each packet
+    uint16_t layoutId() const;
+    uint32_t getLayout(HkLayoutEntry* layout, uint32_t maxEntries) const;
+    /// the layout as text, one line per parameter, for ground tools
+    void printLayout() const;
+
+    uint32_t tick; ///< of the last sample(), the packets have the tick of their sample
+
+  private:
+    HkParameter* table;
+    uint32_t     capacity;
+    uint32_t     numOfParams;
+    HkPacking    packing;
+    uint16_t     sequenceNr;
+    uint16_t     packetsSinceKeyFrame;
+    uint16_t     cachedLayoutId;
+    bool         started; ///< the layout is fixed at the first sample()
+
+    uint32_t        bufferTick[HK_SAMPLE_BUFFERS];
+    uint8_t         sampleBuffer; ///< written by sample()
+    uint8_t         packBuffer;   ///< read by pack()
+    Atomic<uint8_t> latestBuffer; ///< the latest complete sample, | HK_NEW_SAMPLE until pack() takes it
+
+    bool         addInteger(uint16_t id, const void* address, FieldType type, int64_t min, int64_t max, uint16_t divider);
+    HkParameter* newParameter(uint16_t id, const void* address, FieldType type, uint32_t maxRaw, uint16_t divider);
+    void         layoutEntry(uint32_t index, HkLayoutEntry& entry) const;
+    void         findGroups();
+};
+
+/// table for up to MAX_PARAMETERS parameters
+template <uint32_t MAX_PARAMETERS>
+class Housekeeping : public HousekeepingPacker {
+    HkParameter parameters[MAX_PARAMETERS];
+
+  public:
+    Housekeeping() : HousekeepingPacker(parameters, MAX_PARAMETERS) {}
+};
+
+/// the id in the packets of a layout, see HousekeepingPacker::layoutId()
+uint16_t housekeepingLayoutId(const HkLayoutEntry* layout, uint32_t numOfParams);
+
+/// reference decoder of the packets, for ground tools and tests
+class HousekeepingDecoder {
+  public:
+    /// raw: one value per parameter of the layout
+    HousekeepingDecoder(const HkLayoutEntry* layout, uint32_t numOfParams, uint32_t* raw);
+
+    /// false: not of this layout, damaged, or a delta packet without the packet before
+    bool decode(const uint8_t* packet, size_t len);
+
+    uint32_t raw(uint32_t index) const { return rawValues[index]; }
+    /// engineering value of the last decoded raw value
+    double   value(uint32_t index) const;
+    /// parameter index was in the last decoded packet
+    bool     inLastPacket(uint32_t index) const { return lastTick % layout[index].divider == 0; }
+
+    uint32_t decodedPackets;
+    uint32_t rejectedPackets;
+
+  private:
+    const HkLayoutEntry* layout;
+    uint32_t             numOfParams;
+    uint16_t             layoutId;
+    uint32_t*            rawValues;
+    uint32_t             lastTick;
+    uint16_t             nextSequenceNr;
+    bool                 synchronized; ///< after a key frame, until a packet is lost
+};
+
+#ifndef NO_RODOS_NAMESPACE
+}
+#endif
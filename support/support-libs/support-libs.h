@@ -15,3 +15,4 @@
 #include "s3p-code.h"
 #include "s3p-synchronous-interface.h"
 #include "s3p-asynchronous-interface.h"
+#include "housekeeping.h"
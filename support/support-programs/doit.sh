@@ -18,3 +18,7 @@ cd telecommand-generator/
 doit.sh
 cd ..
 
+cd trace-converter/
+doit.sh
+cd ..
+
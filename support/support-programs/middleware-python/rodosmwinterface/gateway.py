@@ -73,7 +73,7 @@ class Gateway():
         # if receivedMsg.topicid >= 1000:
         # print("whats the size", size, receivedMsg.topicid)
         # print("size = ", size)
-        if size < 36:
+        if size < NetworkMessage.HEADER_SIZE:
             print("header broken")
             return
 
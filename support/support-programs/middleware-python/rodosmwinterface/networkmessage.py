@@ -15,22 +15,22 @@ ich habe byteorder probleme? Wenn ich eine Nachricht sende (header big endian),
 
 class NetworkMessage:
     """Type wich abstracts acces to encapsulated NetworkMessages, enabling easy parsing, formatting and subfield aware manipulation"""
-    HEADER_SIZE = 36
+    HEADER_SIZE = 40
     MAX_NETWORK_MESSAGE_LENGTH = 1300
 
-    PARSE_STRING_OG = "!iIhHHHiQII"
-    PARSE_STRING = "!iIhHHHiQII"  # BigEndian
-    PARSE_STRING_LE = "@iIhHHHiQII"  # LittleEndian
+    PARSE_STRING_OG = "!iIhHHHiQIII"
+    PARSE_STRING = "!iIhHHHiQIII"  # BigEndian
+    PARSE_STRING_LE = "@iIhHHHiQIII"  # LittleEndian
 
     def __init__(self, rawBytes=b"", BIGENDIAN_H=True):
         """
         Create new NetworkMessage
-        :param rawBytes: binary NetworkMessage, first 36bytes, are big-endian-byteorder header bytes, rest is little endian data
+        :param rawBytes: binary NetworkMessage, first 40bytes, are big-endian-byteorder header bytes, rest is little endian data
         """
 
         self.BIGENDIAN_P = BIGENDIAN_H
 
-        self.header = [0] * 10
+        self.header = [0] * 11
         self.userDataC = b""
         """userDataC Payload of NetworkMessage, no header, just bytes"""
 
@@ -55,6 +55,7 @@ class NetworkMessage:
         self._sentTime = 0
         self._senderThreadId = 0
         self._topicid = 0
+        self._sequenceNr = 0  # 0: not numbered, receivers do not check for duplicates
         pass
 
     def __repr__(self):
@@ -162,21 +163,22 @@ class NetworkMessage:
         inline int64_t  get_sentTime ()            const { return bigEndianToInt64_t(header +20); }
         inline uint32_t get_senderThreadId()       const { return bigEndianToUint32_t(header+28); }
         inline uint32_t get_topicId()              const { return bigEndianToUint32_t(header+32); } 
+        inline uint32_t get_sequenceNr()           const { return bigEndianToUint32_t(header+36); } // 0 -> not numbered
     """
 
     def parseHeader(self, BigEndian=True):
 
         parseString = ""
         if BigEndian:
-            parseString = "!iIhHHHiQII"
+            parseString = "!iIhHHHiQIII"
         else:
-            parseString = "@iIhHHHiQII"
-        # if len(self.rawmsg) < 36:
+            parseString = "@iIhHHHiQIII"
+        # if len(self.rawmsg) < 40:
         #     return
 
         """parse header of NetworkMessage and set values accordingly"""
-        self.rawHeader = self.rawMsg[:36]
-        unpacked = struct.unpack("!iIhHHHiQII", self.rawHeader)
+        self.rawHeader = self.rawMsg[:self.HEADER_SIZE]
+        unpacked = struct.unpack("!iIhHHHiQIII", self.rawHeader)
 
         self._receiverNode = unpacked[0]
         self._receiverNodeBitMap = unpacked[1]
@@ -188,9 +190,10 @@ class NetworkMessage:
         self._sentTime = unpacked[7]
         self._senderThreadId = unpacked[8]
         self._topicid = unpacked[9]
+        self._sequenceNr = unpacked[10]
 
         self.updateHeader()
-        self.userDataC = self.rawMsg[36:]
+        self.userDataC = self.rawMsg[self.HEADER_SIZE:]
 
     def updateHeader(self):
         self.header[0] = self._receiverNode
@@ -204,6 +207,7 @@ class NetworkMessage:
         self.header[7] = self._sentTime
         self.header[8] = self._senderThreadId
         self.header[9] = self._topicid
+        self.header[10] = self._sequenceNr
 
         self.rawHeader = struct.pack(self.PARSE_STRING, *(self.header))
 
@@ -212,7 +216,7 @@ class NetworkMessage:
         returns NetoworkMessage header and data as uint8 array here a python3-bytes-type
         Message Header will be encoded as Big-Endian
         """
-        if len(self.header) < 10:
+        if len(self.header) < 11:
             return b""
             #raise IndexError
         self.updateHeader()
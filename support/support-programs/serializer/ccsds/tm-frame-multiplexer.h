@@ -0,0 +1,390 @@
+#pragma once
+
+#include "rodos.h"
+#include "ccsds/ccsds-mission-defs.h"
+
+/**
+ * @file tm-frame-multiplexer.h
+ * @date 2026/10/18
+ *
+ * @brief downlink transfer frames (CCSDS 132.0-B), packets of several virtual channels
+ *
+ */
+
+namespace CCSDS {
+
+/*
+ * TmFrameMultiplexer: fixed length downlink transfer frames, each virtual channel
+ * with its own queue of frame buffers. Source packets are written directly into
+ * the frame buffers (no envelop, no copy), packets may continue in the next frame
+ * of their virtual channel (first header pointer). The downlink takes the frames
+ * in the order of the scheduling and gets idle frames if there is nothing to send.
+ *
+ * how to use:
+ *   TmFrameMultiplexer<> downlink(321); // spaceCraftId
+ *
+ *   // producers, one thread per virtual channel (or protect it)
+ *   PacketSlot slot = downlink.reservePacket(vcid, len);
+ *   if(slot.isContiguous()) serialize_your_packet_to(slot.part[0]);
+ *   else                    slot.write(0, packet, len); // it continues in the next frame
+ *   downlink.commitPacket(vcid);
+ *   downlink.flush(vcid); // optional: send the frame now, the rest is an idle packet
+ *
+ *   // downlink thread
+ *   const uint8_t* frame = downlink.nextFrame(); // always FRAME_LEN bytes
+ *   send(frame, downlink.FRAME_LEN);
+ *   downlink.releaseFrame();
+ *
+ * The header fields are written as bytes, not through the generated
+ * DownlinkTFHeader (same layout, see downlink-transferframe.bf). The frame
+ * counters, the CLCW and the CRC are set in nextFrame(), in the order of sending.
+ * No semaphores: the producer of a channel and the downlink share only two
+ * frame counters per channel (Atomic). Only one reservation per virtual channel may be open, it has to be committed
+ * (a packet which is not needed any more can be written as idle packet, APID 0x7ff).
+ */
+
+constexpr uint16_t TF_PRIMARY_HEADER_SIZE = 6;
+constexpr uint16_t TF_OCF_SIZE            = 4; ///< operational control field, the CLCW
+constexpr uint16_t TF_FECF_SIZE           = 2; ///< frame error control field, the CRC
+constexpr uint16_t FHP_NO_PACKET_START    = 0x7ff; ///< first header pointer: the frame only continues a packet
+constexpr uint16_t FHP_IDLE_FRAME         = 0x7fe; ///< first header pointer: only idle data
+constexpr uint16_t IDLE_APID              = 0x7ff;
+constexpr uint16_t MIN_IDLE_PACKET_LEN    = 7; ///< primary header and one byte
+
+enum class VcScheduling : uint8_t {
+    ROUND_ROBIN,    ///< one frame of each channel which has one
+    PRIORITY,       ///< the highest priority first, round robin between equal ones
+    BANDWIDTH_SHARE ///< frames in proportion to the shares (of the channels which have frames)
+};
+
+/// where to write a reserved packet: one part, or two if it continues in the next frame
+struct PacketSlot {
+    uint8_t* part[2]    = { 0, 0 };
+    uint16_t partLen[2] = { 0, 0 };
+
+    bool isValid() const { return part[0] != 0; }
+    bool isContiguous() const { return part[1] == 0; }
+
+    /// copies len bytes to position offset of the packet, across the frame boundary
+    void write(uint16_t offset, const void* data, uint16_t len) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for(uint16_t i = 0; i < len; i++) {
+            uint16_t pos = static_cast<uint16_t>(offset + i);
+            if(pos < partLen[0]) part[0][pos] = bytes[i];
+            else part[1][pos - partLen[0]] = bytes[i];
+        }
+    }
+};
+
+
+template <uint16_t FRAME_LEN_ = DOWNLINK_TF_LEN, uint8_t NUM_OF_VCS = 7, uint8_t FRAMES_PER_VC = 4>
+class TmFrameMultiplexer {
+  public:
+    static constexpr uint16_t FRAME_LEN   = FRAME_LEN_;
+    static constexpr uint8_t  IDLE_VCID   = 7; ///< the highest id (3 bits), not usable by the producers
+    static constexpr uint32_t SHARE_SCALE = 1u << 16;
+
+    static_assert(NUM_OF_VCS >= 1 && NUM_OF_VCS <= IDLE_VCID, "virtual channels 0..6, 7 carries the idle frames");
+    static_assert(FRAMES_PER_VC >= 2, "a packet may continue in the next frame");
+
+    struct VirtualChannelStatistics {
+        uint32_t packets;   ///< committed (producer)
+        uint32_t overflows; ///< reservations which did not fit into the free frame buffers (producer)
+        uint32_t frames;    ///< sent (downlink)
+    };
+
+    /**
+     * @param withClcw   operational control field (4 bytes) before the CRC, see setClcw()
+     * @param withCrc    frame error control field (2 bytes) at the end
+     */
+    TmFrameMultiplexer(uint16_t spaceCraftId_, bool withClcw = true, bool withCrc = true) {
+        spaceCraftId     = spaceCraftId_ & 0x3ff;
+        hasClcw          = withClcw;
+        hasCrc           = withCrc;
+        dataEnd          = static_cast<uint16_t>(FRAME_LEN - (withClcw ? TF_OCF_SIZE : 0) - (withCrc ? TF_FECF_SIZE : 0));
+        clcw             = 0x01000000; // COP in effect 01, like DownlinkEnvelop
+        scheduling       = VcScheduling::ROUND_ROBIN;
+        masterFrameCount = 0;
+        idleFrameCount   = 0;
+        lastServed       = NUM_OF_VCS - 1;
+        servedVc         = -1;
+        idleFrames       = 0;
+        for(VirtualChannel& vc : vcs) {
+            vc.opened      = 0;
+            vc.reserved    = false;
+            vc.ready       = 0;
+            vc.released    = 0;
+            vc.frameCount  = 0;
+            vc.priority    = 0;
+            vc.share       = 1;
+            vc.virtualTime = 0;
+            vc.statistics  = { 0, 0, 0 };
+        }
+        writeIdlePacket(idleFrame + TF_PRIMARY_HEADER_SIZE, dataFieldLen());
+    }
+
+    /// bytes for packets in each frame
+    uint16_t dataFieldLen() const { return static_cast<uint16_t>(dataEnd - TF_PRIMARY_HEADER_SIZE); }
+
+    void setScheduling(VcScheduling scheduling_) { scheduling = scheduling_; }
+    /// VcScheduling::PRIORITY, higher values first
+    void setPriority(uint8_t vcid, uint8_t priority) { if(vcid < NUM_OF_VCS) vcs[vcid].priority = priority; }
+    /// VcScheduling::BANDWIDTH_SHARE, eg. 3 and 1: 75% and 25% of the frames
+    void setShare(uint8_t vcid, uint16_t share) { if(vcid < NUM_OF_VCS) vcs[vcid].share = (share == 0) ? 1 : share; }
+    /// the command link control word for the next frames
+    void setClcw(uint32_t clcw_) { clcw = clcw_; }
+
+    /**
+     * Space for a packet of len bytes (headers included) in the frames of vcid.
+     * If it does not fit into the current frame, it continues in the next one.
+     * Invalid slot: len longer than a data field, or all frame buffers are in use.
+     */
+    PacketSlot reservePacket(uint8_t vcid, uint16_t len) {
+        PacketSlot slot;
+        if(vcid >= NUM_OF_VCS || len == 0 || len > dataFieldLen()) return slot;
+        VirtualChannel& vc = vcs[vcid];
+        if(vc.reserved) return slot;
+
+        if(!hasOpenFrame(vc) && !openFrame(vc)) {
+            vc.statistics.overflows++;
+            return slot;
+        }
+        Frame&   frame = lastFrame(vc);
+        uint16_t room  = static_cast<uint16_t>(dataEnd - frame.fill);
+        if(len > room && !hasFreeFrame(vc)) {
+            vc.statistics.overflows++;
+            return slot;
+        }
+        if(frame.firstHeader == FHP_NO_PACKET_START) frame.firstHeader = static_cast<uint16_t>(frame.fill - TF_PRIMARY_HEADER_SIZE);
+        slot        = take(vc, len);
+        vc.reserved = true;
+        return slot;
+    }
+
+    /// the reserved packet is written: full frames can be sent
+    void commitPacket(uint8_t vcid) {
+        if(vcid >= NUM_OF_VCS || !vcs[vcid].reserved) return;
+        VirtualChannel& vc = vcs[vcid];
+        vc.reserved        = false;
+        vc.statistics.packets++;
+        vc.ready = (lastFrame(vc).fill == dataEnd) ? vc.opened : vc.opened - 1;
+    }
+
+    /// copies the packet into the frames (if it is not written in place)
+    bool writePacket(uint8_t vcid, const void* packet, uint16_t len) {
+        PacketSlot slot = reservePacket(vcid, len);
+        if(!slot.isValid()) return false;
+        slot.write(0, packet, len);
+        commitPacket(vcid);
+        return true;
+    }
+
+    /**
+     * The current frame of vcid can be sent, the rest of its data field is an idle packet.
+     * If the rest is shorter than an idle packet, the idle packet continues in the next
+     * frame: false if there is no free frame buffer for it (try again later).
+     */
+    bool flush(uint8_t vcid) {
+        if(vcid >= NUM_OF_VCS) return false;
+        VirtualChannel& vc = vcs[vcid];
+        if(vc.reserved) return false;
+        if(!hasOpenFrame(vc) || lastFrame(vc).fill == TF_PRIMARY_HEADER_SIZE) return true; // nothing to send
+        Frame&   frame = lastFrame(vc);
+        uint16_t room  = static_cast<uint16_t>(dataEnd - frame.fill);
+        uint16_t len   = (room >= MIN_IDLE_PACKET_LEN) ? room : MIN_IDLE_PACKET_LEN;
+        if(len > room && !hasFreeFrame(vc)) return false;
+
+        if(frame.firstHeader == FHP_NO_PACKET_START) frame.firstHeader = static_cast<uint16_t>(frame.fill - TF_PRIMARY_HEADER_SIZE);
+        PacketSlot slot = take(vc, len);
+        if(slot.isContiguous()) {
+            writeIdlePacket(slot.part[0], len);
+        } else {
+            uint8_t idle[MIN_IDLE_PACKET_LEN];
+            writeIdlePacket(idle, len);
+            slot.write(0, idle, len);
+        }
+        vc.ready = (lastFrame(vc).fill == dataEnd) ? vc.opened : vc.opened - 1;
+        return true;
+    }
+
+    /**
+     * The next frame to send (FRAME_LEN bytes), selected by the scheduling, with
+     * header, CLCW and CRC. An idle frame if no channel has a full one.
+     * Valid until releaseFrame(). Only one thread may send (the downlink), the
+     * producers of the channels may run at the same time, without semaphores.
+     */
+    const uint8_t* nextFrame() {
+        servedVc = selectVc();
+        uint8_t* buf;
+        if(servedVc < 0) {
+            buf = idleFrame;
+            idleFrames++;
+            writeHeader(buf, IDLE_VCID, idleFrameCount++, FHP_IDLE_FRAME);
+        } else {
+            VirtualChannel& vc    = vcs[servedVc];
+            Frame&          frame = vc.frames[vc.released % FRAMES_PER_VC];
+            buf                   = frame.buf;
+            vc.statistics.frames++;
+            writeHeader(buf, static_cast<uint8_t>(servedVc), vc.frameCount++, frame.firstHeader);
+        }
+        writeTrailer(buf);
+        return buf;
+    }
+
+    /// the frame from nextFrame() is sent, its buffer is free again
+    void releaseFrame() {
+        if(servedVc < 0) return;
+        VirtualChannel& vc = vcs[servedVc];
+        vc.released        = vc.released + 1;
+        servedVc           = -1;
+    }
+
+    const VirtualChannelStatistics& getStatistics(uint8_t vcid) const { return vcs[vcid % NUM_OF_VCS].statistics; }
+    uint32_t idleFrames; ///< sent because no channel had a full frame
+
+  private:
+    struct Frame {
+        uint8_t  buf[FRAME_LEN];
+        uint16_t fill;        ///< next free byte
+        uint16_t firstHeader; ///< first header pointer
+    };
+
+    /**
+     * Frames are numbered (modulo FRAMES_PER_VC is the buffer): the producer opens
+     * and completes them (ready), the downlink releases them after sending.
+     */
+    struct VirtualChannel {
+        Frame frames[FRAMES_PER_VC];
+        // producer
+        uint32_t opened;
+        bool     reserved;
+        // producer writes, downlink reads
+        RODOS::Atomic<uint32_t> ready;
+        // downlink writes, producer reads
+        RODOS::Atomic<uint32_t> released;
+        // downlink
+        uint8_t  frameCount;
+        uint8_t  priority;
+        uint16_t share;
+        uint64_t virtualTime; ///< BANDWIDTH_SHARE: frames sent * SHARE_SCALE / share
+        VirtualChannelStatistics statistics;
+    };
+
+    VirtualChannel vcs[NUM_OF_VCS];
+    uint8_t        idleFrame[FRAME_LEN];
+    RODOS::CRC     crc;
+
+    uint16_t     spaceCraftId;
+    bool         hasClcw;
+    bool         hasCrc;
+    uint16_t     dataEnd; ///< first byte after the data field
+    RODOS::Atomic<uint32_t> clcw;
+    VcScheduling scheduling;
+    uint8_t      masterFrameCount;
+    uint8_t      idleFrameCount;
+    uint8_t      lastServed;
+    int32_t      servedVc; ///< from nextFrame(), -1: the idle frame
+
+    static bool   hasOpenFrame(const VirtualChannel& vc) { return vc.opened != vc.ready.load(); }
+    static bool   hasFreeFrame(const VirtualChannel& vc) { return vc.opened - vc.released.load() < FRAMES_PER_VC; }
+    static Frame& lastFrame(VirtualChannel& vc) { return vc.frames[(vc.opened - 1) % FRAMES_PER_VC]; }
+
+    bool openFrame(VirtualChannel& vc) {
+        if(!hasFreeFrame(vc)) return false;
+        vc.opened++;
+        Frame& frame      = lastFrame(vc);
+        frame.fill        = TF_PRIMARY_HEADER_SIZE;
+        frame.firstHeader = FHP_NO_PACKET_START;
+        return true;
+    }
+
+    /// len bytes from the open frame, the rest from a new one (checked by the caller)
+    PacketSlot take(VirtualChannel& vc, uint16_t len) {
+        PacketSlot slot;
+        Frame&     frame = lastFrame(vc);
+        uint16_t   room  = static_cast<uint16_t>(dataEnd - frame.fill);
+        slot.part[0]     = frame.buf + frame.fill;
+        slot.partLen[0]  = (len <= room) ? len : room;
+        frame.fill       = static_cast<uint16_t>(frame.fill + slot.partLen[0]);
+        if(len > room) {
+            openFrame(vc);
+            Frame& next     = lastFrame(vc);
+            slot.part[1]    = next.buf + TF_PRIMARY_HEADER_SIZE;
+            slot.partLen[1] = static_cast<uint16_t>(len - room);
+            next.fill       = static_cast<uint16_t>(next.fill + slot.partLen[1]);
+        }
+        return slot;
+    }
+
+    static void writeIdlePacket(uint8_t* packet, uint16_t len) {
+        packet[0] = static_cast<uint8_t>(IDLE_APID >> 8); // version 0, type 0, no secondary header
+        packet[1] = static_cast<uint8_t>(IDLE_APID & 0xff);
+        packet[2] = 0xc0; // no grouping, sequence count 0
+        packet[3] = 0;
+        packet[4] = static_cast<uint8_t>((len - MIN_IDLE_PACKET_LEN) >> 8);
+        packet[5] = static_cast<uint8_t>((len - MIN_IDLE_PACKET_LEN) & 0xff);
+        for(uint16_t i = 6; i < len; i++) packet[i] = 0x55;
+    }
+
+    /// version 0, spacecraft, vc, OCF flag, frame counters, no secondary header, segment length id 11, first header pointer
+    void writeHeader(uint8_t* buf, uint8_t vcid, uint8_t vcFrameCount, uint16_t firstHeader) {
+        buf[0] = static_cast<uint8_t>(spaceCraftId >> 4);
+        buf[1] = static_cast<uint8_t>(((spaceCraftId & 0x0f) << 4) | ((vcid & 0x07) << 1) | (hasClcw ? 1 : 0));
+        buf[2] = masterFrameCount++;
+        buf[3] = vcFrameCount;
+        buf[4] = static_cast<uint8_t>(0x18 | ((firstHeader >> 8) & 0x07));
+        buf[5] = static_cast<uint8_t>(firstHeader & 0xff);
+    }
+
+    void writeTrailer(uint8_t* buf) {
+        if(hasClcw) {
+            uint32_t word = clcw.load();
+            uint8_t* ocf  = buf + dataEnd;
+            ocf[0]        = static_cast<uint8_t>(word >> 24);
+            ocf[1]        = static_cast<uint8_t>(word >> 16);
+            ocf[2]        = static_cast<uint8_t>(word >> 8);
+            ocf[3]        = static_cast<uint8_t>(word);
+        }
+        if(hasCrc) {
+            uint16_t fecf      = crc.computeCRC(buf, FRAME_LEN - TF_FECF_SIZE, CRC_SEED);
+            buf[FRAME_LEN - 2] = static_cast<uint8_t>(fecf >> 8);
+            buf[FRAME_LEN - 1] = static_cast<uint8_t>(fecf & 0xff);
+        }
+    }
+
+    static bool hasReadyFrame(const VirtualChannel& vc) { return vc.released.load() != vc.ready.load(); }
+
+    /// -1: no channel has a frame to send
+    int32_t selectVc() {
+        int32_t  selected = -1;
+        uint64_t minTime  = 0;
+        for(uint8_t i = 1; i <= NUM_OF_VCS; i++) {
+            uint8_t         vcid = static_cast<uint8_t>((lastServed + i) % NUM_OF_VCS); // round robin from the last one
+            VirtualChannel& vc   = vcs[vcid];
+            if(!hasReadyFrame(vc)) continue;
+            if(selected < 0) {
+                selected = vcid;
+                minTime  = vc.virtualTime;
+                if(scheduling == VcScheduling::ROUND_ROBIN) break;
+                continue;
+            }
+            if(scheduling == VcScheduling::PRIORITY && vc.priority > vcs[selected].priority) selected = vcid;
+            if(scheduling == VcScheduling::BANDWIDTH_SHARE && vc.virtualTime < minTime) {
+                selected = vcid;
+                minTime  = vc.virtualTime;
+            }
+        }
+        if(selected < 0) return -1;
+
+        if(scheduling == VcScheduling::BANDWIDTH_SHARE) {
+            for(VirtualChannel& vc : vcs) { // channels without frames do not save up a share
+                if(!hasReadyFrame(vc) && vc.virtualTime < minTime) vc.virtualTime = minTime;
+            }
+            vcs[selected].virtualTime += SHARE_SCALE / vcs[selected].share;
+        }
+        lastServed = static_cast<uint8_t>(selected);
+        return selected;
+    }
+};
+
+} // namespace CCSDS
@@ -0,0 +1,720 @@
+
+
+//--- generated file, DO NOT modify
+//--- see telecommand-dispatcher.cpp
+#pragma once
+
+#warning GUI_NOP has the id of CMM_NOP, it is not dispatched
+#warning NAV_NOP has the id of GLB_NOP, it is not dispatched
+#warning PAY_NOP has the id of BOM_NOP, it is not dispatched
+namespace Common {
+
+#ifndef NO_RODOS_NAMESPACE
+using RODOS::bigEndianToInt16_t;
+using RODOS::bigEndianToUint16_t;
+using RODOS::bigEndianToInt32_t;
+using RODOS::bigEndianToUint32_t;
+using RODOS::bigEndianToInt64_t;
+using RODOS::bigEndianToUint64_t;
+using RODOS::bigEndianToFloat;
+using RODOS::bigEndianToDouble;
+#endif
+
+//____________________________________ zero copy views of the arguments, big endian
+
+struct XXX_SET_HISTORY_RATE_Args {
+    static const uint16_t LEN = 1;
+    const uint8_t* buf;
+    uint32_t       len;
+    int8_t         RATE()             const { return static_cast<int8_t>(buf[0]); } // cycles
+};
+
+struct XXX_SET_PARAM_Args {
+    static const uint16_t LEN = 5;
+    const uint8_t* buf;
+    uint32_t       len;
+    int8_t         INDEX()            const { return static_cast<int8_t>(buf[0]); } // index
+    int32_t        VALUE()            const { return bigEndianToInt32_t(buf + 1); } // undef
+};
+
+struct CMM_SET_VERBOSITY_Args {
+    static const uint16_t LEN = 1;
+    const uint8_t* buf;
+    uint32_t       len;
+    int8_t         VERBOSITY()        const { return static_cast<int8_t>(buf[0]); } // index
+};
+
+struct CMM_SET_MODE_Args {
+    static const uint16_t LEN = 1;
+    const uint8_t* buf;
+    uint32_t       len;
+    int8_t         MODE()             const { return static_cast<int8_t>(buf[0]); } // index
+};
+
+struct HKE_SET_RATE_Args {
+    static const uint16_t LEN = 1;
+    const uint8_t* buf;
+    uint32_t       len;
+    int8_t         RATE()             const { return static_cast<int8_t>(buf[0]); } // cycles
+};
+
+struct TMC_APPEND_TIME_TIMED_CMD_Args {
+    static const uint16_t MIN_LEN = 4;
+    const uint8_t* buf;
+    uint32_t       len;
+    int32_t        SECS()             const { return bigEndianToInt32_t(buf + 0); } // seconds
+    const char*    TTC_SP()           const { return reinterpret_cast<const char*>(buf + 4); } // sp, len - 4 bytes
+};
+
+struct BOM_JUMP_TO_BOOTIMAGE_Args {
+    static const uint16_t LEN = 1;
+    const uint8_t* buf;
+    uint32_t       len;
+    int8_t         INDEX()            const { return static_cast<int8_t>(buf[0]); } // index
+};
+
+struct BOM_REINIT_BOOT_LIST_Args {
+    static const uint16_t LEN = 3;
+    const uint8_t* buf;
+    uint32_t       len;
+    int8_t         INDEX()            const { return static_cast<int8_t>(buf[0]); } // index
+    int8_t         INDEX2()           const { return static_cast<int8_t>(buf[1]); } // index
+    int8_t         INDEX3()           const { return static_cast<int8_t>(buf[2]); } // index
+};
+
+struct BOM_APPEND_BOOT_IDYX_Args {
+    static const uint16_t LEN = 1;
+    const uint8_t* buf;
+    uint32_t       len;
+    int8_t         INDEX()            const { return static_cast<int8_t>(buf[0]); } // index
+};
+
+struct BOM_CHECK_BOOTIMAGE_Args {
+    static const uint16_t LEN = 1;
+    const uint8_t* buf;
+    uint32_t       len;
+    int8_t         INDEX()            const { return static_cast<int8_t>(buf[0]); } // index
+};
+
+struct POD_UNIT_ON_Args {
+    static const uint16_t LEN = 1;
+    const uint8_t* buf;
+    uint32_t       len;
+    int8_t         INDEX()            const { return static_cast<int8_t>(buf[0]); } // index
+};
+
+struct POD_UNIT_OFF_Args {
+    static const uint16_t LEN = 1;
+    const uint8_t* buf;
+    uint32_t       len;
+    int8_t         INDEX()            const { return static_cast<int8_t>(buf[0]); } // index
+};
+
+struct POD_SETCONF_BITMAP_Args {
+    static const uint16_t LEN = 16;
+    const uint8_t* buf;
+    uint32_t       len;
+    int32_t        BITMAP1()          const { return bigEndianToInt32_t(buf + 0); } // xx
+    int32_t        BITMAP2()          const { return bigEndianToInt32_t(buf + 4); } // xx
+    int32_t        BITMAP3()          const { return bigEndianToInt32_t(buf + 8); } // xx
+    int32_t        BITMAP4()          const { return bigEndianToInt32_t(buf + 12); } // xxx
+};
+
+struct POD_SET_RANGE_Args {
+    static const uint16_t LEN = 5;
+    const uint8_t* buf;
+    uint32_t       len;
+    int8_t         INDEX()            const { return static_cast<int8_t>(buf[0]); } // xx
+    int16_t        MIN()              const { return bigEndianToInt16_t(buf + 1); } // xxx
+    int16_t        MAX()              const { return bigEndianToInt16_t(buf + 3); } // xx
+};
+
+struct TER_HEATER_ON_Args {
+    static const uint16_t LEN = 1;
+    const uint8_t* buf;
+    uint32_t       len;
+    int8_t         INDEX()            const { return static_cast<int8_t>(buf[0]); } // index
+};
+
+struct TER_HEATER_OFF_Args {
+    static const uint16_t LEN = 1;
+    const uint8_t* buf;
+    uint32_t       len;
+    int8_t         INDEX()            const { return static_cast<int8_t>(buf[0]); } // index
+};
+
+struct TER_HEATPIPE_CNTRL_Args {
+    static const uint16_t LEN = 2;
+    const uint8_t* buf;
+    uint32_t       len;
+    int8_t         HP_CONDU1()        const { return static_cast<int8_t>(buf[0]); } // xx
+    int8_t         HP_CONDU2()        const { return static_cast<int8_t>(buf[1]); } // xx
+};
+
+struct TER_SET_RANGE_Args {
+    static const uint16_t LEN = 5;
+    const uint8_t* buf;
+    uint32_t       len;
+    int8_t         INDEX()            const { return static_cast<int8_t>(buf[0]); } // xx
+    int16_t        MIN()              const { return bigEndianToInt16_t(buf + 1); } // xx
+    int16_t        MAX()              const { return bigEndianToInt16_t(buf + 3); } // xx
+};
+
+struct RED_SEND_DUL_TO_OTHERNODE_Args {
+    static const uint16_t LEN = 4;
+    const uint8_t* buf;
+    uint32_t       len;
+    int32_t        LEN()              const { return bigEndianToInt32_t(buf + 0); } // bytes
+};
+
+struct RED_ACCEPT_DUL_OTHERNODE_Args {
+    static const uint16_t LEN = 4;
+    const uint8_t* buf;
+    uint32_t       len;
+    int32_t        LEN()              const { return bigEndianToInt32_t(buf + 0); } // bytes
+};
+
+struct TIM_SET_UTC_Args {
+    static const uint16_t LEN = 8;
+    const uint8_t* buf;
+    uint32_t       len;
+    int32_t        SECS()             const { return bigEndianToInt32_t(buf + 0); } // seconds
+    int32_t        MILLIS()           const { return bigEndianToInt32_t(buf + 4); } // milliseconds
+};
+
+struct TIM_SET_LEAP_Args {
+    static const uint16_t LEN = 4;
+    const uint8_t* buf;
+    uint32_t       len;
+    int32_t        SECS()             const { return bigEndianToInt32_t(buf + 0); } // seconds
+};
+
+struct TIM_SET_UTC_DELTA_Args {
+    static const uint16_t LEN = 8;
+    const uint8_t* buf;
+    uint32_t       len;
+    int32_t        SECS()             const { return bigEndianToInt32_t(buf + 0); } // seconds
+    int32_t        MILLIS()           const { return bigEndianToInt32_t(buf + 4); } // milliseconds
+};
+
+struct DWL_CONFIG_SBAND_Args {
+    static const uint16_t LEN = 4;
+    const uint8_t* buf;
+    uint32_t       len;
+    int32_t        UNKNOWN()          const { return bigEndianToInt32_t(buf + 0); } // xx
+};
+
+struct DWL_CONFIG_XBAND_Args {
+    static const uint16_t LEN = 4;
+    const uint8_t* buf;
+    uint32_t       len;
+    int32_t        UNKNOWN()          const { return bigEndianToInt32_t(buf + 0); } // xx
+};
+
+struct DWL_CONFIG_SBAND_RED_Args {
+    static const uint16_t LEN = 4;
+    const uint8_t* buf;
+    uint32_t       len;
+    int32_t        UNKNOWN()          const { return bigEndianToInt32_t(buf + 0); } // xx
+};
+
+struct DWL_CONFIG_XBAND_RED_Args {
+    static const uint16_t LEN = 4;
+    const uint8_t* buf;
+    uint32_t       len;
+    int32_t        UNKNOWN()          const { return bigEndianToInt32_t(buf + 0); } // xx
+};
+
+struct SFL_SET_MODE_Args {
+    static const uint16_t LEN = 1;
+    const uint8_t* buf;
+    uint32_t       len;
+    int8_t         NEW_MODE()         const { return static_cast<int8_t>(buf[0]); } // index
+};
+
+struct DUL_WRITE_SEGMENT_Args {
+    static const uint16_t LEN = 1;
+    const uint8_t* buf;
+    uint32_t       len;
+    int8_t         INDEX()            const { return static_cast<int8_t>(buf[0]); } // index
+};
+
+struct DUL_UPLOADBLOCK_Args {
+    static const uint16_t LEN = 8;
+    const uint8_t* buf;
+    uint32_t       len;
+    int16_t        ENTRY_NR()         const { return bigEndianToInt16_t(buf + 0); } // index
+    int16_t        BLK_LEN()          const { return bigEndianToInt16_t(buf + 2); } // bytes
+    int32_t        BLK_CR()           const { return bigEndianToInt32_t(buf + 4); } // crc
+};
+
+struct DUL_CHECK_UPLOAD_SEG_Args {
+    static const uint16_t LEN = 8;
+    const uint8_t* buf;
+    uint32_t       len;
+    int32_t        LEN()              const { return bigEndianToInt32_t(buf + 0); } // bytes
+    int32_t        EXPT_CRC()         const { return bigEndianToInt32_t(buf + 4); } // crc
+};
+
+struct SUR_SET_RANGES_Args {
+    static const uint16_t LEN = 5;
+    const uint8_t* buf;
+    uint32_t       len;
+    int8_t         INDEX()            const { return static_cast<int8_t>(buf[0]); } // index
+    int16_t        MIN()              const { return bigEndianToInt16_t(buf + 1); } // advalue
+    int16_t        MAX()              const { return bigEndianToInt16_t(buf + 3); } // advalue
+};
+
+struct ROV_SET_ANT_POS_Args {
+    static const uint16_t LEN = 4;
+    const uint8_t* buf;
+    uint32_t       len;
+    int32_t        ANT_ANGLE()        const { return bigEndianToInt32_t(buf + 0); } // degrees
+};
+
+struct ROV_CNTR_WHEEL_Args {
+    static const uint16_t LEN = 5;
+    const uint8_t* buf;
+    uint32_t       len;
+    int8_t         INDEX()            const { return static_cast<int8_t>(buf[0]); } // index
+    int16_t        ANGLE()            const { return bigEndianToInt16_t(buf + 1); } // degree
+    int16_t        SPEED()            const { return bigEndianToInt16_t(buf + 3); } // m/s
+};
+
+struct ROV_DRIVE_Args {
+    static const uint16_t LEN = 8;
+    const uint8_t* buf;
+    uint32_t       len;
+    int16_t        X_SPEED()          const { return bigEndianToInt16_t(buf + 0); } // m/s
+    int16_t        Y_SPEED()          const { return bigEndianToInt16_t(buf + 2); } // m/s
+    int16_t        ROT_SPEED()        const { return bigEndianToInt16_t(buf + 4); } // deg/se
+    int16_t        TIMOUT()           const { return bigEndianToInt16_t(buf + 6); } // ms
+};
+
+struct ATC_SET_ATC_MODE_Args {
+    static const uint16_t LEN = 1;
+    const uint8_t* buf;
+    uint32_t       len;
+    int8_t         ATC_MODE()         const { return static_cast<int8_t>(buf[0]); } // index
+};
+
+//____________________________________ dispatcher
+
+class TelecommandDispatcher {
+  public:
+    enum Result { DISPATCHED, UNKNOWN_COMMAND, WRONG_LENGTH };
+
+    static const uint32_t NUM_OF_COMMANDS = 120;
+    static const uint32_t NUM_OF_BUCKETS  = 60;
+
+    virtual ~TelecommandDispatcher() {}
+
+    /// finds the command (perfect hash), checks the length of the arguments and calls its handler
+    Result dispatch(uint16_t id, const uint8_t* args, uint32_t len);
+
+    /// index in the dense table, NUM_OF_COMMANDS if unknown
+    static uint32_t indexOf(uint16_t id);
+
+    /// handlers, to be overwritten
+    virtual void XXX_NOP() {}
+    virtual void XXX_SET_HISTORY_RATE([[gnu::unused]] const XXX_SET_HISTORY_RATE_Args& args) {}
+    virtual void XXX_SET_PARAM([[gnu::unused]] const XXX_SET_PARAM_Args& args) {}
+    virtual void XXX_CLEAR_VARS() {}
+    virtual void XXX_SEND_EXTENDTELEM() {}
+    virtual void XXX_WHICH_NEEDS_LONG_TIME() {}
+    virtual void TST_NOP() {}
+    virtual void GLB_NOP() {}
+    virtual void GLB_SEND_EXTENDED_TM() {}
+    virtual void CMM_NOP() {}
+    virtual void CMM_SET_VERBOSITY([[gnu::unused]] const CMM_SET_VERBOSITY_Args& args) {}
+    virtual void CMM_SET_IN_LEOP() {}
+    virtual void CMM_SET_OUT_OF_LEOP() {}
+    virtual void CMM_GOTOSAFEMODE() {}
+    virtual void CMM_SET_MODE([[gnu::unused]] const CMM_SET_MODE_Args& args) {}
+    virtual void CMD_NOP() {}
+    virtual void HKE_NOP() {}
+    virtual void HKE_SET_RATE([[gnu::unused]] const HKE_SET_RATE_Args& args) {}
+    virtual void HKE_START_DOWNLINK() {}
+    virtual void HKE_STOP_DOWNLINK() {}
+    virtual void TCM_NOP() {}
+    virtual void TCM_CLEAR_TT_LIST() {}
+    virtual void TCM_ACTIVATE_PENDING_CMDS() {}
+    virtual void TCM_DELETE_PENDING_CMDS() {}
+    virtual void TCM_SEND_TT_LIST() {}
+    virtual void TMC_APPEND_TIME_TIMED_CMD([[gnu::unused]] const TMC_APPEND_TIME_TIMED_CMD_Args& args) {}
+    virtual void ANM_NOP() {}
+    virtual void ANM_SEND_REPORT() {}
+    virtual void ANM_SEND_RINGBUFFER() {}
+    virtual void ANM_CLEAR_ERR_COUNTER() {}
+    virtual void BOM_NOP() {}
+    virtual void BOM_JUMP_TO_BOOTIMAGE([[gnu::unused]] const BOM_JUMP_TO_BOOTIMAGE_Args& args) {}
+    virtual void BOM_REINIT_BOOT_LIST([[gnu::unused]] const BOM_REINIT_BOOT_LIST_Args& args) {}
+    virtual void BOM_APPEND_BOOT_IDYX([[gnu::unused]] const BOM_APPEND_BOOT_IDYX_Args& args) {}
+    virtual void BOM_SEND_BOOTLIST() {}
+    virtual void BOM_REBOOT() {}
+    virtual void BOM_CHECK_BOOTIMAGE([[gnu::unused]] const BOM_CHECK_BOOTIMAGE_Args& args) {}
+    virtual void POD_NOP() {}
+    virtual void POD_ENABLE_CONTROL() {}
+    virtual void POD_DISABLE_CONTROL() {}
+    virtual void POD_UNIT_ON([[gnu::unused]] const POD_UNIT_ON_Args& args) {}
+    virtual void POD_UNIT_OFF([[gnu::unused]] const POD_UNIT_OFF_Args& args) {}
+    virtual void POD_SETCONF_BITMAP([[gnu::unused]] const POD_SETCONF_BITMAP_Args& args) {}
+    virtual void POD_SET_RANGE([[gnu::unused]] const POD_SET_RANGE_Args& args) {}
+    virtual void POD_SEND_PWR_SETTINGS() {}
+    virtual void TER_NOP() {}
+    virtual void TER_ENABLE_CONTROL() {}
+    virtual void TER_DISABLE_CONTROL() {}
+    virtual void TER_HEATER_ON([[gnu::unused]] const TER_HEATER_ON_Args& args) {}
+    virtual void TER_HEATER_OFF([[gnu::unused]] const TER_HEATER_OFF_Args& args) {}
+    virtual void TER_HEATPIPE_CNTRL([[gnu::unused]] const TER_HEATPIPE_CNTRL_Args& args) {}
+    virtual void TER_SET_RANGE([[gnu::unused]] const TER_SET_RANGE_Args& args) {}
+    virtual void RED_NOP() {}
+    virtual void RED_SEND_DUL_TO_OTHERNODE([[gnu::unused]] const RED_SEND_DUL_TO_OTHERNODE_Args& args) {}
+    virtual void RED_ACCEPT_DUL_OTHERNODE([[gnu::unused]] const RED_ACCEPT_DUL_OTHERNODE_Args& args) {}
+    virtual void RED_RESET_PINPOG_CNT() {}
+    virtual void RED_TOGGLE_WORKER_MONITOR() {}
+    virtual void RED_ENALBE_RECOVER_OTHER() {}
+    virtual void RED_DISABLE_RECOVER_OTHER() {}
+    virtual void WAT_NOP() {}
+    virtual void WAT_RESET_NODE() {}
+    virtual void WAT_NOT_ALLOW_RESET() {}
+    virtual void WAT_ALLOW_RESET() {}
+    virtual void TIM_NOP() {}
+    virtual void TIM_SET_UTC([[gnu::unused]] const TIM_SET_UTC_Args& args) {}
+    virtual void TIM_SET_LEAP([[gnu::unused]] const TIM_SET_LEAP_Args& args) {}
+    virtual void TIM_SET_UTC_DELTA([[gnu::unused]] const TIM_SET_UTC_DELTA_Args& args) {}
+    virtual void TIM_ENABLE_DISTR_UTC() {}
+    virtual void TIM_DISABLE_DISTR_UTC() {}
+    virtual void TIM_ENABLE_1PPS_SYNC() {}
+    virtual void TIM_DISABLE_1PPS_SYNC() {}
+    virtual void TIM_SET_CLOCK_DRIFT() {}
+    virtual void TIM_SEND_TIMEMODEL() {}
+    virtual void DWL_NOP() {}
+    virtual void DWL_SET_LOW_RATE() {}
+    virtual void DWL_SET_HI_RATE() {}
+    virtual void DWL_START_SBAND() {}
+    virtual void DWL_STOP_SBAND() {}
+    virtual void DWL_START_XBAND() {}
+    virtual void DWL_STOP_XBAND() {}
+    virtual void DWL_CONFIG_SBAND([[gnu::unused]] const DWL_CONFIG_SBAND_Args& args) {}
+    virtual void DWL_CONFIG_XBAND([[gnu::unused]] const DWL_CONFIG_XBAND_Args& args) {}
+    virtual void DWL_CONFIG_SBAND_RED([[gnu::unused]] const DWL_CONFIG_SBAND_RED_Args& args) {}
+    virtual void DWL_CONFIG_XBAND_RED([[gnu::unused]] const DWL_CONFIG_XBAND_RED_Args& args) {}
+    virtual void SFL_NOP() {}
+    virtual void SFL_GOTOSAFEMODE() {}
+    virtual void SFL_SET_MODE([[gnu::unused]] const SFL_SET_MODE_Args& args) {}
+    virtual void SFL_SEND_SFLIST() {}
+    virtual void SFL_UPLOADLST() {}
+    virtual void SFL_NEXT_START_IN_LEOP() {}
+    virtual void SFL_OUT_OF_LEOP() {}
+    virtual void SFL_REQUEST_STARTLIST() {}
+    virtual void DUL_NOP() {}
+    virtual void DUL_RESET_DUL_PROTOCOL() {}
+    virtual void DUL_DISTRIBUTE_DATA() {}
+    virtual void DUL_WRITE_SEGMENT([[gnu::unused]] const DUL_WRITE_SEGMENT_Args& args) {}
+    virtual void DUL_UPLOADBLOCK([[gnu::unused]] const DUL_UPLOADBLOCK_Args& args) {}
+    virtual void DUL_CHECK_UPLOAD_SEG([[gnu::unused]] const DUL_CHECK_UPLOAD_SEG_Args& args) {}
+    virtual void SUR_NOP() {}
+    virtual void SUR_SET_RANGES([[gnu::unused]] const SUR_SET_RANGES_Args& args) {}
+    virtual void SUR_ENABLE_THREAD_CHECK() {}
+    virtual void SUR_DISABLE_THREAD_CHECK() {}
+    virtual void SUR_ENABLE_MEM_CHECK() {}
+    virtual void SUR_DISABLE_MEM_CHECK() {}
+    virtual void SUR_SEND_ANALOGVALS() {}
+    virtual void SUR_ENABLE_LATCHUPPROT() {}
+    virtual void SUR_DISABLE_LATCHUPPROT() {}
+    virtual void ROV_NOP() {}
+    virtual void ROV_SEND_EXTENDED_TM() {}
+    virtual void ROV_START_ANT_SCAN() {}
+    virtual void ROV_STOP_ANT_SCAN() {}
+    virtual void ROV_SET_ANT_POS([[gnu::unused]] const ROV_SET_ANT_POS_Args& args) {}
+    virtual void ROV_STOP() {}
+    virtual void ROV_CNTR_WHEEL([[gnu::unused]] const ROV_CNTR_WHEEL_Args& args) {}
+    virtual void ROV_DRIVE([[gnu::unused]] const ROV_DRIVE_Args& args) {}
+    virtual void ATC_NOP() {}
+    virtual void ATC_SET_ATC_MODE([[gnu::unused]] const ATC_SET_ATC_MODE_Args& args) {}
+    virtual void ATC_GOTO_ATC_SAFEMODE() {}
+    virtual void ATC_GOTO_ATC_SUSPENMODE() {}
+    virtual void LND_NOP() {}
+
+  private:
+    struct Entry {
+        uint16_t id;
+        uint16_t argsLen;
+        bool     variableLen;
+    };
+    static inline uint32_t hash(uint32_t key, uint32_t seed) {
+        uint32_t h = (key ^ seed) * 0x9E3779B1u;
+        return h ^ (h >> 15);
+    }
+    static const Entry* entries();
+};
+
+inline const TelecommandDispatcher::Entry* TelecommandDispatcher::entries() {
+    static const Entry table[NUM_OF_COMMANDS] = {
+        { 0x7e05,   0, false }, // RED_TOGGLE_WORKER_MONITOR
+        { 0x0e03,   0, false }, // DUL_DISTRIBUTE_DATA
+        { 0x0301,   0, false }, // HKE_NOP
+        { 0x0d06,   4, true  }, // TMC_APPEND_TIME_TIMED_CMD
+        { 0x7e04,   0, false }, // RED_RESET_PINPOG_CNT
+        { 0x6b03,   0, false }, // WAT_NOT_ALLOW_RESET
+        { 0x0908,   0, false }, // TIM_DISABLE_1PPS_SYNC
+        { 0x6f01,   0, false }, // DWL_NOP
+        { 0x0905,   0, false }, // TIM_ENABLE_DISTR_UTC
+        { 0x6f03,   0, false }, // DWL_SET_HI_RATE
+        { 0x7e03,   4, false }, // RED_ACCEPT_DUL_OTHERNODE
+        { 0x7507,   0, false }, // SUR_SEND_ANALOGVALS
+        { 0x0903,   4, false }, // TIM_SET_LEAP
+        { 0x7d04,   1, false }, // TER_HEATER_ON
+        { 0x7404,   0, false }, // ANM_SEND_RINGBUFFER
+        { 0x7b05,   0, false }, // BOM_SEND_BOOTLIST
+        { 0x7e06,   0, false }, // RED_ENALBE_RECOVER_OTHER
+        { 0x7205,   0, false }, // SFL_UPLOADLST
+        { 0x7506,   0, false }, // SUR_DISABLE_MEM_CHECK
+        { 0x7c03,   0, false }, // POD_DISABLE_CONTROL
+        { 0x7208,   0, false }, // SFL_REQUEST_STARTLIST
+        { 0x7d03,   0, false }, // TER_DISABLE_CONTROL
+        { 0x7d07,   5, false }, // TER_SET_RANGE
+        { 0x7401,   0, false }, // ANM_NOP
+        { 0x6e03,   5, false }, // XXX_SET_PARAM
+        { 0x7801,   0, false }, // GLB_NOP
+        { 0x1204,   0, false }, // TCM_DELETE_PENDING_CMDS
+        { 0x7504,   0, false }, // SUR_DISABLE_THREAD_CHECK
+        { 0x7207,   0, false }, // SFL_OUT_OF_LEOP
+        { 0x7d01,   0, false }, // TER_NOP
+        { 0x0e02,   0, false }, // DUL_RESET_DUL_PROTOCOL
+        { 0x7b06,   0, false }, // BOM_REBOOT
+        { 0x7402,   0, false }, // ANM_SEND_REPORT
+        { 0x6b01,   0, false }, // WAT_NOP
+        { 0x0101,   0, false }, // CMD_NOP
+        { 0x6e05,   0, false }, // XXX_SEND_EXTENDTELEM
+        { 0x7902,   1, false }, // CMM_SET_VERBOSITY
+        { 0x7202,   0, false }, // SFL_GOTOSAFEMODE
+        { 0x0e06,   8, false }, // DUL_CHECK_UPLOAD_SEG
+        { 0x0304,   0, false }, // HKE_STOP_DOWNLINK
+        { 0x1205,   0, false }, // TCM_SEND_TT_LIST
+        { 0x7606,   0, false }, // ROV_STOP
+        { 0x7502,   5, false }, // SUR_SET_RANGES
+        { 0x7509,   0, false }, // SUR_DISABLE_LATCHUPPROT
+        { 0x7903,   0, false }, // CMM_SET_IN_LEOP
+        { 0x7e01,   0, false }, // RED_NOP
+        { 0x7608,   8, false }, // ROV_DRIVE
+        { 0x7b02,   1, false }, // BOM_JUMP_TO_BOOTIMAGE
+        { 0x0e01,   0, false }, // DUL_NOP
+        { 0x7901,   0, false }, // CMM_NOP
+        { 0x6e06,   0, false }, // XXX_WHICH_NEEDS_LONG_TIME
+        { 0x7604,   0, false }, // ROV_STOP_ANT_SCAN
+        { 0x1203,   0, false }, // TCM_ACTIVATE_PENDING_CMDS
+        { 0x7e07,   0, false }, // RED_DISABLE_RECOVER_OTHER
+        { 0x0902,   8, false }, // TIM_SET_UTC
+        { 0x6f07,   0, false }, // DWL_STOP_XBAND
+        { 0x0e05,   8, false }, // DUL_UPLOADBLOCK
+        { 0x0906,   0, false }, // TIM_DISABLE_DISTR_UTC
+        { 0x7c08,   0, false }, // POD_SEND_PWR_SETTINGS
+        { 0x6f0b,   4, false }, // DWL_CONFIG_XBAND_RED
+        { 0x7d02,   0, false }, // TER_ENABLE_CONTROL
+        { 0x7b03,   3, false }, // BOM_REINIT_BOOT_LIST
+        { 0x6e01,   0, false }, // XXX_NOP
+        { 0x7601,   0, false }, // ROV_NOP
+        { 0x7802,   0, false }, // GLB_SEND_EXTENDED_TM
+        { 0x1101,   0, false }, // TST_NOP
+        { 0x7701,   0, false }, // ATC_NOP
+        { 0x7505,   0, false }, // SUR_ENABLE_MEM_CHECK
+        { 0x7b07,   1, false }, // BOM_CHECK_BOOTIMAGE
+        { 0x7905,   0, false }, // CMM_GOTOSAFEMODE
+        { 0x7d06,   2, false }, // TER_HEATPIPE_CNTRL
+        { 0x7b01,   0, false }, // BOM_NOP
+        { 0x0901,   0, false }, // TIM_NOP
+        { 0x7602,   0, false }, // ROV_SEND_EXTENDED_TM
+        { 0x1202,   0, false }, // TCM_CLEAR_TT_LIST
+        { 0x7c01,   0, false }, // POD_NOP
+        { 0x0303,   0, false }, // HKE_START_DOWNLINK
+        { 0x6f09,   4, false }, // DWL_CONFIG_XBAND
+        { 0x7607,   5, false }, // ROV_CNTR_WHEEL
+        { 0x6f08,   4, false }, // DWL_CONFIG_SBAND
+        { 0x7704,   0, false }, // ATC_GOTO_ATC_SUSPENMODE
+        { 0x0904,   8, false }, // TIM_SET_UTC_DELTA
+        { 0x7c04,   1, false }, // POD_UNIT_ON
+        { 0x7c05,   1, false }, // POD_UNIT_OFF
+        { 0x7206,   0, false }, // SFL_NEXT_START_IN_LEOP
+        { 0x7501,   0, false }, // SUR_NOP
+        { 0x6b04,   0, false }, // WAT_ALLOW_RESET
+        { 0x6f05,   0, false }, // DWL_STOP_SBAND
+        { 0x7e02,   4, false }, // RED_SEND_DUL_TO_OTHERNODE
+        { 0x7503,   0, false }, // SUR_ENABLE_THREAD_CHECK
+        { 0x7508,   0, false }, // SUR_ENABLE_LATCHUPPROT
+        { 0x7c02,   0, false }, // POD_ENABLE_CONTROL
+        { 0x7a01,   0, false }, // LND_NOP
+        { 0x7703,   0, false }, // ATC_GOTO_ATC_SAFEMODE
+        { 0x6f0a,   4, false }, // DWL_CONFIG_SBAND_RED
+        { 0x7702,   1, false }, // ATC_SET_ATC_MODE
+        { 0x7204,   0, false }, // SFL_SEND_SFLIST
+        { 0x7201,   0, false }, // SFL_NOP
+        { 0x7c06,  16, false }, // POD_SETCONF_BITMAP
+        { 0x6e02,   1, false }, // XXX_SET_HISTORY_RATE
+        { 0x7d05,   1, false }, // TER_HEATER_OFF
+        { 0x7203,   1, false }, // SFL_SET_MODE
+        { 0x7605,   4, false }, // ROV_SET_ANT_POS
+        { 0x7b04,   1, false }, // BOM_APPEND_BOOT_IDYX
+        { 0x7c07,   5, false }, // POD_SET_RANGE
+        { 0x090a,   0, false }, // TIM_SEND_TIMEMODEL
+        { 0x0302,   1, false }, // HKE_SET_RATE
+        { 0x6e04,   0, false }, // XXX_CLEAR_VARS
+        { 0x7906,   1, false }, // CMM_SET_MODE
+        { 0x0907,   0, false }, // TIM_ENABLE_1PPS_SYNC
+        { 0x6f04,   0, false }, // DWL_START_SBAND
+        { 0x7904,   0, false }, // CMM_SET_OUT_OF_LEOP
+        { 0x7603,   0, false }, // ROV_START_ANT_SCAN
+        { 0x6f06,   0, false }, // DWL_START_XBAND
+        { 0x0909,   0, false }, // TIM_SET_CLOCK_DRIFT
+        { 0x7405,   0, false }, // ANM_CLEAR_ERR_COUNTER
+        { 0x1201,   0, false }, // TCM_NOP
+        { 0x6b02,   0, false }, // WAT_RESET_NODE
+        { 0x0e04,   1, false }, // DUL_WRITE_SEGMENT
+        { 0x6f02,   0, false }, // DWL_SET_LOW_RATE
+    };
+    return table;
+}
+
+inline uint32_t TelecommandDispatcher::indexOf(uint16_t id) {
+    static const uint32_t displacement[NUM_OF_BUCKETS] = {
+        7, 0, 8, 8, 4, 6, 19, 36, 11, 8, 34, 26, 2, 7, 4, 1,
+        27, 4, 29, 10, 1, 16, 12, 28, 16, 49, 3, 8, 0, 17, 95, 30,
+        21, 64, 0, 0, 11, 24, 64, 13, 32, 0, 5, 1, 82, 34, 64, 51,
+        0, 37, 105, 7, 0, 0, 0, 41, 1, 5, 358, 10 };
+    uint32_t index = hash(id, displacement[hash(id, 0) % NUM_OF_BUCKETS]) % NUM_OF_COMMANDS;
+    return (entries()[index].id == id) ? index : NUM_OF_COMMANDS;
+}
+
+inline TelecommandDispatcher::Result TelecommandDispatcher::dispatch(uint16_t id, const uint8_t* args, uint32_t len) {
+    uint32_t index = indexOf(id);
+    if(index == NUM_OF_COMMANDS) return UNKNOWN_COMMAND;
+    const Entry& entry = entries()[index];
+    if(entry.variableLen ? (len < entry.argsLen) : (len != entry.argsLen)) return WRONG_LENGTH;
+    switch(index) { // dense: a jump table
+        case    0: RED_TOGGLE_WORKER_MONITOR(); break;
+        case    1: DUL_DISTRIBUTE_DATA(); break;
+        case    2: HKE_NOP(); break;
+        case    3: TMC_APPEND_TIME_TIMED_CMD(TMC_APPEND_TIME_TIMED_CMD_Args{ args, len }); break;
+        case    4: RED_RESET_PINPOG_CNT(); break;
+        case    5: WAT_NOT_ALLOW_RESET(); break;
+        case    6: TIM_DISABLE_1PPS_SYNC(); break;
+        case    7: DWL_NOP(); break;
+        case    8: TIM_ENABLE_DISTR_UTC(); break;
+        case    9: DWL_SET_HI_RATE(); break;
+        case   10: RED_ACCEPT_DUL_OTHERNODE(RED_ACCEPT_DUL_OTHERNODE_Args{ args, len }); break;
+        case   11: SUR_SEND_ANALOGVALS(); break;
+        case   12: TIM_SET_LEAP(TIM_SET_LEAP_Args{ args, len }); break;
+        case   13: TER_HEATER_ON(TER_HEATER_ON_Args{ args, len }); break;
+        case   14: ANM_SEND_RINGBUFFER(); break;
+        case   15: BOM_SEND_BOOTLIST(); break;
+        case   16: RED_ENALBE_RECOVER_OTHER(); break;
+        case   17: SFL_UPLOADLST(); break;
+        case   18: SUR_DISABLE_MEM_CHECK(); break;
+        case   19: POD_DISABLE_CONTROL(); break;
+        case   20: SFL_REQUEST_STARTLIST(); break;
+        case   21: TER_DISABLE_CONTROL(); break;
+        case   22: TER_SET_RANGE(TER_SET_RANGE_Args{ args, len }); break;
+        case   23: ANM_NOP(); break;
+        case   24: XXX_SET_PARAM(XXX_SET_PARAM_Args{ args, len }); break;
+        case   25: GLB_NOP(); break;
+        case   26: TCM_DELETE_PENDING_CMDS(); break;
+        case   27: SUR_DISABLE_THREAD_CHECK(); break;
+        case   28: SFL_OUT_OF_LEOP(); break;
+        case   29: TER_NOP(); break;
+        case   30: DUL_RESET_DUL_PROTOCOL(); break;
+        case   31: BOM_REBOOT(); break;
+        case   32: ANM_SEND_REPORT(); break;
+        case   33: WAT_NOP(); break;
+        case   34: CMD_NOP(); break;
+        case   35: XXX_SEND_EXTENDTELEM(); break;
+        case   36: CMM_SET_VERBOSITY(CMM_SET_VERBOSITY_Args{ args, len }); break;
+        case   37: SFL_GOTOSAFEMODE(); break;
+        case   38: DUL_CHECK_UPLOAD_SEG(DUL_CHECK_UPLOAD_SEG_Args{ args, len }); break;
+        case   39: HKE_STOP_DOWNLINK(); break;
+        case   40: TCM_SEND_TT_LIST(); break;
+        case   41: ROV_STOP(); break;
+        case   42: SUR_SET_RANGES(SUR_SET_RANGES_Args{ args, len }); break;
+        case   43: SUR_DISABLE_LATCHUPPROT(); break;
+        case   44: CMM_SET_IN_LEOP(); break;
+        case   45: RED_NOP(); break;
+        case   46: ROV_DRIVE(ROV_DRIVE_Args{ args, len }); break;
+        case   47: BOM_JUMP_TO_BOOTIMAGE(BOM_JUMP_TO_BOOTIMAGE_Args{ args, len }); break;
+        case   48: DUL_NOP(); break;
+        case   49: CMM_NOP(); break;
+        case   50: XXX_WHICH_NEEDS_LONG_TIME(); break;
+        case   51: ROV_STOP_ANT_SCAN(); break;
+        case   52: TCM_ACTIVATE_PENDING_CMDS(); break;
+        case   53: RED_DISABLE_RECOVER_OTHER(); break;
+        case   54: TIM_SET_UTC(TIM_SET_UTC_Args{ args, len }); break;
+        case   55: DWL_STOP_XBAND(); break;
+        case   56: DUL_UPLOADBLOCK(DUL_UPLOADBLOCK_Args{ args, len }); break;
+        case   57: TIM_DISABLE_DISTR_UTC(); break;
+        case   58: POD_SEND_PWR_SETTINGS(); break;
+        case   59: DWL_CONFIG_XBAND_RED(DWL_CONFIG_XBAND_RED_Args{ args, len }); break;
+        case   60: TER_ENABLE_CONTROL(); break;
+        case   61: BOM_REINIT_BOOT_LIST(BOM_REINIT_BOOT_LIST_Args{ args, len }); break;
+        case   62: XXX_NOP(); break;
+        case   63: ROV_NOP(); break;
+        case   64: GLB_SEND_EXTENDED_TM(); break;
+        case   65: TST_NOP(); break;
+        case   66: ATC_NOP(); break;
+        case   67: SUR_ENABLE_MEM_CHECK(); break;
+        case   68: BOM_CHECK_BOOTIMAGE(BOM_CHECK_BOOTIMAGE_Args{ args, len }); break;
+        case   69: CMM_GOTOSAFEMODE(); break;
+        case   70: TER_HEATPIPE_CNTRL(TER_HEATPIPE_CNTRL_Args{ args, len }); break;
+        case   71: BOM_NOP(); break;
+        case   72: TIM_NOP(); break;
+        case   73: ROV_SEND_EXTENDED_TM(); break;
+        case   74: TCM_CLEAR_TT_LIST(); break;
+        case   75: POD_NOP(); break;
+        case   76: HKE_START_DOWNLINK(); break;
+        case   77: DWL_CONFIG_XBAND(DWL_CONFIG_XBAND_Args{ args, len }); break;
+        case   78: ROV_CNTR_WHEEL(ROV_CNTR_WHEEL_Args{ args, len }); break;
+        case   79: DWL_CONFIG_SBAND(DWL_CONFIG_SBAND_Args{ args, len }); break;
+        case   80: ATC_GOTO_ATC_SUSPENMODE(); break;
+        case   81: TIM_SET_UTC_DELTA(TIM_SET_UTC_DELTA_Args{ args, len }); break;
+        case   82: POD_UNIT_ON(POD_UNIT_ON_Args{ args, len }); break;
+        case   83: POD_UNIT_OFF(POD_UNIT_OFF_Args{ args, len }); break;
+        case   84: SFL_NEXT_START_IN_LEOP(); break;
+        case   85: SUR_NOP(); break;
+        case   86: WAT_ALLOW_RESET(); break;
+        case   87: DWL_STOP_SBAND(); break;
+        case   88: RED_SEND_DUL_TO_OTHERNODE(RED_SEND_DUL_TO_OTHERNODE_Args{ args, len }); break;
+        case   89: SUR_ENABLE_THREAD_CHECK(); break;
+        case   90: SUR_ENABLE_LATCHUPPROT(); break;
+        case   91: POD_ENABLE_CONTROL(); break;
+        case   92: LND_NOP(); break;
+        case   93: ATC_GOTO_ATC_SAFEMODE(); break;
+        case   94: DWL_CONFIG_SBAND_RED(DWL_CONFIG_SBAND_RED_Args{ args, len }); break;
+        case   95: ATC_SET_ATC_MODE(ATC_SET_ATC_MODE_Args{ args, len }); break;
+        case   96: SFL_SEND_SFLIST(); break;
+        case   97: SFL_NOP(); break;
+        case   98: POD_SETCONF_BITMAP(POD_SETCONF_BITMAP_Args{ args, len }); break;
+        case   99: XXX_SET_HISTORY_RATE(XXX_SET_HISTORY_RATE_Args{ args, len }); break;
+        case  100: TER_HEATER_OFF(TER_HEATER_OFF_Args{ args, len }); break;
+        case  101: SFL_SET_MODE(SFL_SET_MODE_Args{ args, len }); break;
+        case  102: ROV_SET_ANT_POS(ROV_SET_ANT_POS_Args{ args, len }); break;
+        case  103: BOM_APPEND_BOOT_IDYX(BOM_APPEND_BOOT_IDYX_Args{ args, len }); break;
+        case  104: POD_SET_RANGE(POD_SET_RANGE_Args{ args, len }); break;
+        case  105: TIM_SEND_TIMEMODEL(); break;
+        case  106: HKE_SET_RATE(HKE_SET_RATE_Args{ args, len }); break;
+        case  107: XXX_CLEAR_VARS(); break;
+        case  108: CMM_SET_MODE(CMM_SET_MODE_Args{ args, len }); break;
+        case  109: TIM_ENABLE_1PPS_SYNC(); break;
+        case  110: DWL_START_SBAND(); break;
+        case  111: CMM_SET_OUT_OF_LEOP(); break;
+        case  112: ROV_START_ANT_SCAN(); break;
+        case  113: DWL_START_XBAND(); break;
+        case  114: TIM_SET_CLOCK_DRIFT(); break;
+        case  115: ANM_CLEAR_ERR_COUNTER(); break;
+        case  116: TCM_NOP(); break;
+        case  117: WAT_RESET_NODE(); break;
+        case  118: DUL_WRITE_SEGMENT(DUL_WRITE_SEGMENT_Args{ args, len }); break;
+        case  119: DWL_SET_LOW_RATE(); break;
+        default: break;
+    }
+    return DISPATCHED;
+}
+
+} // namespace
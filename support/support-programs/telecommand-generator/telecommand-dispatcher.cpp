@@ -0,0 +1,280 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include "stdint.h"
+#include "string.h"
+
+#include "telecommand-types.h"
+
+// Reads from stdin definition of telecommands (the same as telecommand-generator)
+// and generates a dispatcher:
+//   - a minimal perfect hash of the command ids (service << 8 | subservice)
+//     to a dense table: the same time for each command, no switch/if chains
+//   - for each command with parameters a zero copy view of its arguments,
+//     big endian at the positions given by the parameter list, read with
+//     the same functions as the code of bitFieldsSerializer
+//   - dispatch() finds the command, checks the length and calls the handler
+//     in one pass
+//
+// Lines with subservice 0 define services, not commands.
+// The hash: bucket = hash(id, 0) % buckets, index = hash(id, displacement[bucket]) % commands
+// (hash and displace). The generator searches the displacements.
+
+struct CmdDescr {
+    char cmdName[150];
+    char shortCut[150];
+    int  service;
+    int  subservice;
+    int  numOfParams;
+    char paramType[20][50];
+    char paramName[20][50];
+    char paramUnit[20][50];
+    int  paramPos[20];
+    int  argsLen;     // variable length (char*): the minimum
+    bool variableLen; // the last parameter is char*, the rest of the buffer
+};
+
+static const int MAX_CMDS         = 4000;
+static const int MAX_PARAMS       = 20;
+static const int MAX_DISPLACEMENT = 1000000;
+
+CmdDescr cmds[MAX_CMDS];
+CmdDescr currCmd;
+int      cmdCnt = 0;
+char     namespaceName[50] = "Common";
+
+int      numOfBuckets;
+int      displacement[MAX_CMDS];
+int      slotOfCmd[MAX_CMDS];  // index in the dense table
+int      cmdInSlot[MAX_CMDS];  // -1: free
+
+#define HEADER \
+  "\n\n"\
+  "//--- generated file, DO NOT modify\n"\
+  "//--- see telecommand-dispatcher.cpp\n"\
+  "#pragma once\n\n"
+
+/// the same in the generated code
+static uint32_t hash(uint32_t key, uint32_t seed) {
+    uint32_t h = (key ^ seed) * 0x9E3779B1u;
+    return h ^ (h >> 15);
+}
+
+static int id(const CmdDescr& cmd) { return (cmd.service << 8) | cmd.subservice; }
+
+//____________________________________________ perfect hash
+
+static bool placeBucket(int* members, int numOfMembers, int seed) {
+    int slots[MAX_CMDS];
+    for(int i = 0; i < numOfMembers; i++) {
+        slots[i] = static_cast<int>(hash(static_cast<uint32_t>(id(cmds[members[i]])), static_cast<uint32_t>(seed)) % static_cast<uint32_t>(cmdCnt));
+        if(cmdInSlot[slots[i]] >= 0) return false;
+        for(int j = 0; j < i; j++) if(slots[j] == slots[i]) return false;
+    }
+    for(int i = 0; i < numOfMembers; i++) {
+        cmdInSlot[slots[i]]   = members[i];
+        slotOfCmd[members[i]] = slots[i];
+    }
+    return true;
+}
+
+static bool findPerfectHash() {
+    numOfBuckets = (cmdCnt + 1) / 2;
+    static int bucketOf[MAX_CMDS];
+    static int bucketSize[MAX_CMDS];
+    for(int b = 0; b < numOfBuckets; b++) bucketSize[b] = 0;
+    for(int c = 0; c < cmdCnt; c++) {
+        bucketOf[c] = static_cast<int>(hash(static_cast<uint32_t>(id(cmds[c])), 0) % static_cast<uint32_t>(numOfBuckets));
+        bucketSize[bucketOf[c]]++;
+        cmdInSlot[c] = -1;
+    }
+
+    // the largest buckets first, while there are many free slots
+    for(int size = cmdCnt; size > 0; size--) {
+        for(int b = 0; b < numOfBuckets; b++) {
+            if(bucketSize[b] != size) continue;
+            int members[MAX_CMDS];
+            int numOfMembers = 0;
+            for(int c = 0; c < cmdCnt; c++) if(bucketOf[c] == b) members[numOfMembers++] = c;
+            int seed = 1;
+            while(seed < MAX_DISPLACEMENT && !placeBucket(members, numOfMembers, seed)) seed++;
+            if(seed >= MAX_DISPLACEMENT) return false;
+            displacement[b] = seed;
+        }
+    }
+    for(int b = 0; b < numOfBuckets; b++) if(bucketSize[b] == 0) displacement[b] = 0;
+    return true;
+}
+
+int main() {
+    printf(HEADER);
+    char inputLine[800];
+    char params[800];
+
+    //____________________________________________ Read the file
+    while(fgets(inputLine, 600, stdin)) {
+        for(char* s = inputLine; *s; s++) if(*s == '#') { *s = 0; break; } // remove comments
+
+        params[0] = 0;
+        memset(&currCmd, 0, sizeof(currCmd));
+        sscanf(inputLine, "%s %s %d,%d %[^\n]s", currCmd.cmdName, currCmd.shortCut,
+               &currCmd.service, &currCmd.subservice, params);
+        if(currCmd.cmdName[0] ==  0 ) continue;
+        if(currCmd.cmdName[0] == '@') {
+            strcpy(namespaceName, currCmd.cmdName + 1);
+            continue;
+        }
+        if(currCmd.subservice == 0) continue; // a service
+
+        bool duplicated = false;
+        for(int i = 0; i < cmdCnt; i++) {
+            if(id(cmds[i]) == id(currCmd)) {
+                printf("#warning %s has the id of %s, it is not dispatched\n", currCmd.cmdName, cmds[i].cmdName);
+                duplicated = true;
+            }
+        }
+        if(duplicated) continue;
+
+        /** Read all params, positions like in telecommand-generator **/
+        int pos = 0;
+        for(int i = 0, fields = 4; fields == 4 && i < MAX_PARAMS; i++) {
+            if(params[0] == 0)   break;
+            if(params[0] == ' ') break;
+            fields = sscanf(params, "%s %s %s %[^\n]s", currCmd.paramType[i], currCmd.paramName[i], currCmd.paramUnit[i], params);
+            currCmd.paramPos[i] = pos;
+            currCmd.numOfParams++;
+            if(strcmp(currCmd.paramType[i], "char*") == 0) {
+                currCmd.variableLen = true; // the rest
+                break;
+            }
+            const TypeDescr* type = findType(currCmd.paramType[i]);
+            if(type == 0) {
+                printf("#error %s: unknown type %s\n", currCmd.cmdName, currCmd.paramType[i]);
+                return 1;
+            }
+            pos += type->len;
+        }
+        currCmd.argsLen = pos;
+
+        cmds[cmdCnt] = currCmd;
+        cmdCnt++;
+        if(cmdCnt >= MAX_CMDS) {
+            printf("#warning  to many commands, the rest are lost\n");
+            break;
+        }
+    }
+    if(cmdCnt == 0) {
+        printf("#warning  no commands\n");
+        return 0;
+    }
+    if(!findPerfectHash()) {
+        printf("#error no perfect hash found\n");
+        return 1;
+    }
+
+    printf("namespace %s {\n\n", namespaceName);
+    printf("#ifndef NO_RODOS_NAMESPACE\n");
+    for(const TypeDescr* t = types; t->name; t++) {
+        if(strncmp(t->reader, "bigEndian", 9) == 0) printf("using RODOS::%.*s;\n", static_cast<int>(strchr(t->reader, '(') - t->reader), t->reader);
+    }
+    printf("#endif\n\n");
+
+    //____________________________________________ argument views
+
+    printf("//____________________________________ zero copy views of the arguments, big endian\n\n");
+    for(int c = 0; c < cmdCnt; c++) {
+        const CmdDescr& cmd = cmds[c];
+        if(cmd.numOfParams == 0) continue;
+        printf("struct %s_Args {\n", cmd.cmdName);
+        printf("    static const uint16_t %s = %d;\n", cmd.variableLen ? "MIN_LEN" : "LEN", cmd.argsLen);
+        printf("    const uint8_t* buf;\n");
+        printf("    uint32_t       len;\n");
+        for(int i = 0; i < cmd.numOfParams; i++) {
+            char getter[60];
+            snprintf(getter, sizeof(getter), "%s()", cmd.paramName[i]);
+            if(strcmp(cmd.paramType[i], "char*") == 0) {
+                printf("    const char*    %-18s const { return reinterpret_cast<const char*>(buf + %d); } // %s, len - %d bytes\n",
+                       getter, cmd.paramPos[i], cmd.paramUnit[i], cmd.paramPos[i]);
+                continue;
+            }
+            char reader[100];
+            snprintf(reader, sizeof(reader), findType(cmd.paramType[i])->reader, cmd.paramPos[i]);
+            printf("    %-14s %-18s const { return %s; } // %s\n", cmd.paramType[i], getter, reader, cmd.paramUnit[i]);
+        }
+        printf("};\n\n");
+    }
+
+    //____________________________________________ dispatcher
+
+    printf("//____________________________________ dispatcher\n\n");
+    printf("class TelecommandDispatcher {\n");
+    printf("  public:\n");
+    printf("    enum Result { DISPATCHED, UNKNOWN_COMMAND, WRONG_LENGTH };\n\n");
+    printf("    static const uint32_t NUM_OF_COMMANDS = %d;\n", cmdCnt);
+    printf("    static const uint32_t NUM_OF_BUCKETS  = %d;\n\n", numOfBuckets);
+    printf("    virtual ~TelecommandDispatcher() {}\n\n");
+    printf("    /// finds the command (perfect hash), checks the length of the arguments and calls its handler\n");
+    printf("    Result dispatch(uint16_t id, const uint8_t* args, uint32_t len);\n\n");
+    printf("    /// index in the dense table, NUM_OF_COMMANDS if unknown\n");
+    printf("    static uint32_t indexOf(uint16_t id);\n\n");
+    printf("    /// handlers, to be overwritten\n");
+    for(int c = 0; c < cmdCnt; c++) {
+        const CmdDescr& cmd = cmds[c];
+        if(cmd.numOfParams == 0) {
+            printf("    virtual void %s() {}\n", cmd.cmdName);
+        } else {
+            printf("    virtual void %s([[gnu::unused]] const %s_Args& args) {}\n", cmd.cmdName, cmd.cmdName);
+        }
+    }
+    printf("\n  private:\n");
+    printf("    struct Entry {\n");
+    printf("        uint16_t id;\n");
+    printf("        uint16_t argsLen;\n");
+    printf("        bool     variableLen;\n");
+    printf("    };\n");
+    printf("    static inline uint32_t hash(uint32_t key, uint32_t seed) {\n");
+    printf("        uint32_t h = (key ^ seed) * 0x9E3779B1u;\n");
+    printf("        return h ^ (h >> 15);\n");
+    printf("    }\n");
+    printf("    static const Entry* entries();\n");
+    printf("};\n\n");
+
+    printf("inline const TelecommandDispatcher::Entry* TelecommandDispatcher::entries() {\n");
+    printf("    static const Entry table[NUM_OF_COMMANDS] = {\n");
+    for(int slot = 0; slot < cmdCnt; slot++) {
+        const CmdDescr& cmd = cmds[cmdInSlot[slot]];
+        printf("        { 0x%04x, %3d, %s }, // %s\n", id(cmd), cmd.argsLen, cmd.variableLen ? "true " : "false", cmd.cmdName);
+    }
+    printf("    };\n");
+    printf("    return table;\n");
+    printf("}\n\n");
+
+    printf("inline uint32_t TelecommandDispatcher::indexOf(uint16_t id) {\n");
+    printf("    static const uint32_t displacement[NUM_OF_BUCKETS] = {");
+    for(int b = 0; b < numOfBuckets; b++) printf("%s%s%d", (b == 0) ? "" : ",", (b % 16 == 0) ? "\n        " : " ", displacement[b]);
+    printf(" };\n");
+    printf("    uint32_t index = hash(id, displacement[hash(id, 0) %% NUM_OF_BUCKETS]) %% NUM_OF_COMMANDS;\n");
+    printf("    return (entries()[index].id == id) ? index : NUM_OF_COMMANDS;\n");
+    printf("}\n\n");
+
+    printf("inline TelecommandDispatcher::Result TelecommandDispatcher::dispatch(uint16_t id, const uint8_t* args, uint32_t len) {\n");
+    printf("    uint32_t index = indexOf(id);\n");
+    printf("    if(index == NUM_OF_COMMANDS) return UNKNOWN_COMMAND;\n");
+    printf("    const Entry& entry = entries()[index];\n");
+    printf("    if(entry.variableLen ? (len < entry.argsLen) : (len != entry.argsLen)) return WRONG_LENGTH;\n");
+    printf("    switch(index) { // dense: a jump table\n");
+    for(int slot = 0; slot < cmdCnt; slot++) {
+        const CmdDescr& cmd = cmds[cmdInSlot[slot]];
+        if(cmd.numOfParams == 0) {
+            printf("        case %4d: %s(); break;\n", slot, cmd.cmdName);
+        } else {
+            printf("        case %4d: %s(%s_Args{ args, len }); break;\n", slot, cmd.cmdName, cmd.cmdName);
+        }
+    }
+    printf("        default: break;\n");
+    printf("    }\n");
+    printf("    return DISPATCHED;\n");
+    printf("}\n\n");
+
+    printf("} // namespace\n");
+    return 0;
+}
@@ -4,6 +4,8 @@
 #include "stdint.h"
 #include "string.h"
 
+#include "telecommand-types.h"
+
 // Reads from stdin definition of telecommands
 // and generates code to iterpret them
 //
@@ -88,16 +90,14 @@ int main() {
             allParams[paramCnt].duplicated = false;
             allParams[paramCnt].posInBuf = pos;
 
-            //count position
-            if (!strcmp(currCmd.paramType[i], "int8_t" ))  pos+=1;
-            if (!strcmp(currCmd.paramType[i], "int16_t"))  pos+=2;
-            if (!strcmp(currCmd.paramType[i], "int32_t"))  pos+=4;
-            if (!strcmp(currCmd.paramType[i], "int64_t"))  pos+=4;
-            if (!strcmp(currCmd.paramType[i], "uint8_t" )) pos+=1;
-            if (!strcmp(currCmd.paramType[i], "uint16_t")) pos+=2;
-            if (!strcmp(currCmd.paramType[i], "uint32_t")) pos+=4;
-            if (!strcmp(currCmd.paramType[i], "uint64_t")) pos+=4;
-            if (!strcmp(currCmd.paramType[i], "char*"  ))  pos+=1;
+            //count position, the same as in telecommand-dispatcher
+            if (!strcmp(currCmd.paramType[i], "char*"  )) {
+                pos+=1;
+            } else if (findType(currCmd.paramType[i])) {
+                pos+=findType(currCmd.paramType[i])->len;
+            } else {
+                printf("#warning %s: unknown type %s, the parameters after it are misplaced\n", currCmd.cmdName, currCmd.paramType[i]);
+            }
             paramCnt++;
         }
 
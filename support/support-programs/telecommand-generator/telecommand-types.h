@@ -0,0 +1,30 @@
+#pragma once
+
+// The parameter types of the telecommand definitions (.tc) and their length
+// in the argument buffer, one table for telecommand-generator and
+// telecommand-dispatcher: both place the parameters at the same positions.
+
+struct TypeDescr {
+    const char* name;
+    int         len;
+    const char* reader; // of the bytes at buf + pos
+};
+
+static const TypeDescr types[] = {
+    { "int8_t",   1, "static_cast<int8_t>(buf[%d])" },
+    { "uint8_t",  1, "buf[%d]" },
+    { "int16_t",  2, "bigEndianToInt16_t(buf + %d)" },
+    { "uint16_t", 2, "bigEndianToUint16_t(buf + %d)" },
+    { "int32_t",  4, "bigEndianToInt32_t(buf + %d)" },
+    { "uint32_t", 4, "bigEndianToUint32_t(buf + %d)" },
+    { "int64_t",  8, "bigEndianToInt64_t(buf + %d)" },
+    { "uint64_t", 8, "bigEndianToUint64_t(buf + %d)" },
+    { "float",    4, "bigEndianToFloat(buf + %d)" },
+    { "double",   8, "bigEndianToDouble(buf + %d)" },
+    { 0, 0, 0 }
+};
+
+static const TypeDescr* findType(const char* name) {
+    for(const TypeDescr* t = types; t->name; t++) if(strcmp(t->name, name) == 0) return t;
+    return 0;
+}
@@ -0,0 +1,5 @@
+
+g++ -std=c++17 -O2 -o trace-converter trace-converter.cpp
+
+echo "trace-converter log-or-dump > trace.json          (Perfetto, chrome://tracing)"
+echo "trace-converter -ctf directory log-or-dump        (Trace Compass, babeltrace)"
@@ -0,0 +1,435 @@
+/**
+ * @file trace-converter.cpp
+ * @date 2026/10/18
+ *
+ * @brief converts a dump of RODOS::traceRing to Chrome trace JSON or CTF
+ *
+ * Reads the dump (binary from TraceRing::dump(), or a console log with the
+ * "TRACE <hex>" lines of TraceRing::printDump(), then the last dump in it)
+ * from a file or stdin:
+ *
+ *   trace-converter  dump  > trace.json     Chrome trace JSON: Perfetto, chrome://tracing
+ *   trace-converter -ctf directory  dump    CTF 1.8 (metadata and stream): Trace Compass, babeltrace
+ *
+ * The format of the dump is described in api/trace-ring.h.
+ */
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+// like RODOS::TraceEventType and RODOS::TraceNameKind in api/trace-ring.h
+enum EventType {
+    THREAD_RUN = 1,
+    THREAD_WAIT,
+    SEMAPHORE_REQUEST,
+    SEMAPHORE_ENTER,
+    SEMAPHORE_LEAVE,
+    PUBLISH_BEGIN,
+    PUBLISH_END,
+    TIME_EVENT_BEGIN,
+    TIME_EVENT_END,
+    INTERRUPT_BEGIN,
+    INTERRUPT_END,
+    USER,
+    NUM_OF_TYPES
+};
+enum NameKind { THREAD = 1, TOPIC, TIME_EVENT };
+
+static const char* eventNames[NUM_OF_TYPES] = { "",
+                                                "thread_run",
+                                                "thread_wait",
+                                                "semaphore_request",
+                                                "semaphore_enter",
+                                                "semaphore_leave",
+                                                "publish_begin",
+                                                "publish_end",
+                                                "time_event_begin",
+                                                "time_event_end",
+                                                "interrupt_begin",
+                                                "interrupt_end",
+                                                "user" };
+
+struct Event {
+    int64_t  time;
+    uint32_t thread;
+    uint32_t object;
+    uint32_t arg;
+    uint8_t  type;
+};
+
+static std::map<uint32_t, std::string> names[4]; // by NameKind
+static std::vector<Event>              events;
+static uint32_t                        overwritten = 0;
+
+static uint32_t bigEndian32(const uint8_t* p) { return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3]; }
+
+/************* reading *************/
+
+static bool readAll(FILE* in, std::vector<uint8_t>& data) {
+    uint8_t buffer[4096];
+    size_t  len;
+    while((len = fread(buffer, 1, sizeof(buffer), in)) > 0) data.insert(data.end(), buffer, buffer + len);
+    return !data.empty();
+}
+
+/// the hex of the "TRACE " lines of the last dump in a log
+static std::vector<uint8_t> fromLog(const std::vector<uint8_t>& text) {
+    std::vector<uint8_t> dump;
+    std::string          all(text.begin(), text.end());
+    size_t               pos = 0;
+    while(pos < all.size()) {
+        size_t      end  = all.find('\n', pos);
+        std::string line = all.substr(pos, (end == std::string::npos) ? std::string::npos : end - pos);
+        pos              = (end == std::string::npos) ? all.size() : end + 1;
+
+        size_t start = line.find("TRACE ");
+        if(start == std::string::npos) continue;
+        std::string hex = line.substr(start + 6);
+        if(hex.compare(0, 8, "52545243") == 0) dump.clear(); // "RTRC": a new dump
+        for(size_t i = 0; i + 1 < hex.size(); i += 2) {
+            unsigned int byte;
+            if(sscanf(hex.c_str() + i, "%2x", &byte) != 1) break;
+            dump.push_back(static_cast<uint8_t>(byte));
+        }
+    }
+    return dump;
+}
+
+static bool parse(const std::vector<uint8_t>& dump) {
+    if(dump.size() < 20 || memcmp(dump.data(), "RTRC", 4) != 0) {
+        fprintf(stderr, "no trace dump (RTRC) found\n");
+        return false;
+    }
+    uint32_t version = (uint32_t(dump[4]) << 8) | dump[5];
+    if(version != 1) {
+        fprintf(stderr, "dump version %u not known\n", version);
+        return false;
+    }
+    uint32_t numOfNames  = bigEndian32(&dump[8]);
+    uint32_t numOfEvents = bigEndian32(&dump[12]);
+    overwritten          = bigEndian32(&dump[16]);
+
+    size_t pos = 20;
+    for(uint32_t i = 0; i < numOfNames; i++) {
+        if(pos + 6 > dump.size() || pos + 6 + dump[pos + 1] > dump.size()) {
+            fprintf(stderr, "dump too short (names)\n");
+            return false;
+        }
+        uint8_t kind = dump[pos];
+        uint8_t len  = dump[pos + 1];
+        if(kind >= THREAD && kind <= TIME_EVENT) names[kind][bigEndian32(&dump[pos + 2])] = std::string(reinterpret_cast<const char*>(&dump[pos + 6]), len);
+        pos += 6u + len;
+    }
+    for(uint32_t i = 0; i < numOfEvents; i++, pos += 21) {
+        if(pos + 21 > dump.size()) {
+            fprintf(stderr, "dump too short (events), %u of %u\n", i, numOfEvents);
+            break;
+        }
+        Event event;
+        event.time   = static_cast<int64_t>((uint64_t(bigEndian32(&dump[pos])) << 32) | bigEndian32(&dump[pos + 4]));
+        event.thread = bigEndian32(&dump[pos + 8]);
+        event.object = bigEndian32(&dump[pos + 12]);
+        event.arg    = bigEndian32(&dump[pos + 16]);
+        event.type   = dump[pos + 20];
+        if(event.type == 0 || event.type >= NUM_OF_TYPES) continue; // overwritten while dumping
+        events.push_back(event);
+    }
+    return true;
+}
+
+/************* names *************/
+
+static std::string hexName(const char* prefix, uint32_t id) {
+    char text[32];
+    snprintf(text, sizeof(text), "%s 0x%08x", prefix, id);
+    return text;
+}
+
+static std::string threadName(uint32_t id) {
+    if(id == 0) return "interrupts";
+    auto name = names[THREAD].find(id);
+    return (name != names[THREAD].end()) ? name->second : hexName("thread", id);
+}
+
+/// the object of an event as text
+static std::string objectName(const Event& event) {
+    char text[32];
+    switch(event.type) {
+        case THREAD_RUN:
+        case THREAD_WAIT: return threadName(event.object);
+        case SEMAPHORE_REQUEST:
+        case SEMAPHORE_ENTER:
+        case SEMAPHORE_LEAVE: return hexName("semaphore", event.object);
+        case PUBLISH_BEGIN:
+        case PUBLISH_END: {
+            auto name = names[TOPIC].find(event.object);
+            if(name != names[TOPIC].end()) return name->second;
+            snprintf(text, sizeof(text), "topic %u", event.object);
+            return text;
+        }
+        case TIME_EVENT_BEGIN:
+        case TIME_EVENT_END: {
+            auto name = names[TIME_EVENT].find(event.object);
+            return (name != names[TIME_EVENT].end()) ? name->second : hexName("time event", event.object);
+        }
+        case INTERRUPT_BEGIN:
+        case INTERRUPT_END:
+            if(event.object == 0) return "scheduler";
+            snprintf(text, sizeof(text), "interrupt %u", event.object);
+            return text;
+        default: snprintf(text, sizeof(text), "user %u", event.object); return text;
+    }
+}
+
+static std::string jsonString(const std::string& text) {
+    std::string result = "\"";
+    for(char c : text) {
+        if(c == '"' || c == '\\') result += '\\';
+        if(static_cast<unsigned char>(c) < 0x20) c = ' ';
+        result += c;
+    }
+    return result + "\"";
+}
+
+/************* Chrome trace JSON *************/
+
+/**
+ * Tracks (tid): 1 interrupts (also time events and their publishes), per
+ * thread one with the running slices and one with its calls (publish,
+ * waiting for semaphores, user events). Semaphores held: async slices.
+ */
+class ChromeTrace {
+    FILE*                         out;
+    bool                          first = true;
+    std::map<uint32_t, int>       tracks;  // thread id -> tid of running slices, +1 calls
+    std::map<uint32_t, int64_t>   running; // thread id -> since
+    std::map<int, int>            depth;   // tid -> open B events
+    std::map<uint32_t, uint32_t>  waiting; // thread id -> semaphore requested
+    std::map<uint32_t, bool>      held;    // semaphore -> entered in the trace
+    int64_t                       lastTime = 0;
+
+    void emit(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+    static double us(int64_t ns) { return static_cast<double>(ns) / 1000.0; }
+
+    int track(uint32_t thread) {
+        if(thread == 0) return 1;
+        auto found = tracks.find(thread);
+        if(found != tracks.end()) return found->second;
+        int tid        = 10 + 2 * static_cast<int>(tracks.size());
+        tracks[thread] = tid;
+        std::string name = threadName(thread);
+        emit("{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":%s}}", tid, jsonString(name).c_str());
+        emit("{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":%s}}", tid + 1, jsonString(name + " calls").c_str());
+        return tid;
+    }
+
+    void begin(int tid, int64_t time, const std::string& name, const char* category, uint32_t arg) {
+        emit("{\"ph\":\"B\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"name\":%s,\"cat\":\"%s\",\"args\":{\"arg\":%u}}", tid, us(time), jsonString(name).c_str(),
+             category, arg);
+        depth[tid]++;
+    }
+
+    void end(int tid, int64_t time) {
+        if(depth[tid] == 0) return; // the begin was overwritten
+        emit("{\"ph\":\"E\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}", tid, us(time));
+        depth[tid]--;
+    }
+
+    void startRunning(uint32_t thread, int64_t time) {
+        if(thread == 0 || running.count(thread) != 0) return;
+        track(thread);
+        running[thread] = time;
+    }
+
+    void stopRunning(uint32_t thread, int64_t time) {
+        auto since = running.find(thread);
+        if(since == running.end()) return;
+        emit("{\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"name\":\"running\",\"cat\":\"scheduler\"}", track(thread),
+             us(since->second), us(time - since->second));
+        running.erase(since);
+    }
+
+  public:
+    explicit ChromeTrace(FILE* out_) : out(out_) {}
+
+    void write() {
+        fprintf(out, "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"overwritten\":%u},\"traceEvents\":[\n", overwritten);
+        emit("{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\",\"args\":{\"name\":\"RODOS\"}}");
+        emit("{\"ph\":\"M\",\"pid\":1,\"tid\":1,\"name\":\"thread_name\",\"args\":{\"name\":\"interrupts\"}}");
+        for(const Event& event : events) {
+            lastTime = event.time;
+            int calls = (event.thread == 0) ? 1 : track(event.thread) + 1;
+            switch(event.type) {
+                case THREAD_RUN:
+                    if(event.thread != event.object) stopRunning(event.thread, event.time); // one core: a switch
+                    startRunning(event.object, event.time);
+                    break;
+                case THREAD_WAIT: stopRunning(event.object, event.time); break;
+                case SEMAPHORE_REQUEST:
+                    waiting[event.thread] = event.object;
+                    begin(calls, event.time, "wait " + objectName(event), "semaphore", event.object);
+                    break;
+                case SEMAPHORE_ENTER:
+                    if(waiting.count(event.thread) != 0 && waiting[event.thread] == event.object) {
+                        end(calls, event.time);
+                        waiting.erase(event.thread);
+                    }
+                    held[event.object] = true;
+                    emit("{\"ph\":\"b\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"id\":\"0x%08x\",\"name\":%s,\"cat\":\"semaphore\",\"args\":{\"owner\":%s}}", calls,
+                         us(event.time), event.object, jsonString(objectName(event)).c_str(), jsonString(threadName(event.thread)).c_str());
+                    break;
+                case SEMAPHORE_LEAVE:
+                    if(!held[event.object]) break; // entered before the trace
+                    held[event.object] = false;
+                    emit("{\"ph\":\"e\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"id\":\"0x%08x\",\"name\":%s,\"cat\":\"semaphore\"}", calls, us(event.time),
+                         event.object, jsonString(objectName(event)).c_str());
+                    break;
+                case PUBLISH_BEGIN: begin(calls, event.time, "publish " + objectName(event), "topic", event.arg); break;
+                case TIME_EVENT_BEGIN: begin(1, event.time, objectName(event), "time event", event.arg); break;
+                case INTERRUPT_BEGIN: begin(1, event.time, objectName(event), "interrupt", event.arg); break;
+                case PUBLISH_END: end(calls, event.time); break;
+                case TIME_EVENT_END:
+                case INTERRUPT_END: end(1, event.time); break;
+                case USER:
+                    emit("{\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"name\":%s,\"cat\":\"user\",\"args\":{\"arg\":%u}}", calls,
+                         us(event.time), jsonString(objectName(event)).c_str(), event.arg);
+                    break;
+            }
+        }
+        while(!running.empty()) stopRunning(running.begin()->first, lastTime);
+        for(auto& open : depth) {
+            while(open.second > 0) end(open.first, lastTime);
+        }
+        fprintf(out, "\n]}\n");
+    }
+};
+
+void ChromeTrace::emit(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    fprintf(out, first ? "  " : ",\n  ");
+    vfprintf(out, format, args);
+    va_end(args);
+    first = false;
+}
+
+/************* CTF *************/
+
+static const char* ctfMetadata = R"(/* CTF 1.8 */
+/* RODOS traceRing, written by trace-converter */
+
+typealias integer { size = 8; align = 8; signed = false; } := uint8_t;
+typealias integer { size = 32; align = 8; signed = false; } := uint32_t;
+typealias integer { size = 64; align = 8; signed = false; } := uint64_t;
+
+trace {
+    major = 1;
+    minor = 8;
+    byte_order = be;
+    packet.header := struct {
+        uint32_t magic;
+    };
+};
+
+env {
+    domain = "rodos";
+    tracer_name = "rodos-trace-ring";
+};
+
+clock {
+    name = rodos;
+    description = "NOW() of the node";
+    freq = 1000000000;
+    offset = 0;
+};
+
+typealias integer { size = 64; align = 8; signed = false; map = clock.rodos.value; } := uint64_clock_t;
+
+stream {
+    event.header := struct {
+        uint8_t id;
+        uint64_clock_t timestamp;
+    };
+};
+)";
+
+static void putBigEndian(FILE* out, uint64_t value, int bytes) {
+    for(int i = bytes - 1; i >= 0; i--) fputc(static_cast<int>((value >> (8 * i)) & 0xff), out);
+}
+
+static bool writeCtf(const char* directory) {
+    mkdir(directory, 0755);
+    std::string path     = std::string(directory) + "/metadata";
+    FILE*       metadata = fopen(path.c_str(), "w");
+    if(metadata == 0) {
+        fprintf(stderr, "can not write %s\n", path.c_str());
+        return false;
+    }
+    fputs(ctfMetadata, metadata);
+    for(int type = THREAD_RUN; type < NUM_OF_TYPES; type++) {
+        fprintf(metadata,
+                "\nevent {\n    name = \"%s\";\n    id = %d;\n    fields := struct {\n"
+                "        string thread;\n        string object;\n        uint32_t object_id;\n        uint32_t arg;\n    };\n};\n",
+                eventNames[type], type);
+    }
+    fclose(metadata);
+
+    path         = std::string(directory) + "/stream";
+    FILE* stream = fopen(path.c_str(), "wb");
+    if(stream == 0) {
+        fprintf(stderr, "can not write %s\n", path.c_str());
+        return false;
+    }
+    putBigEndian(stream, 0xC1FC1FC1, 4);
+    for(const Event& event : events) {
+        fputc(event.type, stream);
+        putBigEndian(stream, static_cast<uint64_t>(event.time), 8);
+        std::string thread = threadName(event.thread);
+        std::string object = objectName(event);
+        fwrite(thread.c_str(), 1, thread.size() + 1, stream);
+        fwrite(object.c_str(), 1, object.size() + 1, stream);
+        putBigEndian(stream, event.object, 4);
+        putBigEndian(stream, event.arg, 4);
+    }
+    fclose(stream);
+    return true;
+}
+
+/************* main *************/
+
+int main(int argc, char* argv[]) {
+    const char* ctfDirectory = 0;
+    const char* file         = 0;
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "-ctf") == 0 && i + 1 < argc) ctfDirectory = argv[++i];
+        else if(argv[i][0] == '-') {
+            fprintf(stderr, "usage: trace-converter [-ctf directory] [dump or log]\n");
+            return 1;
+        } else file = argv[i];
+    }
+
+    FILE* in = (file == 0) ? stdin : fopen(file, "rb");
+    if(in == 0) {
+        fprintf(stderr, "can not read %s\n", file);
+        return 1;
+    }
+    std::vector<uint8_t> data;
+    readAll(in, data);
+    if(in != stdin) fclose(in);
+
+    bool binary = data.size() >= 4 && memcmp(data.data(), "RTRC", 4) == 0;
+    if(!parse(binary ? data : fromLog(data))) return 1;
+    fprintf(stderr, "%zu events, %u overwritten before the dump\n", events.size(), overwritten);
+
+    if(ctfDirectory != 0) return writeCtf(ctfDirectory) ? 0 : 1;
+    ChromeTrace(stdout).write();
+    return 0;
+}
@@ -19,14 +19,15 @@ sender_node = ProtoField.int32("rodos.sender_node", "Sender Node")
 sent_time = ProtoField.int64("rodos.sent_time", "Sent Time")
 sender_thread_id = ProtoField.uint32("rodos.sender_thread_id", "Sender Thread ID")
 topic_id = ProtoField.uint32("rodos.topic_id", "Topic ID")
+sequence_nr = ProtoField.uint32("rodos.sequence_nr", "Sequence Number")
 
 -- Add the fields to the protocol
-rodos_protocol.fields = { receiver_node, receiver_nodes_bitmap, max_steps_to_forward, checksum, message_type, message_length, sender_node, sent_time, sender_thread_id, topic_id }
+rodos_protocol.fields = { receiver_node, receiver_nodes_bitmap, max_steps_to_forward, checksum, message_type, message_length, sender_node, sent_time, sender_thread_id, topic_id, sequence_nr }
 
 -- Define the dissector function
 function rodos_protocol.dissector(buffer, pinfo, tree)
     length = buffer:len()
-    if length < 36 then return end -- Minimum length check
+    if length < 40 then return end -- Minimum length check
 
     pinfo.cols.protocol = rodos_protocol.name
 
@@ -43,6 +44,7 @@ function rodos_protocol.dissector(buffer, pinfo, tree)
     subtree:add(sent_time, buffer(20, 8))
     subtree:add(sender_thread_id, buffer(28, 4))
     subtree:add(topic_id, buffer(32, 4))
+    subtree:add(sequence_nr, buffer(36, 4))
 end
 
 -- Register the dissector
@@ -0,0 +1,206 @@
+#include "rodos.h"
+#include "activity.h"
+
+/**
+ * Activity executer (heap and ready fifos): the order of the times, the
+ * priorities of activities due at the same time, resume() from a thread and
+ * from a TimeEvent, a periodic activity keeps its period after resume(),
+ * activateAt(END_OF_TIME) stops it, many activities in time order, and
+ * activities constructed after the executer's init() (from MAIN()): they get
+ * their init(), start at their startAt and, with more of them waiting than
+ * the heap holds, still run in time order.
+ */
+
+uint32_t printfMask = 0;
+
+static char    order[80];
+static int32_t orderLen = 0;
+
+static void record(const char* name) {
+    for(const char* c = name; *c != 0 && orderLen < static_cast<int32_t>(sizeof(order)) - 2; c++) order[orderLen++] = *c;
+    order[orderLen++] = ' ';
+    order[orderLen]   = 0;
+}
+
+static void clearOrder() {
+    orderLen = 0;
+    order[0] = 0;
+}
+
+class Recorder : public Activity {
+  public:
+    int32_t steps = 0;
+    Recorder(const char* name, int prio = 100) : Activity(name, prio) {}
+    void step(int64_t) override {
+        steps++;
+        record(name);
+    }
+};
+
+static Recorder t50("t50"), t10("t10"), t40("t40"), t20("t20"), t30("t30");
+static Recorder low("p50", 50), high("p300", 300), middle("p100", 100);
+static Recorder parked("parked");
+
+class Periodic : public Activity {
+  public:
+    int32_t beats     = 0;
+    int32_t resumed   = 0;
+    int32_t offGrid   = 0;
+    int64_t startedAt = 0;
+    Periodic() : Activity("periodic") {}
+    void step(int64_t timeNow) override {
+        if(suspendedUntil > timeNow) { // resumed: the planned beat stays
+            resumed++;
+            return;
+        }
+        beats++;
+        if((timeNow - startedAt) % (50 * MILLISECONDS) > 20 * MILLISECONDS) offGrid++;
+    }
+} periodic;
+
+//________________________________________________ many activities
+
+static constexpr int32_t MANY = 1000;
+
+static int64_t lastPlanned = 0;
+static int32_t manyRan     = 0;
+static int32_t orderErrors = 0;
+
+class Many : public Activity {
+  public:
+    int64_t planned = 0;
+    Many() : Activity("many") {}
+    void step(int64_t) override {
+        manyRan++;
+        if(planned < lastPlanned) orderErrors++;
+        lastPlanned = planned;
+    }
+} many[MANY];
+
+//________________________________________________ constructed after init()
+
+static constexpr int32_t LATE = 16;
+
+static int32_t lateInits = 0;
+static int32_t lateRan   = 0;
+
+static int64_t lateStart() { // shuffled, 30 .. 45 ms
+    static int32_t constructed = 0;
+    return 30 * MILLISECONDS + ((constructed++ * 7 + 3) % LATE) * MILLISECONDS;
+}
+
+class Late : public Activity {
+  public:
+    Late() : Activity("late", 100, lateStart()) {}
+    void init() override { lateInits++; }
+    void step(int64_t) override {
+        lateRan++;
+        if(getSuspendedUntil() < lastPlanned) orderErrors++;
+        lastPlanned = getSuspendedUntil();
+    }
+};
+
+static Late* late = 0;
+
+void MAIN() { // after initSystem(), before the scheduler starts
+    static Late lateOnes[LATE];
+    late = lateOnes;
+}
+
+class ResumeEvent : public TimeEvent {
+  public:
+    void handle() override { parked.resume(); }
+} resumeEvent;
+
+class ActivityHeapTester : public StaticThread<> {
+  public:
+    ActivityHeapTester() : StaticThread<>("ActivityHeapTester", 200) {}
+
+    void run() {
+        printfMask = 1;
+        suspendCallerUntil(NOW() + 50 * MILLISECONDS);
+
+        PRINTF("__________________ constructed after init()\n");
+        PRINTF("  inits %d, ran %d, order errors %d\n", static_cast<int>(lateInits),
+               static_cast<int>(lateRan), static_cast<int>(orderErrors));
+        lastPlanned = 0;
+
+        PRINTF("__________________ time order\n");
+        int64_t base = NOW() + 20 * MILLISECONDS;
+        t50.activateAt(base + 50 * MILLISECONDS);
+        t10.activateAt(base + 10 * MILLISECONDS);
+        t40.activateAt(base + 40 * MILLISECONDS);
+        t20.activateAt(base + 20 * MILLISECONDS);
+        t30.activateAt(base + 30 * MILLISECONDS);
+        suspendCallerUntil(base + 100 * MILLISECONDS);
+        PRINTF("  %s\n", order);
+
+        PRINTF("__________________ priorities, due at the same time\n");
+        clearOrder();
+        base = NOW() + 20 * MILLISECONDS;
+        low.activateAt(base);
+        high.activateAt(base);
+        middle.activateAt(base);
+        suspendCallerUntil(base + 50 * MILLISECONDS);
+        PRINTF("  %s\n", order);
+
+        PRINTF("__________________ resume\n");
+        clearOrder();
+        parked.resume();
+        suspendCallerUntil(NOW() + 10 * MILLISECONDS);
+        parked.resume();
+        parked.resume(); // before the step: one step
+        suspendCallerUntil(NOW() + 10 * MILLISECONDS);
+        PRINTF("  from thread: steps %d\n", static_cast<int>(parked.steps));
+        resumeEvent.activateAt(NOW() + 10 * MILLISECONDS);
+        suspendCallerUntil(NOW() + 30 * MILLISECONDS);
+        PRINTF("  from TimeEvent: steps %d\n", static_cast<int>(parked.steps));
+
+        PRINTF("__________________ periodic, resume and stop\n");
+        periodic.startedAt = NOW() + 10 * MILLISECONDS;
+        periodic.activatePeriodic(periodic.startedAt, 50 * MILLISECONDS);
+        for(int64_t at = 125; at <= 225; at += 50) { // between the beats
+            suspendCallerUntil(periodic.startedAt + at * MILLISECONDS);
+            periodic.resume();
+        }
+        suspendCallerUntil(periodic.startedAt + 260 * MILLISECONDS);
+        PRINTF("  beats %d, resumed %d, off the grid %d\n", static_cast<int>(periodic.beats),
+               static_cast<int>(periodic.resumed), static_cast<int>(periodic.offGrid));
+        periodic.activateAt(END_OF_TIME);
+        int32_t beatsWhenStopped = periodic.beats;
+        suspendCallerUntil(NOW() + 200 * MILLISECONDS);
+        PRINTF("  beats after stop %d\n", static_cast<int>(periodic.beats - beatsWhenStopped));
+
+        PRINTF("__________________ many\n");
+        base            = NOW() + 20 * MILLISECONDS;
+        uint32_t random = 12345;
+        for(int32_t i = 0; i < MANY; i++) {
+            random          = random * 1103515245 + 12345;
+            many[i].planned = base + static_cast<int64_t>((random >> 8) % 100) * MILLISECONDS;
+            many[i].activateAt(many[i].planned);
+        }
+        suspendCallerUntil(base + 200 * MILLISECONDS);
+        PRINTF("  ran %d, order errors %d\n", static_cast<int>(manyRan), static_cast<int>(orderErrors));
+
+        PRINTF("__________________ more waiting than the heap holds\n");
+        manyRan     = 0;
+        lateRan     = 0;
+        lastPlanned = 0;
+        base        = NOW() + 20 * MILLISECONDS;
+        for(int32_t i = 0; i < LATE; i++) {
+            random = random * 1103515245 + 12345;
+            late[i].activateAt(base + static_cast<int64_t>((random >> 8) % 100) * MILLISECONDS);
+        }
+        for(int32_t i = 0; i < MANY; i++) {
+            random          = random * 1103515245 + 12345;
+            many[i].planned = base + static_cast<int64_t>((random >> 8) % 100) * MILLISECONDS;
+            many[i].activateAt(many[i].planned);
+        }
+        suspendCallerUntil(base + 200 * MILLISECONDS);
+        PRINTF("  ran %d + %d, order errors %d\n", static_cast<int>(manyRan), static_cast<int>(lateRan),
+               static_cast<int>(orderErrors));
+
+        PRINTF("\nThis run (test) terminates now!\n");
+        hwResetAndReboot();
+    }
+} activityHeapTester;
@@ -0,0 +1,68 @@
+#include "rodos.h"
+
+/**
+ * CorePartition: the rules (name, priority, first match), setAffinity() before
+ * and after the creation, a refused mask and a second partition applied at
+ * runtime. Only core 0 is used, the masks of other threads depend on the host.
+ */
+
+uint32_t printfMask = 0;
+
+static const CorePartitionRule rules[] = {
+    { "PartitionByName", 0, 0x1 },
+    { 0, 300, 0x1 },
+};
+static CorePartition partition(rules, 2); // the configuration of the node
+
+static const CorePartitionRule otherRules[] = {
+    { "PartitionUnmatched", 0, 0x1 },
+};
+static CorePartition otherPartition(otherRules, 1, false); // SCHED_OTHER is always permitted
+
+class Sleeper : public StaticThread<> {
+  public:
+    Sleeper(const char* name, int32_t priority) : StaticThread<>(name, priority) {}
+    void run() { suspendCallerUntil(END_OF_TIME); }
+};
+
+static Sleeper byName("PartitionByName", 100);
+static Sleeper byPriority("PartitionByPriority", 400);
+static Sleeper unmatched("PartitionUnmatched", 100);
+static Sleeper explicitMask("PartitionExplicit", 100);
+
+class PartitionInit : public Initiator {
+    void init() { explicitMask.setAffinity(0x1); } // before the threads are created
+} partitionInit;
+
+/// the thread runs on core 0 only
+static bool onCore0(const Thread& thread) { return thread.getAffinity() == 0x1; }
+
+class CorePartitionTester : public StaticThread<> {
+  public:
+    CorePartitionTester() : StaticThread<>("CorePartitionTester", 50) {}
+
+    void run() {
+        printfMask = 1;
+        PRINTF("__________________ rules\n");
+        PRINTF("  active %d\n", CorePartition::active == &partition);
+        PRINTF("  by name %d, by priority %d, explicit %d\n", onCore0(byName), onCore0(byPriority), onCore0(explicitMask));
+        PRINTF("  mask of rules: by name %d, by priority %d, unmatched %d\n", static_cast<int>(partition.maskOf(&byName)),
+               static_cast<int>(partition.maskOf(&byPriority)), static_cast<int>(partition.maskOf(&unmatched)));
+        PRINTF("  unmatched includes core 0 %d\n", (unmatched.getAffinity() & 0x1) != 0);
+
+        PRINTF("__________________ setAffinity\n");
+        PRINTF("  unmatched on core 0: ok %d, on core 0 %d\n", unmatched.setAffinity(0x1), onCore0(unmatched));
+        PRINTF("  core 63: ok %d, still on core 0 %d\n", unmatched.setAffinity(1ull << 63), onCore0(unmatched));
+        PRINTF("  back to the partition: ok %d\n", unmatched.setAffinity(0));
+        PRINTF("  effective mask %d\n", static_cast<int>(CorePartition::effectiveMask(&unmatched)));
+
+        PRINTF("__________________ apply another partition\n");
+        bool applied = otherPartition.apply();
+        PRINTF("  applied %d, active %d\n", applied, CorePartition::active == &otherPartition);
+        PRINTF("  unmatched %d, explicit %d\n", onCore0(unmatched), onCore0(explicitMask));
+        PRINTF("  by priority includes core 0 %d\n", (byPriority.getAffinity() & 0x1) != 0);
+
+        PRINTF("\nThis run (test) terminates now!\n");
+        hwResetAndReboot();
+    }
+} corePartitionTester;
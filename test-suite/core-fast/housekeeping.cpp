@@ -0,0 +1,132 @@
+#include "rodos.h"
+#include "housekeeping.h"
+
+/**
+ * Housekeeping: parameters with ranges and rates packed in bits, deltas and
+ * runs of unchanged parameters, decoded like on ground (HousekeepingDecoder).
+ * Key frames every 4 packets, a lost packet, a too short buffer, deltas
+ * of 32 bit parameters and samples which are not packed.
+ */
+
+uint32_t printfMask = 0;
+
+static uint8_t  mode        = 0;
+static int16_t  temperature = 20;
+static uint32_t counter     = 0;
+static float    voltage     = 28.0f;
+static uint16_t flags       = 0;
+static int32_t  position    = -5000;
+
+static uint32_t wide = 0;
+
+static Housekeeping<8> housekeeping;
+static HkLayoutEntry   layout[8];
+static uint32_t        decodedRaw[8];
+
+static Housekeeping<1> wideHousekeeping;
+static HkLayoutEntry   wideLayout[1];
+static uint32_t        wideDecodedRaw[1];
+
+static void printDecoded(HousekeepingDecoder& decoder) {
+    PRINTF("    ");
+    for(uint32_t i = 0; i < housekeeping.numOfParameters(); i++) {
+        double scaled = (layout[i].type == FieldType::F32) ? decoder.value(i) * 100 + 0.5 : decoder.value(i);
+        if(decoder.inLastPacket(i)) PRINTF(" %d", static_cast<int>(scaled));
+        else PRINTF(" -");
+    }
+    PRINTF("\n");
+}
+
+class HousekeepingTester : public StaticThread<> {
+  public:
+    void init() {
+        housekeeping.add(1, mode, 0, 7);
+        housekeeping.add(2, temperature, -40, 85, 2);
+        housekeeping.add(3, counter, 0, 1000000);
+        housekeeping.add(4, voltage, 0.0f, 40.0f, 0.01f);
+        housekeeping.add(5, flags, 0, 0xffff, 4);
+        housekeeping.add(6, position, -100000, 100000);
+        HkPacking packing;
+        packing.keyFrameInterval = 4;
+        housekeeping.setPacking(packing);
+        wideHousekeeping.add(7, wide, 0, UINT32_MAX);
+    }
+
+    void run() {
+        printfMask = 1;
+
+        PRINTF("__________________ layout\n");
+        housekeeping.printLayout();
+        housekeeping.getLayout(layout, 8);
+        HousekeepingDecoder decoder(layout, housekeeping.numOfParameters(), decodedRaw);
+        PRINTF("  max packet %d bytes, layout id the same on ground %d\n", static_cast<int>(housekeeping.maxPacketSize()),
+               housekeepingLayoutId(layout, housekeeping.numOfParameters()) == housekeeping.layoutId());
+
+        PRINTF("__________________ 10 samples: mode, temperature (/2), counter, voltage * 100, flags (/4), position\n");
+        uint8_t packet[64];
+        for(uint32_t i = 0; i < 10; i++) {
+            counter++;
+            if(i == 3) mode = 2;
+            if(i == 5) temperature = 200; // clamped
+            if(i >= 6) position += 1000;
+            voltage -= 0.05f;
+            housekeeping.sample();
+            size_t len = housekeeping.pack(packet, sizeof(packet));
+            bool   ok  = decoder.decode(packet, len);
+            PRINTF("  tick %d: %d bytes, key frame %d, decoded %d\n", static_cast<int>(housekeeping.tick), static_cast<int>(len),
+                   (packet[2] & HK_KEY_FRAME) != 0, ok);
+            printDecoded(decoder);
+        }
+
+        PRINTF("__________________ a lost packet\n");
+        for(uint32_t i = 0; i < 6; i++) {
+            counter += 3;
+            housekeeping.sample();
+            size_t len = housekeeping.pack(packet, sizeof(packet));
+            bool   ok  = (i == 0) ? false : decoder.decode(packet, len);
+            PRINTF("  tick %d: key frame %d, decoded %d\n", static_cast<int>(housekeeping.tick), (packet[2] & HK_KEY_FRAME) != 0, ok);
+        }
+        PRINTF("  counter %d, decoded %d, rejected %d\n", static_cast<int>(counter), static_cast<int>(decoder.value(2)),
+               static_cast<int>(decoder.rejectedPackets));
+
+        PRINTF("__________________ buffer too short\n");
+        counter++;
+        housekeeping.sample();
+        PRINTF("  packed %d\n", static_cast<int>(housekeeping.pack(packet, 13)));
+        counter++;
+        housekeeping.sample();
+        size_t len = housekeeping.pack(packet, sizeof(packet));
+        PRINTF("  next: key frame %d, decoded %d\n", (packet[2] & HK_KEY_FRAME) != 0, decoder.decode(packet, len));
+
+        PRINTF("__________________ other layout\n");
+        packet[0] ^= 0x01;
+        PRINTF("  decoded %d\n", decoder.decode(packet, len));
+
+        PRINTF("__________________ samples without pack\n");
+        PRINTF("  no new sample: packed %d\n", static_cast<int>(housekeeping.pack(packet, sizeof(packet))));
+        counter = 100;
+        housekeeping.sample();
+        counter = 101;
+        housekeeping.sample();
+        len     = housekeeping.pack(packet, sizeof(packet));
+        bool ok = decoder.decode(packet, len);
+        PRINTF("  two samples, one packet: tick %d, decoded %d, counter %d\n", static_cast<int>(bigEndianToUint32_t(packet + 4)), ok,
+               static_cast<int>(decoder.value(2)));
+
+        PRINTF("__________________ 32 bit parameter: deltas which do not fit in 32 bits are sent raw\n");
+        wideHousekeeping.getLayout(wideLayout, 1);
+        HousekeepingDecoder wideDecoder(wideLayout, 1, wideDecodedRaw);
+        const uint32_t wideValues[] = { 0, 0x80000001u, 3, 0xffffffffu, 0xfffffff0u, 0 };
+        for(uint32_t value : wideValues) {
+            wide = value;
+            wideHousekeeping.sample();
+            len = wideHousekeeping.pack(packet, sizeof(packet));
+            ok  = wideDecoder.decode(packet, len);
+            PRINTF("  %08x: %d bytes, decoded %d, %08x\n", static_cast<unsigned int>(value), static_cast<int>(len), ok,
+                   static_cast<unsigned int>(wideDecoder.raw(0)));
+        }
+
+        PRINTF("\nThis run (test) terminates now!\n");
+        hwResetAndReboot();
+    }
+} housekeepingTester;
@@ -0,0 +1,109 @@
+#include "rodos.h"
+
+/**
+ * LatencyHistogram: the buckets, percentiles of known values, the latency of
+ * the deliveries of a topic with a slow subscriber, a message of another node
+ * with a clock offset and the report of a LatencyMonitor.
+ * Measured latencies depend on the host, only their ranges are printed.
+ */
+
+uint32_t printfMask = 0;
+
+static LatencyMonitor monitor(100 * SECONDS); // reports when asked
+
+static LatencyHistogram valuesHistogram("values", 4000);
+static LatencyHistogram topicHistogram("topic");
+static LatencyHistogram fastHistogram("fast");
+
+static Topic<int32_t> latencyTestTopic(3980, "latencyTestTopic");
+
+static SubscriberReceiver<int32_t> slowReceiver(latencyTestTopic, [](int32_t&) { BUSY_WAITING_UNTIL(NOW() + 2 * MILLISECONDS); }, "slow");
+static SubscriberReceiver<int32_t> fastReceiver(latencyTestTopic, [](int32_t&) {}, "fast");
+
+static uint32_t reports = 0;
+static SubscriberReceiver<LatencyReport> reportReceiver(latencyTopic, [](LatencyReport&) { reports++; });
+
+static LatencyCounts counts;
+
+class LatencyTester : public StaticThread<> {
+  public:
+    LatencyTester() : StaticThread<>("LatencyTester") {}
+
+    void run() {
+        printfMask = 1;
+
+        PRINTF("__________________ buckets\n");
+        int64_t values[] = { 0, 7, 8, 15, 16, 17, 1000, 1 * MILLISECONDS, 1 * SECONDS, 100 * SECONDS };
+        for(int64_t value : values) {
+            uint32_t bucket = LatencyCounts::bucketOf(value);
+            int64_t  lower  = LatencyCounts::bucketLowerBound(bucket);
+            int64_t  upper  = LatencyCounts::bucketUpperBound(bucket);
+            PRINTF("  bucket %d, in it %d, width <= 1/8 %d\n", static_cast<int>(bucket), lower <= value && value <= upper,
+                   (upper - lower + 1) * 8 <= lower || upper == END_OF_TIME || bucket < 8);
+        }
+        bool continuous = true;
+        for(uint32_t i = 1; i < LatencyCounts::NUM_OF_BUCKETS; i++) {
+            if(LatencyCounts::bucketLowerBound(i) != LatencyCounts::bucketUpperBound(i - 1) + 1) continuous = false;
+            if(LatencyCounts::bucketOf(LatencyCounts::bucketLowerBound(i)) != i) continuous = false;
+        }
+        PRINTF("  continuous %d\n", continuous);
+
+        PRINTF("__________________ 1 .. 1000 us\n");
+        for(int64_t i = 1; i <= 1000; i++) valuesHistogram.add(i * MICROSECONDS);
+        valuesHistogram.add(-5); // counts as 0
+        valuesHistogram.snapshot(counts);
+        PRINTF("  count %d, mean %d us, max %d us\n", static_cast<int>(counts.count), static_cast<int>(counts.getMean() / MICROSECONDS),
+               static_cast<int>(counts.max / MICROSECONDS));
+        uint32_t permilles[] = { 0, 500, 900, 990, 1000 };
+        for(uint32_t permille : permilles) {
+            int64_t exact = permille * MICROSECONDS; // the value at permille
+            int64_t value = counts.percentile(permille);
+            PRINTF("  p%d: >= exact %d, < exact + 12.5%% %d\n", static_cast<int>(permille / 10), value >= exact, value <= exact + exact / 8 + 8);
+        }
+        valuesHistogram.snapshot(counts, true);
+        PRINTF("  after reset: count %d, max %d\n", static_cast<int>(valuesHistogram.getCount()), static_cast<int>(valuesHistogram.getMax()));
+        for(int64_t i = 1; i <= 1000; i++) valuesHistogram.add(i * MICROSECONDS); // for the report
+
+        PRINTF("__________________ topic with a slow subscriber\n");
+        latencyTestTopic.setLatencyHistogram(&topicHistogram);
+        fastReceiver.setLatencyHistogram(&fastHistogram);
+        for(int32_t i = 0; i < 10; i++) latencyTestTopic.publish(i);
+        topicHistogram.snapshot(counts);
+        PRINTF("  topic: count %d, id %d, p50 < 2 ms %d, max >= 2 ms %d\n", static_cast<int>(counts.count), static_cast<int>(topicHistogram.topicId),
+               counts.percentile(500) < 2 * MILLISECONDS, counts.max >= 2 * MILLISECONDS);
+        fastHistogram.snapshot(counts);
+        PRINTF("  fast: count %d, id %d, after the slow one %d\n", static_cast<int>(counts.count), static_cast<int>(fastHistogram.topicId),
+               counts.percentile(0) >= 2 * MILLISECONDS);
+
+        PRINTF("__________________ from another node\n");
+        PRINTF("  offset set %d\n", setNodeClockOffset(99, -3 * MILLISECONDS)); // node 99 is 3 ms ahead
+        slowReceiver.enable(false);
+        topicHistogram.reset();
+        NetMsgInfo info;
+        info.senderNode = 99;
+        info.sentTime   = NOW() - 5 * MILLISECONDS + 3 * MILLISECONDS; // sent 5 ms ago
+        int32_t msg     = 1;
+        latencyTestTopic.publish(msg, false, &info);
+        topicHistogram.snapshot(counts);
+        PRINTF("  offset %d ms, count %d, latency 5 .. 10 ms %d\n", static_cast<int>(getNodeClockOffset(99) / MILLISECONDS),
+               static_cast<int>(counts.count), counts.max >= 5 * MILLISECONDS && counts.max < 10 * MILLISECONDS);
+
+        PRINTF("__________________ report\n");
+        monitor.report();
+        const LatencyReport& report = monitor.lastReportMsg;
+        PRINTF("  reports %d, histograms %d\n", static_cast<int>(reports), static_cast<int>(report.numOfHistograms));
+        for(uint32_t i = 0; i < report.numOfHistograms; i++) {
+            const LatencyEntry& entry = report.histograms[i];
+            if(entry.topicId == 4000) {
+                PRINTF("  values: count %d, p50 %d, p90 %d, p99 %d, max %d us\n", static_cast<int>(entry.count), entry.p50Us >= 500 && entry.p50Us < 563,
+                       entry.p90Us >= 900 && entry.p90Us < 1013, entry.p99Us >= 990 && entry.p99Us <= 1000, static_cast<int>(entry.maxUs));
+            } else {
+                PRINTF("  topic %d: count %d\n", static_cast<int>(entry.topicId), static_cast<int>(entry.count));
+            }
+        }
+        PRINTF("  reset: %d\n", valuesHistogram.getCount() == 0 && fastHistogram.getCount() == 0);
+
+        PRINTF("\nThis run (test) terminates now!\n");
+        hwResetAndReboot();
+    }
+} latencyTester;
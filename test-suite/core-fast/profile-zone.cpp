@@ -0,0 +1,120 @@
+#include "rodos.h"
+
+/**
+ * Profiling zones: nested zones, the zones of the middleware (publish) only
+ * in tables with middlewareZones, a thread without table, a full table and
+ * the reports of a ProfileDumper.
+ * Cycles depend on the host, only relations between them are printed.
+ */
+
+uint32_t printfMask = 0;
+
+static ProfileDumper dumper(100 * SECONDS); // dumps when asked
+
+static ProfileTable testerTable("testerTable", true);
+static ProfileTable appTable("appTable");
+static ProfileTable fullTable("fullTable");
+
+static Topic<int32_t> profiledTopic(3990, "profiledTopic");
+static SubscriberReceiver<int32_t> profiledReceiver(profiledTopic, [](int32_t&) { RODOS_PROFILE_SCOPE("receiver"); });
+
+static uint32_t reports       = 0;
+static uint32_t reportedZones = 0;
+static SubscriberReceiver<ProfileReport> reportReceiver(profileTopic, [](ProfileReport& report) {
+    reports++;
+    reportedZones += report.numOfZones;
+});
+
+static const char* zoneNames[] = { "z0", "z1", "z2", "z3", "z4", "z5", "z6", "z7", "z8", "z9",
+                                   "z10", "z11", "z12", "z13", "z14", "z15", "z16", "z17", "z18", "z19" };
+
+static void printZone(const ProfileTable& table, const char* name) {
+    const ProfileZoneStats* zone = table.find(name);
+    if(zone == 0) {
+        PRINTF("  %s: not found\n", name);
+        return;
+    }
+    uint32_t inHistogram = 0;
+    for(uint32_t i = 0; i < ProfileZoneStats::HISTOGRAM_BUCKETS; i++) inHistogram += zone->histogram[i];
+    PRINTF("  %s: count %d, min <= max %d, total >= count * min %d, histogram %d\n", name, static_cast<int>(zone->count), zone->minCycles <= zone->maxCycles,
+           zone->totalCycles >= static_cast<uint64_t>(zone->count) * zone->minCycles, inHistogram == zone->count);
+}
+
+class Unprofiled : public StaticThread<> {
+  public:
+    Unprofiled() : StaticThread<>("Unprofiled") {}
+    void run() {
+        for(int i = 0; i < 10; i++) {
+            RODOS_PROFILE_SCOPE("unprofiled");
+            profiledTopic.publish(i);
+        }
+    }
+} unprofiled;
+
+class ProfileTester : public StaticThread<> {
+  public:
+    ProfileTester() : StaticThread<>("ProfileTester", 50) {}
+
+    void run() {
+        printfMask = 1;
+        PRINTF("__________________ buckets\n");
+        uint32_t cycles[] = { 0, 255, 256, 1023, 1024, 4096, 1000000, 0xffffffff };
+        for(uint32_t value : cycles) PRINTF("  %d\n", static_cast<int>(ProfileZoneStats::bucketOf(value)));
+
+        PRINTF("__________________ nested zones and publish\n");
+        setProfileTable(&testerTable);
+        dumper.dump(); // starts the measurement of the cycles per second
+        int64_t start = NOW();
+        for(int32_t i = 0; i < 5; i++) {
+            RODOS_PROFILE_SCOPE("outer");
+            BUSY_WAITING_UNTIL(NOW() + 1 * MILLISECONDS);
+            for(int j = 0; j < 100; j++) {
+                RODOS_PROFILE_SCOPE("inner");
+            }
+            profiledTopic.publish(i);
+        }
+        printZone(testerTable, "outer");
+        printZone(testerTable, "inner");
+        printZone(testerTable, "publish");
+        printZone(testerTable, "subscriber put");
+        printZone(testerTable, "receiver");
+        printZone(testerTable, "unprofiled");
+        const ProfileZoneStats* outer = testerTable.find("outer");
+        const ProfileZoneStats* inner = testerTable.find("inner");
+        PRINTF("  outer > inner %d, zones %d, dropped %d, thread %d\n", outer->minCycles > inner->maxCycles, static_cast<int>(testerTable.numOfZones),
+               static_cast<int>(testerTable.droppedZones.load()), testerTable.thread == this);
+        setProfileTable(0);
+        RODOS_PROFILE_SCOPE("after");
+        PRINTF("  after setProfileTable(0): found %d\n", testerTable.find("after") != 0);
+
+        PRINTF("__________________ table without middleware zones\n");
+        setProfileTable(&appTable);
+        profiledTopic.publish(0);
+        setProfileTable(0);
+        printZone(appTable, "publish");
+        printZone(appTable, "receiver");
+
+        PRINTF("__________________ full table\n");
+        setProfileTable(&fullTable);
+        for(const char* name : zoneNames) {
+            RODOS_PROFILE_SCOPE(name);
+        }
+        setProfileTable(0);
+        uint32_t found = 0;
+        for(const char* name : zoneNames) found += (fullTable.find(name) != 0);
+        PRINTF("  zones %d, dropped %d, found %d\n", static_cast<int>(fullTable.numOfZones), static_cast<int>(fullTable.droppedZones.load()),
+               static_cast<int>(found));
+
+        PRINTF("__________________ dump\n");
+        while(NOW() - start < 20 * MILLISECONDS) suspendCallerUntil(NOW() + 5 * MILLISECONDS);
+        uint32_t numOfReports = dumper.dump();
+        uint64_t cyclesPerSecond = dumper.lastReportMsg.cyclesPerSecond;
+        PRINTF("  reports %d, received %d, zones %d, cycles per second known %d\n", static_cast<int>(numOfReports), static_cast<int>(reports),
+               static_cast<int>(reportedZones), cyclesPerSecond > 0);
+        double outerNs = static_cast<double>(outer->minCycles) * 1.0e9 / static_cast<double>(cyclesPerSecond);
+        PRINTF("  outer min >= 1 ms %d\n", outerNs >= 0.9e6);
+
+        PRINTF("\nThis run (test) terminates now!\n");
+        hwResetAndReboot();
+    }
+} profileTester;
@@ -0,0 +1,67 @@
+#include "rodos.h"
+
+/**
+ * StackWatermark on a painted array as stack: slices, the watermark after
+ * deeper usage (with a gap of untouched words), the recommended size and the
+ * stack report. The report lists other threads on other ports and posix does
+ * not paint the stacks: it is not printed, only the own usage is checked.
+ */
+
+uint32_t printfMask = 0;
+
+static uint32_t       testStack[256];
+static StackWatermark watermark;
+
+/// slices until the end of the round
+static uint32_t scanRound(uint32_t sliceWords) {
+    uint32_t slices = 1;
+    while(!watermark.scanSlice(sliceWords)) slices++;
+    return slices;
+}
+
+class StackWatermarkTester : public StaticThread<> {
+  public:
+    StackWatermarkTester() : StaticThread<>("StackWatermarkTester") {}
+
+    void run() {
+        printfMask = 1;
+        PRINTF("__________________ painted array\n");
+        StackWatermark::paint(testStack, testStack + 256);
+        bool painted = true;
+        for(uint32_t word : testStack) painted = painted && (word == StackWatermark::EMPTY_MEMORY_MARKER);
+        watermark.init(testStack, testStack + 256);
+        PRINTF("  painted %d, usage before the first round %d\n", painted, static_cast<int>(watermark.getUsage()));
+
+        for(uint32_t i = 200; i < 256; i++) testStack[i] = i; // used: the top 56 words
+        uint32_t slices = scanRound(16);
+        PRINTF("  slices %d, usage %d, rounds %d\n", static_cast<int>(slices), static_cast<int>(watermark.getUsage()), static_cast<int>(watermark.getRounds()));
+        slices = scanRound(16);
+        PRINTF("  unchanged: slices %d, usage %d\n", static_cast<int>(slices), static_cast<int>(watermark.getUsage()));
+
+        PRINTF("__________________ deeper, with a gap\n");
+        testStack[150] = 0;
+        slices = scanRound(16);
+        PRINTF("  slices %d, usage %d\n", static_cast<int>(slices), static_cast<int>(watermark.getUsage()));
+        slices = scanRound(1000);
+        PRINTF("  one big slice: slices %d, usage %d, rounds %d\n", static_cast<int>(slices), static_cast<int>(watermark.getUsage()),
+               static_cast<int>(watermark.getRounds()));
+        testStack[0] = 0; // overflow
+        scanRound(1000);
+        PRINTF("  overflow: usage %d\n", static_cast<int>(watermark.getUsage()));
+
+        PRINTF("__________________ recommended sizes\n");
+        size_t usages[] = { 0, 424, 1000, 20000 };
+        for(size_t usage : usages) PRINTF("  %d -> %d\n", static_cast<int>(usage), static_cast<int>(StackWatermark::recommendedSize(usage)));
+
+        PRINTF("__________________ report\n");
+        Thread::scanStacks(STACK_SCAN_SLICE_WORDS);
+        size_t usage = getStackUsage(); // 0: not measured
+        PRINTF("  own usage not measured or below the recommended size %d\n", usage == 0 || usage < StackWatermark::recommendedSize(usage));
+        printfMask = 0;
+        Thread::printStackReport();
+        printfMask = 1;
+
+        PRINTF("\nThis run (test) terminates now!\n");
+        hwResetAndReboot();
+    }
+} stackWatermarkTester;
@@ -0,0 +1,121 @@
+#include "rodos.h"
+#include "telecommand-dispatcher-test.h"
+
+/**
+ * The dispatcher generated by support-programs/telecommand-generator/telecommand-dispatcher
+ * from telecommand-dispatcher.tc (at build time): each command reaches its handler,
+ * the argument views read each type at its position, unknown ids and wrong lengths
+ * are returned and call no handler.
+ */
+
+uint32_t printfMask = 0;
+
+using namespace TEST;
+
+static const char* resultName(TelecommandDispatcher::Result result) {
+    switch(result) {
+        case TelecommandDispatcher::DISPATCHED:      return "dispatched";
+        case TelecommandDispatcher::UNKNOWN_COMMAND: return "unknown command";
+        case TelecommandDispatcher::WRONG_LENGTH:    return "wrong length";
+    }
+    return "?";
+}
+
+class Handlers : public TelecommandDispatcher {
+  public:
+    uint32_t calls = 0;
+
+    void AOC_NOP() override {
+        calls++;
+        PRINTF("    AOC_NOP\n");
+    }
+    void AOC_SET_MODE(const AOC_SET_MODE_Args& args) override {
+        calls++;
+        PRINTF("    AOC_SET_MODE mode %d trim %d\n", static_cast<int>(args.MODE()), static_cast<int>(args.TRIM()));
+    }
+    void AOC_POINT(const AOC_POINT_Args& args) override {
+        calls++;
+        PRINTF("    AOC_POINT angle %d rate %d duration %d\n", static_cast<int>(args.ANGLE()), static_cast<int>(args.RATE()),
+               static_cast<int>(args.DURATION()));
+    }
+    void AOC_SET_GAINS(const AOC_SET_GAINS_Args& args) override {
+        calls++;
+        PRINTF("    AOC_SET_GAINS gain %.3f limit %.6f\n", static_cast<double>(args.GAIN()), args.LIMIT());
+    }
+    void AOC_SET_EPOCH(const AOC_SET_EPOCH_Args& args) override {
+        calls++;
+        PRINTF("    AOC_SET_EPOCH epoch %lld mask %llx count %u\n", static_cast<long long>(args.EPOCH()),
+               static_cast<unsigned long long>(args.MASK()), static_cast<unsigned int>(args.COUNT()));
+    }
+    void MEM_RESET() override {
+        calls++;
+        PRINTF("    MEM_RESET\n");
+    }
+    void MEM_UPLOAD(const MEM_UPLOAD_Args& args) override {
+        calls++;
+        char data[16] = "";
+        memcpy(data, args.DATA(), (args.len - 4 < sizeof(data)) ? args.len - 4 : sizeof(data) - 1);
+        PRINTF("    MEM_UPLOAD address %x, %d bytes: '%s'\n", static_cast<unsigned int>(args.ADDRESS()), static_cast<int>(args.len - 4), data);
+    }
+};
+
+static Handlers handlers;
+
+static void dispatch(const char* name, uint16_t id, const uint8_t* args, uint32_t len) {
+    uint32_t callsBefore = handlers.calls;
+    TelecommandDispatcher::Result result = handlers.dispatch(id, args, len);
+    PRINTF("  %s %04x, %d bytes: %s, handler called %d\n", name, static_cast<unsigned int>(id), static_cast<int>(len),
+           resultName(result), static_cast<int>(handlers.calls - callsBefore));
+}
+
+class TelecommandDispatcherTester : public StaticThread<> {
+  public:
+    void run() {
+        printfMask = 1;
+        uint8_t args[64];
+
+        PRINTF("__________________ dense table\n");
+        const uint16_t ids[] = { (20 << 8) | 1, (20 << 8) | 2, (20 << 8) | 3, (20 << 8) | 4, (20 << 8) | 5, (200 << 8) | 7, (200 << 8) | 9 };
+        uint32_t       used  = 0;
+        for(uint16_t id : ids) used |= 1u << TelecommandDispatcher::indexOf(id);
+        PRINTF("  %d commands, indices used 0x%x\n", static_cast<int>(TelecommandDispatcher::NUM_OF_COMMANDS), static_cast<unsigned int>(used));
+
+        PRINTF("__________________ each command, its arguments through the views\n");
+        dispatch("AOC_NOP", (20 << 8) | 1, args, 0);
+        args[0] = 3;
+        args[1] = static_cast<uint8_t>(-5);
+        dispatch("AOC_SET_MODE", (20 << 8) | 2, args, 2);
+        int16_tToBigEndian(args, -90);
+        uint16_tToBigEndian(args + 2, 500);
+        int32_tToBigEndian(args + 4, 123456);
+        dispatch("AOC_POINT", (20 << 8) | 3, args, 8);
+        floatToBigEndian(args, 0.125f);
+        doubleToBigEndian(args + 4, 3.141593);
+        dispatch("AOC_SET_GAINS", (20 << 8) | 4, args, 12);
+        int64_tToBigEndian(args, -1234567890123LL);
+        uint64_tToBigEndian(args + 8, 0xfedcba9876543210ULL);
+        uint32_tToBigEndian(args + 16, 77);
+        dispatch("AOC_SET_EPOCH", (20 << 8) | 5, args, 20);
+        dispatch("MEM_RESET", (200 << 8) | 7, args, 0);
+        uint32_tToBigEndian(args, 0x8000);
+        memcpy(args + 4, "hello", 5);
+        dispatch("MEM_UPLOAD", (200 << 8) | 9, args, 9);
+        dispatch("MEM_UPLOAD without data", (200 << 8) | 9, args, 4);
+
+        PRINTF("__________________ unknown ids\n");
+        dispatch("service", (20 << 8) | 0, args, 0);
+        dispatch("subservice not defined", (20 << 8) | 6, args, 0);
+        dispatch("service not defined", (21 << 8) | 1, args, 0);
+        dispatch("all bits", 0xffff, args, 0);
+
+        PRINTF("__________________ wrong lengths\n");
+        dispatch("AOC_NOP with arguments", (20 << 8) | 1, args, 1);
+        dispatch("AOC_POINT too short", (20 << 8) | 3, args, 7);
+        dispatch("AOC_POINT too long", (20 << 8) | 3, args, 9);
+        dispatch("MEM_UPLOAD shorter than address", (200 << 8) | 9, args, 3);
+        PRINTF("  handler calls %d\n", static_cast<int>(handlers.calls));
+
+        PRINTF("\nThis run (test) terminates now!\n");
+        hwResetAndReboot();
+    }
+} telecommandDispatcherTester;
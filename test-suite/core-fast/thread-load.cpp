@@ -0,0 +1,80 @@
+#include "rodos.h"
+
+/**
+ * CPU time accounting: a periodic thread (50 ms, deadline 20 ms) which
+ * once works longer than its deadline and once longer than 2 periods: the
+ * late beat is an overrun too and the beat after it is missed. Then the
+ * report of a ThreadLoadMonitor. The CPU times depend on the host (load),
+ * the number of threads on the port: only relations are printed.
+ */
+
+uint32_t printfMask = 0;
+
+static ThreadLoadMonitor monitor(100 * SECONDS); // reports when asked
+
+static size_t   reportLen = 0;
+static uint32_t reports   = 0;
+class ReportReceiver : public Subscriber {
+  public:
+    ReportReceiver() : Subscriber(threadLoadTopic, "reportReceiver") {}
+    uint32_t put(const uint32_t, const size_t len, void*, const NetMsgInfo&) override {
+        reportLen = len;
+        reports++;
+        return 1;
+    }
+} reportReceiver;
+
+class PeriodicWorker : public StaticThread<> {
+  public:
+    Thread* tester = 0;
+    PeriodicWorker() : StaticThread<>("PeriodicWorker") {}
+
+    void run() {
+        setPeriodicBeat(NOW() + 50 * MILLISECONDS, 50 * MILLISECONDS, 20 * MILLISECONDS);
+        for(uint32_t i = 0; i < 10; i++) {
+            suspendUntilNextBeat();
+            int64_t work = (i == 3) ? 40 * MILLISECONDS : (i == 6) ? 120 * MILLISECONDS : 1 * MILLISECONDS;
+            BUSY_WAITING_UNTIL(NOW() + work);
+        }
+        suspendUntilNextBeat(); // the end of the last activation
+        if(tester) tester->resume();
+        suspendCallerUntil();
+    }
+} periodicWorker;
+
+class ThreadLoadTester : public StaticThread<> {
+  public:
+    ThreadLoadTester() : StaticThread<>("ThreadLoadTester") {}
+
+    void run() {
+        printfMask = 1;
+        PRINTF("__________________ periodic thread\n");
+        int64_t start         = NOW();
+        periodicWorker.tester = this;
+        suspendCallerUntil(NOW() + 5 * SECONDS); // resumed by the worker
+
+        int64_t maxActivation = periodicWorker.getMaxActivationTime();
+        int64_t cpuTime       = periodicWorker.getCpuTime();
+        PRINTF("  activations %d, deadline overruns %d, missed beats %d\n", static_cast<int>(periodicWorker.getActivations()),
+               static_cast<int>(periodicWorker.getDeadlineOverruns()), static_cast<int>(periodicWorker.getMissedBeats()));
+        PRINTF("  max activation > 0: %d, <= CPU time: %d\n", maxActivation > 0, maxActivation <= cpuTime);
+        PRINTF("  CPU time less than the time: %d\n", cpuTime < NOW() - start + 50 * MILLISECONDS);
+
+        PRINTF("__________________ report\n");
+        monitor.report();
+        const ThreadLoadReport& report = monitor.lastReportMsg;
+        uint32_t                worker = 0;
+        for(uint32_t i = 0; i < report.numOfThreads; i++) {
+            if(report.threads[i].threadId == periodicWorker.listElementID) worker = i;
+        }
+        const ThreadLoadEntry& entry = report.threads[worker];
+        PRINTF("  reports %d, length for all threads %d\n", static_cast<int>(reports),
+               reportLen == ThreadLoadReport::lenForThreads(report.numOfThreads));
+        PRINTF("  worker: load > 0 %d, CPU load >= worker %d, activations %d, overruns %d, missed %d, max activation %d\n",
+               entry.loadPermille > 0, report.cpuLoadPermille >= entry.loadPermille, static_cast<int>(entry.activations), entry.deadlineOverruns,
+               entry.missedBeats, entry.maxActivationUs == static_cast<uint32_t>(maxActivation / MICROSECONDS));
+
+        PRINTF("\nThis run (test) terminates now!\n");
+        hwResetAndReboot();
+    }
+} threadLoadTester;
@@ -0,0 +1,226 @@
+#include "rodos.h"
+#include "ccsds/tm-frame-multiplexer.h"
+
+/**
+ * TmFrameMultiplexer with small frames (64 bytes, 52 for packets): idle
+ * frames, packets across frame boundaries (first header pointer), flush,
+ * full frame buffers, round robin, priority and bandwidth share scheduling,
+ * the master and virtual channel frame counters (also their wrap around),
+ * the CLCW and the FECF. The packets are read back from the frames like on
+ * ground.
+ */
+
+using namespace CCSDS;
+
+uint32_t printfMask = 0;
+
+static constexpr uint16_t FRAME_LEN = 64;
+static constexpr uint8_t  VCS       = 3;
+
+static TmFrameMultiplexer<FRAME_LEN, VCS, 4> downlink(321);
+static TmFrameMultiplexer<FRAME_LEN, VCS, 4> withoutTrailer(321, false, false);
+static RODOS::CRC                            crc;
+
+/// a source packet with a primary header, the user data bytes are the sequence count
+static void makePacket(uint8_t* packet, uint16_t apid, uint16_t sequenceCount, uint16_t len) {
+    packet[0] = static_cast<uint8_t>(apid >> 8);
+    packet[1] = static_cast<uint8_t>(apid & 0xff);
+    packet[2] = static_cast<uint8_t>(0xc0 | (sequenceCount >> 8));
+    packet[3] = static_cast<uint8_t>(sequenceCount & 0xff);
+    packet[4] = static_cast<uint8_t>((len - 7) >> 8);
+    packet[5] = static_cast<uint8_t>((len - 7) & 0xff);
+    for(uint16_t i = 6; i < len; i++) packet[i] = static_cast<uint8_t>(sequenceCount);
+}
+
+static bool writePacket(uint8_t vcid, uint16_t apid, uint16_t sequenceCount, uint16_t len) {
+    uint8_t packet[FRAME_LEN];
+    makePacket(packet, apid, sequenceCount, len);
+    return downlink.writePacket(vcid, packet, len);
+}
+
+/// the packets of a virtual channel, from the data fields of its frames
+struct GroundChannel {
+    uint8_t  stream[512];
+    uint16_t len    = 0;
+    bool     synced = false;
+
+    void add(const uint8_t* frame, uint16_t dataEnd) {
+        uint16_t firstHeader = static_cast<uint16_t>(((frame[4] & 0x07) << 8) | frame[5]);
+        uint16_t from        = TF_PRIMARY_HEADER_SIZE;
+        if(!synced) {
+            if(firstHeader == FHP_NO_PACKET_START) return;
+            from   = static_cast<uint16_t>(from + firstHeader);
+            synced = true;
+        }
+        for(uint16_t i = from; i < dataEnd; i++) stream[len++] = frame[i];
+        printPackets();
+    }
+
+    /// the complete packets, removed from the stream
+    void printPackets() {
+        uint16_t pos = 0;
+        while(len - pos >= 6) {
+            uint16_t packetLen = static_cast<uint16_t>(((stream[pos + 4] << 8) | stream[pos + 5]) + 7);
+            if(len - pos < packetLen) break;
+            uint16_t apid          = static_cast<uint16_t>(((stream[pos] & 0x07) << 8) | stream[pos + 1]);
+            uint16_t sequenceCount = static_cast<uint16_t>(((stream[pos + 2] & 0x3f) << 8) | stream[pos + 3]);
+            if(apid == IDLE_APID) {
+                PRINTF("      idle packet %d bytes\n", static_cast<int>(packetLen));
+            } else {
+                bool ok = true;
+                for(uint16_t i = 6; i < packetLen; i++) ok = ok && stream[pos + i] == static_cast<uint8_t>(sequenceCount);
+                PRINTF("      packet apid %d count %d, %d bytes, data ok %d\n", static_cast<int>(apid), static_cast<int>(sequenceCount),
+                       static_cast<int>(packetLen), ok);
+            }
+            pos = static_cast<uint16_t>(pos + packetLen);
+        }
+        for(uint16_t i = pos; i < len; i++) stream[i - pos] = stream[i];
+        len = static_cast<uint16_t>(len - pos);
+    }
+};
+
+static GroundChannel ground[VCS];
+static bool          toGround = true; ///< until the scheduling tests, which send only full frames
+
+static bool crcOk(const uint8_t* frame) {
+    uint16_t fecf = crc.computeCRC(frame, FRAME_LEN - TF_FECF_SIZE, CRC_SEED);
+    return frame[FRAME_LEN - 2] == (fecf >> 8) && frame[FRAME_LEN - 1] == (fecf & 0xff);
+}
+
+/// header fields, CLCW and FECF of the next frame, its packets
+static void sendFrame() {
+    const uint8_t* frame       = downlink.nextFrame();
+    uint16_t       spaceCraft  = static_cast<uint16_t>((frame[0] << 4) | (frame[1] >> 4));
+    uint8_t        vcid        = static_cast<uint8_t>((frame[1] >> 1) & 0x07);
+    uint16_t       firstHeader = static_cast<uint16_t>(((frame[4] & 0x07) << 8) | frame[5]);
+    uint32_t       ocf         = (static_cast<uint32_t>(frame[58]) << 24) | (static_cast<uint32_t>(frame[59]) << 16) |
+                   (static_cast<uint32_t>(frame[60]) << 8) | frame[61];
+    PRINTF("  frame sc %d vc %d master %d vc count %d ocf flag %d fhp %03x clcw %08x fecf ok %d\n", static_cast<int>(spaceCraft),
+           static_cast<int>(vcid), static_cast<int>(frame[2]), static_cast<int>(frame[3]), frame[1] & 1,
+           static_cast<unsigned int>(firstHeader), static_cast<unsigned int>(ocf), crcOk(frame));
+    if(vcid < VCS && toGround) ground[vcid].add(frame, FRAME_LEN - TF_OCF_SIZE - TF_FECF_SIZE);
+    downlink.releaseFrame();
+}
+
+/// the virtual channels of the next n frames
+static void printSchedule(uint32_t n) {
+    PRINTF("  ");
+    for(uint32_t i = 0; i < n; i++) {
+        const uint8_t* frame = downlink.nextFrame();
+        PRINTF("%d", (frame[1] >> 1) & 0x07);
+        downlink.releaseFrame();
+    }
+    PRINTF("\n");
+}
+
+/// sends the frames of all channels, up to the first idle frame
+static void drain() {
+    while(((downlink.nextFrame()[1] >> 1) & 0x07) != TmFrameMultiplexer<FRAME_LEN, VCS, 4>::IDLE_VCID) downlink.releaseFrame();
+}
+
+/// fills the frame buffers of vcid with packets of a whole data field
+static void fillFrames(uint8_t vcid, uint32_t frames) {
+    for(uint32_t i = 0; i < frames; i++) writePacket(vcid, static_cast<uint16_t>(100 + vcid), static_cast<uint16_t>(i), downlink.dataFieldLen());
+}
+
+class TmFrameMultiplexerTester : public StaticThread<> {
+  public:
+    void run() {
+        printfMask = 1;
+
+        PRINTF("__________________ nothing to send: idle frames\n");
+        PRINTF("  data field %d bytes\n", static_cast<int>(downlink.dataFieldLen()));
+        sendFrame();
+        downlink.setClcw(0x01020304);
+        sendFrame();
+        PRINTF("  idle frames %d\n", static_cast<int>(downlink.idleFrames));
+
+        PRINTF("__________________ vc 0: packets of 20 bytes, the third continues in the next frame\n");
+        for(uint16_t i = 0; i < 3; i++) PRINTF("  written %d\n", writePacket(0, 16, i, 20));
+        sendFrame();
+        sendFrame(); // the second frame is not full: idle
+        PRINTF("  two more, then flush: the rest of the frame is an idle packet\n");
+        writePacket(0, 16, 3, 20);
+        writePacket(0, 16, 4, 20);
+        PRINTF("  flushed %d\n", downlink.flush(0));
+        sendFrame();
+        sendFrame();
+
+        PRINTF("__________________ flush with less room than an idle packet: it continues\n");
+        writePacket(0, 16, 5, 48);
+        PRINTF("  flushed %d\n", downlink.flush(0));
+        sendFrame();
+        PRINTF("  flushed %d\n", downlink.flush(0));
+        sendFrame();
+
+        PRINTF("__________________ vc 1: all 4 frame buffers in use\n");
+        uint32_t written = 0;
+        for(uint16_t i = 0; i < 6; i++) written += writePacket(1, 17, i, downlink.dataFieldLen());
+        PRINTF("  written %d of 6, overflows %d, too long %d\n", static_cast<int>(written),
+               static_cast<int>(downlink.getStatistics(1).overflows), writePacket(1, 17, 6, static_cast<uint16_t>(downlink.dataFieldLen() + 1)));
+        for(uint32_t i = 0; i < 4; i++) sendFrame();
+        PRINTF("  after sending: written %d\n", writePacket(1, 17, 6, 20));
+        downlink.flush(1);
+        sendFrame();
+
+        PRINTF("__________________ round robin: 4 frames in vc 0, 2 in vc 1, 3 in vc 2\n");
+        toGround = false;
+        fillFrames(0, 4);
+        fillFrames(1, 2);
+        fillFrames(2, 3);
+        printSchedule(10);
+
+        PRINTF("__________________ priority: vc 2 before vc 0 and vc 1\n");
+        downlink.setScheduling(VcScheduling::PRIORITY);
+        downlink.setPriority(2, 5);
+        fillFrames(0, 3);
+        fillFrames(1, 3);
+        fillFrames(2, 3);
+        printSchedule(10);
+
+        PRINTF("__________________ bandwidth share 3:1 for vc 0 and vc 1, while both have frames\n");
+        downlink.setScheduling(VcScheduling::BANDWIDTH_SHARE);
+        downlink.setShare(0, 3);
+        downlink.setShare(1, 1);
+        uint32_t sent[2] = { 0, 0 };
+        for(uint32_t i = 0; i < 400; i++) {
+            fillFrames(0, 4);
+            fillFrames(1, 4);
+            const uint8_t* frame = downlink.nextFrame();
+            sent[(frame[1] >> 1) & 0x01]++;
+            downlink.releaseFrame();
+        }
+        PRINTF("  vc 0 %d frames, vc 1 %d frames\n", static_cast<int>(sent[0]), static_cast<int>(sent[1]));
+        drain();
+
+        PRINTF("__________________ frame counters: master of all frames, one per vc, modulo 256\n");
+        uint32_t total = downlink.idleFrames;
+        for(uint8_t vcid = 0; vcid < VCS; vcid++) {
+            total += downlink.getStatistics(vcid).frames;
+            PRINTF("  vc %d frames sent %d\n", static_cast<int>(vcid), static_cast<int>(downlink.getStatistics(vcid).frames));
+        }
+        PRINTF("  idle frames %d, all frames %d: the next master count %d, vc 0 count %d, idle count %d\n",
+               static_cast<int>(downlink.idleFrames), static_cast<int>(total), static_cast<int>(total % 256),
+               static_cast<int>(downlink.getStatistics(0).frames % 256), static_cast<int>(downlink.idleFrames % 256));
+        fillFrames(0, 1);
+        sendFrame();
+        sendFrame();
+
+        PRINTF("__________________ FECF: a damaged frame\n");
+        uint8_t copy[FRAME_LEN];
+        memcpy(copy, downlink.nextFrame(), FRAME_LEN);
+        downlink.releaseFrame();
+        PRINTF("  fecf ok %d, ", crcOk(copy));
+        copy[20] ^= 0x10;
+        PRINTF("one bit changed: fecf ok %d\n", crcOk(copy));
+
+        PRINTF("__________________ without CLCW and FECF\n");
+        const uint8_t* frame = withoutTrailer.nextFrame();
+        PRINTF("  data field %d bytes, ocf flag %d, last byte %02x (idle data)\n", static_cast<int>(withoutTrailer.dataFieldLen()), frame[1] & 1,
+               static_cast<unsigned int>(frame[FRAME_LEN - 1]));
+        withoutTrailer.releaseFrame();
+
+        PRINTF("\nThis run (test) terminates now!\n");
+        hwResetAndReboot();
+    }
+} tmFrameMultiplexerTester;
@@ -0,0 +1,129 @@
+#include "rodos.h"
+
+/**
+ * TraceRing: semaphore, publish, time event, suspend and user events of
+ * this thread, a ring which overwrites the oldest events and the dump.
+ * Only the events of this test are printed, the timer signals are traced too.
+ * The thread switches differ from port to port (posix: run and wait of this
+ * thread, bare-metal: the timer interrupt and the idle thread), they are only
+ * counted.
+ */
+
+uint32_t printfMask = 0;
+
+static Topic<int32_t> traceTopic(3970, "traceTopic");
+static int32_t        received = 0;
+static SubscriberReceiver<int32_t> traceReceiver(traceTopic, [](int32_t& msg) { received += msg; });
+
+static Semaphore traceSemaphore;
+
+class TraceTimeEvent : public TimeEvent {
+  public:
+    TraceTimeEvent() : TimeEvent("traceTimeEvent") {}
+    void handle() {}
+} traceTimeEvent;
+
+static TraceEvent events[64];
+static TraceEvent copied[64];
+static TraceEvent fewEvents[8];
+static uint8_t    dumpBuffer[4000];
+
+static const char* typeName(uint8_t type) {
+    static const char* names[] = { "-", "THREAD_RUN", "THREAD_WAIT", "SEMAPHORE_REQUEST", "SEMAPHORE_ENTER", "SEMAPHORE_LEAVE", "PUBLISH_BEGIN",
+                                   "PUBLISH_END", "TIME_EVENT_BEGIN", "TIME_EVENT_END", "INTERRUPT_BEGIN", "INTERRUPT_END", "USER" };
+    return (type <= static_cast<uint8_t>(TraceEventType::USER)) ? names[type] : "?";
+}
+
+class TraceTester : public StaticThread<> {
+  public:
+    TraceTester() : StaticThread<>("TraceTester") {}
+
+    const char* objectName(uint32_t object) {
+        if(object == traceId(this)) return "TraceTester";
+        if(object == traceId(&traceSemaphore)) return "traceSemaphore";
+        if(object == traceId(&traceTimeEvent)) return "traceTimeEvent";
+        if(object == 3970) return "traceTopic";
+        return "other";
+    }
+
+    void run() {
+        printfMask = 1;
+        uint32_t me = traceId(this);
+
+        PRINTF("__________________ events of this thread\n");
+        traceRing.start(events);
+        traceSemaphore.enter();
+        traceSemaphore.leave();
+        traceTopic.publish(5);
+        traceTimeEvent.activateAt(NOW() + 20 * MILLISECONDS);
+        suspendCallerUntil(NOW() + 300 * MILLISECONDS);
+        traceRing.record(TraceEventType::USER, 7, 42);
+        traceRing.stop();
+
+        uint32_t numOfCopied = traceRing.copyEvents(copied, 64);
+        int64_t  lastTime    = 0;
+        bool     inOrder     = true;
+        uint32_t switches    = 0;
+        for(uint32_t i = 0; i < numOfCopied; i++) {
+            TraceEvent& event = copied[i];
+            if(event.type == static_cast<uint8_t>(TraceEventType::THREAD_RUN)) switches++;
+            if(event.type == static_cast<uint8_t>(TraceEventType::THREAD_RUN) || event.type == static_cast<uint8_t>(TraceEventType::THREAD_WAIT) ||
+               event.type == static_cast<uint8_t>(TraceEventType::INTERRUPT_BEGIN) || event.type == static_cast<uint8_t>(TraceEventType::INTERRUPT_END)) {
+                continue;
+            }
+            if(event.thread != me && event.object != traceId(&traceTimeEvent)) continue;
+            if(event.time < lastTime) inOrder = false;
+            lastTime = event.time;
+            const char* name = (event.type == static_cast<uint8_t>(TraceEventType::USER)) ? "" : objectName(event.object);
+            PRINTF("  %s %s arg %d, thread %s\n", typeName(event.type), name, static_cast<int>(event.arg), (event.thread == me) ? "TraceTester" : "-");
+        }
+        PRINTF("  thread switches traced %d\n", switches > 0);
+        PRINTF("  in order %d, received %d, recording %d\n", inOrder, static_cast<int>(received), traceRing.isRecording());
+
+        PRINTF("__________________ dump\n");
+        PRINTF("  too short: %d\n", static_cast<int>(traceRing.dump(dumpBuffer, 30)));
+        size_t len = traceRing.dump(dumpBuffer, sizeof(dumpBuffer));
+        bool   magicOk     = memcmp(dumpBuffer, "RTRC", 4) == 0;
+        uint32_t numOfNames  = bigEndianToUint32_t(&dumpBuffer[8]);
+        uint32_t numOfEvents = bigEndianToUint32_t(&dumpBuffer[12]);
+        PRINTF("  magic %d, version %d, events %d\n", magicOk, static_cast<int>(bigEndianToUint16_t(&dumpBuffer[4])), numOfEvents == numOfCopied);
+        size_t pos = TRACE_DUMP_HEADER_SIZE;
+        for(uint32_t i = 0; i < numOfNames; i++) {
+            uint8_t  kind    = dumpBuffer[pos];
+            uint8_t  nameLen = dumpBuffer[pos + 1];
+            uint32_t id      = bigEndianToUint32_t(&dumpBuffer[pos + 2]);
+            char     name[64];
+            memcpy(name, &dumpBuffer[pos + 6], nameLen < 63 ? nameLen : 63);
+            name[nameLen < 63 ? nameLen : 63] = 0;
+            if(strcmp(objectName(id), name) == 0) PRINTF("  name kind %d: %s\n", kind, name);
+            pos += 6u + nameLen;
+        }
+        PRINTF("  length %d\n", len == pos + numOfEvents * TRACE_DUMP_EVENT_SIZE);
+        const uint8_t* last = &dumpBuffer[len - TRACE_DUMP_EVENT_SIZE];
+        PRINTF("  last: type %s, object %d, arg %d\n", typeName(last[20]), static_cast<int>(bigEndianToUint32_t(&last[12])),
+               static_cast<int>(bigEndianToUint32_t(&last[16])));
+
+        size_t shortLen = traceRing.dump(dumpBuffer, pos + 3 * TRACE_DUMP_EVENT_SIZE + 10);
+        PRINTF("  3 events fit: events %d, length %d\n", static_cast<int>(bigEndianToUint32_t(&dumpBuffer[12])),
+               shortLen == pos + 3 * TRACE_DUMP_EVENT_SIZE);
+
+        PRINTF("__________________ 20 events in a ring of 8\n");
+        traceRing.start(fewEvents);
+        for(uint32_t i = 0; i < 20; i++) traceRing.record(TraceEventType::USER, i);
+        traceRing.stop();
+        numOfCopied        = traceRing.copyEvents(copied, 64);
+        uint32_t lastUser  = 0;
+        bool     ascending = true;
+        for(uint32_t i = 0; i < numOfCopied; i++) {
+            if(copied[i].type != static_cast<uint8_t>(TraceEventType::USER)) continue;
+            if(copied[i].object < lastUser) ascending = false;
+            lastUser = copied[i].object;
+        }
+        uint32_t recorded = traceRing.numOfRecorded();
+        PRINTF("  copied %d, last %d, ascending %d, overwritten %d\n", static_cast<int>(numOfCopied), static_cast<int>(lastUser), ascending,
+               traceRing.numOfOverwritten() == recorded - 8);
+
+        PRINTF("\nThis run (test) terminates now!\n");
+        hwResetAndReboot();
+    }
+} traceTester;
@@ -0,0 +1,105 @@
+#include "rodos.h"
+
+/**
+ * Compact headers for low bandwidth links: checks that decoded messages are
+ * identical to the sent ones and computes how many messages fit through a
+ * simulated 115200 baud UART (8N1, S3P framing as in LinkinterfaceUART).
+ */
+
+uint32_t printfMask = 0;
+
+static constexpr uint32_t UART_BYTES_PER_SECOND = 115200 / 10; // 8 data bits, start and stop bit
+static constexpr int32_t  MSGS_PER_RUN          = 100;
+
+class CountingS3pSender : public S3pSenderSynchronous {
+  public:
+    uint32_t bytesOnWire = 0;
+    void putByte([[gnu::unused]] uint8_t c) override { bytesOnWire++; }
+};
+
+static NetworkMessage prepareTestMsg(int32_t i, uint16_t payloadLen) {
+    static uint8_t payload[64];
+    for(uint16_t k = 0; k < payloadLen; k++) payload[k] = static_cast<uint8_t>(i + k);
+
+    NetworkMessage msg;
+    NetMsgInfo     info;
+    info.senderNode          = 5;
+    info.senderThreadId      = 0x12345678;
+    info.sentTime            = 10 * SECONDS + i * 10 * MILLISECONDS;
+    info.receiverNode        = 3;
+    info.receiverNodesBitMap = 0x08;
+    info.sequenceNr          = static_cast<uint32_t>(i + 1);
+    prepareNetworkMessage(msg, 1002 + static_cast<uint32_t>(i % 3), payload, payloadLen, info);
+    return msg;
+}
+
+static bool sameMsg(NetworkMessage& a, NetworkMessage& b) {
+    return a.numberOfBytesToSend() == b.numberOfBytesToSend() && memcmp(&a, &b, a.numberOfBytesToSend()) == 0;
+}
+
+/// bytes on the wire per message, averaged over MSGS_PER_RUN messages
+static uint32_t bytesPerMsg(uint16_t payloadLen, CompactHeader* codec, bool omitted, bool& allOk) {
+    CountingS3pSender wire;
+    CompactHeader     receiver;
+    for(int32_t i = 0; i < MSGS_PER_RUN; i++) {
+        NetworkMessage msg = prepareTestMsg(i, payloadLen);
+        if(codec == 0) {
+            wire.sendMsg(msg.numberOfBytesToSend(), reinterpret_cast<uint8_t*>(&msg));
+            continue;
+        }
+        size_t len = codec->encode(msg, codec->txBuffer, sizeof(codec->txBuffer));
+        wire.sendMsg(static_cast<int>(len), codec->txBuffer);
+
+        if(omitted) { // as set by the receiver
+            msg.put_receiverNode(-1);
+            msg.put_receiverNodesBitMap(0);
+            msg.put_senderThreadId(0);
+            msg.setCheckSum();
+        }
+        NetworkMessage decoded;
+        if(!receiver.decode(codec->txBuffer, len, decoded) || !sameMsg(msg, decoded)) allOk = false;
+    }
+    return wire.bytesOnWire / MSGS_PER_RUN;
+}
+
+class CompactHeaderTester : public StaticThread<> {
+  public:
+    void run() {
+        printfMask = 1;
+
+        PRINTF("__________________ standard header accepted by compact receivers\n");
+        CompactHeader  receiver;
+        NetworkMessage msg = prepareTestMsg(7, 8);
+        NetworkMessage decoded;
+        bool ok = receiver.decode(reinterpret_cast<uint8_t*>(&msg), msg.numberOfBytesToSend(), decoded) && sameMsg(msg, decoded);
+        PRINTF("  decoded ok: %d\n", ok);
+
+        PRINTF("__________________ corrupted compact message is rejected\n");
+        CompactHeader sender;
+        size_t len = sender.encode(msg, sender.txBuffer, sizeof(sender.txBuffer));
+        sender.txBuffer[len - 1] ^= 0x01;
+        PRINTF("  decoded: %d\n", receiver.decode(sender.txBuffer, len, decoded));
+
+        PRINTF("__________________ bytes per message and messages per second at 115200 baud\n");
+        PRINTF("  payload | standard        | compact         | compact, no thread id/bitmaps\n");
+        uint16_t payloadLens[] = { 4, 8, 16, 64 };
+        bool     allOk         = true;
+        for(uint16_t payloadLen : payloadLens) {
+            CompactHeader compact;
+            CompactHeader compactMinimal(CompactHeader::OMIT_THREAD_ID | CompactHeader::OMIT_ADDRESSING);
+
+            uint32_t standardBytes = bytesPerMsg(payloadLen, 0, false, allOk);
+            uint32_t compactBytes  = bytesPerMsg(payloadLen, &compact, false, allOk);
+            uint32_t minimalBytes  = bytesPerMsg(payloadLen, &compactMinimal, true, allOk);
+            PRINTF("  %7u | %3u B %5u msg/s | %3u B %5u msg/s | %3u B %5u msg/s\n",
+                   static_cast<unsigned>(payloadLen),
+                   static_cast<unsigned>(standardBytes), static_cast<unsigned>(UART_BYTES_PER_SECOND / standardBytes),
+                   static_cast<unsigned>(compactBytes), static_cast<unsigned>(UART_BYTES_PER_SECOND / compactBytes),
+                   static_cast<unsigned>(minimalBytes), static_cast<unsigned>(UART_BYTES_PER_SECOND / minimalBytes));
+        }
+        PRINTF("  all compact messages decoded identical: %d\n", allOk);
+
+        PRINTF("\nThis run (test) terminates now!\n");
+        hwResetAndReboot();
+    }
+} compactHeaderTester;
@@ -0,0 +1,191 @@
+#include "rodos.h"
+
+/**
+ * Content filters: subscribers get only messages which match a predicate
+ * over the message layout. Gateways with setContentFilterExport() send the
+ * filters of their subscribers and do not send messages no filter of
+ * another node matches. The link is simulated: it counts the sent messages
+ * and delivers the messages given to it as received ones.
+ */
+
+uint32_t printfMask = 0;
+
+struct Housekeeping {
+    uint8_t  mode;
+    uint8_t  flags;
+    int16_t  temperature;
+    uint32_t counter;
+    float    voltage;
+};
+
+class SimulatedLink : public Linkinterface {
+  public:
+    uint32_t       msgs    = 0;
+    uint32_t       reports = 0;
+    ContentFilter  lastReport; ///< of topic housekeeping
+    NetworkMessage toReceive;
+    bool           hasToReceive = false;
+
+    SimulatedLink() : Linkinterface(-1) {}
+    bool sendNetworkMsg(NetworkMessage& outgoingMessage) override {
+        if(outgoingMessage.get_topicId() != TOPIC_ID_FOR_CONTENT_FILTER_REPORT) {
+            msgs++;
+            return true;
+        }
+        if(bigEndianToUint32_t(outgoingMessage.userDataC) != 2100) return true;
+        reports++;
+        lastReport.deserialize(outgoingMessage.userDataC + 4, outgoingMessage.get_len() - 4u);
+        return true;
+    }
+    bool getNetworkMsg(NetworkMessage& inMsg, int32_t& numberOfReceivedBytes) override {
+        if(!hasToReceive) return false;
+        inMsg                 = toReceive;
+        numberOfReceivedBytes = -1;
+        hasToReceive          = false;
+        return true;
+    }
+    void suspendUntilDataReady(int64_t reactivationTime) override { Thread::suspendCallerUntil(reactivationTime); }
+};
+
+static SimulatedLink simulatedLink;
+static Gateway       gateway(&simulatedLink, true);
+
+static Topic<Housekeeping> housekeeping(2100, "housekeeping");
+static Topic<Housekeeping> remoteWanted(2101, "remoteWanted");
+static Topic<Housekeeping> noReports(2102, "noReports");
+
+static Fifo<Housekeeping, 16> safeModes, hotOrLowVoltage, notFlagged;
+static Subscriber             safeModeSubscriber(housekeeping, safeModes, "safeModes");
+static Subscriber             hotOrLowSubscriber(housekeeping, hotOrLowVoltage, "hotOrLow");
+static Subscriber             notFlaggedSubscriber(housekeeping, notFlagged, "notFlagged");
+
+static ContentFilter safeModeFilter, hotOrLowFilter, notFlaggedFilter;
+
+static void publishSamples(Topic<Housekeeping>& topic) {
+    for(uint32_t i = 0; i < 10; i++) {
+        Housekeeping sample;
+        sample.mode        = static_cast<uint8_t>(i % 4);
+        sample.flags       = static_cast<uint8_t>(i & 0x06);
+        sample.temperature = static_cast<int16_t>(10 * i);
+        sample.counter     = i;
+        sample.voltage     = 28.0f - static_cast<float>(i);
+        topic.publish(sample);
+    }
+}
+
+static void receiveReport(int32_t nodeNr, uint32_t topicId, const ContentFilter& filter) {
+    uint8_t report[64];
+    uint32_tToBigEndian(report, topicId);
+    NetMsgInfo info;
+    info.senderNode = nodeNr;
+    info.sequenceNr = 1;
+    prepareNetworkMessage(simulatedLink.toReceive, TOPIC_ID_FOR_CONTENT_FILTER_REPORT, report, 4 + filter.serialize(report + 4, sizeof(report) - 4), info);
+    simulatedLink.hasToReceive = true;
+    Thread::suspendCallerUntil(NOW() + 20 * MILLISECONDS);
+}
+
+static void printAll(const char* name, Fifo<Housekeeping, 16>& fifo) {
+    PRINTF("  %s:", name);
+    Housekeeping sample;
+    while(fifo.get(sample)) PRINTF(" %d", static_cast<int>(sample.counter));
+    PRINTF("\n");
+}
+
+class ContentFilterTester : public StaticThread<> {
+  public:
+    void init() {
+        safeModeFilter.compare(offsetof(Housekeeping, mode), FieldType::U8, FilterOp::EQ, 0);
+        hotOrLowFilter.compare(offsetof(Housekeeping, temperature), FieldType::I16, FilterOp::GT, 60)
+          .compareFloat(offsetof(Housekeeping, voltage), FieldType::F32, FilterOp::LT, 22.5)
+          .logicalOr();
+        notFlaggedFilter.compare(offsetof(Housekeeping, flags), FieldType::U8, FilterOp::MASK_ANY, 0x04).logicalNot();
+        safeModeSubscriber.setContentFilter(&safeModeFilter);
+        hotOrLowSubscriber.setContentFilter(&hotOrLowFilter);
+        notFlaggedSubscriber.setContentFilter(&notFlaggedFilter);
+        gateway.setContentFilterExport();
+    }
+
+    void run() {
+        printfMask = 1;
+        setNodeNumber(0);
+
+        PRINTF("__________________ local subscribers, counters 0..9\n");
+        publishSamples(housekeeping);
+        printAll("mode == 0                       ", safeModes);
+        printAll("temperature > 60 || voltage < 22.5", hotOrLowVoltage);
+        printAll("!(flags & 0x04)                 ", notFlagged);
+        PRINTF("  filtered: %d %d %d\n", static_cast<int>(safeModeSubscriber.filteredMsgs),
+               static_cast<int>(hotOrLowSubscriber.filteredMsgs), static_cast<int>(notFlaggedSubscriber.filteredMsgs));
+
+        PRINTF("__________________ special cases\n");
+        Housekeeping sample;
+        memset(&sample, 0, sizeof(sample));
+        PRINTF("  field beyond the message: %d\n", safeModeFilter.matches(&sample, 0));
+        ContentFilter empty, unbalanced, tooLong;
+        unbalanced.compare(0, FieldType::U8, FilterOp::EQ, 1).compare(1, FieldType::U8, FilterOp::EQ, 1);
+        for(uint32_t i = 0; i <= ContentFilter::MAX_INSTRUCTIONS; i++) tooLong.compare(0, FieldType::U8, FilterOp::EQ, 1);
+        PRINTF("  empty: valid %d matches %d\n", empty.isValid(), empty.matches(&sample, sizeof(sample)));
+        PRINTF("  unbalanced: valid %d matches %d\n", unbalanced.isValid(), unbalanced.matches(&sample, sizeof(sample)));
+        PRINTF("  too long: valid %d matches %d\n", tooLong.isValid(), tooLong.matches(&sample, sizeof(sample)));
+        ContentFilter floatMask;
+        floatMask.compareFloat(0, FieldType::F32, FilterOp::MASK_ANY, 1.0);
+        PRINTF("  mask of a float: valid %d\n", floatMask.isValid());
+
+        PRINTF("__________________ serialized and read back\n");
+        uint8_t buf[128];
+        size_t  len = hotOrLowFilter.serialize(buf, sizeof(buf));
+        ContentFilter copy;
+        size_t  read = copy.deserialize(buf, len);
+        PRINTF("  %d bytes, read %d, instructions %d\n", static_cast<int>(len), static_cast<int>(read), static_cast<int>(copy.length()));
+        buf[1] = 0x77; // unknown operation
+        read = copy.deserialize(buf, len);
+        PRINTF("  corrupted: read %d, valid %d\n", static_cast<int>(read), copy.isValid());
+        PRINTF("  too short: read %d\n", static_cast<int>(copy.deserialize(buf, 5)));
+
+        PRINTF("__________________ OR of the filters of all subscribers\n");
+        ContentFilter combined = safeModeFilter;
+        combined.appendOr(hotOrLowFilter);
+        PRINTF("  two: instructions %d, valid %d\n", static_cast<int>(combined.length()), combined.isValid());
+        bool fits = combined.appendOr(notFlaggedFilter);
+        PRINTF("  three: %d, instructions %d\n", fits, static_cast<int>(combined.length()));
+        fits = combined.appendOr(hotOrLowFilter);
+        PRINTF("  four: %d, valid %d (too long: matches all)\n", fits, combined.isValid());
+
+        PRINTF("__________________ gateway: report of the local filters of housekeeping\n");
+        suspendCallerUntil(NOW() + 50 * MILLISECONDS);
+        PRINTF("  report sent %d, instructions %d\n", simulatedLink.reports > 0, static_cast<int>(simulatedLink.lastReport.length()));
+        simulatedLink.reports = 0; // before the change: the gateway may report it at once
+        notFlaggedSubscriber.enable(false);
+        suspendCallerUntil(NOW() + 50 * MILLISECONDS);
+        memset(&sample, 0, sizeof(sample));
+        sample.voltage = 28.0f;
+        PRINTF("  without notFlagged: report sent %d, instructions %d, mode 0 matches %d\n", simulatedLink.reports > 0,
+               static_cast<int>(simulatedLink.lastReport.length()), simulatedLink.lastReport.matches(&sample, sizeof(sample)));
+        sample.mode = 1;
+        PRINTF("  mode 1 matches %d\n", simulatedLink.lastReport.matches(&sample, sizeof(sample)));
+
+        PRINTF("__________________ gateway: node 7 wants only mode 3 of remoteWanted\n");
+        ContentFilter mode3;
+        mode3.compare(offsetof(Housekeeping, mode), FieldType::U8, FilterOp::EQ, 3);
+        receiveReport(7, remoteWanted.topicId, mode3);
+        simulatedLink.msgs = 0;
+        publishSamples(remoteWanted);
+        PRINTF("  remoteWanted: %d of 10 sent, %d filtered\n", static_cast<int>(simulatedLink.msgs), static_cast<int>(gateway.contentFilteredMsgs));
+        simulatedLink.msgs = 0;
+        publishSamples(noReports);
+        PRINTF("  noReports: %d of 10 sent\n", static_cast<int>(simulatedLink.msgs));
+
+        PRINTF("__________________ gateway: table full, the filter of node 40 does not fit\n");
+        for(int32_t node = 10; node < 10 + CONTENT_FILTER_ENTRIES - 1; node++) receiveReport(node, noReports.topicId, mode3);
+        receiveReport(40, remoteWanted.topicId, mode3);
+        simulatedLink.msgs = 0;
+        publishSamples(remoteWanted);
+        PRINTF("  overflows %d, remoteWanted: %d of 10 sent\n", static_cast<int>(gateway.contentFilterOverflows), static_cast<int>(simulatedLink.msgs));
+        simulatedLink.msgs = 0;
+        publishSamples(noReports);
+        PRINTF("  noReports, now with filters: %d of 10 sent\n", static_cast<int>(simulatedLink.msgs));
+
+        PRINTF("\nThis run (test) terminates now!\n");
+        hwResetAndReboot();
+    }
+} contentFilterTester;
@@ -0,0 +1,132 @@
+#include "rodos.h"
+#include "distributed-topic-register.h"
+
+/**
+ * Distributed-topic-register: deltas as soon as subscribers are enabled
+ * or disabled, and the reports of another node (1234) with a lost delta,
+ * snapshot and digests, and after its restart.
+ */
+
+uint32_t printfMask = 0;
+
+static DistributedTopicRegisterDecoy linkTheRegister;
+
+static Topic<int32_t> position(2100, "position");
+static Topic<int32_t> attitude(2101, "attitude");
+static Topic<int32_t> images(2102, "images");
+static Topic<int32_t> unused(2103, "unused");
+
+static void nopReceiver([[gnu::unused]] int32_t& value) {}
+static SubscriberReceiver<int32_t> positionReceiver(position, nopReceiver, "positionReceiver");
+static SubscriberReceiver<int32_t> attitudeReceiver(attitude, nopReceiver, "attitudeReceiver");
+
+static const char* kindNames[] = { "DELTA", "DIGEST", "REQUEST", "SNAPSHOT" };
+
+/** Prints the reports of this node, except the periodic digests */
+class ReportPrinter : public SubscriberReceiver<TopicListPerNode> {
+  public:
+    uint32_t volatile numOfPrinted = 0;
+
+    ReportPrinter() : SubscriberReceiver<TopicListPerNode>(topicListDistribution, "reportPrinter") {}
+    void put(TopicListPerNode& report) override {
+        if(report.nodeNr != static_cast<uint32_t>(getNodeNumber()) || report.kind == TopicReportKind::DIGEST) return;
+        PRINTF("  sent %s generation %u:", kindNames[static_cast<int>(report.kind)], static_cast<unsigned>(report.generation));
+        for(uint32_t i = 0; i < static_cast<uint32_t>(report.numOfAdded + report.numOfRemoved); i++) {
+            PRINTF(" %s%u", (i < report.numOfAdded) ? "+" : "-", static_cast<unsigned>(report.topicIds[i]));
+        }
+        if(report.kind == TopicReportKind::REQUEST) PRINTF(" node %u", static_cast<unsigned>(report.requestedNode));
+        PRINTF("  (%u bytes)\n", static_cast<unsigned>(report.len()));
+        numOfPrinted = numOfPrinted + 1;
+    }
+} reportPrinter;
+
+static TopicListPerNode hisReport;
+
+static void receive(TopicReportKind kind, uint32_t generation, uint32_t numOfAdded, uint32_t numOfRemoved, const uint32_t* ids) {
+    hisReport.nodeNr       = 1234;
+    if(hisReport.bootId == 0) hisReport.bootId = 1;
+    hisReport.nodeIndex    = static_cast<uint8_t>(NodeSet::nodeIndex(1234));
+    hisReport.kind         = kind;
+    hisReport.generation   = generation;
+    hisReport.numOfAdded   = static_cast<uint16_t>(numOfAdded);
+    hisReport.numOfRemoved = static_cast<uint16_t>(numOfRemoved);
+    hisReport.chunk        = 0;
+    hisReport.firstTopicId = 0;
+    hisReport.lastTopicId  = UINT32_MAX;
+    for(uint32_t i = 0; i < numOfAdded + numOfRemoved; i++) hisReport.topicIds[i] = ids[i];
+    topicListDistribution.publish(hisReport, false);
+    Thread::suspendCallerUntil(NOW() + 50 * MILLISECONDS);
+}
+
+/** The register has a low priority: on posix other processes may delay it */
+static void waitForReports(uint32_t numOfPrinted) {
+    int64_t timeout = NOW() + 5 * SECONDS;
+    while(reportPrinter.numOfPrinted < numOfPrinted && NOW() < timeout) Thread::suspendCallerUntil(NOW() + 10 * MILLISECONDS);
+}
+
+static void printBitmaps() {
+    PRINTF("  bitmaps: position %x attitude %x images %x unused %x\n",
+           static_cast<unsigned>(position.receiverNodesBitMap), static_cast<unsigned>(attitude.receiverNodesBitMap),
+           static_cast<unsigned>(images.receiverNodesBitMap), static_cast<unsigned>(unused.receiverNodesBitMap));
+}
+
+class TopicRegisterTester : public StaticThread<> {
+  public:
+    void init() { attitudeReceiver.enable(false); }
+
+    void run() {
+        printfMask = 1;
+
+        PRINTF("__________________ start: topics with subscribers\n");
+        waitForReports(1);
+
+        PRINTF("__________________ enable attitude, disable position\n");
+        attitudeReceiver.enable(true);
+        waitForReports(2);
+        positionReceiver.enable(false);
+        waitForReports(3);
+
+        PRINTF("__________________ node 1234: generation 1\n");
+        uint32_t first[] = { 2102, 9999 };
+        receive(TopicReportKind::DELTA, 1, 2, 0, first);
+        printBitmaps();
+
+        PRINTF("__________________ node 1234: generation 3, 2 was lost\n");
+        uint32_t third[] = { 2103 };
+        receive(TopicReportKind::DELTA, 3, 1, 0, third);
+        waitForReports(4);
+        printBitmaps();
+
+        PRINTF("__________________ node 1234: snapshot of generation 3\n");
+        uint32_t all[] = { 2100, 2103, 5000 };
+        hisReport.digest = topicDigest(2100) + topicDigest(2103) + topicDigest(5000);
+        receive(TopicReportKind::SNAPSHOT, 3, 3, 0, all);
+        printBitmaps();
+
+        PRINTF("__________________ node 1234: digests, the same and another one\n");
+        receive(TopicReportKind::DIGEST, 3, 0, 0, 0);
+        suspendCallerUntil(NOW() + TOPIC_REQUEST_INTERVAL);
+        hisReport.digest = 4711;
+        receive(TopicReportKind::DIGEST, 3, 0, 0, 0);
+        waitForReports(5);
+
+        PRINTF("__________________ node 1234 requests my snapshot\n");
+        hisReport.requestedNode = static_cast<uint32_t>(getNodeNumber());
+        receive(TopicReportKind::REQUEST, 0, 0, 0, 0);
+        waitForReports(6);
+
+        PRINTF("__________________ node 1234 restarted: another boot id, generation 1\n");
+        hisReport.bootId = 2;
+        uint32_t afterRestart[] = { 2101 };
+        hisReport.digest = topicDigest(2101);
+        receive(TopicReportKind::DELTA, 1, 1, 0, afterRestart);
+        printBitmaps();
+
+        PRINTF("__________________ node 1234 restarted with the same boot id: digest of generation 0\n");
+        hisReport.digest = 0;
+        receive(TopicReportKind::DIGEST, 0, 0, 0, 0);
+        printBitmaps();
+
+        hwResetAndReboot();
+    }
+} topicRegisterTester;
@@ -0,0 +1,232 @@
+#include "rodos.h"
+
+/**
+ * Receivers beyond the 32 nodes of receiverNodesBitMap (NodeSet):
+ * the extension at the end of the user data, only sent by gateways with
+ * extended addressing, routers which send only to the links leading to the
+ * receivers, and receiving gateways which distribute only messages for them.
+ * Fragments of long messages carry only the bitmap. This node is node 5. Needs MAX_ADDRESSABLE_NODES 256: only on-posix, see CMakeLists.txt.
+ */
+
+uint32_t printfMask = 0;
+
+/** Prints what it would send */
+class RecordingLink : public Linkinterface {
+  public:
+    const char* name;
+    uint32_t    msgs = 0;
+
+    RecordingLink(const char* name_) : Linkinterface(-1), name(name_) {}
+    bool sendNetworkMsg(NetworkMessage& outgoingMessage) override {
+        msgs++;
+        if(outgoingMessage.get_topicId() < 2200 || outgoingMessage.get_topicId() > 2202) return true; // eg. topic reports, the router part
+        NodeSet receivers;
+        PRINTF("  %s: len %u, bitmap %08x, compressed %s, receivers", name, static_cast<unsigned>(outgoingMessage.get_len()),
+               static_cast<unsigned>(outgoingMessage.get_receiverNodesBitMap()),
+               (outgoingMessage.get_type() & NET_MSG_COMPRESSED) ? "yes" : "no");
+        if(!receivers.readFrom(outgoingMessage)) PRINTF(" only in bitmap");
+        for(int32_t i = receivers.next(0); i >= 0; i = receivers.next(static_cast<uint32_t>(i) + 1)) PRINTF(" %d", static_cast<int>(i));
+        PRINTF("\n");
+        return true;
+    }
+    void suspendUntilDataReady(int64_t reactivationTime) override { Thread::suspendCallerUntil(reactivationTime); }
+};
+
+/** Counts the routed messages */
+class CountingLink : public Linkinterface {
+  public:
+    uint32_t msgs = 0;
+    CountingLink() : Linkinterface(-1) {}
+    bool sendNetworkMsg([[gnu::unused]] NetworkMessage& outgoingMessage) override {
+        msgs++;
+        return true;
+    }
+    void suspendUntilDataReady(int64_t reactivationTime) override { Thread::suspendCallerUntil(reactivationTime); }
+};
+
+/** Delivers one message to its gateway */
+class InjectingLink : public Linkinterface {
+  public:
+    NetworkMessage msg;
+    bool volatile  ready = false;
+
+    InjectingLink() : Linkinterface(-1) {}
+    bool getNetworkMsg(NetworkMessage& inMsg, int32_t& numberOfReceivedBytes) override {
+        if(!ready) return false;
+        inMsg                 = msg;
+        numberOfReceivedBytes = -1;
+        ready                 = false;
+        return true;
+    }
+    void suspendUntilDataReady(int64_t reactivationTime) override { Thread::suspendCallerUntil(reactivationTime); }
+};
+
+/** Sends the messages back as if they came from node 7 */
+class LoopbackLink : public Linkinterface {
+  public:
+    Fifo<NetworkMessage, 16> messages;
+    uint32_t                 fragments   = 0;
+    uint32_t                 withNodeSet = 0;
+
+    LoopbackLink() : Linkinterface(-1) {}
+    bool sendNetworkMsg(NetworkMessage& outgoingMessage) override {
+        if(!(outgoingMessage.get_type() & NET_MSG_FRAGMENT)) return true;
+        fragments++;
+        if(outgoingMessage.get_type() & NET_MSG_RECEIVER_SET) withNodeSet++;
+        NetworkMessage msg = outgoingMessage;
+        msg.put_senderNode(7);
+        msg.setCheckSum();
+        return messages.put(msg);
+    }
+    bool getNetworkMsg(NetworkMessage& inMsg, int32_t& numberOfReceivedBytes) override {
+        numberOfReceivedBytes = -1;
+        return messages.get(inMsg);
+    }
+    void suspendUntilDataReady(int64_t reactivationTime) override { Thread::suspendCallerUntil(reactivationTime); }
+};
+
+struct Frame {
+    uint8_t data[200];
+};
+
+static Topic<int32_t> toSwarm(2200, "toSwarm");
+static Topic<int32_t> toNeighbours(2201, "toNeighbours");
+static Topic<Frame>   frames(2202, "frames");
+static Topic<int32_t> toNode72(2203, "toNode72");
+static Topic<int32_t> fromSwarm(2300, "fromSwarm");
+
+struct Image {
+    uint8_t pixels[3000];
+};
+
+static Topic<Image> images(2204, "images");
+static Image        sentImage;
+
+static RecordingLink      oldLink("old gateway"), newLink("extended gateway"), compressingLink("compressing gateway");
+static Gateway            oldGateway(&oldLink, true);
+static Gateway            newGateway(&newLink, true);
+static Gateway            compressingGateway(&compressingLink, true);
+static PayloadCompression compression;
+
+static CountingLink linkA, linkB, linkC;
+static Gateway      gatewayA(&linkA, true, false); // the router sends, not the gateways
+static Gateway      gatewayB(&linkB, true, false);
+static Gateway      gatewayC(&linkC, true, false);
+static Router       router(false, &gatewayA, &gatewayB, &gatewayC);
+
+static LoopbackLink loopback;
+static Gateway      loopbackGateway(&loopback, true);
+
+static InjectingLink injectingLink;
+static Gateway       receivingGateway(&injectingLink, false, false);
+
+static void fromSwarmReceiver(int32_t& value) { PRINTF("  fromSwarm got %d\n", static_cast<int>(value)); }
+static SubscriberReceiver<int32_t> fromSwarmSubscriber(fromSwarm, fromSwarmReceiver, "fromSwarmSubscriber");
+
+class ImageReceiver : public SubscriberReceiver<Image> {
+  public:
+    ImageReceiver() : SubscriberReceiver<Image>(images, "imageReceiver") {}
+    void put(Image& image, const NetMsgInfo& info) override {
+        if(info.senderNode != 7) return; // the local delivery
+        PRINTF("  image got from node 7, identical %d\n", memcmp(&image, &sentImage, sizeof(image)) == 0);
+    }
+} imageReceiver;
+
+static void arrivesFrom(CountingLink& link, int32_t senderNode) {
+    NetworkMessage msg;
+    NetMsgInfo     info;
+    int32_t        data = 0;
+    info.senderNode = senderNode;
+    info.sequenceNr = 1;
+    prepareNetworkMessage(msg, 3000, &data, sizeof(data), info);
+    info.linkId = link.getLinkdentifier();
+    router.put(3000, sizeof(msg), &msg, info);
+}
+
+static void publishToNode72(const char* title) {
+    linkA.msgs = linkB.msgs = linkC.msgs = 0;
+    for(int32_t i = 0; i < 10; i++) toNode72.publish(i);
+    PRINTF("  %s: link A %u, link B %u, link C %u msgs\n", title, static_cast<unsigned>(linkA.msgs),
+           static_cast<unsigned>(linkB.msgs), static_cast<unsigned>(linkC.msgs));
+}
+
+static void receive(int32_t value, uint32_t receiverIndex) {
+    NodeSet    receivers;
+    NetMsgInfo info;
+    receivers.add(receiverIndex);
+    receivers.add(200);
+    info.senderNode    = 77;
+    info.sequenceNr    = static_cast<uint32_t>(value);
+    info.receiverNodes = &receivers;
+    prepareNetworkMessage(injectingLink.msg, fromSwarm.topicId, &value, sizeof(value), info);
+    injectingLink.ready = true;
+    Thread::suspendCallerUntil(NOW() + 50 * MILLISECONDS);
+}
+
+class ExtendedAddressingTester : public StaticThread<> {
+  public:
+    void init() {
+        newGateway.setExtendedAddressing();
+        compressingGateway.setExtendedAddressing();
+        compressingGateway.setPayloadCompression(&compression);
+        compression.compressTopic(frames.topicId);
+        loopbackGateway.setExtendedAddressing();
+    }
+
+    void run() {
+        printfMask = 1;
+        setNodeNumber(5);
+
+        PRINTF("__________________ node set\n");
+        NodeSet nodes;
+        nodes.add(3);
+        nodes.add(40);
+        nodes.add(200);
+        PRINTF("  count %u, contains 40 %d, 41 %d, 200 %d, extended %d\n", static_cast<unsigned>(nodes.count()),
+               nodes.contains(40), nodes.contains(41), nodes.contains(200), nodes.isExtended());
+        PRINTF("  bitmap %08x, encoded %u bytes\n", static_cast<unsigned>(nodes.fold()), static_cast<unsigned>(nodes.encodedSize()));
+
+        PRINTF("__________________ receivers 40 and 200\n");
+        toSwarm.addReceiverNode(40);
+        toSwarm.addReceiverNode(200);
+        toSwarm.publish(1);
+
+        PRINTF("__________________ receivers 3 and 9: with 256 nodes the bitmap is ambiguous too\n");
+        toNeighbours.addReceiverNode(3);
+        toNeighbours.addReceiverNode(9);
+        toNeighbours.publish(2);
+
+        PRINTF("__________________ compressed, the receivers stay readable\n");
+        Frame frame;
+        memset(&frame, 0, sizeof(frame));
+        frames.addReceiverNode(100);
+        frames.publish(frame);
+
+        PRINTF("__________________ router: node 40 behind link A, 72 behind B, 200 behind C\n");
+        router.setRouteLearning();
+        arrivesFrom(linkA, 40);
+        arrivesFrom(linkB, 72);
+        arrivesFrom(linkC, 200);
+        toNode72.addReceiverNode(72); // bitmap bit 8: nodes 8, 40, 72, 104 ...
+        publishToNode72("bitmap");
+        router.setExtendedAddressing();
+        publishToNode72("node set");
+
+        PRINTF("__________________ receiving gateway, node 5\n");
+        receive(1, 5);
+        receive(2, 6);
+        receive(3, 5);
+
+        PRINTF("__________________ fragments, receivers 5, 40 and 200\n");
+        for(uint32_t i = 0; i < sizeof(sentImage.pixels); i++) sentImage.pixels[i] = static_cast<uint8_t>(i * 7);
+        images.addReceiverNode(5);
+        images.addReceiverNode(40);
+        images.addReceiverNode(200);
+        images.publish(sentImage);
+        Thread::suspendCallerUntil(NOW() + 100 * MILLISECONDS); // loopbackGateway reassembles it
+        PRINTF("  %u fragments, %u with node set\n", static_cast<unsigned>(loopback.fragments),
+               static_cast<unsigned>(loopback.withNodeSet));
+
+        hwResetAndReboot();
+    }
+} extendedAddressingTester;
@@ -0,0 +1,129 @@
+#include <unistd.h>
+
+#include "rodos.h"
+#include "mapped-recorder-storage.h"
+
+/**
+ * Flight recorder in memory mapped files (MappedRecorderStorage, posix):
+ * a second recorder on the same files stands for the next run after a
+ * restart. It finds the records of the first one and continues after the
+ * newest segment, also when the ring has wrapped around. count() while
+ * another thread records. Only on-posix, see CMakeLists.txt.
+ */
+
+uint32_t printfMask = 0;
+
+static constexpr const char* PATH_PREFIX = "/tmp/rodos-flight-recorder-test";
+static constexpr uint32_t    SEGMENTS    = 4;
+
+struct Sample {
+    uint32_t counter;
+    uint8_t  payload[52];
+};
+
+/// of the 1 KB segments, each record with its header
+static constexpr uint32_t RECORDS_PER_SEGMENT =
+      (1024 - sizeof(SegmentHeader) - sizeof(RecordHeader)) / (sizeof(RecordHeader) + sizeof(Sample));
+
+static Topic<Sample> samples(2210, "samples");
+
+static MappedRecorderStorage firstRunFiles(PATH_PREFIX, SEGMENTS, 1024);
+static MappedRecorderStorage nextRunFiles(PATH_PREFIX, SEGMENTS, 1024);
+static FlightRecorder        firstRun(firstRunFiles, "firstRun");
+static FlightRecorder        nextRun(nextRunFiles, "nextRun");
+
+static uint32_t replayedSamples = 0;
+static uint32_t firstReplayed   = 0;
+static uint32_t lastReplayed    = 0;
+static uint32_t outOfOrder      = 0;
+static bool     replaying       = false;
+
+static void receiveSample(Sample& sample) {
+    if(!replaying) return;
+    if(replayedSamples == 0) firstReplayed = sample.counter;
+    else if(sample.counter != lastReplayed + 1) outOfOrder++;
+    lastReplayed = sample.counter;
+    replayedSamples++;
+}
+static SubscriberReceiver<Sample> sampleReceiver(samples, receiveSample, "sampleReceiver");
+
+static void publishSamples(uint32_t from, uint32_t to) {
+    Sample sample;
+    memset(&sample, 0, sizeof(sample));
+    for(sample.counter = from; sample.counter < to; sample.counter++) samples.publish(sample);
+}
+
+static void replayNextRun() {
+    replayedSamples = 0;
+    outOfOrder      = 0;
+    replaying       = true;
+    nextRun.replay();
+    replaying = false;
+    PRINTF("  replayed %d: %d .. %d, out of order %d\n", static_cast<int>(replayedSamples),
+           static_cast<int>(firstReplayed), static_cast<int>(lastReplayed), static_cast<int>(outOfOrder));
+}
+
+/// records while the tester counts
+class BusyPublisher : public StaticThread<> {
+  public:
+    Atomic<bool> publishing{ false };
+    BusyPublisher() : StaticThread<>("busyPublisher", 100) {}
+    void run() {
+        uint32_t counter = 1000;
+        while(1) {
+            if(publishing) publishSamples(counter, counter + 1);
+            counter++;
+            suspendCallerUntil(NOW() + 100 * MICROSECONDS);
+        }
+    }
+} busyPublisher;
+
+class FlightRecorderFilesTester : public StaticThread<> {
+  public:
+    FlightRecorderFilesTester() : StaticThread<>("flightRecorderFilesTester", 200) {}
+
+    void init() {
+        char path[SPRINTF_MAX_SIZE];
+        for(uint32_t i = 0; i < SEGMENTS; i++) { // of an earlier run of this test
+            SPRINTF(path, "%s-%02d.rec", PATH_PREFIX, static_cast<int>(i));
+            unlink(path);
+        }
+        nextRun.enable(false);
+    }
+
+    void run() {
+        printfMask = 1;
+
+        PRINTF("__________________ first run: 70 samples, the ring wraps around\n");
+        publishSamples(0, 70);
+        PRINTF("  recorded %d, kept %d\n", static_cast<int>(firstRun.recordedMsgs), static_cast<int>(firstRun.count()));
+
+        PRINTF("__________________ restart: the records of the first run\n");
+        firstRun.enable(false);
+        nextRun.enable(true);
+        PRINTF("  count %d\n", static_cast<int>(nextRun.count()));
+        replayNextRun();
+
+        PRINTF("__________________ the next run continues after the newest segment\n");
+        publishSamples(70, 80);
+        PRINTF("  recorded %d, count %d\n", static_cast<int>(nextRun.recordedMsgs), static_cast<int>(nextRun.count()));
+        replayNextRun();
+
+        PRINTF("__________________ count while recording\n");
+        busyPublisher.publishing = true;
+        while(nextRun.recordedMsgs < 10 + SEGMENTS * RECORDS_PER_SEGMENT) { // all segments full of this run
+            suspendCallerUntil(NOW() + 1 * MILLISECONDS);
+        }
+        uint32_t wrongCounts = 0;
+        for(uint32_t i = 0; i < 200; i++) {
+            uint32_t count = nextRun.count();
+            if(count < (SEGMENTS - 1) * RECORDS_PER_SEGMENT || count > SEGMENTS * RECORDS_PER_SEGMENT) wrongCounts++;
+            suspendCallerUntil(NOW() + 200 * MICROSECONDS);
+        }
+        busyPublisher.publishing = false;
+        PRINTF("  wrong counts %d, recorded more than 100 %d\n", static_cast<int>(wrongCounts), nextRun.recordedMsgs > 100);
+
+        PRINTF("\nThis run (test) terminates now!\n");
+        hwResetAndReboot();
+    }
+} flightRecorderFilesTester;
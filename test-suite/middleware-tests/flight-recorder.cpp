@@ -0,0 +1,122 @@
+#include "rodos.h"
+
+/**
+ * Flight recorder: all messages published on this node are recorded in a
+ * RAM ring (4 segments of 1 KB) and replayed into the local subscribers,
+ * all or by time and topic, as fast as possible or paced. Old segments are
+ * overwritten, too long messages are not recorded.
+ */
+
+uint32_t printfMask = 0;
+
+struct Event {
+    uint16_t code;
+    uint16_t severity;
+};
+
+static Topic<uint32_t>      counters(2200, "counters");
+static Topic<Event>         events(2201, "events");
+static Topic<uint8_t[2000]> images(2202, "images");
+
+static RamRecorderStorage<1024, 4> storage;
+static FlightRecorder              recorder(storage);
+
+static uint32_t replayedCounters[64];
+static uint32_t numOfReplayedCounters = 0;
+static uint32_t lastReplayedCounter   = 0;
+static uint32_t replayedEvents        = 0;
+static bool     replaying             = false;
+
+static void receiveCounter(uint32_t& counter) {
+    if(!replaying) return;
+    if(numOfReplayedCounters < 64) replayedCounters[numOfReplayedCounters++] = counter;
+    lastReplayedCounter = counter;
+}
+static void receiveEvent([[gnu::unused]] Event& event) {
+    if(replaying) replayedEvents++;
+}
+static SubscriberReceiver<uint32_t> counterReceiver(counters, receiveCounter, "counterReceiver");
+static SubscriberReceiver<Event>    eventReceiver(events, receiveEvent, "eventReceiver");
+
+static uint32_t replay(int64_t from, int64_t to, uint32_t speed, uint32_t topicId) {
+    numOfReplayedCounters = 0;
+    replayedEvents        = 0;
+    replaying             = true;
+    uint32_t published    = recorder.replay(from, to, speed, topicId);
+    replaying             = false;
+    return published;
+}
+
+static void printReplayed(uint32_t published) {
+    PRINTF("  published %d, events %d, counters:", static_cast<int>(published), static_cast<int>(replayedEvents));
+    for(uint32_t i = 0; i < numOfReplayedCounters; i++) PRINTF(" %d", static_cast<int>(replayedCounters[i]));
+    PRINTF("\n");
+}
+
+class FlightRecorderTester : public StaticThread<> {
+  public:
+    void run() {
+        printfMask = 1;
+
+        PRINTF("__________________ counters 0..9, 3 events, 2 only local\n");
+        Event event = { 7, 1 };
+        for(uint32_t i = 0; i < 10; i++) {
+            counters.publish(i);
+            if(i % 4 == 0) events.publish(event);
+        }
+        uint32_t local = 100;
+        counters.publish(local, false);
+        counters.publish(local, false);
+        PRINTF("  recorded %d, count all %d, count counters %d\n", static_cast<int>(recorder.recordedMsgs),
+               static_cast<int>(recorder.count()), static_cast<int>(recorder.count(0, END_OF_TIME, counters.topicId)));
+
+        PRINTF("__________________ replay as fast as possible\n");
+        printReplayed(replay(0, END_OF_TIME, FlightRecorder::AS_FAST_AS_POSSIBLE, FlightRecorder::ALL_TOPICS));
+        PRINTF("  only events\n");
+        printReplayed(replay(0, END_OF_TIME, FlightRecorder::AS_FAST_AS_POSSIBLE, events.topicId));
+        PRINTF("  recorded after replays %d\n", static_cast<int>(recorder.recordedMsgs));
+
+        PRINTF("__________________ counters 20..29, 10 ms between them\n");
+        recorder.clear();
+        int64_t middle = 0;
+        for(uint32_t i = 20; i < 30; i++) {
+            if(i == 25) middle = NOW();
+            counters.publish(i);
+            suspendCallerUntil(NOW() + 10 * MILLISECONDS);
+        }
+        PRINTF("  from the 6th one\n");
+        printReplayed(replay(middle, END_OF_TIME, FlightRecorder::AS_FAST_AS_POSSIBLE, FlightRecorder::ALL_TOPICS));
+        PRINTF("  until the 5th one\n");
+        printReplayed(replay(0, middle, FlightRecorder::AS_FAST_AS_POSSIBLE, FlightRecorder::ALL_TOPICS));
+
+        int64_t start    = NOW();
+        replay(0, END_OF_TIME, 1, FlightRecorder::ALL_TOPICS);
+        int64_t realTime = NOW() - start;
+        start            = NOW();
+        replay(0, END_OF_TIME, 3, FlightRecorder::ALL_TOPICS);
+        int64_t threeTimes = NOW() - start;
+        PRINTF("  paced: speed 1 takes about 90 ms %d, speed 3 about 30 ms %d\n",
+               realTime > 80 * MILLISECONDS && realTime < 150 * MILLISECONDS,
+               threeTimes > 25 * MILLISECONDS && threeTimes < 60 * MILLISECONDS);
+
+        PRINTF("__________________ 200 counters in 4 segments of 1 KB\n");
+        recorder.clear();
+        for(uint32_t i = 0; i < 200; i++) counters.publish(i);
+        uint32_t kept      = recorder.count();
+        uint32_t published = replay(0, END_OF_TIME, FlightRecorder::AS_FAST_AS_POSSIBLE, FlightRecorder::ALL_TOPICS);
+        PRINTF("  kept %d, replayed %d, the last one %d, the oldest overwritten %d\n", static_cast<int>(kept),
+               static_cast<int>(published), static_cast<int>(lastReplayedCounter), kept < 200);
+
+        PRINTF("__________________ too long for a segment\n");
+        static uint8_t image[2000];
+        images.publish(image);
+        PRINTF("  dropped %d\n", static_cast<int>(recorder.droppedMsgs));
+
+        PRINTF("__________________ clear\n");
+        recorder.clear();
+        PRINTF("  count %d\n", static_cast<int>(recorder.count()));
+
+        PRINTF("\nThis run (test) terminates now!\n");
+        hwResetAndReboot();
+    }
+} flightRecorderTester;
@@ -0,0 +1,73 @@
+#include "rodos.h"
+
+/**
+ * Duplicate detection of the gateway: each sender node numbers its
+ * messages, the receiver keeps a sliding window of already received numbers.
+ * Older messages are duplicates, only a sentTime going back is a restart.
+ */
+
+uint32_t printfMask = 0;
+
+static SeenNode seenNode;
+
+static void check(uint32_t sequenceNr, int64_t sentTime = 10 * SECONDS) {
+    bool duplicate = seenNode.isDuplicate(sequenceNr, sentTime);
+    PRINTF("  seqNr %u -> %s\n", static_cast<unsigned>(sequenceNr), duplicate ? "duplicate" : "new");
+}
+
+class DuplicateTester : public StaticThread<> {
+  public:
+    void run() {
+        printfMask = 1;
+
+        PRINTF("__________________ in order and repeated\n");
+        seenNode.restart(7, 1, 10 * SECONDS); // registers 1 as received
+        check(1);
+        check(2);
+        check(3);
+        check(2);
+
+        PRINTF("__________________ out of order\n");
+        check(6);
+        check(5);
+        check(4);
+        check(5);
+
+        PRINTF("__________________ jump over the first word of the window\n");
+        check(100);
+        check(40);
+        check(39);
+        check(40);
+
+        PRINTF("__________________ older than the window: dropped, the window stays\n");
+        check(300);
+        check(100);
+        check(172);
+        check(173);
+        check(173);
+
+        PRINTF("__________________ much older sentTime: sender restarted\n");
+        check(5, 1 * SECONDS);
+        check(5, 1 * SECONDS);
+        check(6, 1 * SECONDS);
+        check(4, 1 * SECONDS);
+        PRINTF("  a little older sentTime is no restart\n");
+        check(5, 1 * SECONDS - 4 * SECONDS / 5);
+
+        PRINTF("__________________ wrap around of the counter\n");
+        seenNode.restart(7, 0xfffffffe, 10 * SECONDS);
+        check(0xffffffff);
+        check(1);
+        check(0xfffffffe);
+        check(0xffffffff);
+        check(2);
+
+        PRINTF("__________________ sequence numbers from getNextMsgSequenceNr\n");
+        uint32_t first  = getNextMsgSequenceNr();
+        uint32_t second = getNextMsgSequenceNr();
+        PRINTF("  never 0: %d, increasing: %d\n", first != 0, second == first + 1);
+
+        PRINTF("\nThis run (test) terminates now!\n");
+        hwResetAndReboot();
+    }
+} duplicateTester;
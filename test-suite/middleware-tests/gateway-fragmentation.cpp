@@ -0,0 +1,141 @@
+#include "rodos.h"
+
+/**
+ * Messages longer than MAX_NETWORK_MESSAGE_LENGTH: the gateway sends them
+ * in fragments, the receiving gateway reassembles them.
+ */
+
+uint32_t printfMask = 0;
+
+/** Sends the messages back as if they came from node 7 */
+class LoopbackLink : public Linkinterface {
+  public:
+    Fifo<NetworkMessage, 64> messages;
+    uint32_t                 sentMsgs = 0;
+
+    LoopbackLink() : Linkinterface(-1) {}
+    bool sendNetworkMsg(NetworkMessage& outgoingMessage) override {
+        NetworkMessage msg = outgoingMessage;
+        msg.put_senderNode(7);
+        msg.setCheckSum();
+        sentMsgs++;
+        return messages.put(msg);
+    }
+    bool getNetworkMsg(NetworkMessage& inMsg, int32_t& numberOfReceivedBytes) override {
+        numberOfReceivedBytes = -1;
+        return messages.get(inMsg);
+    }
+    void suspendUntilDataReady(int64_t reactivationTime) override { Thread::suspendCallerUntil(reactivationTime); }
+};
+
+static LoopbackLink       loopback;
+static Gateway            gateway(&loopback, true);
+static PayloadCompression compression;
+
+struct Image {
+    uint8_t pixels[40][150]; ///< fits in the REASSEMBLY_BUFFER_SIZE of 8 KB
+};
+
+static Topic<Image> images(3200, "images");
+static Image        sentImage;
+static int32_t      imagesReceived  = 0;
+static int32_t      imagesIdentical = 0;
+
+class ImageReceiver : public SubscriberReceiver<Image> {
+  public:
+    ImageReceiver() : SubscriberReceiver<Image>(images, "imageReceiver") {}
+    void put(Image& image, const NetMsgInfo& info) override {
+        if(info.senderNode != 7) return; // the local delivery
+        imagesReceived++;
+        if(memcmp(&image, &sentImage, sizeof(image)) == 0) imagesIdentical++;
+    }
+} imageReceiver;
+
+static void sendImage(uint8_t variant) {
+    for(int32_t y = 0; y < 40; y++) {
+        for(int32_t x = 0; x < 150; x++) sentImage.pixels[y][x] = static_cast<uint8_t>(x + y * variant);
+    }
+    loopback.sentMsgs = 0;
+    imagesReceived    = 0;
+    imagesIdentical   = 0;
+    images.publish(sentImage);
+    Thread::suspendCallerUntil(NOW() + 100 * MILLISECONDS); // gateway thread delivers it
+    PRINTF("  %u bytes in %u network messages, received %d, identical %d\n",
+           static_cast<unsigned>(sizeof(Image)), static_cast<unsigned>(loopback.sentMsgs),
+           static_cast<int>(imagesReceived), static_cast<int>(imagesIdentical));
+}
+
+/*************** the reassembler alone *********/
+
+static Reassembler reassembler;
+static uint8_t     fragment[MAX_NETWORK_MESSAGE_LENGTH];
+
+static ReassemblyBuffer* addFragment(int32_t senderNode, uint32_t msgId, uint32_t totalLen, uint32_t index) {
+    uint32_t offset = index * static_cast<uint32_t>(MAX_FRAGMENT_DATA);
+    size_t   len    = (totalLen - offset < MAX_FRAGMENT_DATA) ? totalLen - offset : MAX_FRAGMENT_DATA;
+    uint32_tToBigEndian(fragment + 0, msgId);
+    uint32_tToBigEndian(fragment + 4, totalLen);
+    uint32_tToBigEndian(fragment + 8, offset);
+    memset(fragment + FRAGMENT_HEADER_SIZE, static_cast<char>(index), len);
+    return reassembler.addFragment(senderNode, 3200, fragment, FRAGMENT_HEADER_SIZE + len);
+}
+
+static void report(ReassemblyBuffer* buffer) {
+    if(buffer == 0) {
+        PRINTF("  incomplete, dropped fragments %u\n", static_cast<unsigned>(reassembler.droppedFragments));
+        return;
+    }
+    bool ok = true;
+    for(uint32_t i = 0; i < buffer->totalLen; i++) {
+        if(buffer->data[i] != i / MAX_FRAGMENT_DATA) ok = false;
+    }
+    PRINTF("  complete: msgId %u, %u bytes, content ok %d\n",
+           static_cast<unsigned>(buffer->msgId), static_cast<unsigned>(buffer->totalLen), ok);
+    reassembler.release(buffer);
+}
+
+class FragmentationTester : public StaticThread<> {
+  public:
+    void run() {
+        printfMask = 1;
+        uint32_t totalLen = static_cast<uint32_t>(3 * MAX_FRAGMENT_DATA + 100);
+
+        PRINTF("__________________ fragments out of order and repeated\n");
+        report(addFragment(5, 100, totalLen, 2));
+        report(addFragment(5, 100, totalLen, 0));
+        report(addFragment(5, 100, totalLen, 2));
+        report(addFragment(5, 100, totalLen, 3));
+        report(addFragment(5, 100, totalLen, 1));
+
+        PRINTF("__________________ late duplicate of a delivered message\n");
+        report(addFragment(5, 100, totalLen, 1));
+
+        PRINTF("__________________ one message per sender at the same time\n");
+        report(addFragment(5, 200, totalLen, 0));
+        report(addFragment(6, 200, totalLen, 0));
+        report(addFragment(6, 200, totalLen, 1));
+        report(addFragment(5, 200, totalLen, 1));
+        report(addFragment(5, 200, totalLen, 2));
+        report(addFragment(6, 200, totalLen, 2));
+        report(addFragment(6, 200, totalLen, 3));
+        report(addFragment(5, 200, totalLen, 3));
+
+        PRINTF("__________________ more incomplete messages than buffers, then timeout\n");
+        for(uint32_t msgId = 300; msgId < 300 + REASSEMBLY_BUFFERS; msgId++) addFragment(5, msgId, totalLen, 0); // all buffers in use
+        report(addFragment(5, 400, totalLen, 0));
+        Thread::suspendCallerUntil(NOW() + REASSEMBLY_TIMEOUT + 10 * MILLISECONDS);
+        report(addFragment(5, 400, totalLen, 0));
+
+        PRINTF("__________________ longer than REASSEMBLY_BUFFER_SIZE\n");
+        report(addFragment(5, 500, REASSEMBLY_BUFFER_SIZE + 1, 0));
+
+        PRINTF("__________________ image through a gateway\n");
+        sendImage(1);
+        PRINTF("__________________ image through a gateway, compressed fragments\n");
+        gateway.setPayloadCompression(&compression);
+        sendImage(0);
+
+        PRINTF("\nThis run (test) terminates now!\n");
+        hwResetAndReboot();
+    }
+} fragmentationTester;
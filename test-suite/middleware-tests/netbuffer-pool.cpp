@@ -0,0 +1,180 @@
+#include "rodos.h"
+
+/**
+ * Network buffers from netBufferPool: the size class for a message,
+ * reference counting, a larger class if one is empty, no buffer if all
+ * are used, a received message is delivered from its pool buffer (zero copy)
+ * and the buffers of a TransmitScheduler go back to the pool.
+ */
+
+uint32_t printfMask = 0;
+
+static constexpr size_t NETWORK_HEADER_SIZE = sizeof(NetworkMessage) - MAX_NETWORK_MESSAGE_LENGTH;
+
+class CountingLink : public Linkinterface {
+  public:
+    uint32_t msgs  = 0;
+    uint32_t bytes = 0;
+    CountingLink() : Linkinterface(-1) {}
+    bool sendNetworkMsg(NetworkMessage& outgoingMessage) override {
+        if(outgoingMessage.get_topicId() < 3300) return true; // eg. topic reports
+        msgs++;
+        bytes += outgoingMessage.numberOfBytesToSend();
+        return true;
+    }
+    void suspendUntilDataReady(int64_t reactivationTime) override { Thread::suspendCallerUntil(reactivationTime); }
+
+    Fifo<NetBuffer*, 4> received; ///< like LinkinterfaceUDP: one reference each
+    bool getNetworkBuffer(NetBufferRef& buffer) override {
+        NetBuffer* next;
+        if(!received.get(next)) return false;
+        buffer = NetBufferRef(next);
+        return true;
+    }
+};
+
+struct Image {
+    uint8_t data[1000];
+};
+
+static Topic<int32_t> counter(3300, "counter");
+static Topic<Image>   images(3301, "images");
+
+static CountingLink      countingLink;
+static Gateway           gateway(&countingLink, true);
+static TransmitScheduler scheduler;
+
+static NetBufferRef allSmall[NET_BUFFERS_SMALL];
+
+static void printFree(const char* when);
+
+/** The messages of node 4711: the gateway delivers them while their pool buffer is in use */
+class RemoteCounterReceiver : public Subscriber {
+  public:
+    RemoteCounterReceiver() : Subscriber(counter, "remoteCounterReceiver") {}
+    uint32_t put([[gnu::unused]] const uint32_t topicId, [[gnu::unused]] const size_t len, void* data, const NetMsgInfo& info) override {
+        if(info.senderNode != 4711) return 0;
+        PRINTF("  received %d from node 4711\n", static_cast<int>(*static_cast<int32_t*>(data)));
+        printFree("in the subscriber");
+        return 1;
+    }
+} remoteCounterReceiver;
+
+static void printFree(const char* when) {
+    PRINTF("  %s: free small %d, medium %d, large %d\n", when,
+           static_cast<int>(netBufferPool.numOfFree(0)),
+           static_cast<int>(netBufferPool.numOfFree(1)), static_cast<int>(netBufferPool.numOfFree(2)));
+}
+
+static void printClass(const char* title, const NetBufferRef& ref) {
+    PRINTF("  %s: %s, capacity %d\n", title, ref.isValid() ? "valid" : "invalid", static_cast<int>(ref.capacity()));
+}
+
+class NetBufferPoolTester : public StaticThread<> {
+  public:
+    void init() { gateway.setTransmitScheduler(&scheduler); }
+
+    void run() {
+        printfMask = 1;
+        suspendCallerUntil(NOW() + 100 * MILLISECONDS); // the gateway is running
+        printFree("at start");
+
+        PRINTF("__________________ size classes\n");
+        {
+            NetBufferRef forInt   = netBufferPool.alloc(NETWORK_HEADER_SIZE + sizeof(int32_t));
+            NetBufferRef forFrame = netBufferPool.alloc(NETWORK_HEADER_SIZE + 200);
+            NetBufferRef forImage = netBufferPool.alloc(NETWORK_HEADER_SIZE + 1000);
+            NetBufferRef tooLong  = netBufferPool.alloc(sizeof(NetworkMessage) + 1);
+            printClass("int32_t", forInt);
+            printClass("200 bytes", forFrame);
+            printClass("1000 bytes", forImage);
+            printClass("longer than a NetworkMessage", tooLong);
+            printFree("allocated");
+        }
+        printFree("released");
+
+        PRINTF("__________________ reference counting\n");
+        {
+            NetworkMessage msg;
+            NetMsgInfo     info;
+            int32_t        value = 4711;
+            prepareNetworkMessage(msg, counter.topicId, &value, sizeof(value), info);
+
+            NetBufferRef copy = netBufferPool.copyOf(msg);
+            PRINTF("  copy: %d bytes used, topic %d\n", static_cast<int>(copy.used()), static_cast<int>(copy->get_topicId()));
+            {
+                NetBufferRef shared = copy;
+                copy.release();
+                PRINTF("  one reference left: topic %d\n", static_cast<int>(shared->get_topicId()));
+                printFree("one reference");
+            }
+            printFree("no reference");
+
+            Fifo<NetBuffer*, 4> fifo;
+            NetBufferRef        queued = netBufferPool.copyOf(msg);
+            fifo.put(queued.detach());
+            NetBuffer* buffer;
+            fifo.get(buffer);
+            NetBufferRef taken(buffer);
+            PRINTF("  through a fifo: valid %d, topic %d\n", queued.isValid(), static_cast<int>(taken->get_topicId()));
+        }
+        printFree("released");
+
+        PRINTF("__________________ all small buffers used\n");
+        for(NetBufferRef& ref : allSmall) ref = netBufferPool.alloc(NETWORK_HEADER_SIZE);
+        {
+            NetBufferRef next = netBufferPool.alloc(NETWORK_HEADER_SIZE);
+            printClass("one more small", next);
+            printFree("allocated");
+        }
+        for(NetBufferRef& ref : allSmall) ref.release();
+        printFree("released");
+
+        PRINTF("__________________ all buffers used\n");
+        {
+            static NetBufferRef allMedium[NET_BUFFERS_MEDIUM];
+            static NetBufferRef allLarge[NET_BUFFERS_LARGE];
+            for(NetBufferRef& ref : allSmall) ref = netBufferPool.alloc(NETWORK_HEADER_SIZE);
+            for(NetBufferRef& ref : allMedium) ref = netBufferPool.alloc(NET_BUFFER_MEDIUM_SIZE);
+            for(NetBufferRef& ref : allLarge) ref = netBufferPool.alloc(sizeof(NetworkMessage));
+            uint32_t     failures = netBufferPool.allocFailures;
+            NetBufferRef none     = netBufferPool.alloc(NETWORK_HEADER_SIZE);
+            printClass("one more", none);
+            PRINTF("  alloc failures +%d\n", static_cast<int>(netBufferPool.allocFailures - failures));
+            for(NetBufferRef& ref : allSmall) ref.release();
+            for(NetBufferRef& ref : allMedium) ref.release();
+            for(NetBufferRef& ref : allLarge) ref.release();
+        }
+        printFree("released");
+
+        PRINTF("__________________ zero copy reception\n");
+        {
+            NetworkMessage msg;
+            NetMsgInfo     info;
+            int32_t        value = 1234;
+            info.init();
+            info.senderNode = 4711;
+            info.sentTime   = NOW();
+            info.sequenceNr = 1;
+            prepareNetworkMessage(msg, counter.topicId, &value, sizeof(value), info);
+            NetBufferRef buffer = netBufferPool.copyOf(msg);
+            countingLink.received.put(buffer.detach());
+        }
+        suspendCallerUntil(NOW() + 50 * MILLISECONDS);
+        printFree("delivered");
+
+        PRINTF("__________________ transmit scheduler\n");
+        Image image;
+        memset(&image, 0, sizeof(image));
+        for(int32_t i = 0; i < 20; i++) {
+            counter.publish(i);
+            images.publish(image);
+        }
+        suspendCallerUntil(NOW() + 100 * MILLISECONDS);
+        PRINTF("  sent %d msgs, %d bytes, waited for buffers %d\n", static_cast<int>(countingLink.msgs),
+               static_cast<int>(countingLink.bytes), static_cast<int>(scheduler.poolEmpty));
+        printFree("all sent");
+
+        hwResetAndReboot();
+    }
+} netBufferPoolTester;
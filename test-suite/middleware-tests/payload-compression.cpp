@@ -0,0 +1,138 @@
+#include "rodos.h"
+
+/**
+ * Compression of the user data of network messages: round trips of the
+ * codec, and a gateway which sends housekeeping compressed over a loopback link.
+ */
+
+uint32_t printfMask = 0;
+
+static PayloadCompression codec;
+static uint8_t            original[MAX_NETWORK_MESSAGE_LENGTH];
+static uint8_t            compressed[MAX_NETWORK_MESSAGE_LENGTH];
+static uint8_t            decompressed[MAX_NETWORK_MESSAGE_LENGTH];
+
+static void roundTrip(const char* name, size_t len) {
+    size_t compressedLen = codec.compress(original, len, compressed, sizeof(compressed));
+    if(compressedLen == 0) {
+        PRINTF("  %s: %u bytes -> not compressed\n", name, static_cast<unsigned>(len));
+        return;
+    }
+    size_t decompressedLen = PayloadCompression::decompress(compressed, compressedLen, decompressed, sizeof(decompressed));
+    bool   ok              = decompressedLen == len && memcmp(original, decompressed, len) == 0;
+    PRINTF("  %s: %u bytes -> %u bytes, identical after decompression: %d\n",
+           name, static_cast<unsigned>(len), static_cast<unsigned>(compressedLen), ok);
+}
+
+/*************** housekeeping over a loopback link *********/
+
+struct Housekeeping {
+    uint32_t counter;
+    int16_t  temperatures[16];
+    uint16_t voltages[16];
+    uint8_t  modes[32];
+    uint32_t errorCounters[16];
+};
+
+/** Sends the messages back as if they came from node 7 */
+class LoopbackLink : public Linkinterface {
+  public:
+    NetworkMessage msg;
+    bool           msgReady = false;
+    uint32_t       bytes    = 0;
+
+    LoopbackLink() : Linkinterface(-1) {}
+    bool sendNetworkMsg(NetworkMessage& outgoingMessage) override {
+        bytes += outgoingMessage.numberOfBytesToSend();
+        msg = outgoingMessage;
+        msg.put_senderNode(7);
+        msg.setCheckSum();
+        msgReady = true;
+        return true;
+    }
+    bool getNetworkMsg(NetworkMessage& inMsg, int32_t& numberOfReceivedBytes) override {
+        if(!msgReady) return false;
+        inMsg                 = msg;
+        numberOfReceivedBytes = -1;
+        msgReady              = false;
+        return true;
+    }
+    void suspendUntilDataReady(int64_t reactivationTime) override { Thread::suspendCallerUntil(reactivationTime); }
+};
+
+static LoopbackLink       loopback;
+static Gateway            gateway(&loopback, true);
+static PayloadCompression gatewayCompression;
+
+static Topic<Housekeeping> housekeeping(3100, "housekeeping");
+static Housekeeping        lastSent;
+static int32_t             receivedFromNetwork = 0;
+static int32_t             receivedIdentical   = 0;
+
+class HousekeepingReceiver : public SubscriberReceiver<Housekeeping> {
+  public:
+    HousekeepingReceiver() : SubscriberReceiver<Housekeeping>(housekeeping, "hkReceiver") {}
+    void put(Housekeeping& hk, const NetMsgInfo& info) override {
+        if(info.senderNode != 7) return; // the local delivery
+        receivedFromNetwork++;
+        if(memcmp(&hk, &lastSent, sizeof(hk)) == 0) receivedIdentical++;
+    }
+} hkReceiver;
+
+static void sendHousekeeping(int32_t n) {
+    loopback.bytes      = 0;
+    receivedFromNetwork = 0;
+    receivedIdentical   = 0;
+    for(int32_t i = 0; i < n; i++) {
+        memset(&lastSent, 0, sizeof(lastSent));
+        lastSent.counter = static_cast<uint32_t>(i);
+        for(int32_t k = 0; k < 16; k++) {
+            lastSent.temperatures[k] = static_cast<int16_t>(200 + k / 4);
+            lastSent.voltages[k]     = 3300;
+        }
+        lastSent.modes[3]         = 1;
+        lastSent.errorCounters[5] = static_cast<uint32_t>(i / 3);
+        housekeeping.publish(lastSent);
+        Thread::suspendCallerUntil(NOW() + 30 * MILLISECONDS); // gateway thread delivers it
+    }
+}
+
+class CompressionTester : public StaticThread<> {
+  public:
+    void run() {
+        printfMask = 1;
+
+        PRINTF("__________________ round trips\n");
+        memset(original, 0, sizeof(original));
+        roundTrip("zeros", 1000);
+        for(size_t i = 0; i < 1024; i++) original[i] = static_cast<uint8_t>(i);
+        roundTrip("ramp", 1024);
+        const char* text = "RODOS RODOS RODOS: real time oriented dependable operating system, real time, dependable";
+        memcpy(original, text, strlen(text));
+        roundTrip("text", strlen(text));
+        uint32_t seed = 12345;
+        for(size_t i = 0; i < 300; i++) {
+            seed        = seed * 1103515245 + 12345;
+            original[i] = static_cast<uint8_t>(seed >> 16);
+        }
+        roundTrip("random", 300);
+        roundTrip("3 bytes", 3);
+
+        PRINTF("__________________ corrupt data\n");
+        uint8_t copyBeforeStart[] = { 0x00, 0x41, 0x80, 0x05 }; // one literal, then copy from 6 bytes back
+        PRINTF("  decompressed len: %u\n",
+               static_cast<unsigned>(PayloadCompression::decompress(copyBeforeStart, sizeof(copyBeforeStart), decompressed, sizeof(decompressed))));
+
+        PRINTF("__________________ housekeeping through a gateway\n");
+        sendHousekeeping(10);
+        PRINTF("  uncompressed: %u bytes on the link, %d of 10 received identical\n",
+               static_cast<unsigned>(loopback.bytes), static_cast<int>(receivedIdentical));
+        gateway.setPayloadCompression(&gatewayCompression);
+        sendHousekeeping(10);
+        PRINTF("  compressed:   %u bytes on the link, %d of 10 received identical\n",
+               static_cast<unsigned>(loopback.bytes), static_cast<int>(receivedIdentical));
+
+        PRINTF("\nThis run (test) terminates now!\n");
+        hwResetAndReboot();
+    }
+} compressionTester;
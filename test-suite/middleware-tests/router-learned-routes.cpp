@@ -0,0 +1,146 @@
+#include "rodos.h"
+
+/**
+ * Simulated topology: this node (0) is a router with 3 links
+ *   link A -> nodes 1, 2
+ *   link B -> node 3, and node 4 behind node 3
+ *   link C -> nodes 5, 6
+ * The router learns the routes from incoming messages and sends
+ * local messages only to the links leading to interested nodes.
+ * At the end a node on link C gets the same node index as node 1.
+ */
+
+uint32_t printfMask = 0;
+
+class CountingLink : public Linkinterface {
+  public:
+    uint32_t msgs  = 0;
+    uint32_t bytes = 0;
+    CountingLink() : Linkinterface(-1) {}
+    bool sendNetworkMsg(NetworkMessage& outgoingMessage) override {
+        msgs++;
+        bytes += outgoingMessage.numberOfBytesToSend();
+        return true;
+    }
+    void suspendUntilDataReady(int64_t reactivationTime) override { Thread::suspendCallerUntil(reactivationTime); }
+    void reset() { msgs = bytes = 0; }
+};
+
+static CountingLink linkA, linkB, linkC;
+static Gateway      gatewayA(&linkA, true, false); // the router sends, not the gateways
+static Gateway      gatewayB(&linkB, true, false);
+static Gateway      gatewayC(&linkC, true, false);
+static Router       router(false, &gatewayA, &gatewayB, &gatewayC);
+
+static Topic<int32_t> toNode1(2001, "toNode1");
+static Topic<int32_t> toNodes3and4(2002, "toNodes3and4");
+static Topic<int32_t> toNodes2and5and6(2003, "toNodes2and5and6");
+static Topic<int32_t> noInformation(2004, "noInformation");
+static Topic<int32_t> toUnknownNode(2005, "toUnknownNode");
+static Topic<int32_t> toBroadcast(5, "toBroadcast");
+
+static void arrivesFrom(CountingLink& link, int32_t senderNode, int16_t stepsLeft) {
+    NetworkMessage msg;
+    NetMsgInfo     info;
+    int32_t        data = 0;
+    info.senderNode          = senderNode;
+    info.receiverNodesBitMap = 0;
+    info.sequenceNr          = 1;
+    prepareNetworkMessage(msg, 3000, &data, sizeof(data), info);
+    msg.put_maxStepsToForward(stepsLeft);
+    info.linkId = link.getLinkdentifier();
+    router.put(3000, sizeof(msg), &msg, info);
+}
+
+static void publishAll() {
+    linkA.reset();
+    linkB.reset();
+    linkC.reset();
+    for(int32_t i = 0; i < 100; i++) {
+        toNode1.publish(i);
+        toNodes3and4.publish(i);
+        toNodes2and5and6.publish(i);
+        noInformation.publish(i);
+        toUnknownNode.publish(i);
+        toBroadcast.publish(i);
+    }
+}
+
+/// bitmap of the known nodes reached through link
+static uint32_t nodesThrough(CountingLink& link) {
+    NodeSet known;
+    router.getRoutingTable()->knownNodes(known);
+    uint32_t bitmap = 0;
+    for(int32_t i = known.next(0); i >= 0; i = known.next(static_cast<uint32_t>(i) + 1)) {
+        NodeSet  node;
+        uint32_t linkId     = 0;
+        uint32_t numOfLinks = 0;
+        node.add(static_cast<uint32_t>(i));
+        router.getRoutingTable()->linksTo(node, &linkId, numOfLinks, 1);
+        if(linkId == link.getLinkdentifier()) bitmap |= 0x01u << i;
+    }
+    return bitmap;
+}
+
+static void report(const char* title) {
+    PRINTF("%s\n", title);
+    PRINTF("  link A: %3u msgs %6u bytes\n", (unsigned)linkA.msgs, (unsigned)linkA.bytes);
+    PRINTF("  link B: %3u msgs %6u bytes\n", (unsigned)linkB.msgs, (unsigned)linkB.bytes);
+    PRINTF("  link C: %3u msgs %6u bytes\n", (unsigned)linkC.msgs, (unsigned)linkC.bytes);
+}
+
+class RouterTester : public StaticThread<> {
+  public:
+    void run() {
+        printfMask = 1;
+        setNodeNumber(0);
+
+        toNode1.receiverNodesBitMap          = (1u << 1);
+        toNodes3and4.receiverNodesBitMap     = (1u << 3) | (1u << 4);
+        toNodes2and5and6.receiverNodesBitMap = (1u << 2) | (1u << 5) | (1u << 6);
+        noInformation.receiverNodesBitMap    = 0;
+        toUnknownNode.receiverNodesBitMap    = (1u << 1) | (1u << 9);
+
+        PRINTF("__________________ learning routes\n");
+        router.setRouteLearning();
+        arrivesFrom(linkA, 1, 9);
+        arrivesFrom(linkA, 2, 9);
+        arrivesFrom(linkB, 3, 9);
+        arrivesFrom(linkB, 4, 8);
+        arrivesFrom(linkC, 4, 7); // longer path, ignored
+        arrivesFrom(linkC, 5, 9);
+        arrivesFrom(linkC, 6, 9);
+
+        NodeSet known;
+        router.getRoutingTable()->knownNodes(known);
+        PRINTF("  known nodes     %08x\n", (unsigned)known.fold());
+        PRINTF("  through link A  %08x\n", (unsigned)nodesThrough(linkA));
+        PRINTF("  through link B  %08x\n", (unsigned)nodesThrough(linkB));
+        PRINTF("  through link C  %08x\n", (unsigned)nodesThrough(linkC));
+
+        publishAll();
+        report("__________________ learned routes");
+        uint32_t routedBytes = linkA.bytes + linkB.bytes + linkC.bytes;
+
+        router.setRouteLearning(false);
+        publishAll();
+        report("__________________ flooding");
+        uint32_t floodedBytes = linkA.bytes + linkB.bytes + linkC.bytes;
+
+        PRINTF("__________________ bandwidth saved: %u of %u bytes (%u%%)\n",
+               (unsigned)(floodedBytes - routedBytes), (unsigned)floodedBytes,
+               (unsigned)(100 * (floodedBytes - routedBytes) / floodedBytes));
+
+        PRINTF("__________________ node 1 + MAX_ADDRESSABLE_NODES on link C: the same index as node 1\n");
+        router.setRouteLearning();
+        arrivesFrom(linkC, 1 + MAX_ADDRESSABLE_NODES, 9);
+        arrivesFrom(linkA, 1, 9);
+        PRINTF("  index collisions %u\n", (unsigned)router.getRoutingTable()->indexCollisions);
+        PRINTF("  through link A  %08x\n", (unsigned)nodesThrough(linkA));
+        publishAll();
+        report("__________________ toNode1 flooded");
+
+        PRINTF("\nThis run (test) terminates now!\n");
+        hwResetAndReboot();
+    }
+} routerTester;
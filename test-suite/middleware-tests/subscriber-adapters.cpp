@@ -0,0 +1,66 @@
+#include "rodos.h"
+
+/**
+ * Subscribers which get only a part of the messages of their topic:
+ * every n-th (decimating), at most one per interval (throttled, with and
+ * without the latest value in a CommBuffer) and only changed ones.
+ */
+
+uint32_t printfMask = 0;
+
+static Topic<int32_t> samples(3500, "samples");
+static Topic<int32_t> modes(3501, "modes");
+
+static void printDecimated(int32_t& value) { PRINTF("  decimated %d\n", static_cast<int>(value)); }
+static void printThrottled(int32_t& value) { PRINTF("  throttled %d\n", static_cast<int>(value)); }
+static void printCoalesced(int32_t& value) { PRINTF("  coalescing %d\n", static_cast<int>(value)); }
+static void printChanged(int32_t& value) { PRINTF("  changed %d\n", static_cast<int>(value)); }
+
+static int32_t allSamples = 0;
+static void    countAll([[gnu::unused]] int32_t& value) { allSamples++; }
+
+static SubscriberReceiver<int32_t>   everySample(samples, countAll, "everySample");
+static DecimatingSubscriber<int32_t> everyThird(samples, 3, printDecimated, "everyThird");
+static ThrottledSubscriber<int32_t>  throttled(samples, 10 * MILLISECONDS, printThrottled, false, "throttled");
+static ThrottledSubscriber<int32_t>  coalescing(samples, 10 * MILLISECONDS, printCoalesced, true, "coalescing");
+static ChangeOnlySubscriber<int32_t> modeChanges(modes, printChanged, "modeChanges");
+
+// the policies of any subscriber, here one with a putter
+static Fifo<int32_t, 16> fifo;
+static Subscriber        combined(modes, fifo, "combined");
+
+class SubscriberAdaptersTester : public StaticThread<> {
+  public:
+    void init() {
+        combined.setChangeOnly();
+        combined.setDecimation(2);
+    }
+
+    void run() {
+        printfMask = 1;
+
+        PRINTF("__________________ 4 bursts of 5 samples, 20 ms between them\n");
+        int32_t value = 1;
+        for(int32_t burst = 0; burst < 4; burst++) {
+            for(int32_t i = 0; i < 5; i++) samples.publish(value++);
+            int32_t latest;
+            if(coalescing.getLatest(latest)) PRINTF("  latest %d\n", static_cast<int>(latest));
+            suspendCallerUntil(NOW() + 20 * MILLISECONDS);
+        }
+        int32_t latest;
+        PRINTF("  all %d, new latest value %d\n", static_cast<int>(allSamples), coalescing.getLatest(latest));
+        PRINTF("  skipped: decimated %d, throttled %d, coalescing %d, every sample %d\n", static_cast<int>(everyThird.skippedMsgs),
+               static_cast<int>(throttled.skippedMsgs), static_cast<int>(coalescing.skippedMsgs), static_cast<int>(everySample.skippedMsgs));
+
+        PRINTF("__________________ modes 1 1 1 2 2 3 3 3 1 4\n");
+        static const int32_t modeSequence[] = { 1, 1, 1, 2, 2, 3, 3, 3, 1, 4 };
+        for(int32_t mode : modeSequence) modes.publish(mode);
+
+        PRINTF("__________________ change only, then decimation 2 (of the changed)\n");
+        int32_t mode;
+        while(fifo.get(mode)) PRINTF("  combined %d\n", static_cast<int>(mode));
+        PRINTF("  skipped %d\n", static_cast<int>(combined.skippedMsgs));
+
+        hwResetAndReboot();
+    }
+} subscriberAdaptersTester;
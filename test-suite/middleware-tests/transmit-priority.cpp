@@ -0,0 +1,98 @@
+#include "rodos.h"
+
+/**
+ * Gateways with a TransmitScheduler on rate limited links:
+ * high priority messages overtake the queued bulk messages (strict priority),
+ * or all classes get their share (weighted fair).
+ */
+
+uint32_t printfMask = 0;
+
+/** Records the order of the sent messages, one letter per topic */
+class RecordingLink : public Linkinterface {
+  public:
+    char     sent[64];
+    uint32_t numOfSent = 0;
+
+    RecordingLink() : Linkinterface(-1) {}
+    bool sendNetworkMsg(NetworkMessage& outgoingMessage) override {
+        uint32_t topicId = outgoingMessage.get_topicId();
+        if(topicId < 3100 || numOfSent >= sizeof(sent) - 1) return true; // eg. topic reports
+        sent[numOfSent++] = "HNB"[(topicId - 3100) % 3];
+        sent[numOfSent]   = 0;
+        return true;
+    }
+    void suspendUntilDataReady(int64_t reactivationTime) override { Thread::suspendCallerUntil(reactivationTime); }
+};
+
+struct Frame {
+    uint8_t data[1300];
+};
+
+// strict priority: HIGH by the policy of the gateway, BULK by the topic
+static Topic<Frame> commands(3100, "commands");
+static Topic<Frame> telemetry(3101, "telemetry");
+static Topic<Frame> images(3102, "images", false, TransmitPriority::BULK);
+
+// weighted fair
+static Topic<Frame> alarms(3103, "alarms", false, TransmitPriority::HIGH);
+static Topic<Frame> housekeeping(3104, "housekeeping");
+static Topic<Frame> files(3105, "files", false, TransmitPriority::BULK);
+
+static RecordingLink     strictLink;
+static Gateway           strictGateway(&strictLink);
+static TransmitScheduler strictScheduler(TransmitScheduler::Mode::STRICT_PRIORITY);
+
+static RecordingLink     fairLink;
+static Gateway           fairGateway(&fairLink);
+static TransmitScheduler fairScheduler(TransmitScheduler::Mode::WEIGHTED_FAIR);
+
+static Frame frame;
+
+class TransmitPriorityTester : public StaticThread<> {
+  public:
+    void init() {
+        strictGateway.addTopicsToForward(&commands, &telemetry, &images);
+        strictGateway.setTopicPriority(commands.topicId, TransmitPriority::HIGH);
+        strictGateway.setTransmitScheduler(&strictScheduler);
+        fairGateway.addTopicsToForward(&alarms, &housekeeping, &files);
+        fairGateway.setTransmitScheduler(&fairScheduler);
+        fairScheduler.setWeights(2, 1, 1);
+    }
+
+    void run() {
+        printfMask = 1;
+
+        PRINTF("__________________ token bucket: 1000 bytes/s, bursts of 100\n");
+        TokenBucket bucket;
+        bucket.setRate(1000, 100, 0);
+        PRINTF("  full: wait %d ms\n", static_cast<int>(bucket.timeUntilReady(0) / MILLISECONDS));
+        bucket.consume(600, 0);
+        PRINTF("  after 600 bytes: wait %d ms\n", static_cast<int>(bucket.timeUntilReady(0) / MILLISECONDS));
+        PRINTF("  250 ms later: wait %d ms\n", static_cast<int>(bucket.timeUntilReady(250 * MILLISECONDS) / MILLISECONDS));
+        PRINTF("  10 s later: wait %d ms\n", static_cast<int>(bucket.timeUntilReady(10 * SECONDS) / MILLISECONDS));
+        bucket.consume(150, 10 * SECONDS);
+        PRINTF("  after 150 bytes: wait %d ms\n", static_cast<int>(bucket.timeUntilReady(10 * SECONDS) / MILLISECONDS));
+
+        PRINTF("__________________ strict priority, 20000 bytes/s\n");
+        strictLink.setRateLimit(20000, 100);
+        for(int32_t i = 0; i < 5; i++) images.publishMsgPart(frame, 60); // the last ones wait for free space
+        commands.publishMsgPart(frame, 60);
+        telemetry.publishMsgPart(frame, 60);
+        Thread::suspendCallerUntil(NOW() + 200 * MILLISECONDS);
+        PRINTF("  sent: %s\n", strictLink.sent);
+        PRINTF("  per class: %u %u %u\n", static_cast<unsigned>(strictScheduler.sentMsgs[0]),
+               static_cast<unsigned>(strictScheduler.sentMsgs[1]), static_cast<unsigned>(strictScheduler.sentMsgs[2]));
+
+        PRINTF("__________________ weighted fair 2 : 1 : 1, 20000 bytes/s\n");
+        fairLink.setRateLimit(20000, 100);
+        fairLink.rateLimiter.consume(3000); // busy for 150 ms: all get queued first
+        for(int32_t i = 0; i < 3; i++) files.publish(frame);
+        for(int32_t i = 0; i < 3; i++) housekeeping.publish(frame);
+        for(int32_t i = 0; i < 3; i++) alarms.publish(frame);
+        Thread::suspendCallerUntil(NOW() + 1 * SECONDS);
+        PRINTF("  sent: %s\n", fairLink.sent);
+
+        hwResetAndReboot();
+    }
+} transmitPriorityTester;